@@ -0,0 +1,7 @@
+g++ -O2 main.cpp -o main
+g++ -O2 -mavx -Wa,-muse-unaligned-vector-move main.cpp -o main_avx
+g++ -O2 -DCY_NO_INTRIN_H main.cpp -o main_scalar
+main_scalar.exe
+main.exe
+main_avx.exe
+pause
\ No newline at end of file
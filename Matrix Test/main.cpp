@@ -0,0 +1,357 @@
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "cyCodeBase/cyCore.h"
+#include "cyCodeBase/cyVector.h"
+#include "cyCodeBase/cyMatrix.h"
+
+// Equivalence tests and microbenchmark for the SIMD Matrix4<float> specializations of cyMatrix.h.
+//
+// The reference is the generic Matrix4 template instantiated with a float wrapper type, so that it runs
+// the scalar code in single precision even when Matrix4<float> is specialized. The products, transforms,
+// and transposes use the same operation order in both, so they must match bit for bit. The inverses use
+// a different algorithm, so they are compared to the double precision inverse with a relative tolerance.
+// The hash of all float results must be the same for the SSE2, AVX, and scalar builds of build.bat.
+// The benchmark times the Matrix4f operations of the build, so the scalar build gives the baseline.
+
+// test settings
+int numCases = 200000;
+int numRounds = 2000;
+bool runTests = true;
+bool runBenchmark = true;
+
+// largest relative errors of the inverses of well-conditioned matrices
+double inverseTolerance = 1e-4;
+double affineInverseTolerance = 1e-5;
+
+// a single precision number that is not float, so that cy::Matrix4<Float> uses the generic template
+struct Float
+{
+    float v;
+    Float() = default;
+    Float(float f) : v(f) {}
+    Float operator+(Float b) const { return v + b.v; }
+    Float operator-(Float b) const { return v - b.v; }
+    Float operator*(Float b) const { return v * b.v; }
+    Float operator/(Float b) const { return v / b.v; }
+    Float operator-() const { return -v; }
+    Float &operator+=(Float b) { v += b.v; return *this; }
+    Float &operator-=(Float b) { v -= b.v; return *this; }
+    Float &operator*=(Float b) { v *= b.v; return *this; }
+    Float &operator/=(Float b) { v /= b.v; return *this; }
+    bool operator==(Float b) const { return v == b.v; }
+    bool operator!=(Float b) const { return v != b.v; }
+    bool operator<(Float b) const { return v < b.v; }
+    bool operator>(Float b) const { return v > b.v; }
+};
+
+typedef cy::Matrix4<Float> RefMatrix4;
+typedef cy::Vec4<Float> RefVec4;
+typedef cy::Vec3<Float> RefVec3;
+
+// the result of one of the checks
+struct Check
+{
+    std::string name;
+    double tolerance;      // largest relative error, or 0 if the results must be bit-identical
+    size_t cases;
+    size_t failures;
+    double worst;          // largest relative error
+    double worstGeneric;   // largest relative error of the generic code, for the inverses
+    Check(std::string const &n, double t) : name(n), tolerance(t), cases(0), failures(0), worst(0), worstGeneric(0) {}
+};
+
+std::mt19937 rng(1);
+uint64_t resultHash = 14695981039346656037ull;
+
+float randomFloat(float range)
+{
+    return std::uniform_real_distribution<float>(-range, range)(rng);
+}
+
+cyMatrix4f randomMatrix()
+{
+    cyMatrix4f m;
+    for (int i = 0; i < 16; i++)
+        m.cell[i] = randomFloat(2);
+    return m;
+}
+
+// rotation, non-uniform scale, shear, and translation
+cyMatrix4f randomAffine()
+{
+    cyVec3f axis(randomFloat(2), randomFloat(2), randomFloat(2));
+    cyVec3f scale(0.2f + fabsf(randomFloat(2)), 0.2f + fabsf(randomFloat(2)), 0.2f + fabsf(randomFloat(2)));
+    cyMatrix4f m = cyMatrix4f::Translation(cyVec3f(randomFloat(2), randomFloat(2), randomFloat(2))) * cyMatrix4f::Rotation(axis.GetNormalized(), randomFloat(2)) * cyMatrix4f::Scale(scale);
+    m.cell[4] += 0.3f * randomFloat(2);
+    return m;
+}
+
+RefMatrix4 toRef(cyMatrix4f const &m)
+{
+    RefMatrix4 r;
+    for (int i = 0; i < 16; i++)
+        r.cell[i] = m.cell[i];
+    return r;
+}
+
+cyMatrix4d toDouble(cyMatrix4f const &m)
+{
+    cyMatrix4d d;
+    for (int i = 0; i < 16; i++)
+        d.cell[i] = m.cell[i];
+    return d;
+}
+
+void hashFloats(float const *f, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        uint32_t bits;
+        memcpy(&bits, &f[i], sizeof(bits));
+        resultHash = (resultHash ^ bits) * 1099511628211ull;
+    }
+}
+
+// compares the bits, so that NaNs and signed zeros must match as well
+bool sameBits(float const *a, Float const *b, int n)
+{
+    for (int i = 0; i < n; i++)
+        if (memcmp(&a[i], &b[i].v, sizeof(float)) != 0)
+            return false;
+    return true;
+}
+
+double value(float f) { return f; }
+double value(Float f) { return f.v; }
+
+// largest difference relative to the largest element of the reference
+template <typename T>
+double relativeError(cy::Matrix4<T> const &m, cyMatrix4d const &ref)
+{
+    double scale = 0, error = 0;
+    for (int i = 0; i < 16; i++)
+        scale = std::max(scale, fabs(ref.cell[i]));
+    for (int i = 0; i < 16; i++)
+        error = std::max(error, fabs(value(m.cell[i]) - ref.cell[i]) / scale);
+    return error;
+}
+
+// true if the largest element of the inverse is small enough that its error does not depend on the algorithm
+bool wellConditioned(cyMatrix4d const &inverse)
+{
+    double largest = 0;
+    for (int i = 0; i < 16; i++)
+        largest = std::max(largest, fabs(inverse.cell[i]));
+    return largest < 50;
+}
+
+void addResult(Check &check, bool passed, double error = 0)
+{
+    check.cases++;
+    check.worst = std::max(check.worst, error);
+    if (!passed)
+        check.failures++;
+}
+
+bool test()
+{
+    Check multiply("Matrix4 * Matrix4", 0);
+    Check transform4("Matrix4 * Vec4", 0);
+    Check transform3("Matrix4 * Vec3", 0);
+    Check transpose("Transpose", 0);
+    Check inverse("GetInverse", inverseTolerance);
+    Check affine("GetAffineInverse", affineInverseTolerance);
+
+    for (int i = 0; i < numCases; i++)
+    {
+        cyMatrix4f a = randomMatrix();
+        cyMatrix4f b = randomMatrix();
+        RefMatrix4 ra = toRef(a);
+        RefMatrix4 rb = toRef(b);
+
+        cyMatrix4f p = a * b;
+        RefMatrix4 rp = ra * rb;
+        addResult(multiply, sameBits(p.cell, rp.cell, 16));
+        hashFloats(p.cell, 16);
+
+        cyVec4f v(randomFloat(2), randomFloat(2), randomFloat(2), randomFloat(2));
+        cyVec4f t4 = a * v;
+        RefVec4 rt4 = ra * RefVec4(v.x, v.y, v.z, v.w);
+        addResult(transform4, sameBits(&t4.x, &rt4.x, 4));
+        hashFloats(&t4.x, 4);
+
+        cyVec3f v3(randomFloat(2), randomFloat(2), randomFloat(2));
+        cyVec4f t3 = a * v3;
+        RefVec4 rt3 = ra * RefVec3(v3.x, v3.y, v3.z);
+        addResult(transform3, sameBits(&t3.x, &rt3.x, 4));
+        hashFloats(&t3.x, 4);
+
+        cyMatrix4f tr = a.GetTranspose();
+        cyMatrix4f trInPlace = a;
+        trInPlace.Transpose();
+        RefMatrix4 rtr = ra.GetTranspose();
+        addResult(transpose, sameBits(tr.cell, rtr.cell, 16) && sameBits(trInPlace.cell, rtr.cell, 16));
+        hashFloats(tr.cell, 16);
+
+        cyMatrix4d inv = toDouble(a).GetInverse();
+        if (wellConditioned(inv))
+        {
+            double error = relativeError(a.GetInverse(), inv);
+            addResult(inverse, error <= inverseTolerance, error);
+            inverse.worstGeneric = std::max(inverse.worstGeneric, relativeError(ra.GetInverse(), inv));
+        }
+
+        cyMatrix4f f = randomAffine();
+        cyMatrix4d finv = toDouble(f).GetInverse();
+        if (wellConditioned(finv))
+        {
+            cyMatrix4f fi = f.GetAffineInverse();
+            cyMatrix4f fiInPlace = f;
+            fiInPlace.InvertAffine();
+            double error = relativeError(fi, finv);
+            bool lastRow = fi.cell[3] == 0 && fi.cell[7] == 0 && fi.cell[11] == 0 && fi.cell[15] == 1;
+            addResult(affine, error <= affineInverseTolerance && lastRow && memcmp(fi.cell, fiInPlace.cell, sizeof(fi.cell)) == 0, error);
+            affine.worstGeneric = std::max(affine.worstGeneric, relativeError(toRef(f).GetAffineInverse(), finv));
+        }
+    }
+
+    bool passed = true;
+    for (Check const *c : { &multiply, &transform4, &transform3, &transpose, &inverse, &affine })
+    {
+        char line[256];
+        if (c->tolerance == 0)
+            snprintf(line, sizeof(line), "%-18s %8zu cases  %s", c->name.c_str(), c->cases, c->failures ? "" : "bit-identical to the generic code");
+        else
+            snprintf(line, sizeof(line), "%-18s %8zu cases  worst relative error %.2g (generic %.2g, tolerance %.0e)", c->name.c_str(), c->cases, c->worst, c->worstGeneric, c->tolerance);
+        std::cout << line;
+        if (c->failures)
+            std::cout << "  FAILED " << c->failures << " cases";
+        std::cout << std::endl;
+        passed = passed && c->failures == 0;
+    }
+    char hash[32];
+    snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)resultHash);
+    std::cout << "Hash of the bit-identical results: " << hash << std::endl;
+    return passed;
+}
+
+//-------------------------------------------------------------------------------
+// Benchmark
+//-------------------------------------------------------------------------------
+
+// returns nanoseconds per call of func for each of the matrices, the fastest of three runs
+template <typename FUNC>
+double timeCalls(size_t numMatrices, FUNC func)
+{
+    double best = 0;
+    for (int run = 0; run < 3; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < numRounds; r++)
+            for (size_t i = 0; i < numMatrices; i++)
+                func(i);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (run == 0 || seconds < best)
+            best = seconds;
+    }
+    return best * 1e9 / ((double)numRounds * numMatrices);
+}
+
+// times one of the operations for all matrices
+double benchmarkOperation(std::vector<cyMatrix4f> const &m, int operation)
+{
+    size_t n = m.size();
+    std::vector<cyMatrix4f> out(n);
+    std::vector<cyVec4f> v(n), vout(n);
+    for (size_t i = 0; i < n; i++)
+        v[i] = cyVec4f((float)i, 1.0f, 2.0f, 1.0f);
+    double ns = 0;
+    switch (operation)
+    {
+    case 0: ns = timeCalls(n, [&](size_t i) { out[i] = m[i] * m[(i + 1) % n]; }); break;
+    case 1: ns = timeCalls(n, [&](size_t i) { vout[i] = m[i] * v[i]; }); break;
+    case 2: ns = timeCalls(n, [&](size_t i) { out[i] = m[i].GetInverse(); }); break;
+    case 3: ns = timeCalls(n, [&](size_t i) { out[i] = m[i].GetAffineInverse(); }); break;
+    case 4: ns = timeCalls(n, [&](size_t i) { out[i] = m[i].GetTranspose(); }); break;
+    case 5: ns = timeCalls(n, [&](size_t i) { out[i] = m[i].GetInverse().GetTranspose(); }); break;
+    }
+    // keep the results alive
+    float sum = 0;
+    for (size_t i = 0; i < n; i++)
+        sum += out[i].cell[5] + vout[i].x;
+    if (sum == 12345.0f)
+        std::cout << " ";
+    return ns;
+}
+
+void benchmark()
+{
+    // model matrices, like the ones of the projects
+    std::vector<cyMatrix4f> m(1024);
+    for (size_t i = 0; i < m.size(); i++)
+    {
+        float f = (float)i;
+        m[i] = cyMatrix4f::Translation(cyVec3f(f, 1, 2)) * cyMatrix4f::RotationXYZ(f * 0.1f, f * 0.2f, f * 0.3f) * cyMatrix4f::Scale((float)(1 + i % 3));
+    }
+    char const *names[] = { "multiply", "transform Vec4", "GetInverse", "GetAffineInverse", "GetTranspose", "inverse-transpose" };
+    std::cout << "ns per call, " << m.size() << " matrices x " << numRounds << " rounds" << std::endl;
+    for (int op = 0; op < 6; op++)
+    {
+        char line[128];
+        snprintf(line, sizeof(line), "%-18s %6.1f", names[op], benchmarkOperation(m, op));
+        std::cout << line << std::endl;
+    }
+}
+
+void printUsage()
+{
+    std::cout << "Usage: main.exe [options]" << std::endl;
+    std::cout << "  -cases count        number of random test cases (default: 200000)" << std::endl;
+    std::cout << "  -rounds count       number of benchmark rounds (default: 2000)" << std::endl;
+    std::cout << "  -notest             only run the benchmark" << std::endl;
+    std::cout << "  -nobench            only run the tests" << std::endl;
+}
+
+bool parseArguments(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-notest") runTests = false;
+        else if (arg == "-nobench") runBenchmark = false;
+        else if (arg == "-cases" && i + 1 < argc) numCases = std::max(atoi(argv[++i]), 1);
+        else if (arg == "-rounds" && i + 1 < argc) numRounds = std::max(atoi(argv[++i]), 1);
+        else
+        {
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (!parseArguments(argc, argv))
+        return 1;
+#if defined(_CY_MATRIX_SSE2) && defined(__AVX__)
+    std::cout << "Matrix4f: SSE2 and AVX" << std::endl;
+#elif defined(_CY_MATRIX_SSE2)
+    std::cout << "Matrix4f: SSE2" << std::endl;
+#else
+    std::cout << "Matrix4f: generic" << std::endl;
+#endif
+    bool passed = true;
+    if (runTests)
+        passed = test();
+    if (runBenchmark)
+        benchmark();
+    return passed ? 0 : 1;
+}
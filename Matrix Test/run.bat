@@ -0,0 +1,4 @@
+main_scalar.exe
+main.exe
+main_avx.exe
+pause
\ No newline at end of file
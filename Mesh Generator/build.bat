@@ -0,0 +1,2 @@
+g++ -O2 main.cpp lodepng.cpp -o main
+pause
\ No newline at end of file
@@ -0,0 +1,7 @@
+g++ -O2 main.cpp lodepng.cpp -o main
+mkdir teapot teddy cube yoda
+main.exe "../Project 7 - Shadow Mapping/teapot.obj" -out teapot
+main.exe "../Project 2 - Tranformations/teddy.obj" -out teddy
+main.exe "../Project 6 - Environment Mapping/cube.obj" -out cube
+if exist "../Project 4 - Textures/yoda.obj" main.exe "../Project 4 - Textures/yoda.obj" -out yoda
+pause
\ No newline at end of file
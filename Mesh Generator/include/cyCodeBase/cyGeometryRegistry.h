@@ -0,0 +1,214 @@
+//-------------------------------------------------------------------------------
+//! \file   cyGeometryRegistry.h
+//!
+//! \brief  Shared GPU buffers of meshes.
+//!
+//! GeometryRegistry owns the vertex buffers, index buffers, and vertex array
+//! objects of meshes, keyed by the mesh and the vertex layout. Requesting the
+//! same mesh with the same layout again returns the existing geometry, so the
+//! data is uploaded to the GPU once. Vertex layouts use fixed attribute
+//! locations, so a single vertex array object can be used by all programs and
+//! render passes that declare the same locations in their shaders.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_GEOMETRY_REGISTRY_H_INCLUDED_
+#define _CY_GEOMETRY_REGISTRY_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyVertexLayout.h"
+#include <map>
+#include <utility>
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Registry of GPU geometry keyed by mesh and vertex layout.
+//!
+//! The mesh key is the address of the mesh (or any other object that identifies
+//! the data) and the layout key identifies the vertex layout type. Geometry is
+//! reference counted: each Acquire call must be matched by a Release call, and
+//! the OpenGL objects are deleted when the last reference is released. All
+//! functions must be called with the OpenGL context current.
+
+class GeometryRegistry
+{
+public:
+	//! A vertex buffer, an optional index buffer, and a vertex array object that refers to them.
+	struct Geometry
+	{
+		GLuint  vao;			//!< Vertex array object
+		GLuint  vertexBuffer;	//!< Vertex buffer
+		GLuint  indexBuffer;	//!< Index buffer with unsigned int indices (zero if the geometry is not indexed)
+		GLsizei numVertices;	//!< The number of vertices
+		GLsizei numIndices;		//!< The number of indices
+		size_t  vertexBytes;	//!< The size of the vertex buffer in bytes
+		size_t  indexBytes;		//!< The size of the index buffer in bytes
+		size_t  GPUBytes() const { return vertexBytes + indexBytes; }	//!< Returns the size of the buffers in bytes.
+		void    Draw( GLenum mode=GL_TRIANGLES ) const;					//!< Binds the vertex array object and draws all vertices or indices.
+	};
+
+	typedef void (*SetAttribsFunc)( GLuint vertexBuffer, size_t offset );	//!< Sets the attribute pointers of the bound vertex array object.
+
+	GeometryRegistry() {}
+	~GeometryRegistry() { Clear(); }
+
+	//!@name Acquiring and releasing geometry
+	//! Returns the geometry of the mesh with the given vertex layout. If the registry does not have it yet, the welded
+	//! vertices are packed with the layout and uploaded with the indices of the welder. The welder is only used
+	//! the first time, so all users of the same mesh and layout must weld the mesh the same way.
+	template <typename LAYOUT>
+	Geometry const * Acquire( TriMesh const &mesh, MeshWelder const &welder, VertexQuantization const &quant=VertexQuantization() );
+	//! Returns the geometry with the given keys if the registry has it, incrementing its reference count. Otherwise returns nullptr.
+	Geometry const * Acquire( void const *meshKey, void const *layoutKey );
+	//! Returns the geometry with the given keys, creating it from the given vertex data and the optional indices if the
+	//! registry does not have it yet. The setAttribs function is called with the vertex array object bound.
+	Geometry const * Acquire( void const *meshKey, void const *layoutKey, void const *vertexData, size_t vertexBytes, GLsizei numVertices, unsigned int const *indices, GLsizei numIndices, SetAttribsFunc setAttribs );
+	//! Releases a reference to the geometry and deletes its OpenGL objects when it is no longer used.
+	void Release( Geometry const *geometry );
+	//! Deletes all geometry, regardless of the reference counts.
+	void Clear();
+
+	//! Returns the key of the given vertex layout type.
+	template <typename LAYOUT> static void const * LayoutKey() { static char const key = 0; return &key; }
+
+	//!@name Statistics
+	size_t NumGeometries() const { return geometry.size(); }		//!< Returns the number of geometries in the registry.
+	size_t GPUBytes( void const *meshKey ) const;					//!< Returns the size of all buffers of the given mesh in bytes, over all layouts.
+	size_t GPUBytes() const;										//!< Returns the size of all buffers in the registry in bytes.
+	unsigned int NumReferences( Geometry const *geometry ) const;	//!< Returns the number of references to the given geometry.
+
+private:
+	typedef std::pair<void const *, void const *> Key;
+	struct Entry
+	{
+		Geometry     geom;
+		unsigned int refCount;
+	};
+	std::map<Key,Entry> geometry;
+
+	static void Delete( Geometry &g );
+	std::map<Key,Entry>::iterator Find( Geometry const *g );
+	std::map<Key,Entry>::const_iterator Find( Geometry const *g ) const { return const_cast<GeometryRegistry*>(this)->Find(g); }
+
+	GeometryRegistry( GeometryRegistry const & );				// not copyable, since it owns OpenGL objects
+	GeometryRegistry & operator = ( GeometryRegistry const & );
+};
+
+//-------------------------------------------------------------------------------
+
+inline void GeometryRegistry::Geometry::Draw( GLenum mode ) const
+{
+	glBindVertexArray( vao );
+	if ( indexBuffer ) glDrawElements( mode, numIndices, GL_UNSIGNED_INT, 0 );
+	else glDrawArrays( mode, 0, numVertices );
+}
+
+template <typename LAYOUT>
+inline GeometryRegistry::Geometry const * GeometryRegistry::Acquire( TriMesh const &mesh, MeshWelder const &welder, VertexQuantization const &quant )
+{
+	Geometry const *g = Acquire( &mesh, LayoutKey<LAYOUT>() );
+	if ( g ) return g;
+	std::vector<unsigned char> data;
+	LAYOUT::Pack( data, mesh, welder, quant );
+	return Acquire( &mesh, LayoutKey<LAYOUT>(), data.data(), data.size(), welder.NumVertices(), welder.Indices().data(), (GLsizei) welder.NumIndices(), &LAYOUT::SetAttribs );
+}
+
+inline GeometryRegistry::Geometry const * GeometryRegistry::Acquire( void const *meshKey, void const *layoutKey )
+{
+	std::map<Key,Entry>::iterator it = geometry.find( Key(meshKey,layoutKey) );
+	if ( it == geometry.end() ) return nullptr;
+	it->second.refCount++;
+	return &it->second.geom;
+}
+
+inline GeometryRegistry::Geometry const * GeometryRegistry::Acquire( void const *meshKey, void const *layoutKey, void const *vertexData, size_t vertexBytes, GLsizei numVertices, unsigned int const *indices, GLsizei numIndices, SetAttribsFunc setAttribs )
+{
+	Geometry const *existing = Acquire( meshKey, layoutKey );
+	if ( existing ) return existing;
+
+	Entry &e = geometry[ Key(meshKey,layoutKey) ];
+	e.refCount = 1;
+	Geometry &g = e.geom;
+	g.numVertices = numVertices;
+	g.numIndices  = indices ? numIndices : 0;
+	g.vertexBytes = vertexBytes;
+	g.indexBytes  = indices ? (size_t) numIndices * sizeof(unsigned int) : 0;
+	g.indexBuffer = 0;
+
+	glGenVertexArrays( 1, &g.vao );
+	glBindVertexArray( g.vao );
+	glGenBuffers( 1, &g.vertexBuffer );
+	glBindBuffer( GL_ARRAY_BUFFER, g.vertexBuffer );
+	glBufferData( GL_ARRAY_BUFFER, vertexBytes, vertexData, GL_STATIC_DRAW );
+	setAttribs( g.vertexBuffer, 0 );
+	if ( indices ) {
+		glGenBuffers( 1, &g.indexBuffer );
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, g.indexBuffer );
+		glBufferData( GL_ELEMENT_ARRAY_BUFFER, g.indexBytes, indices, GL_STATIC_DRAW );
+	}
+	glBindVertexArray( 0 );
+	return &g;
+}
+
+inline void GeometryRegistry::Release( Geometry const *g )
+{
+	std::map<Key,Entry>::iterator it = Find( g );
+	if ( it == geometry.end() ) return;
+	if ( --it->second.refCount > 0 ) return;
+	Delete( it->second.geom );
+	geometry.erase( it );
+}
+
+inline void GeometryRegistry::Clear()
+{
+	for ( std::map<Key,Entry>::iterator it=geometry.begin(); it!=geometry.end(); ++it ) Delete( it->second.geom );
+	geometry.clear();
+}
+
+inline size_t GeometryRegistry::GPUBytes( void const *meshKey ) const
+{
+	size_t bytes = 0;
+	for ( std::map<Key,Entry>::const_iterator it=geometry.lower_bound( Key(meshKey,nullptr) ); it!=geometry.end() && it->first.first==meshKey; ++it ) bytes += it->second.geom.GPUBytes();
+	return bytes;
+}
+
+inline size_t GeometryRegistry::GPUBytes() const
+{
+	size_t bytes = 0;
+	for ( std::map<Key,Entry>::const_iterator it=geometry.begin(); it!=geometry.end(); ++it ) bytes += it->second.geom.GPUBytes();
+	return bytes;
+}
+
+inline unsigned int GeometryRegistry::NumReferences( Geometry const *g ) const
+{
+	std::map<Key,Entry>::const_iterator it = Find( g );
+	return it == geometry.end() ? 0 : it->second.refCount;
+}
+
+inline void GeometryRegistry::Delete( Geometry &g )
+{
+	glDeleteVertexArrays( 1, &g.vao );
+	glDeleteBuffers( 1, &g.vertexBuffer );
+	if ( g.indexBuffer ) glDeleteBuffers( 1, &g.indexBuffer );
+}
+
+inline std::map<GeometryRegistry::Key,GeometryRegistry::Entry>::iterator GeometryRegistry::Find( Geometry const *g )
+{
+	for ( std::map<Key,Entry>::iterator it=geometry.begin(); it!=geometry.end(); ++it ) {
+		if ( &it->second.geom == g ) return it;
+	}
+	return geometry.end();
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::GeometryRegistry cyGeometryRegistry;	//!< Registry of GPU geometry keyed by mesh and vertex layout
+
+//-------------------------------------------------------------------------------
+
+#endif
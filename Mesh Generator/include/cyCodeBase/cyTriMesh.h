@@ -0,0 +1,1053 @@
+// cyCodeBase by Cem Yuksel
+// [www.cemyuksel.com]
+//-------------------------------------------------------------------------------
+//! \file   cyTriMesh.h 
+//! \author Cem Yuksel
+//! 
+//! \brief  Triangular Mesh class.
+//! 
+//-------------------------------------------------------------------------------
+//
+// Copyright (c) 2016, Cem Yuksel <cem@cemyuksel.com>
+// All rights reserved.
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy 
+// of this software and associated documentation files (the "Software"), to deal 
+// in the Software without restriction, including without limitation the rights 
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell 
+// copies of the Software, and to permit persons to whom the Software is 
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all 
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+// 
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_TRIMESH_H_INCLUDED_
+#define _CY_TRIMESH_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyVector.h"
+#include "cyMemoryMap.h"
+#include <vector>
+#include <string>
+#include <thread>
+#include <iostream>
+#include <cstdio>
+#include <cfloat>
+#ifdef __linux__
+# include <sched.h>
+#endif
+
+//-------------------------------------------------------------------------------
+
+_CY_CRT_SECURE_NO_WARNINGS
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+class MeshCache;
+
+//! Triangular Mesh Class
+
+class TriMesh
+{
+public:
+	//! Triangular Mesh Face
+	struct TriFace
+	{
+		unsigned int v[3];	//!< vertex indices
+	};
+
+	//! Simple character string
+	struct Str
+	{
+		char *data;	//!< String data
+		Str() : data(nullptr) {}							//!< Constructor
+		Str( Str const &s ) : data(nullptr) { *this = s; }	//!< Copy constructor
+		~Str() { if ( data ) delete [] data; }				//!< Destructor
+		operator char const * () { return data; }			//!< Implicit conversion to const char
+		void operator = ( Str  const &s ) { *this = s.data; }	//!< Assignment operator
+		void operator = ( char const *s ) { if (s) { size_t n=strlen(s); if (data) delete [] data; data=new char[n+1]; strncpy(data,s,n); data[n]='\0'; } else if (data) { delete [] data; data=nullptr; } }	//!< Assignment operator
+	};
+
+	//! Material definition
+	struct Mtl
+	{
+		Str   name;		//!< Material name
+		float Ka[3];	//!< Ambient color
+		float Kd[3];	//!< Diffuse color
+		float Ks[3];	//!< Specular color
+		float Tf[3];	//!< Transmission color
+		float Ns;		//!< Specular exponent
+		float Ni;		//!< Index of refraction
+		int   illum;	//!< Illumination model
+		Str   map_Ka;	//!< Ambient color texture map
+		Str   map_Kd;	//!< Diffuse color texture map
+		Str   map_Ks;	//!< Specular color texture map
+		Str   map_Ns;	//!< Specular exponent texture map
+		Str   map_d;	//!< Alpha texture map
+		Str   map_bump;	//!< Bump texture map
+		Str   map_disp;	//!< Displacement texture map
+
+		//! Constructor sets the default material values
+		Mtl()
+		{
+			Ka[0]=Ka[1]=Ka[2]=0;
+			Kd[0]=Kd[1]=Kd[2]=1;
+			Ks[0]=Ks[1]=Ks[2]=0;
+			Tf[0]=Tf[1]=Tf[2]=0;
+			Ns=0;
+			Ni=1;
+			illum=2;
+		}
+	};
+
+protected:
+	Vec3f   *v;		//!< vertices
+	TriFace *f;		//!< faces
+	Vec3f   *vn;	//!< vertex normal
+	TriFace *fn;	//!< normal faces
+	Vec3f   *vt;	//!< texture vertices
+	TriFace *ft;	//!< texture faces
+	Mtl     *m;		//!< materials
+	int     *mcfc;	//!< material cumulative face count
+
+	unsigned int nv;	//!< number of vertices
+	unsigned int nf;	//!< number of faces
+	unsigned int nvn;	//!< number of vertex normals
+	unsigned int nvt;	//!< number of texture vertices
+	unsigned int nm;	//!< number of materials
+
+	Vec3f boundMin;	//!< Bounding box minimum bound
+	Vec3f boundMax;	//!< Bounding box maximum bound
+
+	friend class MeshCache;
+
+public:
+
+	//!@name Constructors and Destructor
+	TriMesh() : v(nullptr), f(nullptr), vn(nullptr), fn(nullptr), vt(nullptr), ft(nullptr), m(nullptr), mcfc(nullptr)
+				, nv(0), nf(0), nvn(0), nvt(0), nm(0),boundMin(1,1,1), boundMax(0,0,0) {}
+	TriMesh( TriMesh const &t ) : v(nullptr), f(nullptr), vn(nullptr), fn(nullptr), vt(nullptr), ft(nullptr), m(nullptr), mcfc(nullptr)
+				, nv(0), nf(0), nvn(0), nvt(0), nm(0),boundMin(1,1,1), boundMax(0,0,0) { *this = t; }
+	virtual ~TriMesh() { Clear(); }
+
+	//!@name Component Access Methods
+	Vec3f const &   V (int i) const { return v[i]; }		//!< returns the i^th vertex
+	Vec3f&          V (int i)       { return v[i]; }		//!< returns the i^th vertex
+	TriFace const & F (int i) const { return f[i]; }		//!< returns the i^th face
+	TriFace&        F (int i)       { return f[i]; }		//!< returns the i^th face
+	Vec3f const &   VN(int i) const { return vn[i]; }	//!< returns the i^th vertex normal
+	Vec3f&          VN(int i)       { return vn[i]; }	//!< returns the i^th vertex normal
+	TriFace const & FN(int i) const { return fn[i]; }	//!< returns the i^th normal face
+	TriFace&        FN(int i)       { return fn[i]; }	//!< returns the i^th normal face
+	Vec3f const &   VT(int i) const { return vt[i]; }	//!< returns the i^th vertex texture
+	Vec3f&          VT(int i)       { return vt[i]; }	//!< returns the i^th vertex texture
+	TriFace const & FT(int i) const { return ft[i]; }	//!< returns the i^th texture face
+	TriFace&        FT(int i)       { return ft[i]; }	//!< returns the i^th texture face
+	Mtl const &     M (int i) const { return m[i]; }		//!< returns the i^th material
+	Mtl&            M (int i)       { return m[i]; }		//!< returns the i^th material
+
+	unsigned int NV () const { return nv; }		//!< returns the number of vertices
+	unsigned int NF () const { return nf; }		//!< returns the number of faces
+	unsigned int NVN() const { return nvn; }	//!< returns the number of vertex normals
+	unsigned int NVT() const { return nvt; }	//!< returns the number of texture vertices
+	unsigned int NM () const { return nm; }		//!< returns the number of materials
+
+	bool HasNormals() const { return NVN() > 0; }			//!< returns true if the mesh has vertex normals
+	bool HasTextureVertices() const { return NVT() > 0; }	//!< returns true if the mesh has texture vertices
+
+	//!@name Set Component Count
+	void Clear() { SetNumVertex(0); SetNumFaces(0); SetNumNormals(0); SetNumTexVerts(0); SetNumMtls(0); boundMin.Set(1,1,1); boundMax.Zero(); }	//!< Deletes all components of the mesh
+	void SetNumVertex  ( unsigned int n ) { Allocate(n,v,nv); }															//!< Sets the number of vertices and allocates memory for vertex positions
+	void SetNumFaces   ( unsigned int n ) { Allocate(n,f,nf); if (fn||vn) Allocate(n,fn); if (ft||vt) Allocate(n,ft); }	//!< Sets the number of faces and allocates memory for face data. Normal faces and texture faces are also allocated, if they are used.
+	void SetNumNormals ( unsigned int n ) { Allocate(n,vn,nvn); Allocate(n==0?0:nf,fn); }									//!< Sets the number of normals and allocates memory for normals and normal faces.
+	void SetNumTexVerts( unsigned int n ) { Allocate(n,vt,nvt); Allocate(n==0?0:nf,ft); }									//!< Sets the number of texture coordinates and allocates memory for texture coordinates and texture faces.
+	void SetNumMtls    ( unsigned int n ) { Allocate(n,m,nm); Allocate(n,mcfc); }											//!< Sets the number of materials and allocates memory for material data.
+	void operator = ( TriMesh const &t );																					//!< Copies mesh data from the given mesh.
+
+	//!@name Get Property Methods
+	bool  IsBoundBoxReady() const { return boundMin.x<=boundMax.x && boundMin.y<=boundMax.y && boundMin.z<=boundMax.z; }	//!< Returns true if the bounding box has been computed.
+	Vec3f GetBoundMin() const { return boundMin; }		//!< Returns the minimum values of the bounding box
+	Vec3f GetBoundMax() const { return boundMax; }		//!< Returns the maximum values of the bounding box
+	Vec3f GetVec     (int faceID, Vec3f const &bc) const { return Interpolate(faceID,v,f,bc); }		//!< Returns the point on the given face with the given barycentric coordinates (bc).
+	Vec3f GetNormal  (int faceID, Vec3f const &bc) const { return Interpolate(faceID,vn,fn,bc); }	//!< Returns the the surface normal on the given face at the given barycentric coordinates (bc). The returned vector is not normalized.
+	Vec3f GetTexCoord(int faceID, Vec3f const &bc) const { return Interpolate(faceID,vt,ft,bc); }	//!< Returns the texture coordinate on the given face at the given barycentric coordinates (bc).
+	int   GetMaterialIndex(int faceID) const;				//!< Returns the material index of the face. This method goes through material counts of all materials to find the material index of the face. Returns a negative number if the face as no material
+	int   GetMaterialFaceCount(int mtlID) const { return mtlID>0 ? mcfc[mtlID]-mcfc[mtlID-1] : mcfc[0]; }	//!< Returns the number of faces associated with the given material ID.
+	int   GetMaterialFirstFace(int mtlID) const { return mtlID>0 ? mcfc[mtlID-1] : 0; }	//!< Returns the first face index associated with the given material ID. Other faces associated with the same material are placed are placed consecutively.
+
+	//!@name Compute Methods
+	void ComputeBoundingBox();						//!< Computes the bounding box
+	void ComputeNormals(bool clockwise=false);		//!< Computes and stores vertex normals
+
+	//!@name Load and Save methods
+	bool LoadFromFileObj( char const *filename, bool loadMtl=true, std::ostream *outStream=&std::cout );	//!< Loads the mesh from an OBJ file. Automatically converts all faces to triangles.
+	bool LoadFromFileObjMapped( char const *filename, bool loadMtl=true, std::ostream *outStream=&std::cout, unsigned int numThreads=0 );	//!< Loads the mesh from an OBJ file by memory-mapping it and parsing it in place. Produces the same mesh as LoadFromFileObj, but it is faster for large files and it does not truncate long lines. Large files are split into chunks that are parsed by numThreads threads (0 uses NumProcessors threads).
+	bool SaveToFileObj( char const *filename, std::ostream *outStream );									//!< Saves the mesh to an OBJ file with the given name.
+
+	static unsigned int NumProcessors();	//!< Returns the number of processors that the process can run on, which can be fewer than the hardware threads (for example, with a restricted affinity mask).
+
+private:
+	template <class T> void Allocate( unsigned int n, T* &t ) { if (t) delete [] t; if (n>0) t = new T[n]; else t=nullptr; }
+	template <class T> bool Allocate( unsigned int n, T* &t, unsigned int &nt ) { if (n==nt) return false; nt=n; Allocate(n,t); return true; }
+	template <class T> void Copy( T const *from, unsigned int n, T* &t, unsigned int &nt) { if (!from) n=0; Allocate(n,t,nt); if (t) memcpy(t,from,sizeof(T)*n); }
+	template <class T> void Copy( T const *from, unsigned int n, T* &t) { if (!from) n=0; Allocate(n,t); if (t) memcpy(t,from,sizeof(T)*n); }
+	static Vec3f Interpolate( int i, Vec3f const *v, TriFace const *f, Vec3f const &bc ) { return v[f[i].v[0]]*bc.x + v[f[i].v[1]]*bc.y + v[f[i].v[2]]*bc.z; }
+
+	// Temporary structures
+	struct MtlData
+	{
+		std::string mtlName;
+		unsigned int firstFace;
+		unsigned int faceCount;
+		MtlData() { faceCount=0; firstFace=0; }
+	};
+	struct MtlLibName { std::string filename; };
+	struct MtlList {
+		std::vector<MtlData> mtlData;
+		int GetMtlIndex( char const *mtlName )
+		{
+			for ( unsigned int i=0; i<mtlData.size(); i++ ) {
+				if ( mtlData[i].mtlName == mtlName ) return (int)i;
+			}
+			return -1;
+		}
+		int CreateMtl( char const *mtlName, unsigned int firstFace )
+		{
+			if ( mtlName[0] == '\0' ) return mtlData.empty() ? -1 : 0;
+			int i = GetMtlIndex(mtlName);
+			if ( i >= 0 ) return i;
+			MtlData m;
+			m.mtlName = mtlName;
+			m.firstFace = firstFace;
+			mtlData.push_back(m);
+			return (int)mtlData.size()-1;
+		}
+	};
+	struct ObjData
+	{
+		std::vector<Vec3f>      _v;		// vertices
+		std::vector<TriFace>    _f;		// faces
+		std::vector<Vec3f>      _vn;	// vertex normal
+		std::vector<TriFace>    _fn;	// normal faces
+		std::vector<Vec3f>      _vt;	// texture vertices
+		std::vector<TriFace>    _ft;	// texture faces
+		std::vector<MtlLibName> mtlFiles;
+		std::vector<int>        faceMtlIndex;
+		MtlList mtlList;
+		int currentMtlIndex;
+		bool hasTextures, hasNormals;
+		ObjData() : currentMtlIndex(-1), hasTextures(false), hasNormals(false) {}
+	};
+	class Buffer
+	{
+		char data[1024];
+		int readLine;
+	public:
+		int ReadLine(FILE *fp)
+		{
+			char c = fgetc(fp);
+			while ( !feof(fp) ) {
+				while ( isspace(c) && ( !feof(fp) || c!='\0' ) ) c = fgetc(fp);	// skip empty space
+				if ( c == '#' ) while ( !feof(fp) && c!='\n' && c!='\r' && c!='\0' ) c = fgetc(fp);	// skip comment line
+				else break;
+			}
+			int i=0;
+			bool inspace = false;
+			while ( i<1024-1 ) {
+				if ( feof(fp) || c=='\n' || c=='\r' || c=='\0' ) break;
+				if ( isspace(c) ) {	// only use a single space as the space character
+					inspace = true;
+				} else {
+					if ( inspace ) data[i++] = ' ';
+					inspace = false;
+					data[i++] = c;
+				}
+				c = fgetc(fp);
+			}
+			data[i] = '\0';
+			readLine = i;
+			return i;
+		}
+		char& operator[](int i) { return data[i]; }
+		void ReadVertex( Vec3f &v ) const { v.Zero(); sscanf( data+2, "%f %f %f", &v.x, &v.y, &v.z ); }
+		void ReadFloat3( float f[3] ) const { f[2]=f[1]=f[0]=0; int n = sscanf( data+2, "%f %f %f", &f[0], &f[1], &f[2] ); if ( n==1 ) f[2]=f[1]=f[0]; }
+		void ReadFloat( float *f ) const { sscanf( data+2, "%f", f ); }
+		void ReadInt( int *i, int start ) const { sscanf( data+start, "%d", i ); }
+		bool IsCommand( char const *cmd ) const {
+			int i=0;
+			while ( cmd[i]!='\0' ) {
+				if ( cmd[i] != data[i] ) return false;
+				i++;
+			}
+			return (data[i]=='\0' || data[i]==' ');
+		}
+		char const * Data(int start=0) { return data+start; }
+		void Copy( Str &str, int start=0 )
+		{
+			while ( data[start] != '\0' && data[start] <= ' ' ) start++;
+			str = Data(start);
+		}
+	};
+	struct ObjChunk		// a range of lines of a memory-mapped OBJ file
+	{
+		char const *begin, *end;
+		unsigned int numV, numVT, numVN, numF;		// number of vertex, texture vertex, normal, and face lines
+		unsigned int firstV, firstVT, firstVN;		// number of vertices, texture vertices, and normals in the previous chunks
+		bool hasTextureData, hasNormalData;			// true if the chunk turns on hasTextures or hasNormals
+		bool hasTextures, hasNormals;				// hasTextures and hasNormals at the beginning of the chunk
+		bool endOfFile;								// true if a null character terminates the file within the chunk
+		unsigned int numTriangles;					// number of triangles read from the chunk
+		struct MtlCommand { unsigned int face; bool mtllib; std::string name; };
+		std::vector<MtlCommand> mtlCommands;		// usemtl and mtllib commands with the number of faces before them in the chunk
+		std::vector<TriFace> _f, _ft, _fn;
+	};
+	void ReadObjFace( ObjData &obj, char const *s, char const *e, unsigned int numV, unsigned int numVT, unsigned int numVN );	// s and e bound the face arguments
+	static void ScanObjChunk( ObjChunk &chunk );
+	void ReadObjChunk( ObjChunk &chunk, bool loadMtl );
+	template <typename FUNC> static void ParallelFor( unsigned int n, FUNC func );
+	bool FinishObj( ObjData &obj, char const *filename, bool loadMtl, std::ostream *outStream, bool verticesSet );
+};
+
+//-------------------------------------------------------------------------------
+
+//! In-place tokenizer for OBJ text.
+//!
+//! The functions of this class work directly on a range of characters, such as a
+//! memory-mapped file, without copying lines and without sscanf. They follow the
+//! same rules as TriMesh::LoadFromFileObj, so that both loaders produce the same mesh.
+
+class ObjParser
+{
+public:
+	static bool IsBlank( char c ) { return c==' ' || c=='\t' || c=='\v' || c=='\f'; }	//!< Returns true for the white space characters that can appear within a line
+	static bool IsDigit( char c ) { return c>='0' && c<='9'; }
+
+	//! Finds the next line that is neither empty nor a comment, starting from p.
+	//! Returns false at the end of the data. Otherwise, lineBegin points to the first non-white-space
+	//! character of the line, lineEnd points to the line terminator, and p is moved to the next line.
+	static bool NextLine( char const *&p, char const *end, char const *&lineBegin, char const *&lineEnd );
+
+	//! Returns true if the line begins with the given command followed by white space or the end of the line.
+	//! If so, args is set to the character after the command.
+	static bool IsCommand( char const *lineBegin, char const *lineEnd, char const *cmd, char const *&args );
+
+	//! Reads a number the same way sscanf's "%f" does, and moves p past it. Returns false if there is no number.
+	static bool ReadFloat( char const *&p, char const *end, float &f );
+
+	//! Reads up to n numbers like sscanf's "%f %f ..." and returns the number of values read.
+	static int ReadFloats( char const *p, char const *end, float *f, int n ) { int i=0; while ( i<n && ReadFloat(p,end,f[i]) ) i++; return i; }
+
+	//! Returns the given range without leading and trailing white space, replacing each run of white space with a single space.
+	static std::string ReadString( char const *p, char const *end );
+
+	//! Parses the vertex list of a face command and triangulates it as a fan.
+	//! numV, numVT, and numVN are the numbers of vertices, texture vertices, and normals read so far,
+	//! which are used for resolving negative (relative) indices. hasTextures and hasNormals are set when
+	//! texture or normal indices are found. For each triangle, emit(face,textureFace,normalFace) is called,
+	//! where textureFace and normalFace are nullptr unless hasTextures and hasNormals are set, respectively.
+	template <typename EMIT>
+	static void ReadFace( char const *p, char const *end, unsigned int numV, unsigned int numVT, unsigned int numVN, bool &hasTextures, bool &hasNormals, EMIT emit );
+
+private:
+	static bool ReadFloatStrtof( char const *&p, char const *end, float &f );
+};
+
+//-------------------------------------------------------------------------------
+
+inline bool ObjParser::NextLine( char const *&p, char const *end, char const *&lineBegin, char const *&lineEnd )
+{
+	for (;;) {
+		while ( p<end && ( IsBlank(*p) || *p=='\n' || *p=='\r' ) ) p++;	// skip empty space
+		if ( p>=end || *p=='\0' ) return false;
+		if ( *p != '#' ) break;
+		while ( p<end && *p!='\n' && *p!='\r' && *p!='\0' ) p++;	// skip comment line
+	}
+	lineBegin = p;
+	while ( p<end && *p!='\n' && *p!='\r' && *p!='\0' ) p++;
+	lineEnd = p;
+	if ( p<end ) p++;
+	return true;
+}
+
+inline bool ObjParser::IsCommand( char const *lineBegin, char const *lineEnd, char const *cmd, char const *&args )
+{
+	char const *p = lineBegin;
+	for ( ; *cmd!='\0'; cmd++, p++ ) {
+		if ( p>=lineEnd || *p!=*cmd ) return false;
+	}
+	if ( p<lineEnd && !IsBlank(*p) ) return false;
+	args = p;
+	return true;
+}
+
+inline bool ObjParser::ReadFloat( char const *&p, char const *end, float &f )
+{
+	char const *s = p;
+	while ( s<end && IsBlank(*s) ) s++;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+	// Fast path: read the decimal mantissa into an integer. If it fits and the power of ten is exactly
+	// representable, a single correctly-rounded multiplication or division gives the correctly-rounded result.
+	bool negative = false;
+	if ( s<end && ( *s=='-' || *s=='+' ) ) { negative = (*s=='-'); s++; }
+	if ( s+1<end && s[0]=='0' && ( s[1]=='x' || s[1]=='X' ) ) return ReadFloatStrtof(p,end,f);	// hexadecimal
+	uint64_t m = 0;
+	int digits = 0;		// significant digits in m
+	int e = 0;			// decimal exponent
+	bool hasDigits = false, exact = true;
+	for ( ; s<end && IsDigit(*s); s++ ) {
+		hasDigits = true;
+		if ( digits < 19 ) { m = m*10 + uint64_t(*s-'0'); if ( m ) digits++; }
+		else { e++; if ( *s!='0' ) exact=false; }
+	}
+	if ( s<end && *s=='.' ) {
+		for ( s++; s<end && IsDigit(*s); s++ ) {
+			hasDigits = true;
+			if ( digits < 19 ) { m = m*10 + uint64_t(*s-'0'); if ( m ) digits++; e--; }
+			else if ( *s!='0' ) exact=false;
+		}
+	}
+	if ( !hasDigits ) return ReadFloatStrtof(p,end,f);	// inf, nan, or not a number
+	if ( s<end && ( *s=='e' || *s=='E' ) ) {
+		char const *x = s+1;
+		bool negExp = false;
+		if ( x<end && ( *x=='-' || *x=='+' ) ) { negExp = (*x=='-'); x++; }
+		if ( x<end && IsDigit(*x) ) {
+			int ev = 0;
+			for ( ; x<end && IsDigit(*x); x++ ) if ( ev < 100000 ) ev = ev*10 + (*x-'0');
+			e += negExp ? -ev : ev;
+			s = x;
+		}
+	}
+	if ( exact ) {
+		if ( m == 0 ) { f = negative ? -0.0f : 0.0f; p = s; return true; }
+		static const float  pow10f[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+		static const double pow10d[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+		if ( m <= (uint64_t(1)<<24) && e >= -10 && e <= 10 ) {
+			float r = float(m);
+			r = e < 0 ? r / pow10f[-e] : r * pow10f[e];
+			f = negative ? -r : r;
+			p = s;
+			return true;
+		}
+		if ( m <= (uint64_t(1)<<53) && e >= -22 && e <= 22 ) {
+			double d = double(m);
+			d = e < 0 ? d / pow10d[-e] : d * pow10d[e];
+			// Rounding the double to float is correct, unless the double is exactly halfway between two floats.
+			if ( d >= FLT_MIN && d <= FLT_MAX ) {
+				uint64_t bits;
+				memcpy( &bits, &d, sizeof(bits) );
+				if ( (bits & 0x1FFFFFFF) != 0x10000000 ) {
+					float r = float(d);
+					f = negative ? -r : r;
+					p = s;
+					return true;
+				}
+			}
+		}
+	}
+#endif
+	return ReadFloatStrtof(p,end,f);
+}
+
+inline bool ObjParser::ReadFloatStrtof( char const *&p, char const *end, float &f )
+{
+	// strtof needs a null-terminated string, so copy the token.
+	while ( p<end && IsBlank(*p) ) p++;
+	char const *e = p;
+	while ( e<end && !IsBlank(*e) ) e++;
+	size_t n = size_t(e-p);
+	char buffer[64];
+	std::string longToken;
+	char const *str = buffer;
+	if ( n < sizeof(buffer) ) { memcpy( buffer, p, n ); buffer[n] = '\0'; }
+	else { longToken.assign(p,e); str = longToken.c_str(); }
+	char *strEnd;
+	float r = strtof( str, &strEnd );
+	if ( strEnd == str ) return false;
+	f = r;
+	p += strEnd - str;
+	return true;
+}
+
+inline std::string ObjParser::ReadString( char const *p, char const *end )
+{
+	std::string str;
+	bool inspace = false;
+	for ( ; p<end; p++ ) {
+		if ( IsBlank(*p) ) inspace = true;
+		else {
+			if ( inspace && !str.empty() ) str.push_back(' ');
+			inspace = false;
+			str.push_back(*p);
+		}
+	}
+	return str;
+}
+
+template <typename EMIT>
+inline void ObjParser::ReadFace( char const *p, char const *end, unsigned int numV, unsigned int numVT, unsigned int numVN, bool &hasTextures, bool &hasNormals, EMIT emit )
+{
+	typedef TriMesh::TriFace TriFace;
+	int facevert = -1;
+	bool inspace = true;
+	bool negative = false;
+	int type = 0;
+	unsigned int index = 0;
+	TriFace face, textureFace, normalFace;
+	face.v[0] = face.v[1] = face.v[2] = 0;
+	textureFace.v[0] = textureFace.v[1] = textureFace.v[2] = 0;
+	normalFace. v[0] = normalFace. v[1] = normalFace. v[2] = 0;
+	for ( ; p<end; p++ ) {
+		char c = *p;
+		if ( IsBlank(c) ) inspace = true;
+		else {
+			if ( inspace ) {
+				inspace=false;
+				negative = false;
+				type=0;
+				index=0;
+				switch ( facevert ) {
+					case -1:
+					case 0:
+					case 1:
+						facevert++;
+						break;
+					case 2:
+						// copy the first two vertices from the previous face
+						emit( face, hasTextures ? &textureFace : nullptr, hasNormals ? &normalFace : nullptr );
+						face.v[1] = face.v[2];
+						textureFace.v[1] = textureFace.v[2];
+						normalFace. v[1] = normalFace. v[2];
+						break;
+				}
+			}
+			if ( c == '/' ) { type++; index=0; }
+			if ( c == '-' ) negative = true;
+			if ( IsDigit(c) ) {
+				index = index*10 + (c-'0');
+				switch ( type ) {
+					case 0: face.v       [facevert] = negative ? numV -index : index-1; break;
+					case 1: textureFace.v[facevert] = negative ? numVT-index : index-1; hasTextures=true; break;
+					case 2: normalFace.v [facevert] = negative ? numVN-index : index-1; hasNormals =true; break;
+				}
+			}
+		}
+	}
+	emit( face, hasTextures ? &textureFace : nullptr, hasNormals ? &normalFace : nullptr );
+}
+
+//-------------------------------------------------------------------------------
+
+inline void TriMesh::operator = ( TriMesh const &t )
+{
+	Copy( t.v,  t.nv,  v,  nv  );
+	Copy( t.f,  t.nf,  f,  nf  );
+	Copy( t.vn, t.nvn, vn, nvn );
+	Copy( t.fn, t.nf,  fn );
+	Copy( t.vt, t.nvt, vt, nvt );
+	Copy( t.ft, t.nf,  ft );
+	Allocate(t.nm, m, nm);
+	for ( unsigned int i=0; i<nm; i++ ) m[i] = t.m[i];
+	Copy( t.mcfc, t.nm,  mcfc );
+	boundMin = t.boundMin;
+	boundMax = t.boundMax;
+}
+
+inline int TriMesh::GetMaterialIndex(int faceID) const
+{
+	for ( unsigned int i=0; i<nm; i++ ) {
+		if ( faceID < mcfc[i] ) return (int) i;
+	}
+	return -1;
+}
+
+inline void TriMesh::ComputeBoundingBox()
+{
+	if ( nv > 0 ) {
+		boundMin=v[0];
+		boundMax=v[0];
+		for ( unsigned int i=1; i<nv; i++ ) {
+			if ( boundMin.x > v[i].x ) boundMin.x = v[i].x;
+			if ( boundMin.y > v[i].y ) boundMin.y = v[i].y;
+			if ( boundMin.z > v[i].z ) boundMin.z = v[i].z;
+			if ( boundMax.x < v[i].x ) boundMax.x = v[i].x;
+			if ( boundMax.y < v[i].y ) boundMax.y = v[i].y;
+			if ( boundMax.z < v[i].z ) boundMax.z = v[i].z;
+		}
+	} else {
+		boundMin.Set(1,1,1);
+		boundMax.Set(0,0,0);
+	}
+}
+
+inline void TriMesh::ComputeNormals(bool clockwise)
+{
+	SetNumNormals(nv);
+	for ( unsigned int i=0; i<nvn; i++ ) vn[i].Set(0,0,0);	// initialize all normals to zero
+	for ( unsigned int i=0; i<nf; i++ ) {
+		Vec3f N = (v[f[i].v[1]]-v[f[i].v[0]]) ^ (v[f[i].v[2]]-v[f[i].v[0]]);	// face normal (not normalized)
+		if ( clockwise ) N = -N;
+		vn[f[i].v[0]] += N;
+		vn[f[i].v[1]] += N;
+		vn[f[i].v[2]] += N;
+		fn[i] = f[i];
+	}
+	for ( unsigned int i=0; i<nvn; i++ ) vn[i].Normalize();
+}
+
+inline void TriMesh::ReadObjFace( ObjData &obj, char const *s, char const *e, unsigned int numV, unsigned int numVT, unsigned int numVN )
+{
+	struct Emit {
+		ObjData &obj;
+		void operator () ( TriFace const &face, TriFace const *textureFace, TriFace const *normalFace ) const
+		{
+			obj._f.push_back(face);
+			if ( textureFace ) obj._ft.push_back(*textureFace);
+			if ( normalFace  ) obj._fn.push_back(*normalFace);
+			obj.faceMtlIndex.push_back(obj.currentMtlIndex);
+		}
+	} emit = { obj };
+	unsigned int nFacesBefore = (unsigned int)obj._f.size();
+	ObjParser::ReadFace( s, e, numV, numVT, numVN, obj.hasTextures, obj.hasNormals, emit );
+	if ( obj.currentMtlIndex>=0 ) obj.mtlList.mtlData[obj.currentMtlIndex].faceCount += (unsigned int)obj._f.size() - nFacesBefore;
+}
+
+inline bool TriMesh::LoadFromFileObj( char const *filename, bool loadMtl, std::ostream *outStream )
+{
+	FILE *fp = fopen(filename,"r");
+	if ( !fp ) {
+		if ( outStream ) *outStream << "ERROR: Cannot open file " << filename << std::endl;
+		return false;
+	}
+
+	Clear();
+
+	Buffer buffer;
+	ObjData obj;
+
+	while ( int rb = buffer.ReadLine(fp) ) {
+		if ( buffer.IsCommand("v") ) {
+			Vec3f vertex;
+			buffer.ReadVertex(vertex);
+			obj._v.push_back(vertex);
+		}
+		else if ( buffer.IsCommand("vt") ) {
+			Vec3f texVert;
+			buffer.ReadVertex(texVert);
+			obj._vt.push_back(texVert);
+			obj.hasTextures = true;
+		}
+		else if ( buffer.IsCommand("vn") ) {
+			Vec3f normal;
+			buffer.ReadVertex(normal);
+			obj._vn.push_back(normal);
+			obj.hasNormals = true;
+		}
+		else if ( buffer.IsCommand("f") ) {
+			char const *data = buffer.Data();
+			ReadObjFace( obj, data+1, data+rb, (unsigned int)obj._v.size(), (unsigned int)obj._vt.size(), (unsigned int)obj._vn.size() );
+		}
+		else if ( loadMtl ) {
+			if ( buffer.IsCommand("usemtl") ) {
+				obj.currentMtlIndex = obj.mtlList.CreateMtl(buffer.Data(7), (unsigned int)obj._f.size());
+			}
+			if ( buffer.IsCommand("mtllib") ) {
+				MtlLibName libName;
+				libName.filename = buffer.Data(7);
+				obj.mtlFiles.push_back(libName);
+			}
+		}
+		if ( feof(fp) ) break;
+	}
+
+	fclose(fp);
+
+	return FinishObj( obj, filename, loadMtl, outStream, false );
+}
+
+inline bool TriMesh::LoadFromFileObjMapped( char const *filename, bool loadMtl, std::ostream *outStream, unsigned int numThreads )
+{
+	MemoryMap file;
+	if ( !file.Open(filename) ) {
+		if ( outStream ) *outStream << "ERROR: Cannot open file " << filename << std::endl;
+		return false;
+	}
+
+	Clear();
+
+	// Split the file into chunks at line boundaries
+	const size_t minChunkSize = 1 << 20;
+	if ( numThreads == 0 ) numThreads = NumProcessors();
+	size_t numChunks = file.Size() / minChunkSize;
+	if ( numChunks > numThreads ) numChunks = numThreads;
+	if ( numChunks < 1 ) numChunks = 1;
+	std::vector<ObjChunk> chunks(numChunks);
+	char const *p = file.Data();
+	for ( size_t i=0; i<numChunks; i++ ) {
+		char const *e = file.Data() + file.Size() * (i+1) / numChunks;
+		if ( e < p ) e = p;
+		while ( e<file.End() && e[-1]!='\n' && e[-1]!='\r' ) e++;
+		chunks[i].begin = p;
+		chunks[i].end   = e;
+		p = e;
+	}
+
+	// Count the vertices in each chunk, so that they can be read directly into the mesh arrays
+	ParallelFor( (unsigned int)numChunks, [&chunks]( unsigned int i ) { ScanObjChunk( chunks[i] ); } );
+	unsigned int numV=0, numVT=0, numVN=0;
+	bool hasTextures=false, hasNormals=false;
+	for ( size_t i=0; i<numChunks; i++ ) {
+		ObjChunk &chunk = chunks[i];
+		chunk.firstV  = numV;
+		chunk.firstVT = numVT;
+		chunk.firstVN = numVN;
+		chunk.hasTextures = hasTextures;
+		chunk.hasNormals  = hasNormals;
+		numV  += chunk.numV;
+		numVT += chunk.numVT;
+		numVN += chunk.numVN;
+		hasTextures |= chunk.hasTextureData;
+		hasNormals  |= chunk.hasNormalData;
+		if ( chunk.endOfFile ) { chunks.resize(i+1); break; }
+	}
+	SetNumVertex(numV);
+	SetNumTexVerts(numVT);
+	SetNumNormals(numVN);
+
+	ParallelFor( (unsigned int)chunks.size(), [this,&chunks,loadMtl]( unsigned int i ) { ReadObjChunk( chunks[i], loadMtl ); } );
+
+	// Merge the faces in file order and replay the material commands
+	ObjData obj;
+	if ( chunks.size() == 1 ) {
+		obj._f.swap( chunks[0]._f );
+		obj._ft.swap( chunks[0]._ft );
+		obj._fn.swap( chunks[0]._fn );
+	} else {
+		size_t nf=0, nft=0, nfn=0;
+		for ( size_t i=0; i<chunks.size(); i++ ) { nf += chunks[i]._f.size(); nft += chunks[i]._ft.size(); nfn += chunks[i]._fn.size(); }
+		obj._f .reserve(nf);
+		obj._ft.reserve(nft);
+		obj._fn.reserve(nfn);
+		for ( size_t i=0; i<chunks.size(); i++ ) {
+			obj._f .insert( obj._f .end(), chunks[i]._f .begin(), chunks[i]._f .end() );
+			obj._ft.insert( obj._ft.end(), chunks[i]._ft.begin(), chunks[i]._ft.end() );
+			obj._fn.insert( obj._fn.end(), chunks[i]._fn.begin(), chunks[i]._fn.end() );
+			std::vector<TriFace>().swap( chunks[i]._f  );
+			std::vector<TriFace>().swap( chunks[i]._ft );
+			std::vector<TriFace>().swap( chunks[i]._fn );
+		}
+	}
+	obj.faceMtlIndex.resize( obj._f.size(), -1 );
+	unsigned int firstFace = 0;
+	for ( size_t i=0; i<chunks.size(); i++ ) {
+		ObjChunk &chunk = chunks[i];
+		unsigned int chunkFaces = 0;
+		for ( size_t j=0; j<=chunk.mtlCommands.size(); j++ ) {
+			unsigned int faceEnd = j<chunk.mtlCommands.size() ? chunk.mtlCommands[j].face : chunk.numTriangles;
+			if ( obj.currentMtlIndex >= 0 ) {
+				for ( unsigned int fi=chunkFaces; fi<faceEnd; fi++ ) obj.faceMtlIndex[firstFace+fi] = obj.currentMtlIndex;
+				obj.mtlList.mtlData[obj.currentMtlIndex].faceCount += faceEnd - chunkFaces;
+			}
+			chunkFaces = faceEnd;
+			if ( j == chunk.mtlCommands.size() ) break;
+			ObjChunk::MtlCommand const &cmd = chunk.mtlCommands[j];
+			if ( cmd.mtllib ) {
+				MtlLibName libName;
+				libName.filename = cmd.name;
+				obj.mtlFiles.push_back(libName);
+			} else {
+				obj.currentMtlIndex = obj.mtlList.CreateMtl(cmd.name.c_str(), firstFace+cmd.face);
+			}
+		}
+		firstFace += chunkFaces;
+	}
+
+	file.Close();
+
+	return FinishObj( obj, filename, loadMtl, outStream, true );
+}
+
+inline void TriMesh::ScanObjChunk( ObjChunk &chunk )
+{
+	chunk.numV = chunk.numVT = chunk.numVN = chunk.numF = 0;
+	chunk.hasTextureData = chunk.hasNormalData = false;
+	char const *p = chunk.begin;
+	char const *lineBegin, *lineEnd, *args;
+	while ( ObjParser::NextLine(p,chunk.end,lineBegin,lineEnd) ) {
+		if ( *lineBegin == 'v' ) {
+			if      ( ObjParser::IsCommand(lineBegin,lineEnd,"v", args) ) chunk.numV++;
+			else if ( ObjParser::IsCommand(lineBegin,lineEnd,"vt",args) ) { chunk.numVT++; chunk.hasTextureData = true; }
+			else if ( ObjParser::IsCommand(lineBegin,lineEnd,"vn",args) ) { chunk.numVN++; chunk.hasNormalData  = true; }
+		}
+		else if ( ObjParser::IsCommand(lineBegin,lineEnd,"f",args) ) {
+			chunk.numF++;
+			// Only faces with a '/' can have texture or normal indices
+			if ( !( chunk.hasTextureData && chunk.hasNormalData ) && memchr( args, '/', lineEnd-args ) ) {
+				ObjParser::ReadFace( args, lineEnd, 0, 0, 0, chunk.hasTextureData, chunk.hasNormalData, []( TriFace const &, TriFace const *, TriFace const * ) {} );
+			}
+		}
+	}
+	chunk.endOfFile = p < chunk.end;
+}
+
+inline void TriMesh::ReadObjChunk( ObjChunk &chunk, bool loadMtl )
+{
+	chunk._f.reserve( chunk.numF );
+	if ( chunk.hasTextures || chunk.hasTextureData ) chunk._ft.reserve( chunk.numF );
+	if ( chunk.hasNormals  || chunk.hasNormalData  ) chunk._fn.reserve( chunk.numF );
+
+	unsigned int iv=chunk.firstV, ivt=chunk.firstVT, ivn=chunk.firstVN;
+	char const *p = chunk.begin;
+	char const *lineBegin, *lineEnd, *args;
+	while ( ObjParser::NextLine(p,chunk.end,lineBegin,lineEnd) ) {
+		if ( ObjParser::IsCommand(lineBegin,lineEnd,"v",args) ) {
+			Vec3f &vertex = v[iv++];
+			vertex.Zero();
+			ObjParser::ReadFloats( args, lineEnd, &vertex.x, 3 );
+		}
+		else if ( ObjParser::IsCommand(lineBegin,lineEnd,"vt",args) ) {
+			Vec3f &texVert = vt[ivt++];
+			texVert.Zero();
+			ObjParser::ReadFloats( args, lineEnd, &texVert.x, 3 );
+			chunk.hasTextures = true;
+		}
+		else if ( ObjParser::IsCommand(lineBegin,lineEnd,"vn",args) ) {
+			Vec3f &normal = vn[ivn++];
+			normal.Zero();
+			ObjParser::ReadFloats( args, lineEnd, &normal.x, 3 );
+			chunk.hasNormals = true;
+		}
+		else if ( ObjParser::IsCommand(lineBegin,lineEnd,"f",args) ) {
+			ObjParser::ReadFace( args, lineEnd, iv, ivt, ivn, chunk.hasTextures, chunk.hasNormals, [&chunk]( TriFace const &face, TriFace const *textureFace, TriFace const *normalFace ) {
+				chunk._f.push_back(face);
+				if ( textureFace ) chunk._ft.push_back(*textureFace);
+				if ( normalFace  ) chunk._fn.push_back(*normalFace);
+			});
+		}
+		else if ( loadMtl ) {
+			bool usemtl = ObjParser::IsCommand(lineBegin,lineEnd,"usemtl",args);
+			if ( usemtl || ObjParser::IsCommand(lineBegin,lineEnd,"mtllib",args) ) {
+				ObjChunk::MtlCommand cmd;
+				cmd.face   = (unsigned int)chunk._f.size();
+				cmd.mtllib = !usemtl;
+				cmd.name   = ObjParser::ReadString(args,lineEnd);
+				chunk.mtlCommands.push_back(cmd);
+			}
+		}
+	}
+	chunk.numTriangles = (unsigned int)chunk._f.size();
+}
+
+inline unsigned int TriMesh::NumProcessors()
+{
+	// Splitting the file costs a second pass over it, so it is split only for the processors that can actually run the threads
+#if defined(_WIN32)
+	DWORD_PTR processMask, systemMask;
+	if ( GetProcessAffinityMask( GetCurrentProcess(), &processMask, &systemMask ) ) {
+		unsigned int n = 0;
+		for ( ; processMask; processMask &= processMask-1 ) n++;
+		if ( n > 0 ) return n;
+	}
+#elif defined(__linux__) && defined(CPU_COUNT)
+	cpu_set_t cpus;
+	if ( sched_getaffinity( 0, sizeof(cpus), &cpus ) == 0 ) {
+		int n = CPU_COUNT(&cpus);
+		if ( n > 0 ) return (unsigned int) n;
+	}
+#endif
+	unsigned int n = std::thread::hardware_concurrency();
+	return n > 0 ? n : 1;
+}
+
+template <typename FUNC>
+inline void TriMesh::ParallelFor( unsigned int n, FUNC func )
+{
+	std::vector<std::thread> threads;
+	for ( unsigned int i=1; i<n; i++ ) threads.push_back( std::thread( func, i ) );
+	if ( n > 0 ) func(0);
+	for ( size_t i=0; i<threads.size(); i++ ) threads[i].join();
+}
+
+inline bool TriMesh::FinishObj( ObjData &obj, char const *filename, bool loadMtl, std::ostream *outStream, bool verticesSet )
+{
+	std::vector<TriFace> &_f = obj._f;
+	std::vector<TriFace> &_fn = obj._fn;
+	std::vector<TriFace> &_ft = obj._ft;
+	std::vector<int> &faceMtlIndex = obj.faceMtlIndex;
+	MtlList &mtlList = obj.mtlList;
+
+	if ( _f.size() == 0 ) { // No faces found
+		if ( verticesSet ) Clear();
+		return true;
+	}
+	if ( !verticesSet ) SetNumVertex((unsigned int)obj._v.size());
+	SetNumFaces((unsigned int)_f.size());
+	if ( !verticesSet ) {
+		SetNumTexVerts((unsigned int)obj._vt.size());
+		SetNumNormals((unsigned int)obj._vn.size());
+	}
+	if ( loadMtl ) SetNumMtls((unsigned int)mtlList.mtlData.size());
+
+	// Copy data
+	if ( !verticesSet ) {
+		memcpy(v, obj._v.data(), sizeof(Vec3f)*obj._v.size());
+		if ( obj._vt.size() > 0 ) memcpy(vt, obj._vt.data(), sizeof(Vec3f)*obj._vt.size());
+		if ( obj._vn.size() > 0 ) memcpy(vn, obj._vn.data(), sizeof(Vec3f)*obj._vn.size());
+	}
+
+	if ( mtlList.mtlData.size() > 0 ) {
+		unsigned int fid = 0;
+		for ( int m=0; m<(int)mtlList.mtlData.size(); m++ ) {
+			for ( unsigned int i=mtlList.mtlData[m].firstFace, j=0; j<mtlList.mtlData[m].faceCount && i<_f.size(); i++ ) {
+				if ( faceMtlIndex[i] == m ) {
+					f[fid] = _f[i];
+					if ( fn ) fn[fid] = _fn[i];
+					if ( ft ) ft[fid] = _ft[i];
+					fid++;
+					j++;
+				}
+			}
+			mcfc[m] = fid;
+		}
+		if ( fid <_f.size() ) {
+			for ( unsigned int i=0; i<_f.size(); i++ ) {
+				if ( faceMtlIndex[i] < 0 ) {
+					f[fid] = _f[i];
+					if ( fn ) fn[fid] = _fn[i];
+					if ( ft ) ft[fid] = _ft[i];
+					fid++;
+				}
+			}
+		}
+	} else {
+		memcpy(f, _f.data(), sizeof(TriFace)*_f.size());
+		if ( ft ) memcpy(ft, _ft.data(), sizeof(TriFace)*_ft.size());
+		if ( fn ) memcpy(fn, _fn.data(), sizeof(TriFace)*_fn.size());
+	}
+
+
+	// Load the .mtl files
+	if ( loadMtl ) {
+		Buffer buffer;
+		// get the path from filename
+		char *mtlPathName = nullptr;
+		char const *pathEnd = strrchr(filename,'\\');
+		if ( !pathEnd ) pathEnd = strrchr(filename,'/');
+		if ( pathEnd ) {
+			int n = int(pathEnd-filename) + 1;
+			mtlPathName = new char[n+1];
+			strncpy(mtlPathName,filename,n);
+			mtlPathName[n] = '\0';
+		}
+		for ( unsigned int mi=0; mi<obj.mtlFiles.size(); mi++ ) {
+			std::string mtlFilename = ( mtlPathName ) ? std::string(mtlPathName) + obj.mtlFiles[mi].filename : obj.mtlFiles[mi].filename;
+			FILE *fp = fopen(mtlFilename.data(),"r");
+			if ( !fp ) {
+				if ( outStream ) *outStream << "ERROR: Cannot open file " << mtlFilename.c_str() << std::endl;
+				continue;
+			}
+			int mtlID = -1;
+			while ( buffer.ReadLine(fp) ) {
+				if ( buffer.IsCommand("newmtl") ) {
+					mtlID = mtlList.GetMtlIndex(buffer.Data(7));
+					if ( mtlID >= 0 ) buffer.Copy( m[mtlID].name, 7 );
+				} else if ( mtlID >= 0 ) {
+					if ( buffer.IsCommand("Ka") ) buffer.ReadFloat3( m[mtlID].Ka );
+					else if ( buffer.IsCommand("Kd") ) buffer.ReadFloat3( m[mtlID].Kd );
+					else if ( buffer.IsCommand("Ks") ) buffer.ReadFloat3( m[mtlID].Ks );
+					else if ( buffer.IsCommand("Tf") ) buffer.ReadFloat3( m[mtlID].Tf );
+					else if ( buffer.IsCommand("Ns") ) buffer.ReadFloat( &m[mtlID].Ns );
+					else if ( buffer.IsCommand("Ni") ) buffer.ReadFloat( &m[mtlID].Ni );
+					else if ( buffer.IsCommand("illum") ) buffer.ReadInt( &m[mtlID].illum, 5 );
+					else if ( buffer.IsCommand("map_Ka"  ) ) buffer.Copy( m[mtlID].map_Ka,   7 );
+					else if ( buffer.IsCommand("map_Kd"  ) ) buffer.Copy( m[mtlID].map_Kd,   7 );
+					else if ( buffer.IsCommand("map_Ks"  ) ) buffer.Copy( m[mtlID].map_Ks,   7 );
+					else if ( buffer.IsCommand("map_Ns"  ) ) buffer.Copy( m[mtlID].map_Ns,   7 );
+					else if ( buffer.IsCommand("map_d"   ) ) buffer.Copy( m[mtlID].map_d,    6 );
+					else if ( buffer.IsCommand("map_bump") ) buffer.Copy( m[mtlID].map_bump, 9 );
+					else if ( buffer.IsCommand("bump"    ) ) buffer.Copy( m[mtlID].map_bump, 5 );
+					else if ( buffer.IsCommand("map_disp") ) buffer.Copy( m[mtlID].map_disp, 9 );
+					else if ( buffer.IsCommand("disp"    ) ) buffer.Copy( m[mtlID].map_disp, 5 );
+				}
+			}
+			fclose(fp);
+		}
+		if ( mtlPathName ) delete [] mtlPathName;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------
+
+inline bool TriMesh::SaveToFileObj( char const *filename, std::ostream *outStream )
+{
+	FILE *fp = fopen(filename,"w");
+	if ( !fp ) {
+		if ( outStream ) *outStream << "ERROR: Cannot create file " << filename << std::endl;
+		return false;
+	}
+
+	for ( unsigned int i=0; i<nv; i++ ) {
+		fprintf(fp,"v %f %f %f\n",v[i].x, v[i].y, v[i].z);
+	}
+	for ( unsigned int i=0; i<nvt; i++ ) {
+		fprintf(fp,"vt %f %f %f\n",vt[i].x, vt[i].y, vt[i].z);
+	}
+	for ( unsigned int i=0; i<nvn; i++ ) {
+		fprintf(fp,"vn %f %f %f\n",vn[i].x, vn[i].y, vn[i].z);
+	}
+	int faceFormat = ((nvn>0)<<1) | (nvt>0);
+	switch ( faceFormat ) {
+	case 0:
+		for ( unsigned int i=0; i<nf; i++ ) {
+			fprintf(fp,"f %d %d %d\n", f[i].v[0]+1, f[i].v[1]+1, f[i].v[2]+1);
+		}
+		break;
+	case 1:
+		for ( unsigned int i=0; i<nf; i++ ) {
+			fprintf(fp,"f %d/%d %d/%d %d/%d\n", f[i].v[0]+1, ft[i].v[0]+1, f[i].v[1]+1, ft[i].v[1]+1, f[i].v[2]+1, ft[i].v[2]+1);
+		}
+		break;
+	case 2:
+		for ( unsigned int i=0; i<nf; i++ ) {
+			fprintf(fp,"f %d//%d %d//%d %d//%d\n", f[i].v[0]+1, fn[i].v[0]+1, f[i].v[1]+1, fn[i].v[1]+1, f[i].v[2]+1, fn[i].v[2]+1);
+		}
+		break;
+	case 3:
+		for ( unsigned int i=0; i<nf; i++ ) {
+			fprintf(fp,"f %d/%d/%d %d/%d/%d %d/%d/%d\n", f[i].v[0]+1, ft[i].v[0]+1, fn[i].v[0]+1, f[i].v[1]+1, ft[i].v[1]+1, fn[i].v[1]+1, f[i].v[2]+1, ft[i].v[2]+1, fn[i].v[2]+1);
+		}
+		break;
+	}
+
+	fclose(fp);
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::TriMesh cyTriMesh;	//!< Triangular Mesh Class
+
+//-------------------------------------------------------------------------------
+
+_CY_CRT_SECURE_RESUME_WARNINGS
+#endif
+
@@ -0,0 +1,4 @@
+mkdir bench
+main.exe "../Project 7 - Shadow Mapping/teapot.obj" -out bench -sizes 30m -instances "" -textures "" -maxmem 1 -nocodec
+main.exe bench/teapot_30m.obj -loadbench stdio,1,2,4,8,16,all
+pause
\ No newline at end of file
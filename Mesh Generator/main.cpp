@@ -0,0 +1,1177 @@
+#include <iostream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include "cyCodeBase/cyCore.h"
+#include "cyCodeBase/cyVector.h"
+#include "cyCodeBase/cyTriMesh.h"
+#include "cyCodeBase/cyMeshCache.h"
+#include "cyCodeBase/cyMeshWeld.h"
+#include "cyCodeBase/cyMeshCodec.h"
+#include "lodepng.h"
+
+// Synthetic mesh and scene generator for load and render benchmarks.
+//
+// Every triangle of the base mesh is split into n*n triangles, where n is picked so that the
+// result is as close as possible to each target triangle count. The new vertices are placed on a
+// smooth surface with Phong tessellation and displaced along the normal with fractal noise, so the
+// variants are not just flat subdivisions. Vertices on the shared edges of the base mesh are
+// computed from the edge alone, so the subdivided mesh has no cracks. Every vertex and triangle
+// can be computed from its index, so the OBJ files are written in parallel chunks and the
+// generator never holds the subdivided mesh in memory.
+//
+// With -loadbench, the generator only times loading the given OBJ file with the stdio loader and
+// with the memory-mapped loader using different numbers of threads, such as on a generated variant.
+
+// generator settings
+std::string inputFilename;
+std::string outputDir = ".";
+std::string baseName;
+std::vector<std::string> sizeLabels = { "10k", "100k", "1m", "10m" };
+std::vector<std::string> instanceLabels = { "1", "100", "10k" };
+std::vector<std::string> textureLabels = { "512", "2048" };
+float displacement = 0.003f;    // noise amplitude relative to the bounding box diagonal
+float frequency = 12.0f;        // noise frequency in cycles along the bounding box diagonal
+float smoothing = 0.75f;        // Phong tessellation shape factor (0 keeps the base triangles flat)
+unsigned int seed = 1;
+double maxMemory = 4e9;         // largest estimated memory for loading a variant back to write its binary files
+unsigned int numThreads = 0;
+bool writeCodec = true;
+std::vector<std::string> loadBenchLabels;  // thread counts of the load benchmark, empty to generate the meshes
+unsigned int repeatCount = 3;              // number of times each load of the benchmark is timed
+
+// base mesh, welded so that each vertex has one position, normal, and texture coordinate
+std::vector<cyVec3f> basePositions;
+std::vector<cyVec3f> baseNormals;
+std::vector<cyVec3f> baseSmoothNormals;    // normals averaged over all vertices with the same position
+std::vector<cyVec3f> baseTexCoords;
+std::vector<unsigned int> baseFaces;       // three vertices per face
+std::vector<unsigned int> edgeVertices;    // two vertices per edge, the one with the smaller position first
+std::vector<unsigned int> faceEdges;       // the edges AB, BC, and CA of each face
+bool hasTexCoords = false;
+cyVec3f boundMin, boundMax;
+float diagonal = 1;
+float noiseScale = 1;
+float noiseAmplitude = 0;
+
+// a subdivided variant of the base mesh
+struct Variant
+{
+    std::string name;
+    std::string label;
+    size_t targetTriangles;
+    unsigned int n;            // segments per base edge
+    size_t numVertices;
+    size_t numTriangles;
+    size_t edgeStart;          // index of the first edge vertex
+    size_t interiorStart;      // index of the first interior vertex
+    size_t interiorPerFace;
+    size_t objBytes;
+    size_t cacheBytes;
+    size_t codecBytes;
+    double writeSeconds;
+    double objLoadSeconds;
+    double cacheLoadSeconds;
+    double codecLoadSeconds;
+    bool binary;               // true if the binary files were written
+};
+std::vector<Variant> variants;
+
+// a set of textures with the same resolution
+struct TextureSet
+{
+    unsigned int resolution;
+    std::string mtl;
+    std::string diffuse;
+    std::string specular;
+    std::string normal;
+    std::string height;
+};
+std::vector<TextureSet> textureSets;
+
+// an instanced scene
+struct Scene
+{
+    unsigned int instances;
+    std::string file;
+};
+std::vector<Scene> scenes;
+
+unsigned int getNumThreads()
+{
+    return numThreads > 0 ? numThreads : cyTriMesh::NumProcessors();
+}
+
+std::string outputPath(std::string const &name)
+{
+    return outputDir + "/" + name;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// parses a count with an optional k, m, or g suffix, such as 10k or 500m
+bool parseCount(std::string const &label, size_t &count)
+{
+    char *end;
+    double value = strtod(label.c_str(), &end);
+    double scale = 1;
+    if (*end == 'k' || *end == 'K') { scale = 1e3; end++; }
+    else if (*end == 'm' || *end == 'M') { scale = 1e6; end++; }
+    else if (*end == 'g' || *end == 'G') { scale = 1e9; end++; }
+    if (end == label.c_str() || *end != '\0' || value <= 0)
+    {
+        std::cout << "ERROR: Invalid count \"" << label << "\"." << std::endl;
+        return false;
+    }
+    count = (size_t)(value * scale + 0.5);
+    return true;
+}
+
+std::vector<std::string> splitList(char const *list)
+{
+    std::vector<std::string> items;
+    std::string item;
+    for (char const *c = list; ; c++)
+    {
+        if (*c == ',' || *c == '\0')
+        {
+            if (!item.empty())
+                items.push_back(item);
+            item.clear();
+            if (*c == '\0')
+                break;
+        }
+        else
+        {
+            item += *c;
+        }
+    }
+    return items;
+}
+
+void printUsage()
+{
+    std::cout << "Usage: main.exe mesh.obj [options]" << std::endl;
+    std::cout << "  -out dir            output directory (must exist, default: current directory)" << std::endl;
+    std::cout << "  -name name          base name of the output files (default: the name of the mesh)" << std::endl;
+    std::cout << "  -sizes list         target triangle counts (default: 10k,100k,1m,10m, up to 500m)" << std::endl;
+    std::cout << "  -instances list     instance counts of the scenes (default: 1,100,10k)" << std::endl;
+    std::cout << "  -textures list      texture resolutions (default: 512,2048)" << std::endl;
+    std::cout << "  -displace value     displacement relative to the bounding box diagonal (default: 0.003)" << std::endl;
+    std::cout << "  -frequency value    displacement frequency along the bounding box diagonal (default: 12)" << std::endl;
+    std::cout << "  -smooth value       Phong tessellation factor between 0 and 1 (default: 0.75)" << std::endl;
+    std::cout << "  -seed value         noise and scene seed (default: 1)" << std::endl;
+    std::cout << "  -maxmem bytes       largest variant that is loaded back for the binary files (default: 4g)" << std::endl;
+    std::cout << "  -threads count      number of threads (default: all hardware threads)" << std::endl;
+    std::cout << "  -nocodec            do not write compressed .cymc files" << std::endl;
+    std::cout << "  -loadbench list     only time loading the mesh with the given loaders, such as stdio,1,2,4,8,all" << std::endl;
+    std::cout << "                      (stdio: LoadFromFileObj, a count: mapped loader threads, all: its default)" << std::endl;
+    std::cout << "  -repeat count       number of times each load is timed, the fastest is reported (default: 3)" << std::endl;
+}
+
+bool parseArguments(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        printUsage();
+        return false;
+    }
+    inputFilename = argv[1];
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-nocodec")
+        {
+            writeCodec = false;
+            continue;
+        }
+        if (!hasValue)
+        {
+            std::cout << "ERROR: Missing value for " << arg << "." << std::endl;
+            return false;
+        }
+        char const *value = argv[++i];
+        if (arg == "-out") outputDir = value;
+        else if (arg == "-name") baseName = value;
+        else if (arg == "-sizes") sizeLabels = splitList(value);
+        else if (arg == "-instances") instanceLabels = splitList(value);
+        else if (arg == "-textures") textureLabels = splitList(value);
+        else if (arg == "-displace") displacement = (float)atof(value);
+        else if (arg == "-frequency") frequency = (float)atof(value);
+        else if (arg == "-smooth") smoothing = (float)atof(value);
+        else if (arg == "-seed") seed = (unsigned int)atoi(value);
+        else if (arg == "-threads") numThreads = (unsigned int)atoi(value);
+        else if (arg == "-loadbench") loadBenchLabels = splitList(value);
+        else if (arg == "-repeat") repeatCount = std::max(atoi(value), 1);
+        else if (arg == "-maxmem")
+        {
+            size_t bytes;
+            if (!parseCount(value, bytes))
+                return false;
+            maxMemory = (double)bytes;
+        }
+        else
+        {
+            std::cout << "ERROR: Unknown option " << arg << "." << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+    if (baseName.empty())
+    {
+        size_t slash = inputFilename.find_last_of("/\\");
+        baseName = inputFilename.substr(slash == std::string::npos ? 0 : slash + 1);
+        size_t dot = baseName.find_last_of('.');
+        if (dot != std::string::npos)
+            baseName = baseName.substr(0, dot);
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------------
+// Noise
+//-------------------------------------------------------------------------------
+
+// returns a random value between -1 and 1 for a lattice point, wrapping the coordinates if period > 0
+float latticeValue(int x, int y, int z, int period)
+{
+    if (period > 0)
+    {
+        x = ((x % period) + period) % period;
+        y = ((y % period) + period) % period;
+    }
+    uint32_t h = seed * 0x9E3779B9u;
+    h ^= (uint32_t)x * 0x85EBCA6Bu;
+    h = (h ^ (h >> 15)) * 0x2C1B3C6Du;
+    h ^= (uint32_t)y * 0xC2B2AE35u;
+    h = (h ^ (h >> 13)) * 0x297A2D39u;
+    h ^= (uint32_t)z * 0x27D4EB2Fu;
+    h = (h ^ (h >> 16)) * 0x85EBCA6Bu;
+    h ^= h >> 16;
+    return (float)(h >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+// value noise with its analytic gradient
+float valueNoise(cyVec3f const &p, cyVec3f &gradient, int period)
+{
+    float fx = floorf(p.x), fy = floorf(p.y), fz = floorf(p.z);
+    int ix = (int)fx, iy = (int)fy, iz = (int)fz;
+    float x = p.x - fx, y = p.y - fy, z = p.z - fz;
+
+    // quintic interpolation and its derivative
+    float u = x * x * x * (x * (x * 6 - 15) + 10);
+    float v = y * y * y * (y * (y * 6 - 15) + 10);
+    float w = z * z * z * (z * (z * 6 - 15) + 10);
+    float du = 30 * x * x * (x * (x - 2) + 1);
+    float dv = 30 * y * y * (y * (y - 2) + 1);
+    float dw = 30 * z * z * (z * (z - 2) + 1);
+
+    float a = latticeValue(ix, iy, iz, period);
+    float b = latticeValue(ix + 1, iy, iz, period);
+    float c = latticeValue(ix, iy + 1, iz, period);
+    float d = latticeValue(ix + 1, iy + 1, iz, period);
+    float e = latticeValue(ix, iy, iz + 1, period);
+    float f = latticeValue(ix + 1, iy, iz + 1, period);
+    float g = latticeValue(ix, iy + 1, iz + 1, period);
+    float h = latticeValue(ix + 1, iy + 1, iz + 1, period);
+
+    float k1 = b - a, k2 = c - a, k3 = e - a;
+    float k4 = a - b - c + d, k5 = a - c - e + g, k6 = a - b - e + f;
+    float k7 = -a + b + c - d + e - f - g + h;
+    gradient.x = du * (k1 + k4 * v + k6 * w + k7 * v * w);
+    gradient.y = dv * (k2 + k5 * w + k4 * u + k7 * w * u);
+    gradient.z = dw * (k3 + k6 * u + k5 * v + k7 * u * v);
+    return a + k1 * u + k2 * v + k3 * w + k4 * u * v + k5 * v * w + k6 * w * u + k7 * u * v * w;
+}
+
+// fractal noise with four octaves, between about -1 and 1
+float fractalNoise(cyVec3f const &p, cyVec3f &gradient, int period = 0)
+{
+    float value = 0;
+    float amplitude = 0.5f;
+    float scale = 1;
+    gradient.Set(0, 0, 0);
+    for (int octave = 0; octave < 4; octave++)
+    {
+        cyVec3f g;
+        value += amplitude * valueNoise(p * scale, g, period);
+        gradient += g * (amplitude * scale);
+        amplitude *= 0.5f;
+        scale *= 2;
+        if (period > 0)
+            period *= 2;
+    }
+    return value;
+}
+
+//-------------------------------------------------------------------------------
+// Base mesh
+//-------------------------------------------------------------------------------
+
+bool positionLess(cyVec3f const &a, cyVec3f const &b)
+{
+    if (a.x != b.x) return a.x < b.x;
+    if (a.y != b.y) return a.y < b.y;
+    return a.z < b.z;
+}
+
+bool loadBaseMesh()
+{
+    cyTriMesh mesh;
+    if (!mesh.LoadFromFileObj(inputFilename.c_str(), false))
+        return false;
+    if (mesh.NF() == 0)
+    {
+        std::cout << "ERROR: " << inputFilename << " has no faces." << std::endl;
+        return false;
+    }
+    if (!mesh.HasNormals())
+        mesh.ComputeNormals();
+    mesh.ComputeBoundingBox();
+    boundMin = mesh.GetBoundMin();
+    boundMax = mesh.GetBoundMax();
+    diagonal = (boundMax - boundMin).Length();
+    if (diagonal <= 0)
+        diagonal = 1;
+    noiseScale = frequency / diagonal;
+    noiseAmplitude = displacement * diagonal;
+
+    cyMeshWelder welder;
+    welder.Weld(mesh);
+    welder.GetPositions(mesh, basePositions);
+    welder.GetNormals(mesh, baseNormals);
+    hasTexCoords = welder.HasTexCoords();
+    if (hasTexCoords)
+        welder.GetTexCoords(mesh, baseTexCoords);
+    baseFaces = welder.Indices();
+    unsigned int nv = welder.NumVertices();
+    size_t nf = baseFaces.size() / 3;
+    for (cyVec3f &n : baseNormals)
+        n.Normalize();
+
+    // Average the face normals over the vertices with the same position, so that vertices on
+    // normal and texture seams are smoothed and displaced the same way
+    std::vector<unsigned int> order(nv), positionID(nv);
+    for (unsigned int i = 0; i < nv; i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [](unsigned int a, unsigned int b) { return positionLess(basePositions[a], basePositions[b]); });
+    unsigned int numPositions = 0;
+    for (unsigned int i = 0; i < nv; i++)
+    {
+        if (i > 0 && positionLess(basePositions[order[i - 1]], basePositions[order[i]]))
+            numPositions++;
+        positionID[order[i]] = numPositions;
+    }
+    std::vector<cyVec3f> positionNormals(numPositions + 1, cyVec3f(0, 0, 0));
+    for (size_t f = 0; f < nf; f++)
+    {
+        unsigned int const *v = &baseFaces[3 * f];
+        cyVec3f n = (basePositions[v[1]] - basePositions[v[0]]) ^ (basePositions[v[2]] - basePositions[v[0]]);
+        for (int j = 0; j < 3; j++)
+            positionNormals[positionID[v[j]]] += n;
+    }
+    baseSmoothNormals.resize(nv);
+    for (unsigned int i = 0; i < nv; i++)
+    {
+        cyVec3f n = positionNormals[positionID[i]];
+        float len = n.Length();
+        baseSmoothNormals[i] = len > 0 ? n / len : baseNormals[i];
+    }
+
+    // Find the unique edges and orient them by position
+    std::vector<std::pair<uint64_t, unsigned int>> corners(nf * 3);
+    for (size_t f = 0; f < nf; f++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            uint64_t a = baseFaces[3 * f + j], b = baseFaces[3 * f + (j + 1) % 3];
+            if (a > b)
+                std::swap(a, b);
+            corners[3 * f + j] = std::make_pair((a << 32) | b, (unsigned int)(3 * f + j));
+        }
+    }
+    std::sort(corners.begin(), corners.end());
+    edgeVertices.clear();
+    faceEdges.resize(nf * 3);
+    for (size_t i = 0; i < corners.size(); i++)
+    {
+        if (i == 0 || corners[i].first != corners[i - 1].first)
+        {
+            unsigned int a = (unsigned int)(corners[i].first >> 32), b = (unsigned int)corners[i].first;
+            if (positionLess(basePositions[b], basePositions[a]))
+                std::swap(a, b);
+            edgeVertices.push_back(a);
+            edgeVertices.push_back(b);
+        }
+        faceEdges[corners[i].second] = (unsigned int)(edgeVertices.size() / 2 - 1);
+    }
+
+    std::cout << "Base mesh: " << nf << " triangles, " << nv << " vertices, " << edgeVertices.size() / 2 << " edges" << std::endl;
+    return true;
+}
+
+//-------------------------------------------------------------------------------
+// Subdivision
+//-------------------------------------------------------------------------------
+
+// picks the number of segments per edge that gets closest to the target triangle count
+Variant makeVariant(std::string const &label, size_t target)
+{
+    size_t nf = baseFaces.size() / 3;
+    size_t ne = edgeVertices.size() / 2;
+    double s = sqrt((double)target / (double)nf);
+    unsigned int n = (unsigned int)std::max(1.0, floor(s));
+    if ((double)(n + 1) * (n + 1) * nf - target < target - (double)n * n * nf)
+        n++;
+
+    Variant v = Variant();
+    v.label = label;
+    v.name = baseName + "_" + label;
+    v.targetTriangles = target;
+    v.n = n;
+    v.edgeStart = basePositions.size();
+    v.interiorStart = v.edgeStart + ne * (n - 1);
+    v.interiorPerFace = (size_t)(n - 1) * (n - 2) / 2;
+    if (n == 1)
+        v.interiorPerFace = 0;
+    v.numVertices = v.interiorStart + nf * v.interiorPerFace;
+    v.numTriangles = nf * n * n;
+    return v;
+}
+
+struct Vertex
+{
+    cyVec3f p, n, t;
+};
+
+// evaluates the surface at the given barycentric coordinates of the base vertices a, b, and c
+void evalVertex(unsigned int a, unsigned int b, unsigned int c, float wa, float wb, float wc, Vertex &vert)
+{
+    cyVec3f const &pa = basePositions[a], &pb = basePositions[b], &pc = basePositions[c];
+    cyVec3f const &sa = baseSmoothNormals[a], &sb = baseSmoothNormals[b], &sc = baseSmoothNormals[c];
+
+    // Phong tessellation: blend the flat point with its projections to the tangent planes of the corners
+    cyVec3f q = pa * wa + pb * wb + pc * wc;
+    cyVec3f projected = (q - sa * ((q - pa) % sa)) * wa + (q - sb * ((q - pb) % sb)) * wb + (q - sc * ((q - pc) % sc)) * wc;
+    vert.p = q * (1 - smoothing) + projected * smoothing;
+
+    vert.n = baseNormals[a] * wa + baseNormals[b] * wb + baseNormals[c] * wc;
+    vert.n.Normalize();
+
+    if (noiseAmplitude != 0)
+    {
+        cyVec3f s = sa * wa + sb * wb + sc * wc;
+        s.Normalize();
+        cyVec3f gradient;
+        float h = noiseAmplitude * fractalNoise(vert.p * noiseScale, gradient);
+        gradient *= noiseAmplitude * noiseScale;
+        vert.p += s * h;
+        vert.n -= gradient - vert.n * (gradient % vert.n);
+        vert.n.Normalize();
+    }
+
+    if (hasTexCoords)
+        vert.t = baseTexCoords[a] * wa + baseTexCoords[b] * wb + baseTexCoords[c] * wc;
+}
+
+// computes the vertex with the given index: base vertices first, then edge vertices, then interior vertices
+void getVertex(Variant const &var, size_t i, Vertex &vert)
+{
+    float n = (float)var.n;
+    if (i < var.edgeStart)
+    {
+        unsigned int a = (unsigned int)i;
+        evalVertex(a, a, a, 1, 0, 0, vert);
+    }
+    else if (i < var.interiorStart)
+    {
+        size_t e = (i - var.edgeStart) / (var.n - 1);
+        unsigned int k = (unsigned int)((i - var.edgeStart) % (var.n - 1)) + 1;
+        unsigned int a = edgeVertices[2 * e], b = edgeVertices[2 * e + 1];
+        evalVertex(a, b, a, (var.n - k) / n, k / n, 0, vert);
+    }
+    else
+    {
+        size_t f = (i - var.interiorStart) / var.interiorPerFace;
+        size_t j = (i - var.interiorStart) % var.interiorPerFace;
+        // interior row r has r-1 vertices, starting from row 2
+        size_t m = (size_t)((sqrt(8.0 * j + 1) - 1) / 2);
+        while (m * (m + 1) / 2 > j) m--;
+        while ((m + 1) * (m + 2) / 2 <= j) m++;
+        unsigned int r = (unsigned int)m + 2;
+        unsigned int c = (unsigned int)(j - m * (m + 1) / 2) + 1;
+        unsigned int const *v = &baseFaces[3 * f];
+        evalVertex(v[0], v[1], v[2], (var.n - r) / n, (r - c) / n, c / n, vert);
+    }
+}
+
+// returns the index of the vertex at distance k from the base vertex "from" on edge e
+size_t edgeVertexIndex(Variant const &var, unsigned int e, unsigned int from, unsigned int k)
+{
+    size_t first = var.edgeStart + (size_t)e * (var.n - 1);
+    return first + (edgeVertices[2 * e] == from ? k - 1 : var.n - 1 - k);
+}
+
+// returns the index of grid point (r,c) of face f, where row r goes from corner A (r=0) to edge BC (r=n)
+size_t gridVertexIndex(Variant const &var, size_t f, unsigned int r, unsigned int c)
+{
+    unsigned int const *v = &baseFaces[3 * f];
+    unsigned int const *e = &faceEdges[3 * f];
+    unsigned int n = var.n;
+    if (r == 0) return v[0];
+    if (c == 0) return r == n ? v[1] : edgeVertexIndex(var, e[0], v[0], r);
+    if (c == r) return r == n ? v[2] : edgeVertexIndex(var, e[2], v[0], r);
+    if (r == n) return edgeVertexIndex(var, e[1], v[1], c);
+    return var.interiorStart + f * var.interiorPerFace + (size_t)(r - 2) * (r - 1) / 2 + (c - 1);
+}
+
+// computes the vertex indices of the triangle with the given index
+void getTriangle(Variant const &var, size_t t, size_t idx[3])
+{
+    size_t nn = (size_t)var.n * var.n;
+    size_t f = t / nn;
+    size_t l = t % nn;
+    // row r has 2r+1 triangles, alternating between upward and downward triangles
+    unsigned int r = (unsigned int)sqrt((double)l);
+    while ((size_t)r * r > l) r--;
+    while ((size_t)(r + 1) * (r + 1) <= l) r++;
+    unsigned int k = (unsigned int)(l - (size_t)r * r);
+    unsigned int c = k / 2;
+    if ((k & 1) == 0)
+    {
+        idx[0] = gridVertexIndex(var, f, r, c);
+        idx[1] = gridVertexIndex(var, f, r + 1, c);
+        idx[2] = gridVertexIndex(var, f, r + 1, c + 1);
+    }
+    else
+    {
+        idx[0] = gridVertexIndex(var, f, r, c);
+        idx[1] = gridVertexIndex(var, f, r + 1, c + 1);
+        idx[2] = gridVertexIndex(var, f, r, c + 1);
+    }
+}
+
+//-------------------------------------------------------------------------------
+// OBJ output
+//-------------------------------------------------------------------------------
+
+char *writeUInt(char *p, uint64_t value)
+{
+    char digits[20];
+    int n = 0;
+    do
+    {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (n > 0)
+        *(p++) = digits[--n];
+    return p;
+}
+
+// writes the value with six decimals
+char *writeFloat(char *p, float value)
+{
+    if (!(value == value))
+        value = 0;
+    if (value < 0)
+    {
+        *(p++) = '-';
+        value = -value;
+    }
+    uint64_t scaled = (uint64_t)((double)value * 1e6 + 0.5);
+    p = writeUInt(p, scaled / 1000000);
+    *(p++) = '.';
+    uint32_t fraction = (uint32_t)(scaled % 1000000);
+    for (int i = 5; i >= 0; i--)
+    {
+        p[i] = (char)('0' + fraction % 10);
+        fraction /= 10;
+    }
+    return p + 6;
+}
+
+char *writeVec(char *p, char const *command, cyVec3f const &v, int dimensions)
+{
+    while (*command)
+        *(p++) = *(command++);
+    for (int i = 0; i < dimensions; i++)
+    {
+        *(p++) = ' ';
+        p = writeFloat(p, v[i]);
+    }
+    *(p++) = '\n';
+    return p;
+}
+
+// formats the items in chunks with all threads and writes the chunks in order
+template <typename FORMAT>
+bool writeChunks(FILE *fp, size_t count, size_t maxItemBytes, FORMAT format)
+{
+    const size_t chunkSize = 1 << 15;
+    unsigned int nt = getNumThreads();
+    std::vector<std::vector<char>> buffers(nt);
+    std::vector<size_t> sizes(nt);
+    for (size_t start = 0; start < count; start += chunkSize * nt)
+    {
+        auto work = [&](unsigned int i)
+        {
+            size_t begin = std::min(count, start + i * chunkSize);
+            size_t end = std::min(count, begin + chunkSize);
+            buffers[i].resize(chunkSize * maxItemBytes);
+            char *p = buffers[i].data();
+            for (size_t j = begin; j < end; j++)
+                p = format(p, j);
+            sizes[i] = p - buffers[i].data();
+        };
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < nt; i++)
+            threads.emplace_back(work, i);
+        work(0);
+        for (std::thread &t : threads)
+            t.join();
+        for (unsigned int i = 0; i < nt; i++)
+        {
+            if (sizes[i] > 0 && fwrite(buffers[i].data(), 1, sizes[i], fp) != sizes[i])
+                return false;
+        }
+    }
+    return true;
+}
+
+bool writeOBJ(Variant const &var, std::string const &filename, std::string const &mtlName)
+{
+    FILE *fp = fopen(filename.c_str(), "wb");
+    if (!fp)
+    {
+        std::cout << "ERROR: Cannot create " << filename << "." << std::endl;
+        return false;
+    }
+    fprintf(fp, "# %s: %zu triangles, %zu vertices (%u segments per base edge)\n", var.name.c_str(), var.numTriangles, var.numVertices, var.n);
+    fprintf(fp, "# generated from %s with displacement %g, frequency %g, smoothing %g, seed %u\n", inputFilename.c_str(), displacement, frequency, smoothing, seed);
+    if (!mtlName.empty())
+        fprintf(fp, "mtllib %s\n", mtlName.c_str());
+
+    // each vertex writes its position, normal, and texture coordinate lines together
+    bool ok = writeChunks(fp, var.numVertices, 160, [&](char *p, size_t i)
+    {
+        Vertex vert;
+        getVertex(var, i, vert);
+        p = writeVec(p, "v", vert.p, 3);
+        if (hasTexCoords)
+            p = writeVec(p, "vt", vert.t, 2);
+        return writeVec(p, "vn", vert.n, 3);
+    });
+    if (ok && !mtlName.empty())
+        fprintf(fp, "usemtl generated\n");
+    ok = ok && writeChunks(fp, var.numTriangles, 100, [&](char *p, size_t t)
+    {
+        size_t idx[3];
+        getTriangle(var, t, idx);
+        *(p++) = 'f';
+        for (int j = 0; j < 3; j++)
+        {
+            *(p++) = ' ';
+            p = writeUInt(p, idx[j] + 1);
+            *(p++) = '/';
+            if (hasTexCoords)
+                p = writeUInt(p, idx[j] + 1);
+            *(p++) = '/';
+            p = writeUInt(p, idx[j] + 1);
+        }
+        *(p++) = '\n';
+        return p;
+    });
+    if (fclose(fp) != 0)
+        ok = false;
+    if (!ok)
+        std::cout << "ERROR: Failed writing " << filename << "." << std::endl;
+    return ok;
+}
+
+size_t fileSize(std::string const &filename)
+{
+    cyMeshCache::SourceInfo info;
+    return cyMeshCache::GetSourceInfo(filename.c_str(), info, false) ? (size_t)info.size : 0;
+}
+
+// writes the OBJ file of the variant, then loads it back through the mesh cache to write the binary files
+bool generateVariant(Variant &var, std::string const &mtlName)
+{
+    std::string objName = var.name + ".obj";
+    std::string objFile = outputPath(objName);
+    std::cout << var.name << ": " << var.numTriangles << " triangles, " << var.numVertices << " vertices" << std::endl;
+    if (var.numVertices >= 0xFFFFFFFFu || var.numTriangles >= 0xFFFFFFFFu)
+    {
+        std::cout << "ERROR: " << var.name << " has too many vertices or triangles for 32-bit indices." << std::endl;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!writeOBJ(var, objFile, mtlName))
+        return false;
+    var.writeSeconds = secondsSince(start);
+    var.objBytes = fileSize(objFile);
+    std::cout << "  wrote " << objName << " (" << var.objBytes / 1048576.0 << " MB) in " << var.writeSeconds << " s" << std::endl;
+
+    // the loaded mesh stores positions, normals, texture coordinates, and three index arrays,
+    // and writing the cache or the compressed file can temporarily double that
+    double memory = 2.0 * ((double)var.numVertices * 3 * sizeof(cyVec3f) + (double)var.numTriangles * 3 * sizeof(cyTriMesh::TriFace));
+    if (memory > maxMemory)
+    {
+        std::cout << "  skipped the binary files, loading " << var.name << " needs about " << memory / 1e9 << " GB (-maxmem)" << std::endl;
+        return true;
+    }
+
+    // a stale cache with the same size and time stamp would be accepted, so remove it first
+    std::string cacheFile = cyMeshCache::GetCacheFilename(objFile.c_str());
+    remove(cacheFile.c_str());
+    cyTriMesh mesh;
+    {
+        cyMeshCache cache;
+        start = std::chrono::steady_clock::now();
+        if (!cache.LoadFromFileObj(mesh, objFile.c_str(), true))
+            return false;
+        var.objLoadSeconds = secondsSince(start);
+    }
+    {
+        cyMeshCache cache;
+        start = std::chrono::steady_clock::now();
+        if (!cache.LoadFromFileObj(mesh, objFile.c_str(), true))
+            return false;
+        var.cacheLoadSeconds = secondsSince(start);
+    }
+    var.cacheBytes = fileSize(cacheFile);
+    var.binary = true;
+    std::cout << "  wrote " << var.name << ".cymesh (" << var.cacheBytes / 1048576.0 << " MB), OBJ load " << var.objLoadSeconds << " s, cache load " << var.cacheLoadSeconds << " s" << std::endl;
+
+    if (writeCodec)
+    {
+        std::string codecFile = outputPath(var.name + ".cymc");
+        if (!cyMeshCodec::SaveToFile(codecFile.c_str(), mesh))
+            return false;
+        cyTriMesh decoded;
+        start = std::chrono::steady_clock::now();
+        if (!cyMeshCodec::LoadFromFile(decoded, codecFile.c_str()))
+            return false;
+        var.codecLoadSeconds = secondsSince(start);
+        var.codecBytes = fileSize(codecFile);
+        std::cout << "  wrote " << var.name << ".cymc (" << var.codecBytes / 1048576.0 << " MB), decode " << var.codecLoadSeconds << " s" << std::endl;
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------------
+// Textures
+//-------------------------------------------------------------------------------
+
+// fills the rows of an image with all threads
+template <typename PIXEL>
+void fillImage(unsigned int size, std::vector<unsigned char> &image, PIXEL pixel)
+{
+    image.resize((size_t)size * size * 4);
+    unsigned int nt = std::min(getNumThreads(), size);
+    std::vector<std::thread> threads;
+    auto work = [&](unsigned int i)
+    {
+        for (unsigned int y = i; y < size; y += nt)
+            for (unsigned int x = 0; x < size; x++)
+                pixel(x, y, &image[((size_t)y * size + x) * 4]);
+    };
+    for (unsigned int i = 1; i < nt; i++)
+        threads.emplace_back(work, i);
+    work(0);
+    for (std::thread &t : threads)
+        t.join();
+}
+
+bool savePNG(std::string const &name, std::vector<unsigned char> const &image, unsigned int size)
+{
+    unsigned int error = lodepng::encode(outputPath(name), image, size, size);
+    if (error)
+    {
+        std::cout << "ERROR: Cannot write " << name << ": " << lodepng_error_text(error) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+unsigned char toByte(float value)
+{
+    return (unsigned char)(std::min(std::max(value, 0.0f), 1.0f) * 255 + 0.5f);
+}
+
+// generates tileable diffuse, specular, normal, and height maps with the given resolution
+bool generateTextures(TextureSet &set)
+{
+    const int period = 8;
+    unsigned int size = set.resolution;
+    std::string prefix = baseName + "_" + std::to_string(size);
+    set.diffuse = prefix + "_diffuse.png";
+    set.specular = prefix + "_specular.png";
+    set.normal = prefix + "_normal.png";
+    set.height = prefix + "_height.png";
+    set.mtl = prefix + ".mtl";
+
+    // the height is sampled once and shared by all maps
+    std::vector<float> height((size_t)size * size);
+    std::vector<cyVec3f> slope((size_t)size * size);
+    {
+        std::vector<std::thread> threads;
+        unsigned int nt = std::min(getNumThreads(), size);
+        auto work = [&](unsigned int i)
+        {
+            for (unsigned int y = i; y < size; y += nt)
+            {
+                for (unsigned int x = 0; x < size; x++)
+                {
+                    cyVec3f p((x + 0.5f) * period / size, (y + 0.5f) * period / size, 0.5f);
+                    cyVec3f g;
+                    height[(size_t)y * size + x] = 0.5f + 0.5f * fractalNoise(p, g, period);
+                    slope[(size_t)y * size + x] = g * (0.5f * period);
+                }
+            }
+        };
+        for (unsigned int i = 1; i < nt; i++)
+            threads.emplace_back(work, i);
+        work(0);
+        for (std::thread &t : threads)
+            t.join();
+    }
+
+    std::vector<unsigned char> image;
+    cyVec3f colorA(0.62f, 0.24f, 0.12f), colorB(0.93f, 0.83f, 0.62f);
+    fillImage(size, image, [&](unsigned int x, unsigned int y, unsigned char *c)
+    {
+        float h = height[(size_t)y * size + x];
+        // thin grid lines every 1/16 of the texture show the texture resolution and filtering
+        float gx = fmodf((x + 0.5f) * 16.0f / size, 1.0f), gy = fmodf((y + 0.5f) * 16.0f / size, 1.0f);
+        float line = (gx < 0.04f || gy < 0.04f) ? 0.6f : 1.0f;
+        float t = std::min(std::max(h * 1.6f - 0.3f, 0.0f), 1.0f);
+        cyVec3f color = (colorA * (1 - t) + colorB * t) * line;
+        c[0] = toByte(color.x); c[1] = toByte(color.y); c[2] = toByte(color.z); c[3] = 255;
+    });
+    if (!savePNG(set.diffuse, image, size))
+        return false;
+
+    fillImage(size, image, [&](unsigned int x, unsigned int y, unsigned char *c)
+    {
+        unsigned char s = toByte(0.2f + 0.7f * height[(size_t)y * size + x]);
+        c[0] = c[1] = c[2] = s; c[3] = 255;
+    });
+    if (!savePNG(set.specular, image, size))
+        return false;
+
+    fillImage(size, image, [&](unsigned int x, unsigned int y, unsigned char *c)
+    {
+        cyVec3f const &g = slope[(size_t)y * size + x];
+        cyVec3f n(-g.x, -g.y, 1);
+        n.Normalize();
+        c[0] = toByte(n.x * 0.5f + 0.5f); c[1] = toByte(n.y * 0.5f + 0.5f); c[2] = toByte(n.z * 0.5f + 0.5f); c[3] = 255;
+    });
+    if (!savePNG(set.normal, image, size))
+        return false;
+
+    fillImage(size, image, [&](unsigned int x, unsigned int y, unsigned char *c)
+    {
+        unsigned char h = toByte(height[(size_t)y * size + x]);
+        c[0] = c[1] = c[2] = h; c[3] = 255;
+    });
+    if (!savePNG(set.height, image, size))
+        return false;
+    return true;
+}
+
+bool writeMTL(std::string const &name, TextureSet const *set)
+{
+    FILE *fp = fopen(outputPath(name).c_str(), "w");
+    if (!fp)
+    {
+        std::cout << "ERROR: Cannot create " << name << "." << std::endl;
+        return false;
+    }
+    fprintf(fp, "newmtl generated\n");
+    fprintf(fp, "Ns 40\n");
+    fprintf(fp, "illum 2\n");
+    fprintf(fp, "Ka 0.1 0.1 0.1\n");
+    fprintf(fp, "Kd 0.8 0.8 0.8\n");
+    fprintf(fp, "Ks 0.6 0.6 0.6\n");
+    if (set)
+    {
+        fprintf(fp, "map_Kd %s\n", set->diffuse.c_str());
+        fprintf(fp, "map_Ks %s\n", set->specular.c_str());
+        fprintf(fp, "map_bump %s\n", set->normal.c_str());
+        fprintf(fp, "map_disp %s\n", set->height.c_str());
+    }
+    fclose(fp);
+    return true;
+}
+
+//-------------------------------------------------------------------------------
+// Scenes
+//-------------------------------------------------------------------------------
+
+// returns a random value between 0 and 1
+float randomFloat(uint64_t &state)
+{
+    state += 0x9E3779B97F4A7C15ull;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return (float)(z >> 40) / 16777216.0f;
+}
+
+// places the instances on a cube grid with random rotations and scales, one 3x4 row-major matrix per line
+bool writeScene(Scene &scene)
+{
+    scene.file = baseName + "_scene_" + std::to_string(scene.instances) + ".txt";
+    FILE *fp = fopen(outputPath(scene.file).c_str(), "w");
+    if (!fp)
+    {
+        std::cout << "ERROR: Cannot create " << scene.file << "." << std::endl;
+        return false;
+    }
+    unsigned int side = 1;
+    while ((size_t)side * side * side < scene.instances)
+        side++;
+    // instances do not overlap, since a rotated and scaled mesh fits in a sphere with the scaled diagonal
+    float spacing = diagonal * 1.25f;
+    cyVec3f center = (boundMin + boundMax) * 0.5f;
+    uint64_t state = ((uint64_t)seed << 32) ^ scene.instances;
+
+    fprintf(fp, "# %u instances of %s on a %ux%ux%u grid: one 3x4 row-major transformation per line\n", scene.instances, baseName.c_str(), side, side, side);
+    fprintf(fp, "%u\n", scene.instances);
+    for (unsigned int i = 0; i < scene.instances; i++)
+    {
+        // uniform random rotation from a random unit quaternion
+        float u1 = randomFloat(state), u2 = randomFloat(state) * 2 * (float)M_PI, u3 = randomFloat(state) * 2 * (float)M_PI;
+        float qx = sqrtf(1 - u1) * sinf(u2), qy = sqrtf(1 - u1) * cosf(u2), qz = sqrtf(u1) * sinf(u3), qw = sqrtf(u1) * cosf(u3);
+        float s = 0.75f + 0.5f * randomFloat(state);
+        float m[3][3] = {
+            { 1 - 2 * (qy * qy + qz * qz), 2 * (qx * qy - qz * qw), 2 * (qx * qz + qy * qw) },
+            { 2 * (qx * qy + qz * qw), 1 - 2 * (qx * qx + qz * qz), 2 * (qy * qz - qx * qw) },
+            { 2 * (qx * qz - qy * qw), 2 * (qy * qz + qx * qw), 1 - 2 * (qx * qx + qy * qy) } };
+        cyVec3f cell((float)(i % side), (float)(i / side % side), (float)(i / side / side));
+        cyVec3f offset = (cell - cyVec3f((side - 1) * 0.5f)) * spacing;
+        for (int r = 0; r < 3; r++)
+        {
+            // the mesh is centered at the origin before it is rotated and scaled
+            float t = offset[r] - s * (m[r][0] * center.x + m[r][1] * center.y + m[r][2] * center.z);
+            fprintf(fp, "%g %g %g %g%c", s * m[r][0], s * m[r][1], s * m[r][2], t, r < 2 ? ' ' : '\n');
+        }
+    }
+    fclose(fp);
+    return true;
+}
+
+//-------------------------------------------------------------------------------
+// Load benchmark
+//-------------------------------------------------------------------------------
+
+// hashes the vertex and face arrays, so that the meshes of the loaders can be compared without keeping copies
+uint64_t hashMesh(cyTriMesh const &mesh)
+{
+    uint64_t hash = 14695981039346656037ull;
+    auto add = [&hash](void const *data, size_t bytes)
+    {
+        unsigned char const *p = (unsigned char const *)data;
+        for (size_t i = 0; i < bytes; i++)
+            hash = (hash ^ p[i]) * 1099511628211ull;
+    };
+    unsigned int counts[4] = { mesh.NV(), mesh.NF(), mesh.NVT(), mesh.NVN() };
+    add(counts, sizeof(counts));
+    if (mesh.NV() > 0) add(&mesh.V(0), mesh.NV() * sizeof(cyVec3f));
+    if (mesh.NF() > 0) add(&mesh.F(0), mesh.NF() * sizeof(cyTriMesh::TriFace));
+    if (mesh.NVT() > 0) add(&mesh.VT(0), mesh.NVT() * sizeof(cyVec3f));
+    if (mesh.NVT() > 0) add(&mesh.FT(0), mesh.NF() * sizeof(cyTriMesh::TriFace));
+    if (mesh.NVN() > 0) add(&mesh.VN(0), mesh.NVN() * sizeof(cyVec3f));
+    if (mesh.NVN() > 0) add(&mesh.FN(0), mesh.NF() * sizeof(cyTriMesh::TriFace));
+    return hash;
+}
+
+// times loading the input OBJ file with each loader of -loadbench and checks that they produce the same mesh
+bool benchmarkLoad()
+{
+    double megabytes = fileSize(inputFilename) / 1048576.0;
+    std::cout << inputFilename << ": " << megabytes << " MB, " << cyTriMesh::NumProcessors() << " processors, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << "loader        seconds      MB/s   speedup" << std::endl;
+    double firstSeconds = 0;
+    uint64_t firstHash = 0;
+    for (size_t i = 0; i < loadBenchLabels.size(); i++)
+    {
+        std::string const &label = loadBenchLabels[i];
+        size_t threads = 0;
+        bool stdio = label == "stdio";
+        if (!stdio && label != "all" && !parseCount(label, threads))
+            return false;
+        double best = 0;
+        uint64_t hash = 0;
+        for (unsigned int r = 0; r < repeatCount; r++)
+        {
+            cyTriMesh mesh;
+            auto start = std::chrono::steady_clock::now();
+            bool ok = stdio ? mesh.LoadFromFileObj(inputFilename.c_str(), false, nullptr) : mesh.LoadFromFileObjMapped(inputFilename.c_str(), false, nullptr, (unsigned int)threads);
+            double seconds = secondsSince(start);
+            if (!ok || mesh.NF() == 0)
+            {
+                std::cout << "ERROR: Cannot load " << inputFilename << "." << std::endl;
+                return false;
+            }
+            if (r == 0 || seconds < best)
+                best = seconds;
+            if (r == 0)
+                hash = hashMesh(mesh);
+        }
+        if (i == 0)
+        {
+            firstSeconds = best;
+            firstHash = hash;
+        }
+        char line[128];
+        snprintf(line, sizeof(line), "%-10s %10.3f %9.1f %8.2fx%s", stdio ? "stdio" : label == "all" ? "mapped all" : ("mapped " + label).c_str(), best, megabytes / best, firstSeconds / best, hash == firstHash ? "" : "   MISMATCH");
+        std::cout << line << std::endl;
+        if (hash != firstHash)
+            return false;
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------------
+// Manifest
+//-------------------------------------------------------------------------------
+
+std::string jsonString(std::string const &s)
+{
+    std::string out = "\"";
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+bool writeManifest()
+{
+    std::string name = baseName + "_manifest.json";
+    FILE *fp = fopen(outputPath(name).c_str(), "w");
+    if (!fp)
+    {
+        std::cout << "ERROR: Cannot create " << name << "." << std::endl;
+        return false;
+    }
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"source\": %s,\n", jsonString(inputFilename).c_str());
+    fprintf(fp, "  \"baseTriangles\": %zu,\n", baseFaces.size() / 3);
+    fprintf(fp, "  \"baseVertices\": %zu,\n", basePositions.size());
+    fprintf(fp, "  \"boundMin\": [%g, %g, %g],\n", boundMin.x, boundMin.y, boundMin.z);
+    fprintf(fp, "  \"boundMax\": [%g, %g, %g],\n", boundMax.x, boundMax.y, boundMax.z);
+    fprintf(fp, "  \"displacement\": %g,\n", displacement);
+    fprintf(fp, "  \"frequency\": %g,\n", frequency);
+    fprintf(fp, "  \"smoothing\": %g,\n", smoothing);
+    fprintf(fp, "  \"seed\": %u,\n", seed);
+    fprintf(fp, "  \"meshes\": [\n");
+    for (size_t i = 0; i < variants.size(); i++)
+    {
+        Variant const &v = variants[i];
+        fprintf(fp, "    {\n");
+        fprintf(fp, "      \"name\": %s,\n", jsonString(v.name).c_str());
+        fprintf(fp, "      \"targetTriangles\": %zu,\n", v.targetTriangles);
+        fprintf(fp, "      \"triangles\": %zu,\n", v.numTriangles);
+        fprintf(fp, "      \"vertices\": %zu,\n", v.numVertices);
+        fprintf(fp, "      \"segments\": %u,\n", v.n);
+        fprintf(fp, "      \"obj\": { \"file\": %s, \"bytes\": %zu, \"writeSeconds\": %g }", jsonString(v.name + ".obj").c_str(), v.objBytes, v.writeSeconds);
+        if (v.binary)
+        {
+            fprintf(fp, ",\n      \"objLoadSeconds\": %g,\n", v.objLoadSeconds);
+            fprintf(fp, "      \"cymesh\": { \"file\": %s, \"bytes\": %zu, \"loadSeconds\": %g }", jsonString(v.name + ".cymesh").c_str(), v.cacheBytes, v.cacheLoadSeconds);
+            if (v.codecBytes > 0)
+                fprintf(fp, ",\n      \"cymc\": { \"file\": %s, \"bytes\": %zu, \"loadSeconds\": %g }", jsonString(v.name + ".cymc").c_str(), v.codecBytes, v.codecLoadSeconds);
+        }
+        fprintf(fp, "\n    }%s\n", i + 1 < variants.size() ? "," : "");
+    }
+    fprintf(fp, "  ],\n");
+    fprintf(fp, "  \"textures\": [\n");
+    for (size_t i = 0; i < textureSets.size(); i++)
+    {
+        TextureSet const &t = textureSets[i];
+        fprintf(fp, "    { \"resolution\": %u, \"mtl\": %s, \"diffuse\": %s, \"specular\": %s, \"normal\": %s, \"height\": %s }%s\n",
+            t.resolution, jsonString(t.mtl).c_str(), jsonString(t.diffuse).c_str(), jsonString(t.specular).c_str(),
+            jsonString(t.normal).c_str(), jsonString(t.height).c_str(), i + 1 < textureSets.size() ? "," : "");
+    }
+    fprintf(fp, "  ],\n");
+    fprintf(fp, "  \"scenes\": [\n");
+    for (size_t i = 0; i < scenes.size(); i++)
+    {
+        fprintf(fp, "    { \"instances\": %u, \"file\": %s }%s\n", scenes[i].instances, jsonString(scenes[i].file).c_str(), i + 1 < scenes.size() ? "," : "");
+    }
+    fprintf(fp, "  ]\n");
+    fprintf(fp, "}\n");
+    bool ok = fclose(fp) == 0;
+    if (ok)
+        std::cout << "Wrote " << name << std::endl;
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    if (!parseArguments(argc, argv))
+        return 1;
+    if (!loadBenchLabels.empty())
+        return benchmarkLoad() ? 0 : 1;
+    if (!loadBaseMesh())
+        return 1;
+
+    // textures and materials are written first, so that loading the meshes finds them
+    for (std::string const &label : textureLabels)
+    {
+        size_t resolution;
+        if (!parseCount(label, resolution))
+            return 1;
+        TextureSet set;
+        set.resolution = (unsigned int)resolution;
+        auto start = std::chrono::steady_clock::now();
+        if (!generateTextures(set) || !writeMTL(set.mtl, &set))
+            return 1;
+        std::cout << "Textures " << set.resolution << "x" << set.resolution << " in " << secondsSince(start) << " s" << std::endl;
+        textureSets.push_back(set);
+    }
+    std::string mtlName = baseName + ".mtl";
+    if (!writeMTL(mtlName, textureSets.empty() ? nullptr : &textureSets[0]))
+        return 1;
+
+    for (std::string const &label : sizeLabels)
+    {
+        size_t target;
+        if (!parseCount(label, target))
+            return 1;
+        variants.push_back(makeVariant(label, target));
+        if (!generateVariant(variants.back(), mtlName))
+            return 1;
+    }
+
+    for (std::string const &label : instanceLabels)
+    {
+        size_t count;
+        if (!parseCount(label, count))
+            return 1;
+        Scene scene;
+        scene.instances = (unsigned int)count;
+        if (!writeScene(scene))
+            return 1;
+        scenes.push_back(scene);
+    }
+
+    return writeManifest() ? 0 : 1;
+}
@@ -1,2 +1,2 @@
-g++ main.cpp -o main -lfreeglut -lglu32 -lopengl32 -lglew32
+g++ -Wa,-muse-unaligned-vector-move -DCY_MINGW_UNALIGNED_VECTOR_MOVE main.cpp -o main -lfreeglut -lglu32 -lopengl32 -lglew32
 pause
\ No newline at end of file
@@ -0,0 +1,241 @@
+//-------------------------------------------------------------------------------
+//! \file   cyCPU.h
+//!
+//! \brief  Run-time detection of CPU features and dispatch of SIMD kernels.
+//!
+//! CPU detects the instruction set extensions that the processor and the
+//! operating system support using cpuid and xgetbv. CPUDispatch is a table of
+//! function pointers with one entry per instruction set level, so that a single
+//! binary can call the fastest implementation of a kernel that the processor
+//! supports. The instruction set level can be limited with CPU::ForceISA or the
+//! CY_FORCE_ISA environment variable, so that all implementations can be tested
+//! on the same machine.
+//!
+//! The kernels for instruction sets that are not enabled by the compiler flags
+//! must be marked with the CY_TARGET_* macros, which enable the instruction
+//! sets for the marked functions only.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_CPU_H_INCLUDED_
+#define _CY_CPU_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyCore.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+# define _CY_CPU_X86
+# if defined(_MSC_VER)
+#  include <intrin.h>
+# else
+#  include <cpuid.h>
+# endif
+#endif
+
+// Kernels for instruction sets beyond the compiler flags can be compiled when the compiler supports target attributes
+// (Visual C++ does not need them). Define CY_NO_CPU_DISPATCH to use the instruction sets of the compiler flags only.
+#if defined(_CY_CPU_X86) && !defined(CY_NO_CPU_DISPATCH) && !defined(CY_NO_INTRIN_H) && !defined(CY_NO_EMMINTRIN_H) && !defined(CY_NO_IMMINTRIN_H)
+# if _CY_COMPILER_VER_MEETS(1910,40900,30900,1800)
+#  define _CY_CPU_DISPATCH
+// gcc cannot align the stack for spilling AVX registers on 64-bit Windows (gcc bug 54412), so the aligned spills
+// of the AVX, AVX2, and AVX-512 kernels would crash. With MinGW gcc these kernels are dispatched only when
+// CY_MINGW_UNALIGNED_VECTOR_MOVE is defined, which requires compiling with the assembler option
+// -Wa,-muse-unaligned-vector-move (binutils 2.38 or later) that encodes all aligned vector moves as unaligned ones.
+// The build.bat files of the projects that use dispatched kernels pass both. Without them, MinGW builds use only
+// the SSE kernels, or the AVX kernels that the compiler flags enable (which need the assembler option as well).
+#  if !( defined(__MINGW32__) && defined(_CY_COMPILER_GCC) ) || defined(CY_MINGW_UNALIGNED_VECTOR_MOVE)
+#   define _CY_CPU_DISPATCH_AVX
+#  endif
+# endif
+#endif
+
+// The target attributes of gcc also disable contracting multiplications and additions into fused multiply-add
+// instructions, which AVX2 and AVX-512 would otherwise allow, so that the results do not depend on the instruction set.
+// Kernels can still use the FMA intrinsics explicitly.
+//
+// Generic functions that take or return the vectors of a target must be marked with CY_FORCE_INLINE, so that they
+// are always compiled as a part of the kernel with the target attribute. Otherwise, gcc and clang pass the vectors
+// differently in the caller and the callee.
+#if defined(_CY_CPU_DISPATCH) && defined(_CY_COMPILER_GCC)
+# define CY_TARGET(isa)  __attribute__((target(isa),optimize("fp-contract=off")))
+# define CY_FLATTEN      __attribute__((flatten))
+# define CY_FORCE_INLINE __attribute__((always_inline)) inline
+#elif defined(_CY_CPU_DISPATCH) && ( defined(__GNUC__) || defined(__clang__) )
+# define CY_TARGET(isa)  __attribute__((target(isa)))
+# define CY_FLATTEN      __attribute__((flatten))
+# define CY_FORCE_INLINE __attribute__((always_inline)) inline
+#else
+# define CY_TARGET(isa)
+# define CY_FLATTEN
+# define CY_FORCE_INLINE inline
+#endif
+
+#define CY_TARGET_SSE42  CY_TARGET("sse4.2,popcnt")
+#define CY_TARGET_AVX    CY_TARGET("avx")
+#define CY_TARGET_AVX2   CY_TARGET("avx2,fma,f16c,bmi,bmi2,lzcnt,movbe")
+#define CY_TARGET_AVX512 CY_TARGET("avx512f,avx512cd,avx512bw,avx512dq,avx512vl,avx2,fma,f16c,bmi,bmi2,lzcnt,movbe")
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Detection of the instruction set extensions of the processor.
+
+class CPU
+{
+public:
+	//! Instruction set levels. Each level includes the ones below it.
+	enum ISA {
+		ISA_SCALAR,	//!< No SIMD instructions
+		ISA_SSE2,	//!< SSE and SSE2
+		ISA_SSE42,	//!< SSE3, SSSE3, SSE4.1, SSE4.2, and POPCNT (x86-64-v2)
+		ISA_AVX,	//!< AVX
+		ISA_AVX2,	//!< AVX2, FMA, F16C, BMI1, BMI2, LZCNT, and MOVBE (x86-64-v3)
+		ISA_AVX512,	//!< AVX-512 F, CD, BW, DQ, and VL (x86-64-v4)
+		ISA_COUNT
+	};
+
+	//! Returns the highest instruction set level that both the processor and the operating system support.
+	static ISA GetSupportedISA() { static ISA const isa = Detect(); return isa; }
+
+	//! Returns the instruction set level that the kernels should use, which is the supported level limited by ForceISA.
+	static ISA GetISA() { int s = GetSupportedISA(), f = Limit().load( std::memory_order_relaxed ); return ISA( f < s ? f : s ); }
+
+	//! Limits the instruction set level that the kernels use, so that the implementations for the lower levels can be tested.
+	//! The initial limit is read from the CY_FORCE_ISA environment variable, which holds one of the names of GetName.
+	static void ForceISA( ISA isa ) { Limit().store( isa, std::memory_order_relaxed ); }
+
+	//! Limits the instruction set level given with its name. Returns false if the name is not one of the names of GetName.
+	static bool ForceISA( char const *name ) { ISA isa; if ( ! FindISA( name, isa ) ) return false; ForceISA(isa); return true; }
+
+	//! Removes the limit of ForceISA, so that the kernels use the supported instruction set level.
+	static void ResetISA() { ForceISA( ISA_COUNT ); }
+
+	//! Returns the name of the instruction set level.
+	static char const * GetName( ISA isa )
+	{
+		static char const *names[ISA_COUNT] = { "scalar", "sse2", "sse4.2", "avx", "avx2", "avx512" };
+		return isa >= 0 && isa < ISA_COUNT ? names[isa] : "unknown";
+	}
+
+private:
+	static std::atomic<int> & Limit() { static std::atomic<int> limit( InitialLimit() ); return limit; }
+	static int  InitialLimit() { ISA isa; char const *name = getenv("CY_FORCE_ISA"); return name && FindISA( name, isa ) ? isa : ISA_COUNT; }
+	static bool FindISA( char const *name, ISA &isa );
+	static ISA  Detect();
+#ifdef _CY_CPU_X86
+	static void CPUID( unsigned int leaf, unsigned int subleaf, unsigned int r[4] );
+	static unsigned long long XGETBV();
+#endif
+};
+
+//-------------------------------------------------------------------------------
+
+//! A table of the implementations of a function for different instruction set levels.
+//!
+//! Get returns the implementation for the highest level that is not above
+//! CPU::GetISA(). The scalar implementation must be provided, and the other
+//! levels fall back to the implementation of the level below them.
+
+template <typename FUNC>
+class CPUDispatch
+{
+public:
+	explicit CPUDispatch( FUNC scalar ) { for ( int i=0; i<CPU::ISA_COUNT; i++ ) func[i] = scalar; }
+
+	//! Sets the implementation for the instruction set level, which is also used by the higher levels that do not have their own.
+	void Set( CPU::ISA isa, FUNC f )
+	{
+		FUNC prev = func[isa];
+		for ( int i=isa; i<CPU::ISA_COUNT && func[i]==prev; i++ ) func[i] = f;
+	}
+
+	FUNC Get() const { return func[ CPU::GetISA() ]; }	//!< Returns the implementation for the current instruction set level.
+	FUNC Get( CPU::ISA isa ) const { return func[isa]; }	//!< Returns the implementation for the given instruction set level.
+
+private:
+	FUNC func[CPU::ISA_COUNT];
+};
+
+//-------------------------------------------------------------------------------
+
+inline bool CPU::FindISA( char const *name, ISA &isa )
+{
+	for ( int i=0; i<ISA_COUNT; i++ ) {
+		if ( strcmp( name, GetName( ISA(i) ) ) == 0 ) {
+			isa = ISA(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+inline CPU::ISA CPU::Detect()
+{
+#ifdef _CY_CPU_X86
+	unsigned int r[4];
+	CPUID( 0, 0, r );
+	unsigned int maxLeaf = r[0];
+	if ( maxLeaf < 1 ) return ISA_SCALAR;
+	CPUID( 1, 0, r );
+	unsigned int c1 = r[2], d1 = r[3], b7 = 0, c81 = 0;
+	if ( maxLeaf >= 7 ) { CPUID( 7, 0, r ); b7 = r[1]; }
+	CPUID( 0x80000000, 0, r );
+	if ( r[0] >= 0x80000001 ) { CPUID( 0x80000001, 0, r ); c81 = r[2]; }
+
+	auto has = []( unsigned int reg, unsigned int bits ) { return ( reg & bits ) == bits; };
+	if ( ! has( d1, (1u<<25) | (1u<<26) ) ) return ISA_SCALAR;	// SSE, SSE2
+	if ( ! has( c1, (1u<<0) | (1u<<9) | (1u<<19) | (1u<<20) | (1u<<23) ) ) return ISA_SSE2;	// SSE3, SSSE3, SSE4.1, SSE4.2, POPCNT
+	// AVX also requires the operating system to save the YMM registers (OSXSAVE, and the SSE and AVX states in XCR0)
+	if ( ! has( c1, (1u<<27) | (1u<<28) ) ) return ISA_SSE42;	// OSXSAVE, AVX
+	unsigned long long xcr0 = XGETBV();
+	if ( ( xcr0 & 0x06 ) != 0x06 ) return ISA_SSE42;
+	if ( ! has( c1, (1u<<12) | (1u<<22) | (1u<<29) ) ) return ISA_AVX;	// FMA, MOVBE, F16C
+	if ( ! has( b7, (1u<<3) | (1u<<5) | (1u<<8) ) ) return ISA_AVX;	// BMI1, AVX2, BMI2
+	if ( ! has( c81, (1u<<5) ) ) return ISA_AVX;	// LZCNT
+	// AVX-512 also requires the operating system to save the opmask and ZMM registers
+	if ( ! has( b7, (1u<<16) | (1u<<17) | (1u<<28) | (1u<<30) | (1u<<31) ) ) return ISA_AVX2;	// AVX-512 F, DQ, CD, BW, VL
+	if ( ( xcr0 & 0xE0 ) != 0xE0 ) return ISA_AVX2;
+	return ISA_AVX512;
+#else
+	return ISA_SCALAR;
+#endif
+}
+
+#ifdef _CY_CPU_X86
+inline void CPU::CPUID( unsigned int leaf, unsigned int subleaf, unsigned int r[4] )
+{
+# ifdef _MSC_VER
+	int i[4];
+	__cpuidex( i, (int) leaf, (int) subleaf );
+	for ( int k=0; k<4; k++ ) r[k] = (unsigned int) i[k];
+# else
+	__cpuid_count( leaf, subleaf, r[0], r[1], r[2], r[3] );
+# endif
+}
+
+inline unsigned long long CPU::XGETBV()
+{
+# ifdef _MSC_VER
+	return _xgetbv(0);
+# else
+	unsigned int a, d;
+	__asm__ __volatile__( "xgetbv" : "=a"(a), "=d"(d) : "c"(0) );
+	return ( (unsigned long long) d << 32 ) | a;
+# endif
+}
+#endif
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::CPU cyCPU;	//!< Detection of the instruction set extensions of the processor
+
+//-------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,766 @@
+//-------------------------------------------------------------------------------
+//! \file   cyGLB.h
+//!
+//! \brief  Zero-copy loader for binary glTF 2.0 (.glb) files.
+//!
+//! GLBFile memory-maps a .glb file, parses its JSON chunk, and validates the
+//! buffer views and accessors that the meshes use against the binary chunk,
+//! and the indices of the primitives against the number of their vertices.
+//! The vertex and index data are never copied: the buffer views are passed
+//! directly from the mapped file to glBufferData, and the vertex attributes
+//! and index buffers are set up from the accessors. Materials, textures, and
+//! images are parsed as well; embedded images can be decoded in place.
+//!
+//! Only the data in the binary chunk of the file is supported. Files that refer
+//! to external buffers or that use sparse accessors are rejected.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_GLB_H_INCLUDED_
+#define _CY_GLB_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#if !defined(__gl_h_) && !defined(__GL_H__) && !defined(_GL_H) && !defined(__X_GL_H)
+#error gl.h not included before cyGLB.h
+#endif
+#ifndef GL_VERSION_3_3
+#error OpenGL 3.3 definitions are required for cyGLB.h. You must include an OpenGL extensions header before including cyGLB.h.
+#endif
+
+//-------------------------------------------------------------------------------
+
+#include "cyMatrix.h"
+#include "cyMemoryMap.h"
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cfloat>
+#include <iostream>
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Binary glTF 2.0 file.
+//!
+//! After Load, the arrays of the file are available through the accessor
+//! functions, and the file remains mapped until Close is called or the object
+//! is destroyed. Indices into the arrays are -1 when an optional property is
+//! missing.
+
+class GLBFile
+{
+public:
+	//! The vertex attributes of a primitive that are used.
+	enum Attrib { ATTRIB_POSITION, ATTRIB_NORMAL, ATTRIB_TEXCOORD, NUM_ATTRIBS };
+
+	//! A range of the binary chunk.
+	struct BufferView
+	{
+		size_t byteOffset;	//!< Offset in the binary chunk
+		size_t byteLength;	//!< Size in bytes
+		size_t byteStride;	//!< Stride of the vertex data, or zero if the elements are tightly packed
+		GLenum target;		//!< GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER, from the file or from the way the view is used, or zero if not used by a mesh
+	};
+
+	//! Typed data in a buffer view.
+	struct Accessor
+	{
+		int    bufferView;		//!< The buffer view
+		size_t byteOffset;		//!< Offset in the buffer view
+		GLenum componentType;	//!< GL_BYTE, GL_UNSIGNED_BYTE, GL_SHORT, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT, or GL_FLOAT
+		bool   normalized;		//!< Whether integer data is normalized
+		size_t count;			//!< The number of elements
+		int    numComponents;	//!< The number of components per element (1 to 4, or 4, 9, and 16 for matrices)
+		size_t stride;			//!< The distance between elements in bytes
+		bool   hasBounds;		//!< Whether min and max are given (always true for positions)
+		float  min[4], max[4];	//!< The minimum and maximum values of the first four components
+	};
+
+	//! A set of triangles with a material.
+	struct Primitive
+	{
+		int    attribs[NUM_ATTRIBS];	//!< The accessors of the vertex attributes
+		int    indices;					//!< The accessor of the indices
+		int    material;				//!< The material
+		GLenum mode;					//!< The primitive type, such as GL_TRIANGLES
+	};
+
+	//! A mesh made of primitives.
+	struct Mesh
+	{
+		std::string            name;		//!< Mesh name
+		std::vector<Primitive> primitives;	//!< The primitives of the mesh
+	};
+
+	//! Metallic-roughness material.
+	struct Material
+	{
+		std::string name;				//!< Material name
+		float baseColor[4];				//!< Base color factor
+		float emissive[3];				//!< Emissive factor
+		float metallic;					//!< Metallic factor
+		float roughness;				//!< Roughness factor
+		int   baseColorTexture;			//!< Texture of the base color
+		int   metallicRoughnessTexture;	//!< Texture of the metallic (blue) and roughness (green) factors
+		int   normalTexture;			//!< Tangent-space normal map
+		int   occlusionTexture;			//!< Ambient occlusion map
+		int   emissiveTexture;			//!< Emissive map
+		bool  doubleSided;				//!< Whether back faces are visible
+	};
+
+	//! A texture, which is an image with a sampler.
+	struct Texture
+	{
+		int    image;		//!< The image
+		GLenum magFilter;	//!< Magnification filter, or zero if not given
+		GLenum minFilter;	//!< Minification filter, or zero if not given
+		GLenum wrapS;		//!< Wrapping mode in s
+		GLenum wrapT;		//!< Wrapping mode in t
+	};
+
+	//! An image stored in a buffer view or in an external file.
+	struct Image
+	{
+		int         bufferView;	//!< The buffer view of an embedded image
+		std::string mimeType;	//!< The MIME type of an embedded image, such as "image/png"
+		std::string uri;		//!< The file name of an external image
+	};
+
+	//! An instance of a mesh in the scene, with its node transformation.
+	struct MeshInstance
+	{
+		int      mesh;		//!< The mesh
+		Matrix4f transform;	//!< The transformation from mesh space to scene space
+	};
+
+	GLBFile() {}
+
+	//!@name Loading
+	//! Maps and parses the given file. Returns false and writes an error message to the given stream if the file
+	//! cannot be read or it is not a valid binary glTF 2.0 file that this loader supports.
+	bool Load( char const *filename, std::ostream *outStream=&std::cout );
+	//! Releases the mapped file and clears all arrays.
+	void Close();
+
+	//!@name File contents
+	int NumBufferViews() const { return (int) bufferViews.size(); }	//!< Returns the number of buffer views.
+	int NumAccessors  () const { return (int) accessors  .size(); }	//!< Returns the number of accessors.
+	int NumMeshes     () const { return (int) meshes     .size(); }	//!< Returns the number of meshes.
+	int NumMaterials  () const { return (int) materials  .size(); }	//!< Returns the number of materials.
+	int NumTextures   () const { return (int) textures   .size(); }	//!< Returns the number of textures.
+	int NumImages     () const { return (int) images     .size(); }	//!< Returns the number of images.
+	BufferView const & GetBufferView( int i ) const { return bufferViews[i]; }	//!< Returns the given buffer view.
+	Accessor   const & GetAccessor  ( int i ) const { return accessors  [i]; }	//!< Returns the given accessor.
+	Mesh       const & GetMesh      ( int i ) const { return meshes     [i]; }	//!< Returns the given mesh.
+	Material   const & GetMaterial  ( int i ) const { return materials  [i]; }	//!< Returns the given material.
+	Texture    const & GetTexture   ( int i ) const { return textures   [i]; }	//!< Returns the given texture.
+	Image      const & GetImage     ( int i ) const { return images     [i]; }	//!< Returns the given image.
+	//! Returns the mesh instances of the default scene with their transformations. If the file has no scenes,
+	//! each mesh is returned once with the identity transformation.
+	std::vector<MeshInstance> const & GetMeshInstances() const { return instances; }
+
+	//!@name Data access
+	void const * BufferViewData( int view ) const { return bin + bufferViews[view].byteOffset; }	//!< Returns the data of the buffer view in the mapped file.
+	void const * AccessorData  ( int acc  ) const { Accessor const &a = accessors[acc]; return bin + bufferViews[a.bufferView].byteOffset + a.byteOffset; }	//!< Returns the first element of the accessor in the mapped file.
+	Vec3f GetBoundMin( int positionAccessor ) const { Accessor const &a = accessors[positionAccessor]; return Vec3f( a.min[0], a.min[1], a.min[2] ); }	//!< Returns the minimum of a position accessor.
+	Vec3f GetBoundMax( int positionAccessor ) const { Accessor const &a = accessors[positionAccessor]; return Vec3f( a.max[0], a.max[1], a.max[2] ); }	//!< Returns the maximum of a position accessor.
+	//! Computes the bounding box of all mesh instances in scene space from the bounds of their position accessors.
+	void ComputeBoundingBox( Vec3f &boundMin, Vec3f &boundMax ) const;
+
+	//!@name OpenGL
+	//! Creates a buffer object for each buffer view that a mesh uses and uploads the view directly from the mapped file.
+	//! The buffer IDs are written to the given array for each buffer view, with zero for the views that are not used.
+	void CreateBuffers( std::vector<GLuint> &buffers, GLenum usage=GL_STATIC_DRAW ) const;
+	//! Sets the attribute pointers and the index buffer of the primitive in the currently bound vertex array object,
+	//! using the buffers of CreateBuffers and the given attribute locations. Attributes that the primitive does not
+	//! have, or that have a negative location, are disabled.
+	void SetAttribs( Primitive const &prim, std::vector<GLuint> const &buffers, GLint const locations[NUM_ATTRIBS] ) const;
+	//! Returns the number of indices of the primitive, or the number of vertices if it has no indices.
+	GLsizei NumElements( Primitive const &prim ) const { return (GLsizei) accessors[ prim.indices >= 0 ? prim.indices : prim.attribs[ATTRIB_POSITION] ].count; }
+	//! Returns the index type of the primitive for glDrawElements.
+	GLenum IndexType( Primitive const &prim ) const { return accessors[prim.indices].componentType; }
+	//! Returns the offset of the first index of the primitive in its index buffer, for glDrawElements.
+	void const * IndexOffset( Primitive const &prim ) const { return (void const *)( accessors[prim.indices].byteOffset ); }
+
+	//! Returns the size of a component type in bytes, or zero if the type is not valid.
+	static size_t ComponentSize( GLenum componentType );
+
+private:
+	//! A parsed JSON value.
+	struct JSON
+	{
+		enum Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT } type = NUL;
+		double                   number = 0;
+		std::string              str;
+		std::vector<JSON>        items;		// array elements or object values
+		std::vector<std::string> keys;		// object keys
+
+		JSON const * Get( char const *key ) const;
+		double Number( char const *key, double defaultValue ) const { JSON const *v = Get(key); return v && v->type == NUMBER ? v->number : defaultValue; }
+		int    Index ( char const *key ) const { return (int) Number( key, -1 ); }
+		bool   Boolean( char const *key, bool defaultValue ) const { JSON const *v = Get(key); return v && v->type == BOOLEAN ? v->number != 0 : defaultValue; }
+		std::string String( char const *key ) const { JSON const *v = Get(key); return v && v->type == STRING ? v->str : std::string(); }
+		int TextureIndex( char const *key ) const { JSON const *v = Get(key); return v && v->type == OBJECT ? v->Index("index") : -1; }
+		void Floats( char const *key, float *f, int n ) const { JSON const *v = Get(key); if ( v && v->type == ARRAY ) for ( int i=0; i<n && i<(int)v->items.size(); i++ ) f[i] = (float) v->items[i].number; }
+
+		static bool Parse( char const *&p, char const *end, JSON &value, int depth );
+		static void SkipSpace( char const *&p, char const *end ) { while ( p < end && ( *p==' ' || *p=='\t' || *p=='\n' || *p=='\r' ) ) p++; }
+		static bool ParseString( char const *&p, char const *end, std::string &s );
+	};
+
+	MemoryMap                 file;
+	char const               *bin = nullptr;
+	size_t                    binSize = 0;
+	std::vector<BufferView>   bufferViews;
+	std::vector<Accessor>     accessors;
+	std::vector<Mesh>         meshes;
+	std::vector<Material>     materials;
+	std::vector<Texture>      textures;
+	std::vector<Image>        images;
+	std::vector<MeshInstance> instances;
+
+	bool Parse( JSON const &root, std::ostream *outStream );
+	bool ValidateAccessor( int acc, int numComponents, bool allowNormalized, bool allowFloat, char const *name, std::ostream *outStream ) const;
+	size_t MaxIndex( int acc ) const;	// the largest value of a validated index accessor
+	void AddInstances( JSON const &nodes, int node, Matrix4f const &parent, int depth );
+	static Matrix4f NodeTransform( JSON const &node );
+	static int NumComponents( std::string const &type );
+};
+
+//-------------------------------------------------------------------------------
+// JSON parsing
+//-------------------------------------------------------------------------------
+
+inline GLBFile::JSON const * GLBFile::JSON::Get( char const *key ) const
+{
+	for ( size_t i=0; i<keys.size(); i++ ) if ( keys[i] == key ) return &items[i];
+	return nullptr;
+}
+
+inline bool GLBFile::JSON::ParseString( char const *&p, char const *end, std::string &s )
+{
+	if ( p >= end || *p != '"' ) return false;
+	p++;
+	s.clear();
+	while ( p < end && *p != '"' ) {
+		if ( *p != '\\' ) { s.push_back( *(p++) ); continue; }
+		if ( ++p >= end ) return false;
+		char c = *(p++);
+		switch ( c ) {
+			case 'b': s.push_back('\b'); break;
+			case 'f': s.push_back('\f'); break;
+			case 'n': s.push_back('\n'); break;
+			case 'r': s.push_back('\r'); break;
+			case 't': s.push_back('\t'); break;
+			case 'u': {
+				auto Hex4 = [&]( unsigned int &code ) {
+					if ( end - p < 4 ) return false;
+					code = 0;
+					for ( int i=0; i<4; i++, p++ ) {
+						char h = *p;
+						code <<= 4;
+						if      ( h >= '0' && h <= '9' ) code |= h - '0';
+						else if ( h >= 'a' && h <= 'f' ) code |= h - 'a' + 10;
+						else if ( h >= 'A' && h <= 'F' ) code |= h - 'A' + 10;
+						else return false;
+					}
+					return true;
+				};
+				unsigned int code;
+				if ( ! Hex4(code) ) return false;
+				if ( code >= 0xD800 && code < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u' ) {
+					p += 2;
+					unsigned int low;
+					if ( ! Hex4(low) ) return false;
+					code = 0x10000 + ( (code - 0xD800) << 10 ) + ( low - 0xDC00 );
+				}
+				// UTF-8 encoding
+				if ( code < 0x80 ) s.push_back( (char) code );
+				else if ( code < 0x800 ) { s.push_back( (char)( 0xC0 | (code>>6) ) ); s.push_back( (char)( 0x80 | (code&0x3F) ) ); }
+				else if ( code < 0x10000 ) { s.push_back( (char)( 0xE0 | (code>>12) ) ); s.push_back( (char)( 0x80 | ((code>>6)&0x3F) ) ); s.push_back( (char)( 0x80 | (code&0x3F) ) ); }
+				else { s.push_back( (char)( 0xF0 | (code>>18) ) ); s.push_back( (char)( 0x80 | ((code>>12)&0x3F) ) ); s.push_back( (char)( 0x80 | ((code>>6)&0x3F) ) ); s.push_back( (char)( 0x80 | (code&0x3F) ) ); }
+				break;
+			}
+			default: s.push_back( c ); break;	// '"', '\\', and '/'
+		}
+	}
+	if ( p >= end ) return false;
+	p++;
+	return true;
+}
+
+inline bool GLBFile::JSON::Parse( char const *&p, char const *end, JSON &v, int depth )
+{
+	if ( depth > 64 ) return false;
+	SkipSpace( p, end );
+	if ( p >= end ) return false;
+	switch ( *p ) {
+		case '{':
+			v.type = OBJECT;
+			p++;
+			SkipSpace( p, end );
+			if ( p < end && *p == '}' ) { p++; return true; }
+			for (;;) {
+				SkipSpace( p, end );
+				v.keys.push_back( std::string() );
+				if ( ! ParseString( p, end, v.keys.back() ) ) return false;
+				SkipSpace( p, end );
+				if ( p >= end || *p != ':' ) return false;
+				p++;
+				v.items.push_back( JSON() );
+				if ( ! Parse( p, end, v.items.back(), depth+1 ) ) return false;
+				SkipSpace( p, end );
+				if ( p < end && *p == ',' ) { p++; continue; }
+				if ( p < end && *p == '}' ) { p++; return true; }
+				return false;
+			}
+		case '[':
+			v.type = ARRAY;
+			p++;
+			SkipSpace( p, end );
+			if ( p < end && *p == ']' ) { p++; return true; }
+			for (;;) {
+				v.items.push_back( JSON() );
+				if ( ! Parse( p, end, v.items.back(), depth+1 ) ) return false;
+				SkipSpace( p, end );
+				if ( p < end && *p == ',' ) { p++; continue; }
+				if ( p < end && *p == ']' ) { p++; return true; }
+				return false;
+			}
+		case '"':
+			v.type = STRING;
+			return ParseString( p, end, v.str );
+		case 't':
+			if ( end - p < 4 || strncmp( p, "true", 4 ) != 0 ) return false;
+			v.type = BOOLEAN; v.number = 1; p += 4;
+			return true;
+		case 'f':
+			if ( end - p < 5 || strncmp( p, "false", 5 ) != 0 ) return false;
+			v.type = BOOLEAN; v.number = 0; p += 5;
+			return true;
+		case 'n':
+			if ( end - p < 4 || strncmp( p, "null", 4 ) != 0 ) return false;
+			v.type = NUL; p += 4;
+			return true;
+		default: {
+			// The JSON chunk is not null-terminated, so the number is copied before strtod
+			char buffer[64];
+			int n = 0;
+			while ( p+n < end && n < 63 && strchr( "+-0123456789.eE", p[n] ) ) { buffer[n] = p[n]; n++; }
+			if ( n == 0 ) return false;
+			buffer[n] = '\0';
+			char *numEnd;
+			v.type = NUMBER;
+			v.number = strtod( buffer, &numEnd );
+			if ( numEnd != buffer + n ) return false;
+			p += n;
+			return true;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------
+// Loading
+//-------------------------------------------------------------------------------
+
+inline bool GLBFile::Load( char const *filename, std::ostream *outStream )
+{
+	Close();
+	auto Error = [&]( char const *msg ) { if ( outStream ) *outStream << "ERROR: " << filename << ": " << msg << std::endl; Close(); return false; };
+
+	if ( ! file.Open( filename ) ) return Error( "cannot open file" );
+	char const *data = file.Data();
+	size_t size = file.Size();
+
+	// Header: magic, version, and length, followed by the JSON chunk and the optional binary chunk
+	uint32_t header[3];
+	if ( size < 20 ) return Error( "not a glTF binary file" );
+	memcpy( header, data, 12 );
+	if ( memcmp( data, "glTF", 4 ) != 0 ) return Error( "not a glTF binary file" );
+	if ( header[1] != 2 ) return Error( "unsupported glTF version" );
+	if ( header[2] > size ) return Error( "file is truncated" );
+	size = header[2];
+
+	uint32_t chunk[2];
+	memcpy( chunk, data + 12, 8 );
+	if ( chunk[1] != 0x4E4F534A ) return Error( "the first chunk is not JSON" );
+	if ( chunk[0] > size - 20 ) return Error( "JSON chunk is truncated" );
+	char const *json = data + 20;
+	char const *jsonEnd = json + chunk[0];
+
+	size_t binOffset = 20 + ( ( (size_t) chunk[0] + 3 ) & ~size_t(3) );
+	if ( binOffset + 8 <= size ) {
+		memcpy( chunk, data + binOffset, 8 );
+		if ( chunk[1] == 0x004E4942 ) {
+			if ( chunk[0] > size - binOffset - 8 ) return Error( "binary chunk is truncated" );
+			bin = data + binOffset + 8;
+			binSize = chunk[0];
+		}
+	}
+
+	JSON root;
+	char const *p = json;
+	if ( ! JSON::Parse( p, jsonEnd, root, 0 ) || root.type != JSON::OBJECT ) return Error( "invalid JSON chunk" );
+	if ( ! Parse( root, outStream ) ) { Close(); return false; }
+	return true;
+}
+
+inline void GLBFile::Close()
+{
+	file.Close();
+	bin = nullptr;
+	binSize = 0;
+	bufferViews.clear();
+	accessors.clear();
+	meshes.clear();
+	materials.clear();
+	textures.clear();
+	images.clear();
+	instances.clear();
+}
+
+inline size_t GLBFile::ComponentSize( GLenum componentType )
+{
+	switch ( componentType ) {
+		case GL_BYTE:  case GL_UNSIGNED_BYTE:  return 1;
+		case GL_SHORT: case GL_UNSIGNED_SHORT: return 2;
+		case GL_UNSIGNED_INT: case GL_FLOAT:   return 4;
+		default: return 0;
+	}
+}
+
+inline int GLBFile::NumComponents( std::string const &type )
+{
+	if ( type == "SCALAR" ) return 1;
+	if ( type == "VEC2" ) return 2;
+	if ( type == "VEC3" ) return 3;
+	if ( type == "VEC4" || type == "MAT2" ) return 4;
+	if ( type == "MAT3" ) return 9;
+	if ( type == "MAT4" ) return 16;
+	return 0;
+}
+
+inline bool GLBFile::Parse( JSON const &root, std::ostream *outStream )
+{
+	auto Error = [&]( char const *msg, int index=-1 ) {
+		if ( outStream ) { *outStream << "ERROR: glTF: " << msg; if ( index >= 0 ) *outStream << " " << index; *outStream << std::endl; }
+		return false;
+	};
+	JSON const empty;
+	auto Array = [&]( char const *key ) -> JSON const & { JSON const *v = root.Get(key); return v && v->type == JSON::ARRAY ? *v : empty; };
+
+	JSON const *asset = root.Get("asset");
+	if ( ! asset || asset->String("version").compare( 0, 1, "2" ) != 0 ) return Error( "unsupported asset version" );
+
+	// Only the binary chunk can be used as a buffer
+	JSON const &jbuffers = Array("buffers");
+	std::vector<size_t> bufferLength( jbuffers.items.size() );
+	for ( size_t i=0; i<jbuffers.items.size(); i++ ) {
+		JSON const &b = jbuffers.items[i];
+		if ( i > 0 || b.Get("uri") ) return Error( "external buffers are not supported, buffer", (int)i );
+		bufferLength[i] = (size_t) b.Number( "byteLength", 0 );
+		if ( bufferLength[i] > binSize ) return Error( "buffer is larger than the binary chunk, buffer", (int)i );
+	}
+
+	JSON const &jviews = Array("bufferViews");
+	bufferViews.resize( jviews.items.size() );
+	for ( size_t i=0; i<jviews.items.size(); i++ ) {
+		JSON const &v = jviews.items[i];
+		BufferView &bv = bufferViews[i];
+		int buffer = v.Index("buffer");
+		bv.byteOffset = (size_t) v.Number( "byteOffset", 0 );
+		bv.byteLength = (size_t) v.Number( "byteLength", 0 );
+		bv.byteStride = (size_t) v.Number( "byteStride", 0 );
+		bv.target     = (GLenum) v.Number( "target", 0 );
+		if ( buffer < 0 || buffer >= (int) bufferLength.size() ) return Error( "invalid buffer of buffer view", (int)i );
+		if ( bv.byteOffset > bufferLength[buffer] || bv.byteLength > bufferLength[buffer] - bv.byteOffset ) return Error( "buffer view is out of range, buffer view", (int)i );
+		if ( bv.byteStride != 0 && ( bv.byteStride < 4 || bv.byteStride > 252 || bv.byteStride % 4 != 0 ) ) return Error( "invalid stride of buffer view", (int)i );
+	}
+
+	JSON const &jaccessors = Array("accessors");
+	accessors.resize( jaccessors.items.size() );
+	for ( size_t i=0; i<jaccessors.items.size(); i++ ) {
+		JSON const &j = jaccessors.items[i];
+		Accessor &a = accessors[i];
+		a.bufferView    = j.Index("bufferView");
+		a.byteOffset    = (size_t) j.Number( "byteOffset", 0 );
+		a.componentType = (GLenum) j.Number( "componentType", 0 );
+		a.normalized    = j.Boolean( "normalized", false );
+		a.count         = (size_t) j.Number( "count", 0 );
+		a.numComponents = NumComponents( j.String("type") );
+		a.hasBounds     = j.Get("min") && j.Get("max");
+		for ( int k=0; k<4; k++ ) { a.min[k] = 0; a.max[k] = 0; }
+		j.Floats( "min", a.min, 4 );
+		j.Floats( "max", a.max, 4 );
+		a.stride = 0;
+		if ( j.Get("sparse") ) return Error( "sparse accessors are not supported, accessor", (int)i );
+		size_t componentSize = ComponentSize( a.componentType );
+		if ( componentSize == 0 || a.numComponents == 0 || a.count == 0 ) return Error( "invalid accessor", (int)i );
+		if ( a.bufferView < 0 || a.bufferView >= (int) bufferViews.size() ) continue;	// validated when a mesh uses it
+		BufferView const &bv = bufferViews[a.bufferView];
+		size_t elementSize = componentSize * a.numComponents;
+		a.stride = bv.byteStride ? bv.byteStride : elementSize;
+		if ( ( bv.byteOffset + a.byteOffset ) % componentSize != 0 ) return Error( "misaligned accessor", (int)i );
+		if ( a.stride < elementSize ) return Error( "accessor elements overlap, accessor", (int)i );
+		// the checks are ordered so that they cannot overflow
+		if ( a.byteOffset > bv.byteLength || elementSize > bv.byteLength - a.byteOffset || a.count - 1 > ( bv.byteLength - a.byteOffset - elementSize ) / a.stride ) return Error( "accessor is out of range of its buffer view, accessor", (int)i );
+	}
+
+	JSON const &jimages = Array("images");
+	images.resize( jimages.items.size() );
+	for ( size_t i=0; i<jimages.items.size(); i++ ) {
+		JSON const &j = jimages.items[i];
+		images[i].bufferView = j.Index("bufferView");
+		images[i].mimeType   = j.String("mimeType");
+		images[i].uri        = j.String("uri");
+		if ( images[i].bufferView >= (int) bufferViews.size() ) return Error( "invalid buffer view of image", (int)i );
+	}
+
+	JSON const &jsamplers = Array("samplers");
+	JSON const &jtextures = Array("textures");
+	textures.resize( jtextures.items.size() );
+	for ( size_t i=0; i<jtextures.items.size(); i++ ) {
+		JSON const &j = jtextures.items[i];
+		Texture &t = textures[i];
+		t.image = j.Index("source");
+		t.magFilter = t.minFilter = 0;
+		t.wrapS = t.wrapT = GL_REPEAT;
+		int s = j.Index("sampler");
+		if ( s >= 0 && s < (int) jsamplers.items.size() ) {
+			JSON const &js = jsamplers.items[s];
+			t.magFilter = (GLenum) js.Number( "magFilter", 0 );
+			t.minFilter = (GLenum) js.Number( "minFilter", 0 );
+			t.wrapS     = (GLenum) js.Number( "wrapS", GL_REPEAT );
+			t.wrapT     = (GLenum) js.Number( "wrapT", GL_REPEAT );
+		}
+		if ( t.image >= (int) images.size() ) return Error( "invalid image of texture", (int)i );
+	}
+
+	JSON const &jmaterials = Array("materials");
+	materials.resize( jmaterials.items.size() );
+	auto ValidTexture = [&]( int t ) { return t < (int) textures.size() ? t : -1; };
+	for ( size_t i=0; i<jmaterials.items.size(); i++ ) {
+		JSON const &j = jmaterials.items[i];
+		Material &m = materials[i];
+		m.name = j.String("name");
+		for ( int k=0; k<4; k++ ) m.baseColor[k] = 1;
+		for ( int k=0; k<3; k++ ) m.emissive[k] = 0;
+		m.metallic = 1;
+		m.roughness = 1;
+		m.baseColorTexture = m.metallicRoughnessTexture = -1;
+		JSON const *pbr = j.Get("pbrMetallicRoughness");
+		if ( pbr ) {
+			pbr->Floats( "baseColorFactor", m.baseColor, 4 );
+			m.metallic  = (float) pbr->Number( "metallicFactor",  1 );
+			m.roughness = (float) pbr->Number( "roughnessFactor", 1 );
+			m.baseColorTexture         = ValidTexture( pbr->TextureIndex("baseColorTexture") );
+			m.metallicRoughnessTexture = ValidTexture( pbr->TextureIndex("metallicRoughnessTexture") );
+		}
+		j.Floats( "emissiveFactor", m.emissive, 3 );
+		m.normalTexture    = ValidTexture( j.TextureIndex("normalTexture") );
+		m.occlusionTexture = ValidTexture( j.TextureIndex("occlusionTexture") );
+		m.emissiveTexture  = ValidTexture( j.TextureIndex("emissiveTexture") );
+		m.doubleSided      = j.Boolean( "doubleSided", false );
+	}
+
+	JSON const &jmeshes = Array("meshes");
+	meshes.resize( jmeshes.items.size() );
+	std::vector<size_t> maxIndex( accessors.size(), SIZE_MAX );	// computed once for each index accessor
+	for ( size_t i=0; i<jmeshes.items.size(); i++ ) {
+		JSON const &j = jmeshes.items[i];
+		meshes[i].name = j.String("name");
+		JSON const *jprims = j.Get("primitives");
+		if ( ! jprims || jprims->type != JSON::ARRAY ) return Error( "mesh has no primitives, mesh", (int)i );
+		for ( size_t k=0; k<jprims->items.size(); k++ ) {
+			JSON const &jp = jprims->items[k];
+			Primitive prim;
+			JSON const *attribs = jp.Get("attributes");
+			if ( ! attribs ) return Error( "primitive has no attributes, mesh", (int)i );
+			prim.attribs[ATTRIB_POSITION] = attribs->Index("POSITION");
+			prim.attribs[ATTRIB_NORMAL  ] = attribs->Index("NORMAL");
+			prim.attribs[ATTRIB_TEXCOORD] = attribs->Index("TEXCOORD_0");
+			prim.indices  = jp.Index("indices");
+			prim.material = jp.Index("material");
+			prim.mode     = (GLenum) jp.Number( "mode", GL_TRIANGLES );
+			if ( prim.material >= (int) materials.size() ) return Error( "invalid material of mesh", (int)i );
+			if ( prim.attribs[ATTRIB_POSITION] < 0 ) return Error( "primitive has no positions, mesh", (int)i );
+			if ( ! ValidateAccessor( prim.attribs[ATTRIB_POSITION], 3, false, true,  "POSITION",   outStream ) ) return false;
+			if ( ! ValidateAccessor( prim.attribs[ATTRIB_NORMAL  ], 3, false, true,  "NORMAL",     outStream ) ) return false;
+			if ( ! ValidateAccessor( prim.attribs[ATTRIB_TEXCOORD], 2, true,  true,  "TEXCOORD_0", outStream ) ) return false;
+			if ( ! ValidateAccessor( prim.indices,                  1, false, false, "indices",    outStream ) ) return false;
+			size_t numVertices = accessors[ prim.attribs[ATTRIB_POSITION] ].count;
+			for ( int a=1; a<NUM_ATTRIBS; a++ ) {
+				if ( prim.attribs[a] >= 0 && accessors[ prim.attribs[a] ].count != numVertices ) return Error( "vertex attributes have different counts, mesh", (int)i );
+			}
+			if ( ! accessors[ prim.attribs[ATTRIB_POSITION] ].hasBounds ) return Error( "positions have no bounds, mesh", (int)i );
+			if ( prim.indices >= 0 ) {
+				Accessor const &ia = accessors[prim.indices];
+				if ( bufferViews[ia.bufferView].byteStride != 0 ) return Error( "index buffer view has a stride, mesh", (int)i );
+				// the GPU would read past the end of the vertex buffers
+				if ( maxIndex[prim.indices] == SIZE_MAX ) maxIndex[prim.indices] = MaxIndex( prim.indices );
+				if ( maxIndex[prim.indices] >= numVertices ) return Error( "index is out of range of the vertices, mesh", (int)i );
+				if ( bufferViews[ia.bufferView].target == GL_ARRAY_BUFFER ) return Error( "index buffer view is a vertex buffer, mesh", (int)i );
+				bufferViews[ia.bufferView].target = GL_ELEMENT_ARRAY_BUFFER;
+			}
+			for ( int a=0; a<NUM_ATTRIBS; a++ ) {
+				if ( prim.attribs[a] < 0 ) continue;
+				BufferView &bv = bufferViews[ accessors[ prim.attribs[a] ].bufferView ];
+				if ( bv.target == GL_ELEMENT_ARRAY_BUFFER ) return Error( "vertex buffer view is an index buffer, mesh", (int)i );
+				bv.target = GL_ARRAY_BUFFER;
+			}
+			meshes[i].primitives.push_back( prim );
+		}
+	}
+
+	// Mesh instances of the default scene
+	JSON const &jnodes = Array("nodes");
+	JSON const &jscenes = Array("scenes");
+	int scene = root.Index("scene");
+	if ( scene < 0 && ! jscenes.items.empty() ) scene = 0;
+	if ( scene >= (int) jscenes.items.size() ) return Error( "invalid default scene", scene );
+	if ( scene >= 0 ) {
+		JSON const *roots = jscenes.items[scene].Get("nodes");
+		if ( roots && roots->type == JSON::ARRAY ) {
+			for ( size_t i=0; i<roots->items.size(); i++ ) AddInstances( jnodes, (int) roots->items[i].number, Matrix4f::Identity(), 0 );
+		}
+	} else {
+		for ( int i=0; i<(int)meshes.size(); i++ ) {
+			MeshInstance inst;
+			inst.mesh = i;
+			inst.transform.SetIdentity();
+			instances.push_back( inst );
+		}
+	}
+	return true;
+}
+
+inline bool GLBFile::ValidateAccessor( int acc, int numComponents, bool allowNormalized, bool allowFloat, char const *name, std::ostream *outStream ) const
+{
+	if ( acc < 0 ) return true;
+	auto Error = [&]( char const *msg ) { if ( outStream ) *outStream << "ERROR: glTF: " << name << " accessor " << acc << " " << msg << std::endl; return false; };
+	if ( acc >= (int) accessors.size() ) return Error( "does not exist" );
+	Accessor const &a = accessors[acc];
+	if ( a.bufferView < 0 || a.bufferView >= (int) bufferViews.size() ) return Error( "has no data" );
+	if ( a.numComponents != numComponents ) return Error( "has a wrong type" );
+	bool valid;
+	if ( allowFloat && a.componentType == GL_FLOAT ) valid = true;
+	else if ( allowNormalized ) valid = a.normalized && ( a.componentType == GL_UNSIGNED_BYTE || a.componentType == GL_UNSIGNED_SHORT );
+	else valid = ! allowFloat && ( a.componentType == GL_UNSIGNED_BYTE || a.componentType == GL_UNSIGNED_SHORT || a.componentType == GL_UNSIGNED_INT );
+	if ( ! valid ) return Error( "has a wrong component type" );
+	return true;
+}
+
+inline size_t GLBFile::MaxIndex( int acc ) const
+{
+	Accessor const &a = accessors[acc];
+	char const *p = (char const *) AccessorData( acc );
+	size_t maxIndex = 0;
+	for ( size_t i=0; i<a.count; i++, p+=a.stride ) {
+		size_t index;
+		switch ( a.componentType ) {
+			case GL_UNSIGNED_BYTE:  { uint8_t  v; memcpy( &v, p, 1 ); index = v; break; }
+			case GL_UNSIGNED_SHORT: { uint16_t v; memcpy( &v, p, 2 ); index = v; break; }
+			default:                { uint32_t v; memcpy( &v, p, 4 ); index = v; break; }
+		}
+		if ( maxIndex < index ) maxIndex = index;
+	}
+	return maxIndex;
+}
+
+inline Matrix4f GLBFile::NodeTransform( JSON const &node )
+{
+	Matrix4f m;
+	JSON const *matrix = node.Get("matrix");
+	if ( matrix && matrix->type == JSON::ARRAY && matrix->items.size() == 16 ) {
+		for ( int i=0; i<16; i++ ) m.cell[i] = (float) matrix->items[i].number;	// column-major, as in Matrix4
+		return m;
+	}
+	float t[3] = { 0, 0, 0 }, r[4] = { 0, 0, 0, 1 }, s[3] = { 1, 1, 1 };
+	node.Floats( "translation", t, 3 );
+	node.Floats( "rotation",    r, 4 );
+	node.Floats( "scale",       s, 3 );
+	// rotation quaternion (x,y,z,w) to matrix, scaled and translated
+	float x=r[0], y=r[1], z=r[2], w=r[3];
+	Matrix3f rs( Vec3f( 1-2*(y*y+z*z),   2*(x*y+w*z),   2*(x*z-w*y) ) * s[0],
+	             Vec3f(   2*(x*y-w*z), 1-2*(x*x+z*z),   2*(y*z+w*x) ) * s[1],
+	             Vec3f(   2*(x*z+w*y),   2*(y*z-w*x), 1-2*(x*x+y*y) ) * s[2] );
+	return Matrix4f( rs, Vec3f( t[0], t[1], t[2] ) );
+}
+
+inline void GLBFile::AddInstances( JSON const &nodes, int node, Matrix4f const &parent, int depth )
+{
+	// The depth limit guards against cycles in invalid files
+	if ( node < 0 || node >= (int) nodes.items.size() || depth > (int) nodes.items.size() ) return;
+	JSON const &n = nodes.items[node];
+	Matrix4f transform = parent * NodeTransform( n );
+	int mesh = n.Index("mesh");
+	if ( mesh >= 0 && mesh < (int) meshes.size() ) {
+		MeshInstance inst;
+		inst.mesh = mesh;
+		inst.transform = transform;
+		instances.push_back( inst );
+	}
+	JSON const *children = n.Get("children");
+	if ( children && children->type == JSON::ARRAY ) {
+		for ( size_t i=0; i<children->items.size(); i++ ) AddInstances( nodes, (int) children->items[i].number, transform, depth+1 );
+	}
+}
+
+//-------------------------------------------------------------------------------
+
+inline void GLBFile::ComputeBoundingBox( Vec3f &boundMin, Vec3f &boundMax ) const
+{
+	boundMin.Set(  FLT_MAX,  FLT_MAX,  FLT_MAX );
+	boundMax.Set( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+	for ( size_t i=0; i<instances.size(); i++ ) {
+		Mesh const &mesh = meshes[ instances[i].mesh ];
+		for ( size_t k=0; k<mesh.primitives.size(); k++ ) {
+			int pa = mesh.primitives[k].attribs[ATTRIB_POSITION];
+			Vec3f bmin = GetBoundMin(pa), bmax = GetBoundMax(pa);
+			for ( int c=0; c<8; c++ ) {
+				Vec3f corner( c&1 ? bmax.x : bmin.x, c&2 ? bmax.y : bmin.y, c&4 ? bmax.z : bmin.z );
+				Vec4f p = instances[i].transform * Vec4f( corner, 1.0f );
+				for ( int j=0; j<3; j++ ) { boundMin[j] = Min( boundMin[j], p[j] ); boundMax[j] = Max( boundMax[j], p[j] ); }
+			}
+		}
+	}
+}
+
+inline void GLBFile::CreateBuffers( std::vector<GLuint> &buffers, GLenum usage ) const
+{
+	buffers.assign( bufferViews.size(), 0 );
+	for ( size_t i=0; i<bufferViews.size(); i++ ) {
+		BufferView const &bv = bufferViews[i];
+		if ( bv.target != GL_ARRAY_BUFFER && bv.target != GL_ELEMENT_ARRAY_BUFFER ) continue;
+		glGenBuffers( 1, &buffers[i] );
+		glBindBuffer( bv.target, buffers[i] );
+		glBufferData( bv.target, bv.byteLength, bin + bv.byteOffset, usage );
+	}
+}
+
+inline void GLBFile::SetAttribs( Primitive const &prim, std::vector<GLuint> const &buffers, GLint const locations[NUM_ATTRIBS] ) const
+{
+	for ( int i=0; i<NUM_ATTRIBS; i++ ) {
+		if ( locations[i] < 0 ) continue;
+		if ( prim.attribs[i] < 0 ) { glDisableVertexAttribArray( locations[i] ); continue; }
+		Accessor const &a = accessors[ prim.attribs[i] ];
+		glBindBuffer( GL_ARRAY_BUFFER, buffers[a.bufferView] );
+		glVertexAttribPointer( locations[i], a.numComponents, a.componentType, a.normalized, (GLsizei) a.stride, (void const *) a.byteOffset );
+		glEnableVertexAttribArray( locations[i] );
+	}
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+	if ( prim.indices >= 0 ) glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, buffers[ accessors[prim.indices].bufferView ] );
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::GLBFile cyGLBFile;	//!< Binary glTF 2.0 file
+
+//-------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,351 @@
+//-------------------------------------------------------------------------------
+//! \file   cyObjStream.h
+//!
+//! \brief  Out-of-core OBJ reading and spatial clustering.
+//!
+//! ObjStream reads an OBJ file in chunks of bounded size, so that meshes that do
+//! not fit in memory can be processed. ObjClusters uses it for splitting such a
+//! mesh into spatial clusters, each of which is stored in a separate mesh cache
+//! file (see cyMeshCache.h) that can be loaded independently.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_OBJ_STREAM_H_INCLUDED_
+#define _CY_OBJ_STREAM_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyTriMesh.h"
+#include "cyMeshCache.h"
+#include <unordered_map>
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Streaming OBJ reader.
+//!
+//! Reads the vertex positions and faces of an OBJ file, one chunk at a time.
+//! Each chunk contains at most maxVertices vertices and roughly maxFaces triangles
+//! (a chunk ends after the polygon that reaches the limit). Faces are triangulated
+//! the same way as TriMesh::LoadFromFileObj and their vertex indices refer to all
+//! vertices of the file, with relative (negative) indices resolved. Texture
+//! coordinates, normals, and materials are ignored.
+
+class ObjStream
+{
+public:
+	typedef TriMesh::TriFace TriFace;
+
+	//! A chunk of the OBJ file. The pointers remain valid until the next call to Read.
+	struct Chunk
+	{
+		Vec3f   const *v;		//!< vertex positions
+		TriFace const *f;		//!< triangles
+		unsigned int   numV;	//!< number of vertices in the chunk
+		unsigned int   numF;	//!< number of triangles in the chunk
+		unsigned int   firstV;	//!< index of the first vertex of the chunk in the file
+		unsigned int   firstF;	//!< index of the first triangle of the chunk in the file
+	};
+
+	ObjStream( unsigned int maxVertices=1<<20, unsigned int maxFaces=1<<20 ) : pos(nullptr), maxV(maxVertices>0?maxVertices:1), maxF(maxFaces>0?maxFaces:1), numV(0), numF(0) {}
+
+	bool Open( char const *filename ) { Close(); if ( !file.Open(filename) ) return false; Rewind(); return true; }	//!< Opens the given OBJ file for reading.
+	void Close() { file.Close(); pos=nullptr; std::vector<Vec3f>().swap(v); std::vector<TriFace>().swap(f); }		//!< Closes the file and releases the chunk buffers.
+	bool IsOpen() const { return file.IsOpen(); }				//!< Returns true if a file is open.
+	void Rewind() { pos=file.Data(); numV=0; numF=0; }			//!< Restarts reading from the beginning of the file.
+	bool Read( Chunk &chunk );									//!< Reads the next chunk. Returns false if there is no more data.
+	unsigned int NumVerticesRead() const { return numV; }		//!< Returns the number of vertices read so far.
+	unsigned int NumFacesRead   () const { return numF; }		//!< Returns the number of triangles read so far.
+
+	//! Reads the whole file and calls func(chunk) for each chunk. Returns false if the file cannot be opened or func returns false.
+	template <typename FUNC> bool ForEachChunk( char const *filename, FUNC func );
+
+private:
+	MemoryMap            file;
+	char const          *pos;
+	unsigned int         maxV, maxF;
+	unsigned int         numV, numF;
+	std::vector<Vec3f>   v;
+	std::vector<TriFace> f;
+
+	ObjStream( ObjStream const & ) CY_CLASS_FUNCTION_DELETE
+	ObjStream& operator = ( ObjStream const & ) CY_CLASS_FUNCTION_DELETE
+};
+
+//-------------------------------------------------------------------------------
+
+//! Spatial clusters of a large mesh.
+//!
+//! Build streams an OBJ file and distributes its triangles to the cells of a
+//! uniform grid using their centroids. The triangles of each cell are written as
+//! a separate mesh cache file with its own vertex array, along with a text index
+//! file that lists the clusters and their bounding boxes. Only vertex positions and
+//! faces are stored; normals can be computed after loading a cluster.
+//!
+//! Build keeps the vertex positions and triangles in temporary files next to the
+//! output and accesses them through memory mappings, so its memory use is bounded
+//! by the size of the largest cluster, rather than the size of the mesh.
+
+class ObjClusters
+{
+public:
+	//! Cluster information
+	struct Cluster
+	{
+		std::string  filename;	//!< Mesh cache file of the cluster
+		unsigned int numV;		//!< Number of vertices
+		unsigned int numF;		//!< Number of triangles
+		Vec3f        boundMin;	//!< Bounding box minimum bound
+		Vec3f        boundMax;	//!< Bounding box maximum bound
+	};
+
+	//! Splits the given OBJ file into clusters of about trianglesPerCluster triangles. The index file is written to
+	//! outputPrefix + ".clusters" and the clusters are written to outputPrefix + "_N.cymesh".
+	static bool Build( char const *objFilename, char const *outputPrefix, unsigned int trianglesPerCluster=1<<18, std::ostream *outStream=&std::cout );
+
+	bool Open( char const *indexFilename );		//!< Reads the cluster index file written by Build.
+	unsigned int   NumClusters() const { return (unsigned int) clusters.size(); }	//!< Returns the number of clusters.
+	Cluster const& GetCluster( unsigned int i ) const { return clusters[i]; }		//!< Returns the information of the i^th cluster.
+	bool Load( unsigned int i, TriMesh &mesh ) const;	//!< Loads the i^th cluster.
+
+private:
+	std::vector<Cluster> clusters;
+	std::string path;	// directory of the index file
+
+	static std::string GetPath( char const *filename ) { std::string s(filename); size_t i=s.find_last_of("/\\"); return i==std::string::npos ? std::string() : s.substr(0,i+1); }
+};
+
+//-------------------------------------------------------------------------------
+
+inline bool ObjStream::Read( Chunk &chunk )
+{
+	v.clear();
+	f.clear();
+	chunk.firstV = numV;
+	chunk.firstF = numF;
+	char const *end = file.End();
+	char const *lineBegin, *lineEnd, *args;
+	bool hasTextures=false, hasNormals=false;
+	while ( pos && v.size()<maxV && f.size()<maxF ) {
+		if ( !ObjParser::NextLine(pos,end,lineBegin,lineEnd) ) { pos=nullptr; break; }
+		if ( ObjParser::IsCommand(lineBegin,lineEnd,"v",args) ) {
+			Vec3f vertex;
+			vertex.Zero();
+			ObjParser::ReadFloats( args, lineEnd, &vertex.x, 3 );
+			v.push_back(vertex);
+			numV++;
+		}
+		else if ( ObjParser::IsCommand(lineBegin,lineEnd,"f",args) ) {
+			std::vector<TriFace> &faces = f;
+			ObjParser::ReadFace( args, lineEnd, numV, 0, 0, hasTextures, hasNormals, [&faces]( TriFace const &face, TriFace const *, TriFace const * ) { faces.push_back(face); } );
+		}
+	}
+	numF += (unsigned int) f.size();
+	chunk.v    = v.data();
+	chunk.f    = f.data();
+	chunk.numV = (unsigned int) v.size();
+	chunk.numF = (unsigned int) f.size();
+	return chunk.numV > 0 || chunk.numF > 0;
+}
+
+template <typename FUNC>
+inline bool ObjStream::ForEachChunk( char const *filename, FUNC func )
+{
+	if ( !Open(filename) ) return false;
+	Chunk chunk;
+	while ( Read(chunk) ) {
+		if ( !func(chunk) ) { Close(); return false; }
+	}
+	Close();
+	return true;
+}
+
+//-------------------------------------------------------------------------------
+
+inline bool ObjClusters::Build( char const *objFilename, char const *outputPrefix, unsigned int trianglesPerCluster, std::ostream *outStream )
+{
+	typedef TriMesh::TriFace TriFace;
+	std::string prefix = outputPrefix;
+	std::string tmpV = prefix + ".tmpv";
+	std::string tmpF = prefix + ".tmpf";
+	std::string tmpB = prefix + ".tmpb";
+	struct TempFiles {
+		std::string const *names[3];
+		~TempFiles() { for ( int i=0; i<3; i++ ) remove( names[i]->c_str() ); }
+	} tempFiles = { { &tmpV, &tmpF, &tmpB } };
+
+	// Stream the OBJ file into binary vertex and face files
+	FILE *fpV = fopen( tmpV.c_str(), "wb" );
+	FILE *fpF = fopen( tmpF.c_str(), "wb" );
+	bool ok = fpV && fpF;
+	Vec3f boundMin( 1, 1, 1), boundMax(0,0,0);
+	unsigned int numV=0, numF=0;
+	if ( ok ) {
+		ObjStream stream;
+		ok = stream.ForEachChunk( objFilename, [&]( ObjStream::Chunk const &chunk ) {
+			for ( unsigned int i=0; i<chunk.numV; i++ ) {
+				Vec3f const &p = chunk.v[i];
+				if ( numV+i == 0 ) boundMin = boundMax = p;
+				if ( boundMin.x > p.x ) boundMin.x = p.x;
+				if ( boundMin.y > p.y ) boundMin.y = p.y;
+				if ( boundMin.z > p.z ) boundMin.z = p.z;
+				if ( boundMax.x < p.x ) boundMax.x = p.x;
+				if ( boundMax.y < p.y ) boundMax.y = p.y;
+				if ( boundMax.z < p.z ) boundMax.z = p.z;
+			}
+			numV += chunk.numV;
+			numF += chunk.numF;
+			return fwrite( chunk.v, sizeof(Vec3f), chunk.numV, fpV ) == chunk.numV && fwrite( chunk.f, sizeof(TriFace), chunk.numF, fpF ) == chunk.numF;
+		});
+	}
+	if ( fpV && fclose(fpV) != 0 ) ok = false;
+	if ( fpF && fclose(fpF) != 0 ) ok = false;
+	if ( !ok ) {
+		if ( outStream ) *outStream << "ERROR: Cannot convert file " << objFilename << std::endl;
+		return false;
+	}
+
+	// Choose a grid with roughly cubic cells
+	if ( trianglesPerCluster == 0 ) trianglesPerCluster = 1;
+	unsigned int targetCells = ( numF + trianglesPerCluster - 1 ) / trianglesPerCluster;
+	if ( targetCells < 1 ) targetCells = 1;
+	Vec3f size = boundMax - boundMin;
+	float minSize = size.Max() * 1e-3f;
+	if ( minSize <= 0 ) minSize = 1;
+	size.ClampMin( minSize );
+	float cellSize = std::cbrt( size.x*size.y*size.z / targetCells );
+	unsigned int gx = cy::Max( 1u, (unsigned int) std::ceil( size.x / cellSize ) );
+	unsigned int gy = cy::Max( 1u, (unsigned int) std::ceil( size.y / cellSize ) );
+	unsigned int gz = cy::Max( 1u, (unsigned int) std::ceil( size.z / cellSize ) );
+	Vec3f cellScale( gx/size.x, gy/size.y, gz/size.z );
+
+	// Distribute the triangles to the cells, writing them to a temporary file in blocks
+	MemoryMap fileV, fileF;
+	if ( !fileV.Open( tmpV.c_str(), false ) || !fileF.Open( tmpF.c_str() ) ) return false;
+	Vec3f   const *v = (Vec3f   const *) fileV.Data();
+	TriFace const *f = (TriFace const *) fileF.Data();
+	const unsigned int blockSize = 1024;
+	struct Block { uint64_t offset; unsigned int count; };
+	std::vector< std::vector<TriFace> > cellFaces( size_t(gx)*gy*gz );
+	std::vector< std::vector<Block> >   cellBlocks( cellFaces.size() );
+	uint64_t offset = 0;
+	FILE *fpB = fopen( tmpB.c_str(), "wb" );
+	if ( !fpB ) return false;
+	auto flush = [&]( size_t cell ) {
+		std::vector<TriFace> &faces = cellFaces[cell];
+		if ( faces.empty() ) return true;
+		Block block = { offset, (unsigned int) faces.size() };
+		cellBlocks[cell].push_back( block );
+		offset += sizeof(TriFace) * faces.size();
+		bool written = fwrite( faces.data(), sizeof(TriFace), faces.size(), fpB ) == faces.size();
+		faces.clear();
+		return written;
+	};
+	for ( unsigned int i=0; ok && i<numF; i++ ) {
+		TriFace const &face = f[i];
+		if ( face.v[0] >= numV || face.v[1] >= numV || face.v[2] >= numV ) continue;	// invalid index
+		Vec3f c = ( ( v[face.v[0]] + v[face.v[1]] + v[face.v[2]] ) / 3.0f - boundMin ) * cellScale;
+		c.ClampMin( 0.0f );
+		unsigned int ix = cy::Min( gx-1, (unsigned int) c.x );
+		unsigned int iy = cy::Min( gy-1, (unsigned int) c.y );
+		unsigned int iz = cy::Min( gz-1, (unsigned int) c.z );
+		size_t cell = ( size_t(iz)*gy + iy )*gx + ix;
+		cellFaces[cell].push_back( face );
+		if ( cellFaces[cell].size() >= blockSize ) ok = flush(cell);
+	}
+	for ( size_t i=0; ok && i<cellFaces.size(); i++ ) ok = flush(i);
+	std::vector< std::vector<TriFace> >().swap( cellFaces );
+	fileF.Close();
+	if ( fclose(fpB) != 0 ) ok = false;
+	if ( !ok ) return false;
+
+	// Write each cell as a cluster with its own vertex array
+	MemoryMap fileB;
+	if ( offset > 0 && !fileB.Open( tmpB.c_str(), false ) ) return false;
+	MeshCache::SourceInfo sourceInfo;
+	if ( !MeshCache::GetSourceInfo( objFilename, sourceInfo, false ) ) return false;
+	std::string indexFilename = prefix + ".clusters";
+	FILE *fpIndex = fopen( indexFilename.c_str(), "w" );
+	if ( !fpIndex ) {
+		if ( outStream ) *outStream << "ERROR: Cannot create file " << indexFilename << std::endl;
+		return false;
+	}
+	std::string name = prefix.substr( GetPath(outputPrefix).size() );
+	std::unordered_map<unsigned int,unsigned int> vertexMap;
+	std::vector<Vec3f> clusterV;
+	std::vector<TriFace> clusterF;
+	unsigned int numClusters = 0;
+	for ( size_t cell=0; ok && cell<cellBlocks.size(); cell++ ) {
+		if ( cellBlocks[cell].empty() ) continue;
+		vertexMap.clear();
+		clusterV.clear();
+		clusterF.clear();
+		for ( size_t b=0; b<cellBlocks[cell].size(); b++ ) {
+			Block const &block = cellBlocks[cell][b];
+			TriFace const *bf = (TriFace const *)( fileB.Data() + block.offset );
+			for ( unsigned int i=0; i<block.count; i++ ) {
+				TriFace face;
+				for ( int j=0; j<3; j++ ) {
+					std::pair<std::unordered_map<unsigned int,unsigned int>::iterator,bool> r = vertexMap.insert( std::make_pair( bf[i].v[j], (unsigned int) clusterV.size() ) );
+					if ( r.second ) clusterV.push_back( v[ bf[i].v[j] ] );
+					face.v[j] = r.first->second;
+				}
+				clusterF.push_back( face );
+			}
+		}
+		TriMesh mesh;
+		mesh.SetNumVertex( (unsigned int) clusterV.size() );
+		mesh.SetNumFaces ( (unsigned int) clusterF.size() );
+		memcpy( &mesh.V(0), clusterV.data(), sizeof(Vec3f)*clusterV.size() );
+		memcpy( &mesh.F(0), clusterF.data(), sizeof(TriFace)*clusterF.size() );
+		mesh.ComputeBoundingBox();
+		char clusterName[32];
+		snprintf( clusterName, sizeof(clusterName), "_%u.cymesh", numClusters++ );
+		std::string clusterFilename = prefix + clusterName;
+		if ( !MeshCache::Write( clusterFilename.c_str(), mesh, sourceInfo, false ) ) {
+			if ( outStream ) *outStream << "ERROR: Cannot create file " << clusterFilename << std::endl;
+			ok = false;
+			break;
+		}
+		Vec3f bmin = mesh.GetBoundMin(), bmax = mesh.GetBoundMax();
+		fprintf( fpIndex, "cluster %s%s %u %u %.9g %.9g %.9g %.9g %.9g %.9g\n", name.c_str(), clusterName, mesh.NV(), mesh.NF(), bmin.x, bmin.y, bmin.z, bmax.x, bmax.y, bmax.z );
+	}
+	if ( fclose(fpIndex) != 0 ) ok = false;
+	return ok;
+}
+
+inline bool ObjClusters::Open( char const *indexFilename )
+{
+	clusters.clear();
+	path = GetPath( indexFilename );
+	FILE *fp = fopen( indexFilename, "r" );
+	if ( !fp ) return false;
+	char line[4096], filename[4096];
+	while ( fgets( line, sizeof(line), fp ) ) {
+		Cluster c;
+		if ( sscanf( line, "cluster %4095s %u %u %f %f %f %f %f %f", filename, &c.numV, &c.numF, &c.boundMin.x, &c.boundMin.y, &c.boundMin.z, &c.boundMax.x, &c.boundMax.y, &c.boundMax.z ) != 9 ) continue;
+		c.filename = filename;
+		clusters.push_back( c );
+	}
+	fclose(fp);
+	return true;
+}
+
+inline bool ObjClusters::Load( unsigned int i, TriMesh &mesh ) const
+{
+	if ( i >= clusters.size() ) return false;
+	MeshCache cache;
+	return cache.Open( ( path + clusters[i].filename ).c_str() ) && cache.GetMesh( mesh );
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::ObjStream   cyObjStream;	//!< Streaming OBJ reader
+typedef cy::ObjClusters cyObjClusters;	//!< Spatial clusters of a large mesh
+
+//-------------------------------------------------------------------------------
+
+#endif
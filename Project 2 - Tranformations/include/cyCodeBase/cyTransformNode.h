@@ -0,0 +1,260 @@
+//-------------------------------------------------------------------------------
+//! \file   cyTransformNode.h
+//!
+//! \brief  Transformation hierarchy with cached world and camera matrices.
+//!
+//! TransformNode holds a local transformation (translation, rotation, and
+//! scale) and a parent node, and caches its world matrix, the world bounds of
+//! its local bounding box, and its model-view and model-view-projection
+//! matrices for each Camera it is drawn with. Changing a node marks its subtree
+//! as dirty, and the cached values of a node are recomputed only when they are
+//! requested after a change of the node, one of its ancestors, or the camera.
+//! If nothing changes between frames, requesting the matrices costs a few
+//! comparisons.
+//!
+//! The cached values are updated by the const access functions, so a node must
+//! not be accessed by multiple threads at the same time.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_TRANSFORM_NODE_H_INCLUDED_
+#define _CY_TRANSFORM_NODE_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyMatrix.h"
+#include "cyBatchTransform.h"
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! A view and projection transformation, which caches their product.
+
+class Camera
+{
+public:
+	Camera() : view(Matrix4f::Identity()), projection(Matrix4f::Identity()), viewProjection(Matrix4f::Identity()), revision(NewRevision()), dirty(false) {}
+
+	void SetView      ( Matrix4f const &m ) { view = m;       Changed(); }	//!< Sets the view matrix, which transforms world space to view space.
+	void SetProjection( Matrix4f const &m ) { projection = m; Changed(); }	//!< Sets the projection matrix, which transforms view space to clip space.
+
+	Matrix4f const & GetView      () const { return view; }			//!< Returns the view matrix.
+	Matrix4f const & GetProjection() const { return projection; }	//!< Returns the projection matrix.
+
+	//! Returns the product of the projection and view matrices.
+	Matrix4f const & GetViewProjection() const { if ( dirty ) { viewProjection = projection * view; dirty = false; } return viewProjection; }
+
+	//! Returns a number that changes with every change of the camera. Different cameras never have the same number,
+	//! unless one is a copy of the other.
+	unsigned int GetRevision() const { return revision; }
+
+private:
+	Matrix4f         view;
+	Matrix4f         projection;
+	mutable Matrix4f viewProjection;
+	unsigned int     revision;
+	mutable bool     dirty;
+
+	void Changed() { revision = NewRevision(); dirty = true; }
+	static unsigned int NewRevision() { static std::atomic<unsigned int> counter(0); return ++counter; }
+};
+
+//-------------------------------------------------------------------------------
+
+//! A node of a transformation hierarchy.
+//!
+//! The local matrix is translation * rotation * scale, and the world matrix is
+//! the world matrix of the parent times the local matrix. The children are not
+//! owned by the node: destroying a node detaches its children, which become
+//! root nodes.
+
+class TransformNode
+{
+public:
+	TransformNode() : parent(nullptr), translation(0,0,0), rotation(Matrix3f::Identity()), scale(1,1,1), boundMin(1,1,1), boundMax(0,0,0)
+		, localDirty(true), worldDirty(true), boundsDirty(true), worldRevision(0) {}
+	~TransformNode();
+
+	TransformNode( TransformNode const & ) CY_CLASS_FUNCTION_DELETE
+	TransformNode& operator = ( TransformNode const & ) CY_CLASS_FUNCTION_DELETE
+
+	//!@name Hierarchy
+
+	//! Attaches the node to the given parent, or detaches it if the parent is null. The local transformation is kept.
+	void SetParent( TransformNode *p );
+	TransformNode * GetParent() const { return parent; }							//!< Returns the parent node, or null for a root node.
+	size_t          NumChildren() const { return children.size(); }				//!< Returns the number of child nodes.
+	TransformNode * GetChild( size_t i ) const { return children[i]; }			//!< Returns the i-th child node.
+
+	//!@name Local transformation
+
+	void SetTranslation( Vec3f const &t ) { translation = t; LocalChanged(); }	//!< Sets the translation.
+	void SetRotation( Matrix3f const &r ) { rotation = r;    LocalChanged(); }	//!< Sets the rotation matrix.
+	void SetRotationXYZ( float angleX, float angleY, float angleZ ) { SetRotation( Matrix3f::RotationXYZ(angleX,angleY,angleZ) ); }	//!< Sets the rotation around x, y, and then z axes.
+	void SetScale( Vec3f const &s ) { scale = s; LocalChanged(); }				//!< Sets the scale along the axes.
+	void SetScale( float s ) { SetScale( Vec3f(s,s,s) ); }						//!< Sets a uniform scale.
+
+	Vec3f    const & GetTranslation() const { return translation; }			//!< Returns the translation.
+	Matrix3f const & GetRotation   () const { return rotation; }			//!< Returns the rotation matrix.
+	Vec3f    const & GetScale      () const { return scale; }				//!< Returns the scale.
+
+	//! Returns the local matrix, translation * rotation * scale.
+	Matrix4f const & GetLocalMatrix() const { if ( localDirty ) { local = Matrix4f( rotation * Matrix3f::Scale(scale), translation ); localDirty = false; } return local; }
+
+	//!@name World and camera transformations
+
+	//! Returns the world matrix, which transforms the local space of the node to world space.
+	Matrix4f const & GetWorldMatrix() const;
+	//! Returns the model-view matrix for the camera, the view matrix of the camera times the world matrix.
+	Matrix4f const & GetModelView( Camera const &camera ) const { return CameraMatrices(camera).modelView; }
+	//! Returns the model-view-projection matrix for the camera, the view-projection matrix of the camera times the world matrix.
+	Matrix4f const & GetMVP( Camera const &camera ) const { return CameraMatrices(camera).mvp; }
+
+	//!@name Bounds
+
+	//! Sets the bounding box in the local space of the node.
+	void SetBounds( Vec3f const &bmin, Vec3f const &bmax ) { boundMin = bmin; boundMax = bmax; boundsDirty = true; }
+	//! Sets the bounding box to the bounding box of the given points in the local space of the node.
+	void SetBounds( Vec3f const *points, size_t n ) { Vec3f bmin, bmax; BatchTransform::ComputeBounds( points, n, bmin, bmax ); SetBounds( bmin, bmax ); }
+
+	bool  IsBoundBoxReady() const { return boundMin.x<=boundMax.x && boundMin.y<=boundMax.y && boundMin.z<=boundMax.z; }	//!< Returns true if the bounding box is set.
+	Vec3f GetBoundMin() const { return boundMin; }								//!< Returns the minimum of the local bounding box.
+	Vec3f GetBoundMax() const { return boundMax; }								//!< Returns the maximum of the local bounding box.
+	Vec3f GetBoundCenter() const { return ( boundMin + boundMax ) * 0.5f; }		//!< Returns the center of the local bounding box.
+
+	//! Returns the axis-aligned bounding box of the transformed local bounding box in world space.
+	void GetWorldBounds( Vec3f &bmin, Vec3f &bmax ) const;
+
+private:
+	struct CameraCache
+	{
+		Camera const *camera;
+		unsigned int  cameraRevision;
+		unsigned int  worldRevision;
+		Matrix4f      modelView;
+		Matrix4f      mvp;
+	};
+
+	TransformNode               *parent;
+	std::vector<TransformNode*>  children;
+	Vec3f                        translation;
+	Matrix3f                     rotation;
+	Vec3f                        scale;
+	Vec3f                        boundMin, boundMax;
+
+	mutable Matrix4f                 local;
+	mutable Matrix4f                 world;
+	mutable Vec3f                    worldBoundMin, worldBoundMax;
+	mutable std::vector<CameraCache> cameras;
+	mutable bool                     localDirty, worldDirty, boundsDirty;
+	mutable unsigned int             worldRevision;	// incremented when the world matrix is recomputed
+
+	void LocalChanged() { localDirty = true; WorldChanged(); }
+	void WorldChanged();
+	CameraCache const & CameraMatrices( Camera const &camera ) const;
+};
+
+//-------------------------------------------------------------------------------
+
+inline TransformNode::~TransformNode()
+{
+	SetParent( nullptr );
+	for ( size_t i=0; i<children.size(); i++ ) {
+		children[i]->parent = nullptr;
+		children[i]->WorldChanged();
+	}
+}
+
+inline void TransformNode::SetParent( TransformNode *p )
+{
+	if ( p == parent ) return;
+#ifndef NDEBUG
+	for ( TransformNode const *a = p; a; a = a->parent ) assert( a != this );	// the node cannot be its own ancestor
+#endif
+	if ( parent ) parent->children.erase( std::find( parent->children.begin(), parent->children.end(), this ) );
+	parent = p;
+	if ( parent ) parent->children.push_back( this );
+	WorldChanged();
+}
+
+inline void TransformNode::WorldChanged()
+{
+	// The descendants of a dirty node are always dirty, because a node can be updated only after its ancestors,
+	// so the marking stops at the nodes that are already dirty.
+	if ( worldDirty ) return;
+	worldDirty  = true;
+	boundsDirty = true;
+	for ( size_t i=0; i<children.size(); i++ ) children[i]->WorldChanged();
+}
+
+inline Matrix4f const & TransformNode::GetWorldMatrix() const
+{
+	if ( worldDirty ) {
+		if ( parent ) world = parent->GetWorldMatrix() * GetLocalMatrix();
+		else world = GetLocalMatrix();
+		worldDirty = false;
+		worldRevision++;
+	}
+	return world;
+}
+
+inline TransformNode::CameraCache const & TransformNode::CameraMatrices( Camera const &camera ) const
+{
+	GetWorldMatrix();
+	CameraCache *c = nullptr;
+	for ( size_t i=0; i<cameras.size(); i++ ) {
+		if ( cameras[i].camera == &camera ) { c = &cameras[i]; break; }
+	}
+	if ( ! c ) {
+		cameras.push_back( CameraCache() );
+		c = &cameras.back();
+		c->camera = &camera;
+		c->cameraRevision = camera.GetRevision() - 1;
+	}
+	if ( c->cameraRevision != camera.GetRevision() || c->worldRevision != worldRevision ) {
+		c->modelView = camera.GetView() * world;
+		c->mvp = camera.GetViewProjection() * world;
+		c->cameraRevision = camera.GetRevision();
+		c->worldRevision  = worldRevision;
+	}
+	return *c;
+}
+
+inline void TransformNode::GetWorldBounds( Vec3f &bmin, Vec3f &bmax ) const
+{
+	Matrix4f const &m = GetWorldMatrix();
+	if ( boundsDirty && ! IsBoundBoxReady() ) {
+		worldBoundMin = boundMin;
+		worldBoundMax = boundMax;
+		boundsDirty = false;
+	}
+	if ( boundsDirty ) {
+		// The center of the box is transformed, and the extent along each world axis is the sum of the
+		// extents along the local axes, scaled by the absolute values of the matrix elements.
+		Vec3f center = GetBoundCenter();
+		Vec3f extent = ( boundMax - boundMin ) * 0.5f;
+		Vec3f wc = Vec3f( m * center );
+		Vec3f we;
+		for ( int r=0; r<3; r++ ) we[r] = std::abs(m.cell[r])*extent.x + std::abs(m.cell[4+r])*extent.y + std::abs(m.cell[8+r])*extent.z;
+		worldBoundMin = wc - we;
+		worldBoundMax = wc + we;
+		boundsDirty = false;
+	}
+	bmin = worldBoundMin;
+	bmax = worldBoundMax;
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::Camera        cyCamera;			//!< A view and projection transformation
+typedef cy::TransformNode cyTransformNode;	//!< A node of a transformation hierarchy
+
+//-------------------------------------------------------------------------------
+
+#endif
@@ -6,7 +6,9 @@
 #include "cyCodeBase/cyVector.h"
 #include "cyCodeBase/cyMatrix.h"
 #include "cyCodeBase/cyTriMesh.h"
+#include "cyCodeBase/cyMeshCache.h"
 #include "cyCodeBase/cyGL.h"
+#include "cyCodeBase/cyTransformNode.h"
 
 // number of vertices in given obj
 int num_v;
@@ -43,32 +45,26 @@ GLuint vs_id;
 GLuint fs_id;
 GLuint mvp;
 
+// object transformation and camera, which cache the mvp matrix between frames
+cyTransformNode object;
+cyCamera camera;
+
 // find center x & y points to translate to
-cyVec3f findCenter(std::vector<GLfloat> vertices)
+cyVec3f findCenter()
 {
-    GLfloat min_x = vertices[0], max_x = vertices[0];
-    GLfloat min_y = vertices[1], max_y = vertices[1];
-
-    for (size_t i = 0; i < vertices.size(); i += 3)
-    {
-        GLfloat x = vertices[i];
-        GLfloat y = vertices[i + 1];
-
-        min_x = std::min(min_x, x);
-        max_x = std::max(max_x, x);
-
-        min_y = std::min(min_y, y);
-        max_y = std::max(max_y, y);
-    }
-
-    GLfloat center_x = min_x + ((max_x - min_x) / 2.0f);
-    GLfloat center_y = min_y + ((max_y - min_y) / 2.0f);
+    cyVec3f center = object.GetBoundCenter();
+    return cyVec3f(center.x, center.y, depth);
+}
 
-    return cyVec3f(center_x, center_y, depth);
+// update object transformation after rotation or zoom
+void updateObject()
+{
+    object.SetTranslation(findCenter());
+    object.SetRotationXYZ(rot_x, rot_y, 0);
 }
 
-// calculate MVP matrix
-cyMatrix4f getMVP(bool ortho)
+// update projection matrix after resize or projection switch
+void updateCamera()
 {
     // near and far planes
     float near_p = depth - depth;
@@ -83,7 +79,7 @@ cyMatrix4f getMVP(bool ortho)
         persp_m.Normalize();
     }
 
-    return (persp_m * cyMatrix4f::Translation(findCenter(vertices)) * cyMatrix4f::RotationXYZ(rot_x, rot_y, 0));
+    camera.SetProjection(persp_m);
 }
 
 // generate vertex buffer object and bind data
@@ -99,7 +95,8 @@ GLuint getVBO(int argc, const char *filename)
     // read vertex data
     bool read_status;
     cyTriMesh reader;
-    if (!(read_status = reader.LoadFromFileObj(filename, false)))
+    cyMeshCache cache;
+    if (!(read_status = cache.LoadFromFileObj(reader, filename, false)))
     {
         fprintf(stderr, "Error: cannot read file");
         exit(1);
@@ -115,6 +112,7 @@ GLuint getVBO(int argc, const char *filename)
         vertices.push_back(_verts[1]);
         vertices.push_back(_verts[2]);
     }
+    object.SetBounds(&reader.V(0), num_v);
 
     // generate and bind vertex buffer object
     GLuint vbo_id;
@@ -180,6 +178,7 @@ void resize(int w, int h)
     width = w;
     height = h;
     aspect = width / height;
+    updateCamera();
 }
 
 // display function
@@ -190,9 +189,7 @@ void draw()
     glUseProgram(program_id);
 
     // calculate and set mvp matrix
-    float matrix[16];
-    getMVP(ortho).Get(matrix);
-    glUniformMatrix4fv(mvp, 1, false, matrix);
+    glUniformMatrix4fv(mvp, 1, false, object.GetMVP(camera).cell);
 
     // draw
     glDrawArrays(GL_POINTS, 0, num_v);
@@ -212,6 +209,7 @@ void keyListener(unsigned char key, int x, int y)
     case 'p':
     case 'P':
         ortho = !ortho;
+        updateCamera();
         break;
     case 27:
         glutLeaveMainLoop();
@@ -258,6 +256,7 @@ void mouseMotion(int x, int y)
         else if (prev_x > x) // cursor moves left
             rot_y -= 0.02;   // rotate along y-axis
         prev_x = x;
+        updateObject();
     }
     // right click - start zooming
     else if (mouse_button == GLUT_RIGHT_BUTTON)
@@ -267,6 +266,8 @@ void mouseMotion(int x, int y)
         else
             depth -= 0.15; // zoom out
         prev_y_zoom = y;
+        updateObject();
+        updateCamera();
     }
     glutPostRedisplay();
 }
@@ -304,6 +305,8 @@ int main(int argc, char *argv[])
     GLuint vbo_id = getVBO(argc, argv[1]);
     compileShaders();
     setShaderVariables();
+    updateObject();
+    updateCamera();
 
     // start
     glutMainLoop();
@@ -94,6 +94,25 @@ namespace cy {
 # endif
 #endif
 
+// Detecting constant evaluation, so that functions can be constexpr and still use faster run-time implementations
+#if (__cplusplus>=201402L) || (defined(_MSVC_LANG) && _MSVC_LANG>=201402L)
+# if defined(__cpp_lib_is_constant_evaluated)
+#  define CY_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+# elif _CY_COMPILER_VER_MEETS(1925,90000,90000,99999)
+#  define CY_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+# endif
+#endif
+// Variables that are initialized with CY_CONSTEXPR functions should be declared with CY_CONSTEXPR_VAR,
+// so that they become constants initialized at run time when the functions cannot be constexpr.
+#ifdef CY_IS_CONSTANT_EVALUATED
+# define CY_CONSTEXPR constexpr
+# define CY_CONSTEXPR_VAR constexpr
+#else
+# define CY_IS_CONSTANT_EVALUATED() false
+# define CY_CONSTEXPR
+# define CY_CONSTEXPR_VAR const
+#endif
+
 // nullptr
 #if _CY_COMPILER_VER_BELOW(1600,40600,20900,1210)
 class _cy_nullptr_t {
@@ -254,7 +273,59 @@ template<> CY_NODISCARD inline double Sqrt    <double>( double v ) { __m128d t=_
 template<> CY_NODISCARD inline double SqrtSafe<double>( double v ) { __m128d t=_mm_set1_pd(Max(v,0.0)); return _mm_cvtsd_f64(_mm_sqrt_sd(t,t)); }
 #endif
 
-template<typename T> inline T Pi  () { return T(3.141592653589793238462643383279502884197169); }
+template<typename T> constexpr inline T Pi  () { return T(3.141592653589793238462643383279502884197169); }
+
+//! \cond HIDDEN_SYMBOLS
+// Implementations of math functions that can be evaluated in constant expressions. They are computed in double precision.
+struct _cy_const_math
+{
+	static CY_CONSTEXPR double Sqrt( double v )
+	{
+		if ( !( v > 0 ) ) return v == 0 ? v : std::numeric_limits<double>::quiet_NaN();
+		if ( v == std::numeric_limits<double>::infinity() ) return v;
+		double s = 1;
+		while ( v > 4    ) { v *= 0.25; s *= 2;   }
+		while ( v < 0.25 ) { v *= 4;    s *= 0.5; }
+		double r = 1;
+		for ( int i=0; i<8; ++i ) r = 0.5 * ( r + v / r );
+		return r * s;
+	}
+	// Reduces the angle to [-pi/4,pi/4] and returns the quadrant
+	static CY_CONSTEXPR int Reduce( double &a )
+	{
+		const double pi_2_hi = 1.5707963267948966;		// pi/2 split into two parts, so that the reduction is accurate
+		const double pi_2_lo = 6.123233995736766e-17;
+		double q = a / pi_2_hi;
+		long long k = (long long)( q < 0 ? q - 0.5 : q + 0.5 );
+		a = ( a - double(k)*pi_2_hi ) - double(k)*pi_2_lo;
+		return int( k & 3 );
+	}
+	static CY_CONSTEXPR double SinSeries( double a ) { double a2=a*a, t=a, s=a; for ( int k=1; k<12; ++k ) { t *= -a2 / double((2*k)*(2*k+1)); s += t; } return s; }
+	static CY_CONSTEXPR double CosSeries( double a ) { double a2=a*a, t=1, s=1; for ( int k=1; k<12; ++k ) { t *= -a2 / double((2*k-1)*(2*k)); s += t; } return s; }
+	static CY_CONSTEXPR double Sin( double a )
+	{
+		if ( !( a - a == 0 ) ) return std::numeric_limits<double>::quiet_NaN();
+		int q = Reduce(a);
+		return q==0 ? SinSeries(a) : q==1 ? CosSeries(a) : q==2 ? -SinSeries(a) : -CosSeries(a);
+	}
+	static CY_CONSTEXPR double Cos( double a )
+	{
+		if ( !( a - a == 0 ) ) return std::numeric_limits<double>::quiet_NaN();
+		int q = Reduce(a);
+		return q==0 ? CosSeries(a) : q==1 ? -SinSeries(a) : q==2 ? -CosSeries(a) : SinSeries(a);
+	}
+	static CY_CONSTEXPR double Tan( double a ) { return Sin(a) / Cos(a); }
+};
+//! \endcond
+
+//!@name Math functions that can be evaluated at compile time.
+//! They use the standard library functions at run time, and double precision series in constant expressions.
+//! If the compiler cannot detect constant evaluation, they are not constexpr.
+
+template <typename T> CY_NODISCARD inline CY_CONSTEXPR T SqrtConst( T v ) { return CY_IS_CONSTANT_EVALUATED() ? T( _cy_const_math::Sqrt(double(v)) ) : (T) std::sqrt(v); }
+template <typename T> CY_NODISCARD inline CY_CONSTEXPR T SinConst ( T a ) { return CY_IS_CONSTANT_EVALUATED() ? T( _cy_const_math::Sin (double(a)) ) : (T) std::sin (a); }
+template <typename T> CY_NODISCARD inline CY_CONSTEXPR T CosConst ( T a ) { return CY_IS_CONSTANT_EVALUATED() ? T( _cy_const_math::Cos (double(a)) ) : (T) std::cos (a); }
+template <typename T> CY_NODISCARD inline CY_CONSTEXPR T TanConst ( T a ) { return CY_IS_CONSTANT_EVALUATED() ? T( _cy_const_math::Tan (double(a)) ) : (T) std::tan (a); }
 
 template <typename T> CY_NODISCARD inline bool IsFinite( T v ) { return std::numeric_limits<T>::is_integer || std::isfinite(v); }
 
@@ -0,0 +1,134 @@
+//-------------------------------------------------------------------------------
+//! \file   cyMemoryMap.h
+//!
+//! \brief  Read-only memory-mapped files.
+//!
+//! MemoryMap maps an entire file into the address space of the process, so that
+//! its contents can be read in place without copying them through stdio buffers.
+//! The mapping is released when the object is destroyed.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_MEMORY_MAP_H_INCLUDED_
+#define _CY_MEMORY_MAP_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyCore.h"
+
+#ifdef _WIN32
+# ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+# endif
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Read-only memory-mapped file.
+//!
+//! Empty files are opened successfully, but Data() returns nullptr for them.
+
+class MemoryMap
+{
+public:
+	MemoryMap() : data(nullptr), size(0), isOpen(false) { InitHandles(); }
+	~MemoryMap() { Close(); }
+
+	//!@name Open and Close
+	bool Open( char const *filename, bool sequential=true );	//!< Maps the given file. If sequential is true, the OS is told that the data will be read front to back.
+	void Close();												//!< Releases the mapping.
+
+	//!@name Access
+	bool        IsOpen() const { return isOpen; }				//!< Returns true if a file is mapped.
+	char const* Data  () const { return data; }					//!< Returns the first byte of the file.
+	char const* End   () const { return data + size; }			//!< Returns the byte past the end of the file.
+	size_t      Size  () const { return size; }					//!< Returns the size of the file in bytes.
+
+private:
+	char const *data;
+	size_t      size;
+	bool        isOpen;
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE mapping;
+	void InitHandles() { file=INVALID_HANDLE_VALUE; mapping=nullptr; }
+#else
+	void InitHandles() {}
+#endif
+
+	MemoryMap( MemoryMap const & ) CY_CLASS_FUNCTION_DELETE
+	MemoryMap& operator = ( MemoryMap const & ) CY_CLASS_FUNCTION_DELETE
+};
+
+//-------------------------------------------------------------------------------
+
+inline bool MemoryMap::Open( char const *filename, bool sequential )
+{
+	Close();
+#ifdef _WIN32
+	file = CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, nullptr );
+	if ( file == INVALID_HANDLE_VALUE ) return false;
+	LARGE_INTEGER fileSize;
+	if ( !GetFileSizeEx( file, &fileSize ) ) { Close(); return false; }
+	size = (size_t) fileSize.QuadPart;
+	if ( size > 0 ) {
+		mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+		if ( !mapping ) { Close(); return false; }
+		data = (char const *) MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+		if ( !data ) { Close(); return false; }
+	}
+#else
+	int fd = open( filename, O_RDONLY );
+	if ( fd < 0 ) return false;
+	struct stat st;
+	if ( fstat( fd, &st ) != 0 ) { close(fd); return false; }
+	size = (size_t) st.st_size;
+	if ( size > 0 ) {
+		void *p = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if ( p == MAP_FAILED ) { close(fd); size=0; return false; }
+		data = (char const *) p;
+# ifdef POSIX_MADV_SEQUENTIAL
+		if ( sequential ) posix_madvise( p, size, POSIX_MADV_SEQUENTIAL );
+# endif
+	}
+	close(fd);	// the mapping keeps its own reference to the file
+#endif
+	isOpen = true;
+	return true;
+}
+
+inline void MemoryMap::Close()
+{
+#ifdef _WIN32
+	if ( data ) UnmapViewOfFile( data );
+	if ( mapping ) CloseHandle( mapping );
+	if ( file != INVALID_HANDLE_VALUE ) CloseHandle( file );
+	InitHandles();
+#else
+	if ( data ) munmap( (void*) data, size );
+#endif
+	data   = nullptr;
+	size   = 0;
+	isOpen = false;
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::MemoryMap cyMemoryMap;	//!< Read-only memory-mapped file
+
+//-------------------------------------------------------------------------------
+
+#endif
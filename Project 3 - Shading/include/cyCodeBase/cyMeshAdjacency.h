@@ -0,0 +1,303 @@
+//-------------------------------------------------------------------------------
+//! \file   cyMeshAdjacency.h
+//!
+//! \brief  Half-edge adjacency of triangle meshes and edge extraction.
+//!
+//! MeshAdjacency finds the opposite (twin) half-edge of every half-edge of an
+//! indexed triangle mesh in linear time. On top of the adjacency, it extracts
+//! the silhouette edges for a given view point and the feature edges (border
+//! edges and sharp edges) as line index buffers, so that outlines can be drawn
+//! with GL_LINES without amplifying every triangle in a geometry shader. It also
+//! generates index buffers for GL_TRIANGLES_ADJACENCY, so that silhouettes can
+//! be detected on the GPU instead.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_MESH_ADJACENCY_H_INCLUDED_
+#define _CY_MESH_ADJACENCY_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyTriMesh.h"
+#include <vector>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Half-edge adjacency of an indexed triangle mesh.
+//!
+//! Half-edge i is the edge from corner i to the next corner of triangle i/3, so
+//! the half-edges are implicit in the index buffer and only the twins are stored.
+//! An edge shared by exactly two triangles with opposite orientations is a
+//! manifold edge and its half-edges are twins of each other. Border edges and
+//! non-manifold edges (shared by more than two triangles or by two triangles
+//! with the same orientation) have no twin.
+//!
+//! The adjacency should be built from indices that refer to positions only, like
+//! the faces of a TriMesh, since vertices that are split along normal or texture
+//! seams would turn the seams into border edges.
+
+class MeshAdjacency
+{
+public:
+	enum : unsigned int { NONE = 0xFFFFFFFF };	//!< Index of a missing half-edge or vertex
+
+	//!@name Building
+	//! Builds the adjacency of the faces of the given mesh.
+	void Build( TriMesh const &mesh, unsigned int numThreads=1 ) { Build( mesh.NF() > 0 ? mesh.F(0).v : nullptr, (size_t) mesh.NF()*3, mesh.NV(), numThreads ); }
+	//! Builds the adjacency of the given triangles. The index array is copied.
+	//! The twins are found using the given number of threads (0 uses all hardware threads).
+	void Build( unsigned int const *indices, size_t numIndices, unsigned int numVertices, unsigned int numThreads=1 );
+
+	//!@name Half-edges
+	unsigned int NumHalfEdges () const { return (unsigned int) indices.size(); }		//!< Returns the number of half-edges, which is three times the number of triangles.
+	unsigned int NumTriangles () const { return (unsigned int) indices.size() / 3; }	//!< Returns the number of triangles.
+	unsigned int NumVertices  () const { return numVertices; }							//!< Returns the number of vertices.
+	unsigned int NumEdges     () const { return (unsigned int) edges.size(); }		//!< Returns the number of unique edges.
+	unsigned int NumBorderEdges     () const { return numBorder; }					//!< Returns the number of edges with a single triangle.
+	unsigned int NumNonManifoldEdges() const { return numNonManifold; }				//!< Returns the number of half-edges that are on non-manifold edges.
+	unsigned int Twin  ( unsigned int h ) const { return twin[h]; }					//!< Returns the opposite half-edge, or NONE.
+	unsigned int Origin( unsigned int h ) const { return indices[h]; }				//!< Returns the vertex that the half-edge starts from.
+	unsigned int Target( unsigned int h ) const { return indices[ Next(h) ]; }		//!< Returns the vertex that the half-edge ends at.
+	unsigned int Edge  ( unsigned int e ) const { return edges[e]; }				//!< Returns a half-edge of the given edge.
+	bool IsBorder( unsigned int h ) const { return twin[h] == NONE; }				//!< Returns true if the half-edge has no twin.
+	bool IsManifold() const { return numBorder == 0 && numNonManifold == 0; }		//!< Returns true if every half-edge has a twin.
+	//! Returns an outgoing half-edge of the given vertex, or NONE if the vertex is not used.
+	//! For vertices on the border, the returned half-edge is a border half-edge if the vertex has one.
+	unsigned int VertexHalfEdge( unsigned int v ) const { return vertexHalfEdge[v]; }
+	static unsigned int Next    ( unsigned int h ) { return h - h%3 + (h%3+1)%3; }	//!< Returns the next half-edge of the triangle.
+	static unsigned int Prev    ( unsigned int h ) { return h - h%3 + (h%3+2)%3; }	//!< Returns the previous half-edge of the triangle.
+	static unsigned int Triangle( unsigned int h ) { return h / 3; }					//!< Returns the triangle of the half-edge.
+
+	//!@name Adjacency index buffers
+	//! Writes six indices per triangle for drawing with GL_TRIANGLES_ADJACENCY: the three vertices of the triangle
+	//! at the even positions, and the vertex of the adjacent triangle opposite to each edge at the odd positions.
+	//! For border and non-manifold edges, the opposite vertex of the triangle itself is used, so the adjacent
+	//! triangle has the reverse orientation and a silhouette test in the geometry shader always keeps the edge.
+	void GetTrianglesAdjacency( std::vector<unsigned int> &adjacencyIndices ) const;
+
+	//!@name Edge extraction
+	//! Computes the plane of each triangle from the given positions, which are read with the given stride in bytes.
+	//! The planes must be computed before extracting silhouette or feature edges.
+	void SetPositions( Vec3f const *positions, size_t positionStride=sizeof(Vec3f), unsigned int numThreads=1 );
+	//! Writes the vertex pairs of the border edges and of the edges where the angle between the normals of the two
+	//! triangles is larger than the given angle in radians. Returns the number of edges.
+	unsigned int FeatureEdges( std::vector<unsigned int> &lineIndices, float minAngle ) const;
+	//! Writes the vertex pairs of the silhouette edges for the given view point in model space, in homogeneous
+	//! coordinates: w=1 for a perspective camera position, and w=0 for the direction towards an orthographic camera.
+	//! An edge is a silhouette edge if one of its triangles faces the view point and the other does not.
+	//! Border edges are included if includeBorders is true. The edges are written in the order of NumEdges,
+	//! using the given number of threads (0 uses all hardware threads). Returns the number of edges.
+	unsigned int SilhouetteEdges( std::vector<unsigned int> &lineIndices, Vec4f const &viewPoint, bool includeBorders=true, unsigned int numThreads=1 ) const;
+
+private:
+	std::vector<unsigned int> indices;
+	std::vector<unsigned int> twin;
+	std::vector<unsigned int> edges;			// one half-edge per edge: the half-edge with the smaller index, or a half-edge without a twin
+	std::vector<unsigned int> vertexHalfEdge;
+	std::vector<Vec4f>        planes;			// normalized triangle normal and the negative distance to the origin
+	mutable std::vector<unsigned char> facing;
+	mutable std::vector< std::vector<unsigned int> > threadLines;
+	unsigned int numVertices    = 0;
+	unsigned int numBorder      = 0;
+	unsigned int numNonManifold = 0;
+
+	static unsigned int NumThreads( unsigned int numThreads, size_t n );
+	template <typename FUNC> static void ParallelFor( unsigned int n, FUNC func );
+};
+
+//-------------------------------------------------------------------------------
+
+inline unsigned int MeshAdjacency::NumThreads( unsigned int numThreads, size_t n )
+{
+	const size_t minItemsPerThread = 1 << 16;
+	if ( numThreads == 0 ) numThreads = std::thread::hardware_concurrency();
+	size_t maxThreads = n / minItemsPerThread;
+	if ( numThreads > maxThreads ) numThreads = (unsigned int) maxThreads;
+	return numThreads < 1 ? 1 : numThreads;
+}
+
+template <typename FUNC>
+inline void MeshAdjacency::ParallelFor( unsigned int n, FUNC func )
+{
+	std::vector<std::thread> threads;
+	for ( unsigned int i=1; i<n; i++ ) threads.push_back( std::thread( func, i ) );
+	if ( n > 0 ) func(0);
+	for ( size_t i=0; i<threads.size(); i++ ) threads[i].join();
+}
+
+//-------------------------------------------------------------------------------
+
+inline void MeshAdjacency::Build( unsigned int const *idx, size_t numIndices, unsigned int numVerts, unsigned int numThreads )
+{
+	numIndices -= numIndices % 3;
+	indices.assign( idx, idx + numIndices );
+	numVertices = numVerts;
+	unsigned int nh = (unsigned int) numIndices;
+
+	// Outgoing half-edges of each vertex, sorted by the origin vertex with a counting sort
+	std::vector<unsigned int> first( numVertices + 1, 0 );
+	for ( unsigned int h=0; h<nh; h++ ) first[ indices[h] + 1 ]++;
+	for ( unsigned int v=0; v<numVertices; v++ ) first[v+1] += first[v];
+	std::vector<unsigned int> outgoing( nh );
+	{
+		std::vector<unsigned int> pos( first.begin(), first.end() - 1 );
+		for ( unsigned int h=0; h<nh; h++ ) outgoing[ pos[ indices[h] ]++ ] = h;
+	}
+
+	// The twin of a->b is the only half-edge b->a, if a->b is also the only half-edge from a to b.
+	// Each half-edge is processed independently, so the half-edges are partitioned among the threads.
+	twin.resize( nh );
+	unsigned int n = NumThreads( numThreads, nh );
+	ParallelFor( n, [&]( unsigned int t ) {
+		unsigned int hBegin = (unsigned int)( (uint64_t) nh * t / n );
+		unsigned int hEnd   = (unsigned int)( (uint64_t) nh * (t+1) / n );
+		for ( unsigned int h=hBegin; h<hEnd; h++ ) {
+			unsigned int a = indices[h];
+			unsigned int b = indices[ Next(h) ];
+			unsigned int match = NONE, numMatches = 0, numSame = 0;
+			for ( unsigned int i=first[b]; i<first[b+1]; i++ ) {
+				unsigned int o = outgoing[i];
+				if ( indices[ Next(o) ] == a ) { match = o; numMatches++; }
+			}
+			for ( unsigned int i=first[a]; i<first[a+1]; i++ ) {
+				if ( indices[ Next(outgoing[i]) ] == b ) numSame++;
+			}
+			twin[h] = ( numMatches == 1 && numSame == 1 && a != b ) ? match : NONE;
+		}
+	});
+
+	// Edges, border and non-manifold counts, and vertex half-edges
+	edges.clear();
+	numBorder = 0;
+	numNonManifold = 0;
+	vertexHalfEdge.assign( numVertices, NONE );
+	for ( unsigned int h=0; h<nh; h++ ) {
+		unsigned int a = indices[h];
+		if ( twin[h] == NONE ) {
+			edges.push_back( h );
+			// The half-edge is on a non-manifold edge if another half-edge connects the same vertices
+			unsigned int b = indices[ Next(h) ];
+			bool shared = false;
+			for ( unsigned int i=first[b]; i<first[b+1] && !shared; i++ ) shared = indices[ Next(outgoing[i]) ] == a;
+			for ( unsigned int i=first[a]; i<first[a+1] && !shared; i++ ) shared = outgoing[i] != h && indices[ Next(outgoing[i]) ] == b;
+			if ( shared ) numNonManifold++; else numBorder++;
+			vertexHalfEdge[a] = h;
+		} else {
+			if ( h < twin[h] ) edges.push_back( h );
+			if ( vertexHalfEdge[a] == NONE ) vertexHalfEdge[a] = h;
+		}
+	}
+	planes.clear();
+}
+
+//-------------------------------------------------------------------------------
+
+inline void MeshAdjacency::GetTrianglesAdjacency( std::vector<unsigned int> &adjacencyIndices ) const
+{
+	adjacencyIndices.resize( indices.size() * 2 );
+	for ( unsigned int h=0; h<indices.size(); h++ ) {
+		unsigned int t = twin[h];
+		adjacencyIndices[ 2*h     ] = indices[h];
+		adjacencyIndices[ 2*h + 1 ] = indices[ Prev( t != NONE ? t : h ) ];
+	}
+}
+
+//-------------------------------------------------------------------------------
+
+inline void MeshAdjacency::SetPositions( Vec3f const *positions, size_t positionStride, unsigned int numThreads )
+{
+	unsigned int nt = NumTriangles();
+	planes.resize( nt );
+	unsigned int n = NumThreads( numThreads, nt );
+	ParallelFor( n, [&]( unsigned int t ) {
+		unsigned int fBegin = (unsigned int)( (uint64_t) nt * t / n );
+		unsigned int fEnd   = (unsigned int)( (uint64_t) nt * (t+1) / n );
+		for ( unsigned int f=fBegin; f<fEnd; f++ ) {
+			Vec3f const &p0 = *(Vec3f const *)( (char const *) positions + positionStride * indices[3*f  ] );
+			Vec3f const &p1 = *(Vec3f const *)( (char const *) positions + positionStride * indices[3*f+1] );
+			Vec3f const &p2 = *(Vec3f const *)( (char const *) positions + positionStride * indices[3*f+2] );
+			Vec3f nrm = (p1 - p0) ^ (p2 - p0);
+			float len = nrm.Length();
+			if ( len > 0 ) nrm /= len;
+			planes[f] = Vec4f( nrm, -(nrm % p0) );
+		}
+	});
+}
+
+inline unsigned int MeshAdjacency::FeatureEdges( std::vector<unsigned int> &lineIndices, float minAngle ) const
+{
+	lineIndices.clear();
+	float cosAngle = std::cos( minAngle );
+	for ( size_t e=0; e<edges.size(); e++ ) {
+		unsigned int h = edges[e];
+		unsigned int t = twin[h];
+		if ( t != NONE ) {
+			Vec4f const &p0 = planes[ Triangle(h) ];
+			Vec4f const &p1 = planes[ Triangle(t) ];
+			if ( p0.x*p1.x + p0.y*p1.y + p0.z*p1.z >= cosAngle ) continue;
+		}
+		lineIndices.push_back( indices[h] );
+		lineIndices.push_back( indices[ Next(h) ] );
+	}
+	return (unsigned int) lineIndices.size() / 2;
+}
+
+inline unsigned int MeshAdjacency::SilhouetteEdges( std::vector<unsigned int> &lineIndices, Vec4f const &viewPoint, bool includeBorders, unsigned int numThreads ) const
+{
+	unsigned int nt = NumTriangles();
+	unsigned int ne = NumEdges();
+	facing.resize( nt );
+
+	// First the facing of the triangles, then the edges of each thread are written to a separate
+	// array, and the arrays are concatenated in order.
+	unsigned int n = NumThreads( numThreads, nt );
+	threadLines.resize( n );
+	ParallelFor( n, [&]( unsigned int t ) {
+		unsigned int fBegin = (unsigned int)( (uint64_t) nt * t / n );
+		unsigned int fEnd   = (unsigned int)( (uint64_t) nt * (t+1) / n );
+		for ( unsigned int f=fBegin; f<fEnd; f++ ) facing[f] = planes[f] % viewPoint > 0;
+	});
+	ParallelFor( n, [&]( unsigned int t ) {
+		unsigned int eBegin = (unsigned int)( (uint64_t) ne * t / n );
+		unsigned int eEnd   = (unsigned int)( (uint64_t) ne * (t+1) / n );
+		std::vector<unsigned int> &lines = threadLines[t];
+		lines.clear();
+		for ( unsigned int e=eBegin; e<eEnd; e++ ) {
+			unsigned int h = edges[e];
+			unsigned int tw = twin[h];
+			bool keep = ( tw == NONE ) ? includeBorders : facing[ Triangle(h) ] != facing[ Triangle(tw) ];
+			if ( keep ) {
+				lines.push_back( indices[h] );
+				lines.push_back( indices[ Next(h) ] );
+			}
+		}
+	});
+
+	if ( n == 1 ) lineIndices.swap( threadLines[0] );
+	else {
+		size_t size = 0;
+		for ( unsigned int t=0; t<n; t++ ) size += threadLines[t].size();
+		lineIndices.resize( size );
+		size_t offset = 0;
+		for ( unsigned int t=0; t<n; t++ ) {
+			std::copy( threadLines[t].begin(), threadLines[t].end(), lineIndices.begin() + offset );
+			offset += threadLines[t].size();
+		}
+	}
+	return (unsigned int) lineIndices.size() / 2;
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::MeshAdjacency cyMeshAdjacency;	//!< Half-edge adjacency of an indexed triangle mesh
+
+//-------------------------------------------------------------------------------
+
+#endif
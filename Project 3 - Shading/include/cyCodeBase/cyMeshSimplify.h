@@ -0,0 +1,460 @@
+//-------------------------------------------------------------------------------
+//! \file   cyMeshSimplify.h
+//!
+//! \brief  Mesh simplification and level of detail selection.
+//!
+//! MeshSimplifier reduces the number of triangles of a welded mesh by collapsing
+//! edges in the order of their quadric error (Garland and Heckbert, "Surface
+//! Simplification Using Quadric Error Metrics", SIGGRAPH 1997). Edges are
+//! collapsed onto one of their existing vertices, so the simplified index
+//! buffers use the same vertex buffer as the original mesh. Normal and texture
+//! coordinate seams, which appear as welded vertices that share a position,
+//! are preserved, and open borders only collapse along themselves.
+//!
+//! MeshLOD builds a chain of simplified levels in a single index buffer and
+//! selects a level based on the projected size of the bounding sphere.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_MESH_SIMPLIFY_H_INCLUDED_
+#define _CY_MESH_SIMPLIFY_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyMeshWeld.h"
+#include "cyMeshOptimizer.h"
+#include "cyMatrix.h"
+#include <vector>
+#include <algorithm>
+#include <cfloat>
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Quadric error metric simplifier for welded meshes.
+//!
+//! Each welded vertex is classified as manifold (it can collapse onto any
+//! neighbor), border (it can only collapse along the open border), seam (one of
+//! two welded vertices with the same position on a normal or texture coordinate
+//! seam; both collapse together along the seam), or locked. Collapses are done
+//! in passes: each pass sorts the cheapest collapse of every vertex and applies
+//! them in order, skipping the ones that touch a vertex that changed in the same
+//! pass or that would flip a triangle.
+
+class MeshSimplifier
+{
+public:
+	//! Prepares the welded mesh for simplification. The welder must not be changed afterwards.
+	void Init( TriMesh const &mesh, MeshWelder const &welder );
+
+	//! Collapses edges until the number of triangles is at most the given target, or until the error of the
+	//! next collapse would exceed maxError. Calling it again with a smaller target continues from the current
+	//! result. Returns the number of triangles.
+	unsigned int Simplify( unsigned int targetTriangles, float maxError=FLT_MAX );
+
+	unsigned int NumTriangles() const { return (unsigned int)( indices.size() / 3 ); }	//!< Returns the current number of triangles.
+	std::vector<unsigned int> const & Indices() const { return indices; }	//!< Returns the current index buffer, which uses the vertices of the welder.
+	float Error() const { return error; }	//!< Returns the largest error of the collapses so far, as an approximate distance from the original surface.
+
+	unsigned int NumLockedVertices() const { unsigned int n=0; for ( size_t i=0; i<kind.size(); i++ ) n += ( kind[i] == LOCKED ); return n; }	//!< Returns the number of vertices that cannot collapse.
+
+	MeshSimplifier() : error(0) {}
+
+private:
+	//! Symmetric 4x4 matrix of the sum of squared distances to a set of planes, with the total weight of the planes.
+	struct Quadric
+	{
+		double a[10];
+		double w;
+		void Zero() { for ( int i=0; i<10; i++ ) a[i] = 0; w = 0; }
+		void AddPlane( Vec3f const &n, float d, double weight )
+		{
+			double x=n.x, y=n.y, z=n.z, dd=d;
+			a[0] += weight*x*x; a[1] += weight*x*y; a[2] += weight*x*z; a[3] += weight*x*dd;
+			a[4] += weight*y*y; a[5] += weight*y*z; a[6] += weight*y*dd;
+			a[7] += weight*z*z; a[8] += weight*z*dd;
+			a[9] += weight*dd*dd;
+			w += weight;
+		}
+		void operator += ( Quadric const &q ) { for ( int i=0; i<10; i++ ) a[i] += q.a[i]; w += q.w; }
+		double Eval( Vec3f const &p ) const	// weighted sum of squared distances
+		{
+			double x=p.x, y=p.y, z=p.z;
+			return a[0]*x*x + 2*a[1]*x*y + 2*a[2]*x*z + 2*a[3]*x
+			     + a[4]*y*y + 2*a[5]*y*z + 2*a[6]*y
+			     + a[7]*z*z + 2*a[8]*z
+			     + a[9];
+		}
+	};
+
+	enum Kind : unsigned char { MANIFOLD, BORDER, SEAM, LOCKED };
+	enum : unsigned int { NONE = 0xFFFFFFFF };
+
+	std::vector<unsigned int> indices;
+	std::vector<Vec3f>        positions;
+	std::vector<Quadric>      quadrics;
+	std::vector<unsigned char> kind;
+	std::vector<unsigned int> sibling;		// the other welded vertex with the same position, for seam vertices
+	std::vector<unsigned int> openNext;		// the target of the open edge that leaves the vertex, for border and seam vertices
+	std::vector<unsigned int> openPrev;		// the source of the open edge that enters the vertex, for border and seam vertices
+	std::vector<unsigned int> collapsed;	// the vertex that each vertex collapsed onto, or NONE
+	float error;
+
+	unsigned int Find( unsigned int v ) { while ( collapsed[v] != NONE ) { unsigned int n = collapsed[v]; if ( collapsed[n] != NONE ) collapsed[v] = collapsed[n]; v = n; } return v; }
+	bool IsOpenNeighbor( unsigned int v, unsigned int w ) { return ( openNext[v] != NONE && Find(openNext[v]) == w ) || ( openPrev[v] != NONE && Find(openPrev[v]) == w ); }
+	unsigned int FindSeamTarget( unsigned int v, Vec3f const &p );
+	bool FlipsTriangle( unsigned int v, unsigned int w, std::vector<unsigned int> const &adjFirst, std::vector<unsigned int> const &adjacency ) const;
+	static uint64_t EdgeKey( unsigned int a, unsigned int b ) { return ( uint64_t(a) << 32 ) | b; }
+	static bool HasEdge( std::vector<uint64_t> const &edges, unsigned int a, unsigned int b ) { return std::binary_search( edges.begin(), edges.end(), EdgeKey(a,b) ); }
+};
+
+//-------------------------------------------------------------------------------
+
+//! A chain of levels of detail in a single index buffer.
+//!
+//! Level 0 is the original mesh, and each following level is simplified from
+//! the previous one. All levels use the same vertex buffer.
+
+class MeshLOD
+{
+public:
+	//! A level of detail in the index buffer.
+	struct Level
+	{
+		unsigned int firstIndex;	//!< The first index of the level in the index buffer
+		unsigned int numIndices;	//!< The number of indices of the level
+		float        error;			//!< The approximate distance of the level from the original surface, in object space
+	};
+
+	//! Builds the levels with the given ratios of the original number of triangles (in decreasing order),
+	//! and computes the bounding sphere from the bounding box of the mesh, which must already be computed.
+	//! A level is not added if the simplifier cannot reduce the previous level within maxError.
+	//! The triangles of each level are reordered for the vertex cache.
+	void Build( TriMesh const &mesh, MeshWelder const &welder, float const *ratios, int numRatios, float maxError=FLT_MAX, unsigned int cacheSize=16 );
+
+	//! Sets the levels, for example after reading them from a file, and computes the bounding sphere from the
+	//! bounding box of the mesh, which must already be computed. The index buffer is left empty.
+	void SetLevels( Level const *lvls, int numLevels, TriMesh const &mesh ) { levels.assign( lvls, lvls + numLevels ); SetBoundingSphere( mesh ); }
+
+	int NumLevels() const { return (int) levels.size(); }						//!< Returns the number of levels.
+	Level const & GetLevel( int i ) const { return levels[i]; }					//!< Returns the given level.
+	Level const * GetLevels() const { return levels.data(); }					//!< Returns the array of levels.
+	std::vector<unsigned int> const & Indices() const { return indices; }		//!< Returns the index buffer of all levels.
+	Vec3f GetBoundCenter() const { return boundCenter; }						//!< Returns the center of the bounding sphere.
+	float GetBoundRadius() const { return boundRadius; }						//!< Returns the radius of the bounding sphere.
+
+	//! Returns the radius of the bounding sphere on the screen, in pixels, for the given model-view and projection
+	//! matrices and viewport height. Returns FLT_MAX if the camera is inside the sphere.
+	float ProjectedRadius( Matrix4f const &modelView, Matrix4f const &projection, float viewportHeight ) const;
+	//! Returns the coarsest level whose error, projected with the scale of the bounding sphere, is at most the given
+	//! number of pixels.
+	int SelectLevel( Matrix4f const &modelView, Matrix4f const &projection, float viewportHeight, float pixelError=1 ) const;
+
+	MeshLOD() : boundRadius(0) {}
+
+private:
+	std::vector<Level>        levels;
+	std::vector<unsigned int> indices;
+	Vec3f boundCenter;
+	float boundRadius;
+
+	void SetBoundingSphere( TriMesh const &mesh ) { boundCenter = ( mesh.GetBoundMin() + mesh.GetBoundMax() ) * 0.5f; boundRadius = ( mesh.GetBoundMax() - mesh.GetBoundMin() ).Length() * 0.5f; }
+};
+
+//-------------------------------------------------------------------------------
+
+inline void MeshSimplifier::Init( TriMesh const &mesh, MeshWelder const &welder )
+{
+	indices = welder.Indices();
+	welder.GetPositions( mesh, positions );
+	unsigned int nv = welder.NumVertices();
+	size_t numTriangles = indices.size() / 3;
+	error = 0;
+	collapsed.assign( nv, NONE );
+
+	// Welded vertices with the same position index
+	std::vector<unsigned int> const &vertexV = welder.VertexV();
+	std::vector<unsigned int> groupHead( mesh.NV(), NONE );
+	std::vector<unsigned int> groupNext( nv, NONE );
+	std::vector<unsigned int> groupSize( mesh.NV(), 0 );
+	for ( unsigned int v=0; v<nv; v++ ) {
+		groupNext[v] = groupHead[ vertexV[v] ];
+		groupHead[ vertexV[v] ] = v;
+		groupSize[ vertexV[v] ]++;
+	}
+
+	// Open edges are the directed edges without an opposite edge. They are borders if the edge between
+	// the positions is also open, and seams otherwise.
+	std::vector<uint64_t> edges( numTriangles*3 ), posEdges( numTriangles*3 );
+	for ( size_t t=0; t<numTriangles; t++ ) {
+		for ( int j=0; j<3; j++ ) {
+			unsigned int a = indices[t*3+j], b = indices[t*3+(j+1)%3];
+			edges   [t*3+j] = EdgeKey( a, b );
+			posEdges[t*3+j] = EdgeKey( vertexV[a], vertexV[b] );
+		}
+	}
+	std::sort( edges.begin(), edges.end() );
+	std::sort( posEdges.begin(), posEdges.end() );
+
+	std::vector<unsigned char> openOut( nv, 0 ), openIn( nv, 0 ), numBorder( nv, 0 );
+	openNext.assign( nv, NONE );
+	openPrev.assign( nv, NONE );
+	quadrics.resize( nv );
+	for ( unsigned int v=0; v<nv; v++ ) quadrics[v].Zero();
+	for ( size_t t=0; t<numTriangles; t++ ) {
+		unsigned int const *f = &indices[t*3];
+		Vec3f const &p0 = positions[f[0]], &p1 = positions[f[1]], &p2 = positions[f[2]];
+		Vec3f n = ( p1 - p0 ) ^ ( p2 - p0 );
+		float area2 = n.Length();
+		if ( area2 > 0 ) n /= area2;
+		// Plane quadric, weighted by the triangle area
+		Quadric q;
+		q.Zero();
+		q.AddPlane( n, -( n % p0 ), area2 * 0.5 );
+		for ( int j=0; j<3; j++ ) quadrics[f[j]] += q;
+		for ( int j=0; j<3; j++ ) {
+			unsigned int a = f[j], b = f[(j+1)%3];
+			if ( HasEdge( edges, b, a ) ) continue;
+			if ( openOut[a] < 255 ) openOut[a]++;
+			if ( openIn [b] < 255 ) openIn [b]++;
+			openNext[a] = b;
+			openPrev[b] = a;
+			if ( ! HasEdge( posEdges, vertexV[b], vertexV[a] ) ) { if ( numBorder[a] < 255 ) numBorder[a]++; if ( numBorder[b] < 255 ) numBorder[b]++; }
+			// A plane perpendicular to the triangle through the open edge keeps borders and seams in place
+			Vec3f e = positions[b] - positions[a];
+			float len2 = e % e;
+			Vec3f m = e ^ n;
+			float mlen = m.Length();
+			if ( mlen > 0 ) {
+				m /= mlen;
+				Quadric qe;
+				qe.Zero();
+				qe.AddPlane( m, -( m % positions[a] ), len2 * 4 );
+				quadrics[a] += qe;
+				quadrics[b] += qe;
+			}
+		}
+	}
+
+	// Classify the vertices
+	kind.assign( nv, LOCKED );
+	sibling.assign( nv, NONE );
+	for ( unsigned int v=0; v<nv; v++ ) {
+		unsigned int size = groupSize[ vertexV[v] ];
+		if ( size == 1 ) {
+			if ( openOut[v] == 0 && openIn[v] == 0 ) kind[v] = MANIFOLD;
+			else if ( openOut[v] == 1 && openIn[v] == 1 && numBorder[v] == 2 ) kind[v] = BORDER;
+		} else if ( size == 2 ) {
+			unsigned int s = groupHead[ vertexV[v] ];
+			if ( s == v ) s = groupNext[v];
+			bool seam = true;
+			unsigned int pair[2] = { v, s };
+			for ( int k=0; k<2; k++ ) {
+				unsigned int u = pair[k];
+				if ( openOut[u] != 1 || openIn[u] != 1 || numBorder[u] != 0 ) seam = false;
+			}
+			if ( seam ) { kind[v] = SEAM; sibling[v] = s; }
+		}
+	}
+}
+
+inline unsigned int MeshSimplifier::FindSeamTarget( unsigned int v, Vec3f const &p )
+{
+	unsigned int c[2] = { openNext[v], openPrev[v] };
+	for ( int k=0; k<2; k++ ) {
+		if ( c[k] == NONE ) continue;
+		unsigned int w = Find( c[k] );
+		if ( positions[w] == p ) return w;
+	}
+	return NONE;
+}
+
+inline bool MeshSimplifier::FlipsTriangle( unsigned int v, unsigned int w, std::vector<unsigned int> const &adjFirst, std::vector<unsigned int> const &adjacency ) const
+{
+	Vec3f const &pw = positions[w];
+	for ( unsigned int k=adjFirst[v]; k<adjFirst[v+1]; k++ ) {
+		unsigned int const *f = &indices[ adjacency[k]*3 ];
+		if ( f[0] == w || f[1] == w || f[2] == w ) continue;	// this triangle is removed
+		int j = ( f[0] == v ) ? 0 : ( f[1] == v ? 1 : 2 );
+		Vec3f const &p1 = positions[ f[(j+1)%3] ];
+		Vec3f const &p2 = positions[ f[(j+2)%3] ];
+		Vec3f n0 = ( p1 - positions[v] ) ^ ( p2 - positions[v] );
+		Vec3f n1 = ( p1 - pw ) ^ ( p2 - pw );
+		if ( ( n0 % n1 ) <= 0.25f * n0.Length() * n1.Length() ) return true;	// flipped or turned by more than about 75 degrees
+	}
+	return false;
+}
+
+inline unsigned int MeshSimplifier::Simplify( unsigned int targetTriangles, float maxError )
+{
+	unsigned int nv = (unsigned int) positions.size();
+	double maxCost = (double) maxError * maxError;
+	std::vector<unsigned int> adjFirst( nv + 1 ), adjacency;
+	std::vector<double> bestCost( nv );
+	std::vector<unsigned int> bestTarget( nv ), order;
+	std::vector<unsigned char> changed( nv );
+
+	while ( NumTriangles() > targetTriangles ) {
+		size_t numTriangles = NumTriangles();
+
+		// Vertex to triangle adjacency
+		std::fill( adjFirst.begin(), adjFirst.end(), 0 );
+		for ( size_t i=0; i<indices.size(); i++ ) adjFirst[ indices[i] + 1 ]++;
+		for ( unsigned int v=0; v<nv; v++ ) adjFirst[v+1] += adjFirst[v];
+		adjacency.resize( indices.size() );
+		{
+			std::vector<unsigned int> pos( adjFirst.begin(), adjFirst.end()-1 );
+			for ( size_t i=0; i<indices.size(); i++ ) adjacency[ pos[ indices[i] ]++ ] = (unsigned int)( i / 3 );
+		}
+
+		// The cheapest valid collapse of each vertex
+		std::fill( bestCost.begin(), bestCost.end(), DBL_MAX );
+		std::fill( bestTarget.begin(), bestTarget.end(), (unsigned int) NONE );
+		for ( size_t i=0; i<indices.size(); i++ ) {
+			unsigned int v = indices[i];
+			unsigned int w = indices[ i - i%3 + (i%3+1)%3 ];
+			for ( int dir=0; dir<2; dir++, std::swap(v,w) ) {
+				double cost;
+				switch ( kind[v] ) {
+					case MANIFOLD:
+						cost = quadrics[v].Eval( positions[w] ) / Max( quadrics[v].w, 1e-30 );
+						break;
+					case BORDER:
+						if ( ! IsOpenNeighbor( v, w ) ) continue;
+						cost = quadrics[v].Eval( positions[w] ) / Max( quadrics[v].w, 1e-30 );
+						break;
+					case SEAM: {
+						if ( ! IsOpenNeighbor( v, w ) ) continue;
+						unsigned int s = sibling[v];
+						unsigned int ws = FindSeamTarget( s, positions[w] );
+						if ( ws == NONE ) continue;
+						Quadric q = quadrics[v];
+						q += quadrics[s];
+						cost = q.Eval( positions[w] ) / Max( q.w, 1e-30 );
+						break;
+					}
+					default: continue;
+				}
+				cost = Max( cost, 0.0 );
+				if ( cost < bestCost[v] ) { bestCost[v] = cost; bestTarget[v] = w; }
+			}
+		}
+		order.clear();
+		for ( unsigned int v=0; v<nv; v++ ) if ( bestTarget[v] != NONE && bestCost[v] <= maxCost ) order.push_back( v );
+		if ( order.empty() ) break;
+		std::sort( order.begin(), order.end(), [&bestCost]( unsigned int a, unsigned int b ) { return bestCost[a] < bestCost[b]; } );
+
+		// Apply the collapses in order, skipping the ones next to a vertex that already changed in this pass,
+		// until about enough triangles are removed
+		std::fill( changed.begin(), changed.end(), 0 );
+		size_t toRemove = numTriangles - targetTriangles;
+		size_t removed = 0;
+		for ( size_t k=0; k<order.size() && removed<toRemove; k++ ) {
+			unsigned int v = order[k];
+			unsigned int w = bestTarget[v];
+			unsigned int s = NONE, ws = NONE;
+			if ( changed[v] || changed[w] ) continue;
+			if ( kind[v] == SEAM ) {
+				s = sibling[v];
+				ws = FindSeamTarget( s, positions[w] );
+				if ( ws == NONE || changed[s] || changed[ws] ) continue;
+			}
+			if ( FlipsTriangle( v, w, adjFirst, adjacency ) ) continue;
+			if ( s != NONE && FlipsTriangle( s, ws, adjFirst, adjacency ) ) continue;
+
+			// Lock the neighborhoods, so that the collapses in this pass do not interact
+			unsigned int moved[2] = { v, s };
+			for ( int m=0; m<2; m++ ) {
+				unsigned int u = moved[m];
+				if ( u == NONE ) continue;
+				for ( unsigned int a=adjFirst[u]; a<adjFirst[u+1]; a++ ) {
+					unsigned int const *f = &indices[ adjacency[a]*3 ];
+					changed[f[0]] = changed[f[1]] = changed[f[2]] = 1;
+				}
+			}
+			collapsed[v] = w;
+			quadrics[w] += quadrics[v];
+			removed += ( kind[v] == BORDER ) ? 1 : 2;
+			if ( s != NONE ) {
+				collapsed[s] = ws;
+				quadrics[ws] += quadrics[s];
+			}
+			error = Max( error, (float) std::sqrt( bestCost[v] ) );
+		}
+		if ( removed == 0 ) break;
+
+		// Update the index buffer and remove the degenerate triangles
+		size_t n = 0;
+		for ( size_t t=0; t<numTriangles; t++ ) {
+			unsigned int a = Find( indices[t*3+0] );
+			unsigned int b = Find( indices[t*3+1] );
+			unsigned int c = Find( indices[t*3+2] );
+			if ( a == b || b == c || c == a ) continue;
+			indices[n++] = a;
+			indices[n++] = b;
+			indices[n++] = c;
+		}
+		indices.resize( n );
+	}
+	return NumTriangles();
+}
+
+//-------------------------------------------------------------------------------
+
+inline void MeshLOD::Build( TriMesh const &mesh, MeshWelder const &welder, float const *ratios, int numRatios, float maxError, unsigned int cacheSize )
+{
+	indices = welder.Indices();
+	levels.clear();
+	Level level0 = { 0, (unsigned int) indices.size(), 0 };
+	levels.push_back( level0 );
+	SetBoundingSphere( mesh );
+
+	MeshSimplifier simplifier;
+	simplifier.Init( mesh, welder );
+	unsigned int numTriangles = welder.NumIndices() / 3;
+	for ( int i=0; i<numRatios; i++ ) {
+		unsigned int target = (unsigned int)( numTriangles * ratios[i] );
+		simplifier.Simplify( target, maxError );
+		std::vector<unsigned int> const &lod = simplifier.Indices();
+		if ( lod.empty() || lod.size() >= levels.back().numIndices ) continue;
+		Level level = { (unsigned int) indices.size(), (unsigned int) lod.size(), simplifier.Error() };
+		indices.insert( indices.end(), lod.begin(), lod.end() );
+		MeshOptimizer::OptimizeVertexCache( &indices[level.firstIndex], level.numIndices, welder.NumVertices(), cacheSize );
+		levels.push_back( level );
+	}
+}
+
+inline float MeshLOD::ProjectedRadius( Matrix4f const &modelView, Matrix4f const &projection, float viewportHeight ) const
+{
+	Vec4f c = modelView * boundCenter;
+	// the largest scale of the model-view matrix
+	float scale2 = 0;
+	for ( int i=0; i<3; i++ ) scale2 = Max( scale2, Vec3f( modelView.cell[i*4+0], modelView.cell[i*4+1], modelView.cell[i*4+2] ).LengthSquared() );
+	float r = boundRadius * std::sqrt( scale2 );
+	float pixels = projection.cell[5] * viewportHeight * 0.5f;	// pixels per unit at unit distance
+	if ( projection.cell[11] == 0 ) return r * pixels;			// orthographic projection
+	float dist = -c.z;
+	if ( dist <= r ) return FLT_MAX;
+	return r * pixels / std::sqrt( dist*dist - r*r );
+}
+
+inline int MeshLOD::SelectLevel( Matrix4f const &modelView, Matrix4f const &projection, float viewportHeight, float pixelError ) const
+{
+	if ( levels.empty() || boundRadius <= 0 ) return 0;
+	float pixelsPerUnit = ProjectedRadius( modelView, projection, viewportHeight ) / boundRadius;
+	int i = 0;
+	while ( i+1 < NumLevels() && levels[i+1].error * pixelsPerUnit <= pixelError ) i++;
+	return i;
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::MeshSimplifier cyMeshSimplifier;	//!< Quadric error metric simplifier for welded meshes
+typedef cy::MeshLOD        cyMeshLOD;			//!< A chain of levels of detail in a single index buffer
+
+//-------------------------------------------------------------------------------
+
+#endif
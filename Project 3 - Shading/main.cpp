@@ -6,6 +6,7 @@
 #include "cyCodeBase/cyVector.h"
 #include "cyCodeBase/cyMatrix.h"
 #include "cyCodeBase/cyTriMesh.h"
+#include "cyCodeBase/cyMeshCache.h"
 #include "cyCodeBase/cyGL.h"
 
 // number of vertices in given obj
@@ -105,7 +106,8 @@ GLuint *getVBO(int argc, const char *filename)
     // read vertex data
     bool read_status;
     cyTriMesh reader;
-    if (!(read_status = reader.LoadFromFileObj(filename, false)))
+    cyMeshCache cache;
+    if (!(read_status = cache.LoadFromFileObj(reader, filename, false)))
     {
         fprintf(stderr, "Error: cannot read file");
         exit(1);
@@ -0,0 +1,616 @@
+//-------------------------------------------------------------------------------
+//! \file   cyBatchTransform.h
+//!
+//! \brief  Transformation of large point and normal arrays with SIMD instructions.
+//!
+//! BatchTransform transforms arrays of points by a 4x4 or 3x4 matrix, and
+//! arrays of normals by the inverse transpose of its 3x3 sub-matrix. The arrays
+//! can be interleaved (arrays of Vec3f or Vec4f) or separate x, y, and z
+//! arrays. The points can be divided by their w coordinates after the
+//! transformation, and the clip codes of the transformed points can be written
+//! for culling. Sixteen points are transformed at a time with AVX-512, eight
+//! with AVX, and four with SSE2, and large arrays are partitioned among
+//! multiple threads. The instruction set is selected at run time (see cyCPU.h).
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_BATCH_TRANSFORM_H_INCLUDED_
+#define _CY_BATCH_TRANSFORM_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyMatrix.h"
+#include "cyCPU.h"
+#include <vector>
+#include <thread>
+#include <cstring>
+
+#if !defined(CY_NO_INTRIN_H) && !defined(CY_NO_EMMINTRIN_H) && !defined(CY_NO_IMMINTRIN_H)
+# if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#  define _CY_BATCH_TRANSFORM_SSE2
+#  if defined(__AVX__) || defined(_CY_CPU_DISPATCH_AVX)
+#   define _CY_BATCH_TRANSFORM_AVX
+#  endif
+#  if defined(__AVX512F__) || defined(_CY_CPU_DISPATCH_AVX)
+#   define _CY_BATCH_TRANSFORM_AVX512
+#  endif
+# endif
+#endif
+
+// The range functions do not have target attributes, so gcc warns about passing AVX vectors to them (-Wpsabi),
+// even though they are always inlined into the kernels. The AVX-512 intrinsics of gcc 12 also cause false warnings.
+#ifdef _CY_COMPILER_GCC
+# pragma GCC diagnostic push
+# pragma GCC diagnostic ignored "-Wpsabi"
+# if __GNUC__ == 12
+#  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+# endif
+#endif
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Batch transformation of points and normals.
+//!
+//! The points are transformed in the same order of operations as
+//! Matrix4f::operator*(Vec3f), and the normals as Matrix3f::operator*(Vec3f)
+//! followed by Vec3f::Normalize, so the results are the same as transforming
+//! them one at a time (unless the compiler contracts the scalar code into
+//! fused multiply-add instructions). The perspective divide uses division,
+//! not multiplication with the reciprocal of w.
+//!
+//! The output arrays can be the same as the input arrays. Arrays with fewer
+//! points than the parallel threshold are transformed by the calling thread.
+//!
+//! The kernels are selected for the instruction set level of CPU::GetISA()
+//! at each call. All levels produce the same results.
+
+class BatchTransform
+{
+public:
+	//! Clip code bits of a point in clip space, set when the point is outside of the corresponding plane of the view volume.
+	enum ClipCode {
+		CLIP_LEFT   = 0x01,	//!< x < -w
+		CLIP_RIGHT  = 0x02,	//!< x >  w
+		CLIP_BOTTOM = 0x04,	//!< y < -w
+		CLIP_TOP    = 0x08,	//!< y >  w
+		CLIP_NEAR   = 0x10,	//!< z < -w
+		CLIP_FAR    = 0x20,	//!< z >  w
+	};
+
+	BatchTransform() : numThreads(0), parallelThreshold(1<<18) { SetMatrix( Matrix4f::Identity() ); }
+	explicit BatchTransform( Matrix4f  const &m ) : numThreads(0), parallelThreshold(1<<18) { SetMatrix(m); }
+	explicit BatchTransform( Matrix34f const &m ) : numThreads(0), parallelThreshold(1<<18) { SetMatrix(m); }
+
+	//! Sets the transformation matrix and computes the normal matrix, the inverse transpose of its 3x3 sub-matrix.
+	void SetMatrix( Matrix4f const &m ) { matrix = m; normalMatrix = Matrix3f(m).GetInverse().GetTranspose(); }
+	//! Sets the transformation matrix, which has 0,0,0,1 as its last row.
+	void SetMatrix( Matrix34f const &m ) { SetMatrix( Matrix4f(m) ); }
+
+	//! Sets the number of threads (0 uses all hardware threads, 1 disables multithreading).
+	void SetNumThreads( unsigned int n ) { numThreads = n; }
+	//! Sets the minimum number of points that each thread transforms, so smaller arrays are transformed by a single thread.
+	void SetParallelThreshold( size_t n ) { parallelThreshold = n > 0 ? n : 1; }
+
+	Matrix4f const & GetMatrix() const { return matrix; }			//!< Returns the transformation matrix.
+	Matrix3f const & GetNormalMatrix() const { return normalMatrix; }	//!< Returns the matrix that transforms the normals.
+
+	//!@name Points
+
+	//! Transforms the points (with w=1). If perspectiveDivide is true, the results are divided by their w coordinates.
+	//! If clipCodes is not null, the clip codes of the transformed points (before the division) are written to it.
+	void TransformPoints( Vec3f const *in, Vec3f *out, size_t n, bool perspectiveDivide=false, unsigned char *clipCodes=nullptr ) const;
+
+	//! Transforms the points (with w=1) to homogeneous coordinates.
+	//! If clipCodes is not null, the clip codes of the transformed points are written to it.
+	void TransformPoints( Vec3f const *in, Vec4f *out, size_t n, unsigned char *clipCodes=nullptr ) const;
+
+	//! Transforms the points (with w=1) given as separate coordinate arrays. The w coordinates are written to ow, unless it is null.
+	//! If perspectiveDivide is true, the x, y, and z coordinates are divided by w.
+	//! If clipCodes is not null, the clip codes of the transformed points (before the division) are written to it.
+	void TransformPoints( float const *x, float const *y, float const *z, float *ox, float *oy, float *oz, float *ow, size_t n, bool perspectiveDivide=false, unsigned char *clipCodes=nullptr ) const;
+
+	//!@name Normals
+
+	//! Transforms the normals by the normal matrix, and normalizes them if normalize is true.
+	void TransformNormals( Vec3f const *in, Vec3f *out, size_t n, bool normalize=true ) const;
+
+	//! Transforms the normals given as separate coordinate arrays by the normal matrix, and normalizes them if normalize is true.
+	void TransformNormals( float const *x, float const *y, float const *z, float *ox, float *oy, float *oz, size_t n, bool normalize=true ) const;
+
+	//!@name Bounds
+
+	//! Computes the bounding box of the points, ignoring the NaN coordinates.
+	//! If there are no points, boundMin is set to +infinity and boundMax to -infinity.
+	static void ComputeBounds( Vec3f const *points, size_t n, Vec3f &boundMin, Vec3f &boundMax );
+
+	//! Computes the bounding box of the points given as separate coordinate arrays, ignoring the NaN coordinates.
+	//! If there are no points, boundMin is set to +infinity and boundMax to -infinity.
+	static void ComputeBounds( float const *x, float const *y, float const *z, size_t n, Vec3f &boundMin, Vec3f &boundMax );
+
+private:
+	Matrix4f     matrix;
+	Matrix3f     normalMatrix;
+	unsigned int numThreads;
+	size_t       parallelThreshold;
+
+	//! \cond HIDDEN_SYMBOLS
+
+	// Operations on one, four, and eight floats. The interleaved loads and stores convert between
+	// the array of Vec3f (or Vec4f) and the x, y, and z (and w) vectors.
+	struct F1
+	{
+		typedef float V;
+		enum { N=1 };
+		static V    Set  ( float f ) { return f; }
+		static V    Load ( float const *p ) { return *p; }
+		static void Store( float *p, V v ) { *p = v; }
+		static V    Add  ( V a, V b ) { return a + b; }
+		static V    Mul  ( V a, V b ) { return a * b; }
+		static V    Div  ( V a, V b ) { return a / b; }
+		static V    Sqrt ( V a ) { return cy::Sqrt(a); }
+		static V    Min  ( V a, V b ) { return a < b ? a : b; }
+		static V    Max  ( V a, V b ) { return a > b ? a : b; }
+		static void LoadXYZ ( Vec3f const *p, V &x, V &y, V &z ) { x = p->x; y = p->y; z = p->z; }
+		static void StoreXYZ( Vec3f *p, V x, V y, V z ) { p->x = x; p->y = y; p->z = z; }
+		static void StoreXYZW( Vec4f *p, V x, V y, V z, V w ) { p->x = x; p->y = y; p->z = z; p->w = w; }
+		static void ClipCodes( unsigned char *c, V x, V y, V z, V w )
+		{
+			*c = (unsigned char)( (x < -w)*CLIP_LEFT | (x > w)*CLIP_RIGHT | (y < -w)*CLIP_BOTTOM | (y > w)*CLIP_TOP | (z < -w)*CLIP_NEAR | (z > w)*CLIP_FAR );
+		}
+	};
+
+#ifdef _CY_BATCH_TRANSFORM_SSE2
+	struct F4
+	{
+		typedef __m128 V;
+		enum { N=4 };
+		static V    Set  ( float f ) { return _mm_set1_ps(f); }
+		static V    Load ( float const *p ) { return _mm_loadu_ps(p); }
+		static void Store( float *p, V v ) { _mm_storeu_ps(p,v); }
+		static V    Add  ( V a, V b ) { return _mm_add_ps(a,b); }
+		static V    Mul  ( V a, V b ) { return _mm_mul_ps(a,b); }
+		static V    Div  ( V a, V b ) { return _mm_div_ps(a,b); }
+		static V    Sqrt ( V a ) { return _mm_sqrt_ps(a); }
+		static V    Min  ( V a, V b ) { return _mm_min_ps(a,b); }
+		static V    Max  ( V a, V b ) { return _mm_max_ps(a,b); }
+		static void LoadXYZ( Vec3f const *p, V &x, V &y, V &z )
+		{
+			float const *f = &p->x;
+			__m128 a = _mm_loadu_ps(f), b = _mm_loadu_ps(f+4), c = _mm_loadu_ps(f+8);	// x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+			__m128 xy = _mm_shuffle_ps( b, c, _MM_SHUFFLE(2,1,3,2) );	// x2 y2 x3 y3
+			__m128 yz = _mm_shuffle_ps( a, b, _MM_SHUFFLE(1,0,2,1) );	// y0 z0 y1 z1
+			x = _mm_shuffle_ps( a,  xy, _MM_SHUFFLE(2,0,3,0) );
+			y = _mm_shuffle_ps( yz, xy, _MM_SHUFFLE(3,1,2,0) );
+			z = _mm_shuffle_ps( yz, c,  _MM_SHUFFLE(3,0,3,1) );
+		}
+		static void StoreXYZ( Vec3f *p, V x, V y, V z )
+		{
+			float *f = &p->x;
+			__m128 xy = _mm_shuffle_ps( x, y, _MM_SHUFFLE(2,0,2,0) );	// x0 x2 y0 y2
+			__m128 yz = _mm_shuffle_ps( y, z, _MM_SHUFFLE(3,1,3,1) );	// y1 y3 z1 z3
+			__m128 zx = _mm_shuffle_ps( z, x, _MM_SHUFFLE(3,1,2,0) );	// z0 z2 x1 x3
+			_mm_storeu_ps( f,   _mm_shuffle_ps( xy, zx, _MM_SHUFFLE(2,0,2,0) ) );
+			_mm_storeu_ps( f+4, _mm_shuffle_ps( yz, xy, _MM_SHUFFLE(3,1,2,0) ) );
+			_mm_storeu_ps( f+8, _mm_shuffle_ps( zx, yz, _MM_SHUFFLE(3,1,3,1) ) );
+		}
+		static void StoreXYZW( Vec4f *p, V x, V y, V z, V w )
+		{
+			_MM_TRANSPOSE4_PS( x, y, z, w );
+			float *f = &p->x;
+			_mm_storeu_ps( f,    x );
+			_mm_storeu_ps( f+ 4, y );
+			_mm_storeu_ps( f+ 8, z );
+			_mm_storeu_ps( f+12, w );
+		}
+		static __m128i ClipBits( V x, V y, V z, V w )
+		{
+			__m128 nw = _mm_sub_ps( _mm_setzero_ps(), w );
+			__m128 c = _mm_and_ps( _mm_cmplt_ps(x,nw), Bit(CLIP_LEFT  ) );
+			c = _mm_or_ps( c, _mm_and_ps( _mm_cmpgt_ps(x,w ), Bit(CLIP_RIGHT ) ) );
+			c = _mm_or_ps( c, _mm_and_ps( _mm_cmplt_ps(y,nw), Bit(CLIP_BOTTOM) ) );
+			c = _mm_or_ps( c, _mm_and_ps( _mm_cmpgt_ps(y,w ), Bit(CLIP_TOP   ) ) );
+			c = _mm_or_ps( c, _mm_and_ps( _mm_cmplt_ps(z,nw), Bit(CLIP_NEAR  ) ) );
+			c = _mm_or_ps( c, _mm_and_ps( _mm_cmpgt_ps(z,w ), Bit(CLIP_FAR   ) ) );
+			return _mm_castps_si128(c);
+		}
+		static void ClipCodes( unsigned char *c, V x, V y, V z, V w )
+		{
+			__m128i b = ClipBits( x, y, z, w );
+			b = _mm_packs_epi32( b, b );
+			b = _mm_packus_epi16( b, b );
+			int v = _mm_cvtsi128_si32( b );
+			memcpy( c, &v, 4 );
+		}
+		static V Bit( int b ) { return _mm_castsi128_ps( _mm_set1_epi32(b) ); }
+	};
+#endif
+
+#ifdef _CY_BATCH_TRANSFORM_AVX
+	struct F8
+	{
+		typedef __m256 V;
+		enum { N=8 };
+		CY_TARGET_AVX static V    Set  ( float f ) { return _mm256_set1_ps(f); }
+		CY_TARGET_AVX static V    Load ( float const *p ) { return _mm256_loadu_ps(p); }
+		CY_TARGET_AVX static void Store( float *p, V v ) { _mm256_storeu_ps(p,v); }
+		CY_TARGET_AVX static V    Add  ( V a, V b ) { return _mm256_add_ps(a,b); }
+		CY_TARGET_AVX static V    Mul  ( V a, V b ) { return _mm256_mul_ps(a,b); }
+		CY_TARGET_AVX static V    Div  ( V a, V b ) { return _mm256_div_ps(a,b); }
+		CY_TARGET_AVX static V    Sqrt ( V a ) { return _mm256_sqrt_ps(a); }
+		CY_TARGET_AVX static V    Min  ( V a, V b ) { return _mm256_min_ps(a,b); }
+		CY_TARGET_AVX static V    Max  ( V a, V b ) { return _mm256_max_ps(a,b); }
+		// The lower halves hold the points 0-3 and the upper halves hold the points 4-7, so that the shuffles of F4 can be used.
+		CY_TARGET_AVX static void LoadXYZ( Vec3f const *p, V &x, V &y, V &z )
+		{
+			float const *f = &p->x;
+			__m256 a = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps(f  ) ), _mm_loadu_ps(f+12), 1 );
+			__m256 b = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps(f+4) ), _mm_loadu_ps(f+16), 1 );
+			__m256 c = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps(f+8) ), _mm_loadu_ps(f+20), 1 );
+			__m256 xy = _mm256_shuffle_ps( b, c, _MM_SHUFFLE(2,1,3,2) );
+			__m256 yz = _mm256_shuffle_ps( a, b, _MM_SHUFFLE(1,0,2,1) );
+			x = _mm256_shuffle_ps( a,  xy, _MM_SHUFFLE(2,0,3,0) );
+			y = _mm256_shuffle_ps( yz, xy, _MM_SHUFFLE(3,1,2,0) );
+			z = _mm256_shuffle_ps( yz, c,  _MM_SHUFFLE(3,0,3,1) );
+		}
+		CY_TARGET_AVX static void StoreXYZ( Vec3f *p, V x, V y, V z )
+		{
+			float *f = &p->x;
+			__m256 xy = _mm256_shuffle_ps( x, y, _MM_SHUFFLE(2,0,2,0) );
+			__m256 yz = _mm256_shuffle_ps( y, z, _MM_SHUFFLE(3,1,3,1) );
+			__m256 zx = _mm256_shuffle_ps( z, x, _MM_SHUFFLE(3,1,2,0) );
+			__m256 a = _mm256_shuffle_ps( xy, zx, _MM_SHUFFLE(2,0,2,0) );
+			__m256 b = _mm256_shuffle_ps( yz, xy, _MM_SHUFFLE(3,1,2,0) );
+			__m256 c = _mm256_shuffle_ps( zx, yz, _MM_SHUFFLE(3,1,3,1) );
+			_mm_storeu_ps( f,    _mm256_castps256_ps128(a) );
+			_mm_storeu_ps( f+ 4, _mm256_castps256_ps128(b) );
+			_mm_storeu_ps( f+ 8, _mm256_castps256_ps128(c) );
+			_mm_storeu_ps( f+12, _mm256_extractf128_ps(a,1) );
+			_mm_storeu_ps( f+16, _mm256_extractf128_ps(b,1) );
+			_mm_storeu_ps( f+20, _mm256_extractf128_ps(c,1) );
+		}
+		CY_TARGET_AVX static void StoreXYZW( Vec4f *p, V x, V y, V z, V w )
+		{
+			F4::StoreXYZW( p,   _mm256_castps256_ps128(x),   _mm256_castps256_ps128(y),   _mm256_castps256_ps128(z),   _mm256_castps256_ps128(w)   );
+			F4::StoreXYZW( p+4, _mm256_extractf128_ps(x,1), _mm256_extractf128_ps(y,1), _mm256_extractf128_ps(z,1), _mm256_extractf128_ps(w,1) );
+		}
+		CY_TARGET_AVX static void ClipCodes( unsigned char *c, V x, V y, V z, V w )
+		{
+			__m128i lo = F4::ClipBits( _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z), _mm256_castps256_ps128(w) );
+			__m128i hi = F4::ClipBits( _mm256_extractf128_ps(x,1), _mm256_extractf128_ps(y,1), _mm256_extractf128_ps(z,1), _mm256_extractf128_ps(w,1) );
+			__m128i b = _mm_packs_epi32( lo, hi );
+			_mm_storel_epi64( (__m128i*) c, _mm_packus_epi16( b, b ) );
+		}
+	};
+#endif
+
+#ifdef _CY_BATCH_TRANSFORM_AVX512
+	struct F16
+	{
+		typedef __m512 V;
+		enum { N=16 };
+		CY_TARGET_AVX512 static V    Set  ( float f ) { return _mm512_set1_ps(f); }
+		CY_TARGET_AVX512 static V    Load ( float const *p ) { return _mm512_loadu_ps(p); }
+		CY_TARGET_AVX512 static void Store( float *p, V v ) { _mm512_storeu_ps(p,v); }
+		CY_TARGET_AVX512 static V    Add  ( V a, V b ) { return _mm512_add_ps(a,b); }
+		CY_TARGET_AVX512 static V    Mul  ( V a, V b ) { return _mm512_mul_ps(a,b); }
+		CY_TARGET_AVX512 static V    Div  ( V a, V b ) { return _mm512_div_ps(a,b); }
+		CY_TARGET_AVX512 static V    Sqrt ( V a ) { return _mm512_sqrt_ps(a); }
+		CY_TARGET_AVX512 static V    Min  ( V a, V b ) { return _mm512_min_ps(a,b); }
+		CY_TARGET_AVX512 static V    Max  ( V a, V b ) { return _mm512_max_ps(a,b); }
+		// The 48 floats of 16 points are in three vectors a, b, and c. The coordinate with the offset o of point k is the
+		// float 3k+o, which is in a or b if it is below 32, and in c otherwise, and the low bits of 3k+o are its index in them.
+		CY_TARGET_AVX512 static V Gather( __m512 a, __m512 b, __m512 c, int o )
+		{
+			__m512i i = _mm512_add_epi32( _mm512_setr_epi32( 0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45 ), _mm512_set1_epi32(o) );
+			__mmask16 inC = _mm512_cmpge_epi32_mask( i, _mm512_set1_epi32(32) );
+			return _mm512_mask_permutexvar_ps( _mm512_permutex2var_ps( a, i, b ), inC, i, c );
+		}
+		CY_TARGET_AVX512 static void LoadXYZ( Vec3f const *p, V &x, V &y, V &z )
+		{
+			float const *f = &p->x;
+			__m512 a = _mm512_loadu_ps(f), b = _mm512_loadu_ps(f+16), c = _mm512_loadu_ps(f+32);
+			x = Gather( a, b, c, 0 );
+			y = Gather( a, b, c, 1 );
+			z = Gather( a, b, c, 2 );
+		}
+		// Each output vector takes its x and y coordinates from x and y (with the indices 16 and above), and its z coordinates from z.
+		CY_TARGET_AVX512 static void StoreXYZ( Vec3f *p, V x, V y, V z )
+		{
+			float *f = &p->x;
+			_mm512_storeu_ps( f,    _mm512_mask_permutexvar_ps( _mm512_permutex2var_ps( x, _mm512_setr_epi32(  0,16, 0, 1,17, 1, 2,18, 2, 3,19, 3, 4,20, 4, 5 ), y ), 0x4924, _mm512_setr_epi32(  0, 0, 0, 0, 0, 1, 0, 0, 2, 0, 0, 3, 0, 0, 4, 0 ), z ) );
+			_mm512_storeu_ps( f+16, _mm512_mask_permutexvar_ps( _mm512_permutex2var_ps( x, _mm512_setr_epi32( 21, 0, 6,22, 0, 7,23, 0, 8,24, 0, 9,25, 0,10,26 ), y ), 0x2492, _mm512_setr_epi32(  0, 5, 0, 0, 6, 0, 0, 7, 0, 0, 8, 0, 0, 9, 0, 0 ), z ) );
+			_mm512_storeu_ps( f+32, _mm512_mask_permutexvar_ps( _mm512_permutex2var_ps( x, _mm512_setr_epi32(  0,11,27, 0,12,28, 0,13,29, 0,14,30, 0,15,31, 0 ), y ), 0x9249, _mm512_setr_epi32( 10, 0, 0,11, 0, 0,12, 0, 0,13, 0, 0,14, 0, 0,15 ), z ) );
+		}
+		CY_TARGET_AVX512 static void StoreXYZW( Vec4f *p, V x, V y, V z, V w )
+		{
+			F8::StoreXYZW( p,   Low(x),  Low(y),  Low(z),  Low(w)  );
+			F8::StoreXYZW( p+8, High(x), High(y), High(z), High(w) );
+		}
+		CY_TARGET_AVX512 static void ClipCodes( unsigned char *c, V x, V y, V z, V w )
+		{
+			__m512 nw = _mm512_sub_ps( _mm512_setzero_ps(), w );
+			__m512i b = _mm512_setzero_si512();
+			b = _mm512_mask_mov_epi32( b, _mm512_cmp_ps_mask( x, nw, _CMP_LT_OQ ), _mm512_set1_epi32( CLIP_LEFT ) );
+			b = _mm512_mask_or_epi32 ( b, _mm512_cmp_ps_mask( x, w,  _CMP_GT_OQ ), b, _mm512_set1_epi32( CLIP_RIGHT  ) );
+			b = _mm512_mask_or_epi32 ( b, _mm512_cmp_ps_mask( y, nw, _CMP_LT_OQ ), b, _mm512_set1_epi32( CLIP_BOTTOM ) );
+			b = _mm512_mask_or_epi32 ( b, _mm512_cmp_ps_mask( y, w,  _CMP_GT_OQ ), b, _mm512_set1_epi32( CLIP_TOP    ) );
+			b = _mm512_mask_or_epi32 ( b, _mm512_cmp_ps_mask( z, nw, _CMP_LT_OQ ), b, _mm512_set1_epi32( CLIP_NEAR   ) );
+			b = _mm512_mask_or_epi32 ( b, _mm512_cmp_ps_mask( z, w,  _CMP_GT_OQ ), b, _mm512_set1_epi32( CLIP_FAR    ) );
+			_mm_storeu_si128( (__m128i*) c, _mm512_cvtepi32_epi8(b) );
+		}
+		CY_TARGET_AVX512 static __m256 Low ( V v ) { return _mm512_castps512_ps256(v); }
+		CY_TARGET_AVX512 static __m256 High( V v ) { return _mm256_castpd_ps( _mm512_extractf64x4_pd( _mm512_castps_pd(v), 1 ) ); }
+	};
+#endif
+
+	// Sources and destinations of the points: interleaved Vec3f, interleaved Vec4f, and separate arrays.
+	struct AoS3In  { Vec3f const *p; template <typename S> CY_FORCE_INLINE void Load ( size_t i, typename S::V &x, typename S::V &y, typename S::V &z ) const { S::LoadXYZ( p+i, x, y, z ); } };
+	struct SoAIn   { float const *x, *y, *z; template <typename S> CY_FORCE_INLINE void Load ( size_t i, typename S::V &ox, typename S::V &oy, typename S::V &oz ) const { ox = S::Load(x+i); oy = S::Load(y+i); oz = S::Load(z+i); } };
+	struct AoS3Out { Vec3f *p; template <typename S> CY_FORCE_INLINE void Store( size_t i, typename S::V const &x, typename S::V const &y, typename S::V const &z, typename S::V const &  ) const { S::StoreXYZ ( p+i, x, y, z ); } };
+	struct AoS4Out { Vec4f *p; template <typename S> CY_FORCE_INLINE void Store( size_t i, typename S::V const &x, typename S::V const &y, typename S::V const &z, typename S::V const &w ) const { S::StoreXYZW( p+i, x, y, z, w ); } };
+	struct SoAOut  { float *x, *y, *z, *w; template <typename S> CY_FORCE_INLINE void Store( size_t i, typename S::V const &ox, typename S::V const &oy, typename S::V const &oz, typename S::V const &ow ) const { S::Store(x+i,ox); S::Store(y+i,oy); S::Store(z+i,oz); if ( w ) S::Store(w+i,ow); } };
+
+	// Each range function transforms the points from begin, as many as the vector width allows, and returns the index of the first remaining point.
+	template <typename S, typename IN, typename OUT> CY_FORCE_INLINE size_t PointRange ( IN const &in, OUT const &out, size_t begin, size_t end, bool divide, unsigned char *clipCodes ) const;
+	template <typename S, typename IN, typename OUT> CY_FORCE_INLINE size_t NormalRange( IN const &in, OUT const &out, size_t begin, size_t end, bool normalize ) const;
+	template <typename S, typename IN> CY_FORCE_INLINE static size_t BoundsRange( IN const &in, size_t begin, size_t end, Vec3f &boundMin, Vec3f &boundMax );
+
+	// The kernels of each instruction set level process the points from begin to end, using the widest vectors first.
+	// Each one calls the kernel of the level below for the remaining points, and the target levels inline all of them.
+	template <typename IN, typename OUT> void PointsScalar( IN const &in, OUT const &out, size_t begin, size_t end, bool divide, unsigned char *clipCodes ) const { PointRange<F1>( in, out, begin, end, divide, clipCodes ); }
+	template <typename IN, typename OUT> void NormalsScalar( IN const &in, OUT const &out, size_t begin, size_t end, bool normalize ) const { NormalRange<F1>( in, out, begin, end, normalize ); }
+	template <typename IN> static void BoundsScalar( IN const &in, size_t begin, size_t end, Vec3f &boundMin, Vec3f &boundMax ) { BoundsRange<F1>( in, begin, end, boundMin, boundMax ); }
+#ifdef _CY_BATCH_TRANSFORM_SSE2
+	template <typename IN, typename OUT> void PointsSSE2( IN const &in, OUT const &out, size_t begin, size_t end, bool divide, unsigned char *clipCodes ) const { PointsScalar( in, out, PointRange<F4>( in, out, begin, end, divide, clipCodes ), end, divide, clipCodes ); }
+	template <typename IN, typename OUT> void NormalsSSE2( IN const &in, OUT const &out, size_t begin, size_t end, bool normalize ) const { NormalsScalar( in, out, NormalRange<F4>( in, out, begin, end, normalize ), end, normalize ); }
+	template <typename IN> static void BoundsSSE2( IN const &in, size_t begin, size_t end, Vec3f &boundMin, Vec3f &boundMax ) { BoundsScalar( in, BoundsRange<F4>( in, begin, end, boundMin, boundMax ), end, boundMin, boundMax ); }
+#endif
+#ifdef _CY_BATCH_TRANSFORM_AVX
+	template <typename IN, typename OUT> CY_TARGET_AVX CY_FLATTEN void PointsAVX( IN const &in, OUT const &out, size_t begin, size_t end, bool divide, unsigned char *clipCodes ) const { PointsSSE2( in, out, PointRange<F8>( in, out, begin, end, divide, clipCodes ), end, divide, clipCodes ); }
+	template <typename IN, typename OUT> CY_TARGET_AVX CY_FLATTEN void NormalsAVX( IN const &in, OUT const &out, size_t begin, size_t end, bool normalize ) const { NormalsSSE2( in, out, NormalRange<F8>( in, out, begin, end, normalize ), end, normalize ); }
+	template <typename IN> CY_TARGET_AVX CY_FLATTEN static void BoundsAVX( IN const &in, size_t begin, size_t end, Vec3f &boundMin, Vec3f &boundMax ) { BoundsSSE2( in, BoundsRange<F8>( in, begin, end, boundMin, boundMax ), end, boundMin, boundMax ); }
+#endif
+#ifdef _CY_BATCH_TRANSFORM_AVX512
+	template <typename IN, typename OUT> CY_TARGET_AVX512 CY_FLATTEN void PointsAVX512( IN const &in, OUT const &out, size_t begin, size_t end, bool divide, unsigned char *clipCodes ) const { PointsAVX( in, out, PointRange<F16>( in, out, begin, end, divide, clipCodes ), end, divide, clipCodes ); }
+	template <typename IN, typename OUT> CY_TARGET_AVX512 CY_FLATTEN void NormalsAVX512( IN const &in, OUT const &out, size_t begin, size_t end, bool normalize ) const { NormalsAVX( in, out, NormalRange<F16>( in, out, begin, end, normalize ), end, normalize ); }
+	template <typename IN> CY_TARGET_AVX512 CY_FLATTEN static void BoundsAVX512( IN const &in, size_t begin, size_t end, Vec3f &boundMin, Vec3f &boundMax ) { BoundsAVX( in, BoundsRange<F16>( in, begin, end, boundMin, boundMax ), end, boundMin, boundMax ); }
+#endif
+
+	template <typename IN, typename OUT> void Points ( IN const &in, OUT const &out, size_t n, bool divide, unsigned char *clipCodes ) const;
+	template <typename IN, typename OUT> void Normals( IN const &in, OUT const &out, size_t n, bool normalize ) const;
+	template <typename IN> static void Bounds( IN const &in, size_t n, Vec3f &boundMin, Vec3f &boundMax );
+	template <typename FUNC> void ParallelRanges( size_t n, FUNC func ) const;
+
+	//! \endcond
+};
+
+//-------------------------------------------------------------------------------
+
+inline void BatchTransform::TransformPoints( Vec3f const *in, Vec3f *out, size_t n, bool perspectiveDivide, unsigned char *clipCodes ) const
+{
+	AoS3In  i = { in  };
+	AoS3Out o = { out };
+	Points( i, o, n, perspectiveDivide, clipCodes );
+}
+
+inline void BatchTransform::TransformPoints( Vec3f const *in, Vec4f *out, size_t n, unsigned char *clipCodes ) const
+{
+	AoS3In  i = { in  };
+	AoS4Out o = { out };
+	Points( i, o, n, false, clipCodes );
+}
+
+inline void BatchTransform::TransformPoints( float const *x, float const *y, float const *z, float *ox, float *oy, float *oz, float *ow, size_t n, bool perspectiveDivide, unsigned char *clipCodes ) const
+{
+	SoAIn  i = { x, y, z };
+	SoAOut o = { ox, oy, oz, ow };
+	Points( i, o, n, perspectiveDivide, clipCodes );
+}
+
+inline void BatchTransform::TransformNormals( Vec3f const *in, Vec3f *out, size_t n, bool normalize ) const
+{
+	AoS3In  i = { in  };
+	AoS3Out o = { out };
+	Normals( i, o, n, normalize );
+}
+
+inline void BatchTransform::TransformNormals( float const *x, float const *y, float const *z, float *ox, float *oy, float *oz, size_t n, bool normalize ) const
+{
+	SoAIn  i = { x, y, z };
+	SoAOut o = { ox, oy, oz, nullptr };
+	Normals( i, o, n, normalize );
+}
+
+//-------------------------------------------------------------------------------
+
+template <typename S, typename IN, typename OUT>
+CY_FORCE_INLINE size_t BatchTransform::PointRange( IN const &in, OUT const &out, size_t begin, size_t end, bool divide, unsigned char *clipCodes ) const
+{
+	typedef typename S::V V;
+	V m[16];
+	for ( int k=0; k<16; k++ ) m[k] = S::Set( matrix.cell[k] );
+	size_t i = begin;
+	for ( ; i+S::N<=end; i+=S::N ) {
+		V x, y, z;
+		in.template Load<S>( i, x, y, z );
+		V tx = S::Add( S::Add( S::Mul(x,m[0]), S::Mul(y,m[4]) ), S::Add( S::Mul(z,m[ 8]), m[12] ) );
+		V ty = S::Add( S::Add( S::Mul(x,m[1]), S::Mul(y,m[5]) ), S::Add( S::Mul(z,m[ 9]), m[13] ) );
+		V tz = S::Add( S::Add( S::Mul(x,m[2]), S::Mul(y,m[6]) ), S::Add( S::Mul(z,m[10]), m[14] ) );
+		V tw = S::Add( S::Add( S::Mul(x,m[3]), S::Mul(y,m[7]) ), S::Add( S::Mul(z,m[11]), m[15] ) );
+		if ( clipCodes ) S::ClipCodes( clipCodes+i, tx, ty, tz, tw );
+		if ( divide ) {
+			tx = S::Div( tx, tw );
+			ty = S::Div( ty, tw );
+			tz = S::Div( tz, tw );
+		}
+		out.template Store<S>( i, tx, ty, tz, tw );
+	}
+	return i;
+}
+
+template <typename S, typename IN, typename OUT>
+CY_FORCE_INLINE size_t BatchTransform::NormalRange( IN const &in, OUT const &out, size_t begin, size_t end, bool normalize ) const
+{
+	typedef typename S::V V;
+	V m[9];
+	for ( int k=0; k<9; k++ ) m[k] = S::Set( normalMatrix.cell[k] );
+	size_t i = begin;
+	for ( ; i+S::N<=end; i+=S::N ) {
+		V x, y, z;
+		in.template Load<S>( i, x, y, z );
+		V tx = S::Add( S::Add( S::Mul(x,m[0]), S::Mul(y,m[3]) ), S::Mul(z,m[6]) );
+		V ty = S::Add( S::Add( S::Mul(x,m[1]), S::Mul(y,m[4]) ), S::Mul(z,m[7]) );
+		V tz = S::Add( S::Add( S::Mul(x,m[2]), S::Mul(y,m[5]) ), S::Mul(z,m[8]) );
+		if ( normalize ) {
+			V len = S::Sqrt( S::Add( S::Add( S::Mul(tx,tx), S::Mul(ty,ty) ), S::Mul(tz,tz) ) );
+			tx = S::Div( tx, len );
+			ty = S::Div( ty, len );
+			tz = S::Div( tz, len );
+		}
+		out.template Store<S>( i, tx, ty, tz, tz );
+	}
+	return i;
+}
+
+template <typename S, typename IN>
+CY_FORCE_INLINE size_t BatchTransform::BoundsRange( IN const &in, size_t begin, size_t end, Vec3f &boundMin, Vec3f &boundMax )
+{
+	typedef typename S::V V;
+	V minX = S::Set(boundMin.x), minY = S::Set(boundMin.y), minZ = S::Set(boundMin.z);
+	V maxX = S::Set(boundMax.x), maxY = S::Set(boundMax.y), maxZ = S::Set(boundMax.z);
+	size_t i = begin;
+	for ( ; i+S::N<=end; i+=S::N ) {
+		V x, y, z;
+		in.template Load<S>( i, x, y, z );
+		// The coordinates are the first arguments, so that NaN coordinates return the current bounds
+		minX = S::Min( x, minX );  maxX = S::Max( x, maxX );
+		minY = S::Min( y, minY );  maxY = S::Max( y, maxY );
+		minZ = S::Min( z, minZ );  maxZ = S::Max( z, maxZ );
+	}
+	float b[6][S::N];
+	S::Store( b[0], minX );  S::Store( b[1], minY );  S::Store( b[2], minZ );
+	S::Store( b[3], maxX );  S::Store( b[4], maxY );  S::Store( b[5], maxZ );
+	for ( int k=0; k<S::N; k++ ) {
+		boundMin.x = F1::Min( b[0][k], boundMin.x );  boundMax.x = F1::Max( b[3][k], boundMax.x );
+		boundMin.y = F1::Min( b[1][k], boundMin.y );  boundMax.y = F1::Max( b[4][k], boundMax.y );
+		boundMin.z = F1::Min( b[2][k], boundMin.z );  boundMax.z = F1::Max( b[5][k], boundMax.z );
+	}
+	return i;
+}
+
+template <typename IN, typename OUT>
+inline void BatchTransform::Points( IN const &in, OUT const &out, size_t n, bool divide, unsigned char *clipCodes ) const
+{
+	typedef void (BatchTransform::*Kernel)( IN const &, OUT const &, size_t, size_t, bool, unsigned char * ) const;
+	static CPUDispatch<Kernel> const kernels = []() {
+		CPUDispatch<Kernel> k( &BatchTransform::PointsScalar<IN,OUT> );
+#ifdef _CY_BATCH_TRANSFORM_SSE2
+		k.Set( CPU::ISA_SSE2, &BatchTransform::PointsSSE2<IN,OUT> );
+#endif
+#ifdef _CY_BATCH_TRANSFORM_AVX
+		k.Set( CPU::ISA_AVX, &BatchTransform::PointsAVX<IN,OUT> );
+#endif
+#ifdef _CY_BATCH_TRANSFORM_AVX512
+		k.Set( CPU::ISA_AVX512, &BatchTransform::PointsAVX512<IN,OUT> );
+#endif
+		return k;
+	}();
+	Kernel kernel = kernels.Get();
+	ParallelRanges( n, [&]( size_t begin, size_t end ) { (this->*kernel)( in, out, begin, end, divide, clipCodes ); } );
+}
+
+template <typename IN, typename OUT>
+inline void BatchTransform::Normals( IN const &in, OUT const &out, size_t n, bool normalize ) const
+{
+	typedef void (BatchTransform::*Kernel)( IN const &, OUT const &, size_t, size_t, bool ) const;
+	static CPUDispatch<Kernel> const kernels = []() {
+		CPUDispatch<Kernel> k( &BatchTransform::NormalsScalar<IN,OUT> );
+#ifdef _CY_BATCH_TRANSFORM_SSE2
+		k.Set( CPU::ISA_SSE2, &BatchTransform::NormalsSSE2<IN,OUT> );
+#endif
+#ifdef _CY_BATCH_TRANSFORM_AVX
+		k.Set( CPU::ISA_AVX, &BatchTransform::NormalsAVX<IN,OUT> );
+#endif
+#ifdef _CY_BATCH_TRANSFORM_AVX512
+		k.Set( CPU::ISA_AVX512, &BatchTransform::NormalsAVX512<IN,OUT> );
+#endif
+		return k;
+	}();
+	Kernel kernel = kernels.Get();
+	ParallelRanges( n, [&]( size_t begin, size_t end ) { (this->*kernel)( in, out, begin, end, normalize ); } );
+}
+
+template <typename IN>
+inline void BatchTransform::Bounds( IN const &in, size_t n, Vec3f &boundMin, Vec3f &boundMax )
+{
+	typedef void (*Kernel)( IN const &, size_t, size_t, Vec3f &, Vec3f & );
+	static CPUDispatch<Kernel> const kernels = []() {
+		CPUDispatch<Kernel> k( &BatchTransform::BoundsScalar<IN> );
+#ifdef _CY_BATCH_TRANSFORM_SSE2
+		k.Set( CPU::ISA_SSE2, &BatchTransform::BoundsSSE2<IN> );
+#endif
+#ifdef _CY_BATCH_TRANSFORM_AVX
+		k.Set( CPU::ISA_AVX, &BatchTransform::BoundsAVX<IN> );
+#endif
+#ifdef _CY_BATCH_TRANSFORM_AVX512
+		k.Set( CPU::ISA_AVX512, &BatchTransform::BoundsAVX512<IN> );
+#endif
+		return k;
+	}();
+	float inf = std::numeric_limits<float>::infinity();
+	boundMin.Set(  inf,  inf,  inf );
+	boundMax.Set( -inf, -inf, -inf );
+	kernels.Get()( in, 0, n, boundMin, boundMax );
+}
+
+inline void BatchTransform::ComputeBounds( Vec3f const *points, size_t n, Vec3f &boundMin, Vec3f &boundMax )
+{
+	AoS3In i = { points };
+	Bounds( i, n, boundMin, boundMax );
+}
+
+inline void BatchTransform::ComputeBounds( float const *x, float const *y, float const *z, size_t n, Vec3f &boundMin, Vec3f &boundMax )
+{
+	SoAIn i = { x, y, z };
+	Bounds( i, n, boundMin, boundMax );
+}
+
+template <typename FUNC>
+inline void BatchTransform::ParallelRanges( size_t n, FUNC func ) const
+{
+	unsigned int nt = numThreads > 0 ? numThreads : std::thread::hardware_concurrency();
+	size_t maxThreads = n / parallelThreshold;
+	if ( nt > maxThreads ) nt = (unsigned int) maxThreads;
+	if ( nt <= 1 ) {
+		func( size_t(0), n );
+		return;
+	}
+	// The ranges start at multiples of eight points, so only the last range has a scalar remainder
+	size_t blocks = ( n + 7 ) / 8;
+	auto range = [&]( unsigned int t ) {
+		size_t begin = Min( n, blocks * t / nt * 8 ), end = Min( n, blocks * (t+1) / nt * 8 );
+		func( begin, end );
+	};
+	std::vector<std::thread> threads;
+	for ( unsigned int t=1; t<nt; t++ ) threads.push_back( std::thread( range, t ) );
+	range(0);
+	for ( size_t t=0; t<threads.size(); t++ ) threads[t].join();
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+#ifdef _CY_COMPILER_GCC
+# pragma GCC diagnostic pop
+#endif
+
+//-------------------------------------------------------------------------------
+
+typedef cy::BatchTransform cyBatchTransform;	//!< Transformation of large point and normal arrays
+
+//-------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,438 @@
+//-------------------------------------------------------------------------------
+//! \file   cyMeshCache.h
+//!
+//! \brief  Binary mesh cache files for TriMesh.
+//!
+//! A mesh cache (.cymesh) file stores the arrays of a TriMesh loaded from an OBJ
+//! file, along with optional application-defined buffers, such as GPU-ready
+//! vertex and index buffers. The cache is written next to the OBJ file and it is
+//! memory-mapped when loaded, so that the stored buffers can be passed directly
+//! to functions like glBufferData without copying or parsing.
+//!
+//! A cache file is valid only for the OBJ file it was created from. It records
+//! the size, modification time, and a hash of the OBJ file, and it is rebuilt
+//! when they do not match. Changes in .mtl files are not detected. The
+//! application-defined buffers are stored with a version number that the
+//! application chooses, so that it can rebuild them when the way they are
+//! generated changes.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_MESH_CACHE_H_INCLUDED_
+#define _CY_MESH_CACHE_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyTriMesh.h"
+#include "cyMemoryMap.h"
+#include <sys/stat.h>
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Binary mesh cache file.
+//!
+//! The file begins with a header and a table of named sections, followed by the
+//! section data. Each section begins at a 64-byte boundary. The mesh arrays use
+//! the section names "v", "f", "vn", "fn", "vt", "ft", "mcfc", "mtl", and "bounds".
+//! Any other name can be used for application-defined buffers.
+
+class MeshCache
+{
+public:
+	static const uint32_t VERSION = 2;	//!< The version of the file format. Cache files with a different version are rebuilt.
+
+	//! Information about the source file, used for validating the cache.
+	struct SourceInfo
+	{
+		uint64_t size;	//!< File size in bytes
+		int64_t  time;	//!< Last modification time
+		uint64_t hash;	//!< Hash of the file contents
+	};
+
+	//! A named block of data that is stored in the cache file.
+	struct Buffer
+	{
+		char const *name;	//!< Section name (at most 15 characters)
+		void const *data;	//!< Data pointer
+		size_t      size;	//!< Data size in bytes
+	};
+
+	MeshCache() : loadMtl(false) { source.size=0; source.time=0; source.hash=0; }
+
+	//!@name Loading OBJ files through the cache
+
+	//! Loads the given OBJ file using the cache file next to it. If the cache is missing or out of date,
+	//! the OBJ file is loaded and a new cache file is written. If verifyHash is true, the contents of the
+	//! OBJ file are hashed and compared as well, in addition to the file size and modification time.
+	//! The bounding box of the mesh is computed. The cache file remains mapped until Close is called,
+	//! so that its buffers can be accessed.
+	bool LoadFromFileObj( TriMesh &mesh, char const *filename, bool loadMtl=true, bool verifyHash=false, std::ostream *outStream=&std::cout );
+
+	//! Rewrites the cache file of the last OBJ file loaded by LoadFromFileObj, adding the given buffers.
+	//! The buffers can be accessed using GetBuffer afterwards. The buffer version is stored with them and it
+	//! is returned by GetBufferVersion, so that buffers generated with different settings are not reused.
+	bool SaveBuffers( TriMesh const &mesh, Buffer const *buffers, int numBuffers, uint64_t bufferVersion=0, std::ostream *outStream=&std::cout );
+
+	//!@name Cache file access
+	bool Open( char const *cacheFilename );		//!< Maps the given cache file. Returns false if the file cannot be opened or it is not a valid cache file.
+	void Close() { file.Close(); }				//!< Releases the mapped cache file.
+	bool IsOpen() const { return file.IsOpen(); }	//!< Returns true if a cache file is mapped.
+	bool IsValid( SourceInfo const &sourceInfo, bool loadMtl, bool compareHash ) const;	//!< Returns true if the mapped cache file was created from the given source with the given loadMtl option.
+	bool GetMesh( TriMesh &mesh ) const;		//!< Copies the mesh data of the mapped cache file to the given mesh.
+	void const* GetBuffer( char const *name, size_t &size ) const;	//!< Returns a pointer to the data of the named section in the mapped file and sets its size. Returns nullptr if there is no such section.
+	void const* GetBuffer( char const *name ) const { size_t size; return GetBuffer(name,size); }	//!< Returns a pointer to the data of the named section in the mapped file, or nullptr.
+	uint64_t GetBufferVersion() const { return IsOpen() ? GetHeader()->bufferVersion : 0; }	//!< Returns the version of the application-defined buffers of the mapped file given to SaveBuffers.
+
+	//!@name Static methods
+	static bool Write( char const *cacheFilename, TriMesh const &mesh, SourceInfo const &sourceInfo, bool loadMtl, Buffer const *buffers=nullptr, int numBuffers=0, uint64_t bufferVersion=0 );	//!< Writes a cache file.
+	static bool GetSourceInfo( char const *filename, SourceInfo &info, bool computeHash );	//!< Gets the size and modification time of the given file. If computeHash is true, also computes the hash of its contents.
+	static uint64_t Hash( void const *data, size_t size );	//!< Computes the 64-bit hash that is used for the source files.
+	static std::string GetCacheFilename( char const *filename );	//!< Returns the cache filename for the given OBJ file, replacing its extension with ".cymesh".
+
+protected:
+	//! Cache file header
+	struct Header
+	{
+		char     magic[8];		// "CYMESH" followed by two null characters
+		uint32_t version;
+		uint32_t byteOrder;		// 0x01020304 in the native byte order of the writer
+		uint64_t sourceSize;
+		int64_t  sourceTime;
+		uint64_t sourceHash;
+		uint32_t flags;
+		uint32_t numSections;
+		uint64_t bufferVersion;	// version of the application-defined buffers
+	};
+	//! Section table entry
+	struct Section
+	{
+		char     name[16];
+		uint64_t offset;
+		uint64_t size;
+	};
+	enum { FLAG_MTL = 1 };	// materials were loaded with the mesh
+
+	MemoryMap   file;
+	std::string cacheFilename;
+	SourceInfo  source;		// the source of the last OBJ file loaded by LoadFromFileObj
+	bool        loadMtl;
+
+	Header  const * GetHeader  () const { return (Header const *) file.Data(); }
+	Section const * GetSections() const { return (Section const *) ( file.Data() + sizeof(Header) ); }
+
+	static void WriteString( std::vector<char> &data, char const *str );
+	static bool ReadString ( char const *&p, char const *end, TriMesh::Str &str );
+};
+
+//-------------------------------------------------------------------------------
+
+inline bool MeshCache::LoadFromFileObj( TriMesh &mesh, char const *filename, bool loadMtl, bool verifyHash, std::ostream *outStream )
+{
+	Close();
+	this->loadMtl = loadMtl;
+	cacheFilename = GetCacheFilename(filename);
+	if ( !GetSourceInfo( filename, source, verifyHash ) ) {
+		if ( outStream ) *outStream << "ERROR: Cannot open file " << filename << std::endl;
+		return false;
+	}
+
+	if ( Open(cacheFilename.c_str()) ) {
+		if ( IsValid( source, loadMtl, verifyHash ) && GetMesh(mesh) ) return true;
+		Close();
+	}
+
+	if ( !mesh.LoadFromFileObjMapped( filename, loadMtl, outStream ) ) return false;
+	mesh.ComputeBoundingBox();
+
+	if ( !verifyHash ) GetSourceInfo( filename, source, true );
+	if ( !Write( cacheFilename.c_str(), mesh, source, loadMtl ) ) {
+		if ( outStream ) *outStream << "WARNING: Cannot write file " << cacheFilename << std::endl;
+		return true;
+	}
+	Open( cacheFilename.c_str() );
+	return true;
+}
+
+inline bool MeshCache::SaveBuffers( TriMesh const &mesh, Buffer const *buffers, int numBuffers, uint64_t bufferVersion, std::ostream *outStream )
+{
+	if ( cacheFilename.empty() ) return false;
+	Close();	// the file cannot be written while it is mapped on some systems
+	if ( !Write( cacheFilename.c_str(), mesh, source, loadMtl, buffers, numBuffers, bufferVersion ) ) {
+		if ( outStream ) *outStream << "WARNING: Cannot write file " << cacheFilename << std::endl;
+		return false;
+	}
+	return Open( cacheFilename.c_str() );
+}
+
+inline bool MeshCache::Open( char const *cacheFilename )
+{
+	if ( !file.Open( cacheFilename, false ) ) return false;
+	Header const *header = GetHeader();
+	if ( file.Size() < sizeof(Header) ||
+		memcmp( header->magic, "CYMESH\0\0", 8 ) != 0 ||
+		header->version   != VERSION ||
+		header->byteOrder != 0x01020304 ||
+		file.Size() < sizeof(Header) + sizeof(Section)*uint64_t(header->numSections) ) {
+		Close();
+		return false;
+	}
+	Section const *sections = GetSections();
+	for ( uint32_t i=0; i<header->numSections; i++ ) {
+		if ( sections[i].offset > file.Size() || sections[i].size > file.Size() - sections[i].offset ) {
+			Close();
+			return false;
+		}
+	}
+	return true;
+}
+
+inline bool MeshCache::IsValid( SourceInfo const &sourceInfo, bool loadMtl, bool compareHash ) const
+{
+	if ( !IsOpen() ) return false;
+	Header const *header = GetHeader();
+	if ( header->sourceSize != sourceInfo.size ) return false;
+	if ( header->sourceTime != sourceInfo.time ) return false;
+	if ( compareHash && header->sourceHash != sourceInfo.hash ) return false;
+	return ( (header->flags & FLAG_MTL) != 0 ) == loadMtl;
+}
+
+inline void const* MeshCache::GetBuffer( char const *name, size_t &size ) const
+{
+	size = 0;
+	if ( !IsOpen() ) return nullptr;
+	Section const *sections = GetSections();
+	for ( uint32_t i=0; i<GetHeader()->numSections; i++ ) {
+		if ( strncmp( sections[i].name, name, sizeof(sections[i].name) ) == 0 ) {
+			size = (size_t) sections[i].size;
+			return file.Data() + sections[i].offset;
+		}
+	}
+	return nullptr;
+}
+
+inline bool MeshCache::GetMesh( TriMesh &mesh ) const
+{
+	size_t nv, nf, nvn, nfn, nvt, nft, nmcfc, nmtl, nbounds;
+	void const *v      = GetBuffer( "v",      nv  );
+	void const *f      = GetBuffer( "f",      nf  );
+	void const *vn     = GetBuffer( "vn",     nvn );
+	void const *fn     = GetBuffer( "fn",     nfn );
+	void const *vt     = GetBuffer( "vt",     nvt );
+	void const *ft     = GetBuffer( "ft",     nft );
+	void const *mcfc   = GetBuffer( "mcfc",   nmcfc );
+	char const *mtl    = (char const *) GetBuffer( "mtl", nmtl );
+	void const *bounds = GetBuffer( "bounds", nbounds );
+	if ( !v || !f || !bounds || nbounds != 2*sizeof(Vec3f) ) return false;
+	nv  /= sizeof(Vec3f);
+	nf  /= sizeof(TriMesh::TriFace);
+	nvn /= sizeof(Vec3f);
+	nvt /= sizeof(Vec3f);
+	unsigned int nm = (unsigned int)( nmcfc / sizeof(int) );
+	if ( ( nvn > 0 && nfn != nf*sizeof(TriMesh::TriFace) ) || ( nvt > 0 && nft != nf*sizeof(TriMesh::TriFace) ) ) return false;
+
+	mesh.Clear();
+	mesh.SetNumVertex  ( (unsigned int) nv  );
+	mesh.SetNumFaces   ( (unsigned int) nf  );
+	mesh.SetNumTexVerts( (unsigned int) nvt );
+	mesh.SetNumNormals ( (unsigned int) nvn );
+	mesh.SetNumMtls    ( nm );
+	if ( nv  > 0 ) memcpy( mesh.v,  v,  nv *sizeof(Vec3f) );
+	if ( nf  > 0 ) memcpy( mesh.f,  f,  nf *sizeof(TriMesh::TriFace) );
+	if ( nvn > 0 ) memcpy( mesh.vn, vn, nvn*sizeof(Vec3f) );
+	if ( nvn > 0 ) memcpy( mesh.fn, fn, nf *sizeof(TriMesh::TriFace) );
+	if ( nvt > 0 ) memcpy( mesh.vt, vt, nvt*sizeof(Vec3f) );
+	if ( nvt > 0 ) memcpy( mesh.ft, ft, nf *sizeof(TriMesh::TriFace) );
+	if ( nm  > 0 ) memcpy( mesh.mcfc, mcfc, nm*sizeof(int) );
+	memcpy( &mesh.boundMin, bounds, sizeof(Vec3f) );
+	memcpy( &mesh.boundMax, (Vec3f const *)bounds + 1, sizeof(Vec3f) );
+
+	char const *p = mtl, *end = mtl + nmtl;
+	for ( unsigned int i=0; i<nm; i++ ) {
+		TriMesh::Mtl &m = mesh.m[i];
+		const size_t numValues = 14;
+		if ( !p || size_t(end-p) < numValues*sizeof(float) + sizeof(int) ) { mesh.Clear(); return false; }
+		float values[numValues];
+		memcpy( values, p, sizeof(values) );
+		p += sizeof(values);
+		for ( int j=0; j<3; j++ ) {
+			m.Ka[j] = values[j];
+			m.Kd[j] = values[3+j];
+			m.Ks[j] = values[6+j];
+			m.Tf[j] = values[9+j];
+		}
+		m.Ns = values[12];
+		m.Ni = values[13];
+		memcpy( &m.illum, p, sizeof(int) );
+		p += sizeof(int);
+		if ( !ReadString( p, end, m.name     ) ||
+			 !ReadString( p, end, m.map_Ka   ) ||
+			 !ReadString( p, end, m.map_Kd   ) ||
+			 !ReadString( p, end, m.map_Ks   ) ||
+			 !ReadString( p, end, m.map_Ns   ) ||
+			 !ReadString( p, end, m.map_d    ) ||
+			 !ReadString( p, end, m.map_bump ) ||
+			 !ReadString( p, end, m.map_disp ) ) { mesh.Clear(); return false; }
+	}
+	return true;
+}
+
+inline bool MeshCache::Write( char const *cacheFilename, TriMesh const &mesh, SourceInfo const &sourceInfo, bool loadMtl, Buffer const *buffers, int numBuffers, uint64_t bufferVersion )
+{
+	std::vector<char> mtl;
+	for ( unsigned int i=0; i<mesh.nm; i++ ) {
+		TriMesh::Mtl const &m = mesh.m[i];
+		float values[14] = { m.Ka[0], m.Ka[1], m.Ka[2], m.Kd[0], m.Kd[1], m.Kd[2], m.Ks[0], m.Ks[1], m.Ks[2], m.Tf[0], m.Tf[1], m.Tf[2], m.Ns, m.Ni };
+		mtl.insert( mtl.end(), (char const *)values, (char const *)values + sizeof(values) );
+		mtl.insert( mtl.end(), (char const *)&m.illum, (char const *)&m.illum + sizeof(int) );
+		WriteString( mtl, m.name.data );
+		WriteString( mtl, m.map_Ka.data );
+		WriteString( mtl, m.map_Kd.data );
+		WriteString( mtl, m.map_Ks.data );
+		WriteString( mtl, m.map_Ns.data );
+		WriteString( mtl, m.map_d.data );
+		WriteString( mtl, m.map_bump.data );
+		WriteString( mtl, m.map_disp.data );
+	}
+	Vec3f bounds[2] = { mesh.boundMin, mesh.boundMax };
+
+	std::vector<Buffer> data;
+	Buffer b;
+	b.name="v";      b.data=mesh.v;      b.size=sizeof(Vec3f)*mesh.nv;  data.push_back(b);
+	b.name="f";      b.data=mesh.f;      b.size=sizeof(TriMesh::TriFace)*mesh.nf; data.push_back(b);
+	if ( mesh.nvn > 0 ) {
+		b.name="vn"; b.data=mesh.vn;     b.size=sizeof(Vec3f)*mesh.nvn; data.push_back(b);
+		b.name="fn"; b.data=mesh.fn;     b.size=sizeof(TriMesh::TriFace)*mesh.nf; data.push_back(b);
+	}
+	if ( mesh.nvt > 0 ) {
+		b.name="vt"; b.data=mesh.vt;     b.size=sizeof(Vec3f)*mesh.nvt; data.push_back(b);
+		b.name="ft"; b.data=mesh.ft;     b.size=sizeof(TriMesh::TriFace)*mesh.nf; data.push_back(b);
+	}
+	if ( mesh.nm > 0 ) {
+		b.name="mcfc"; b.data=mesh.mcfc; b.size=sizeof(int)*mesh.nm; data.push_back(b);
+		b.name="mtl";  b.data=mtl.data(); b.size=mtl.size(); data.push_back(b);
+	}
+	b.name="bounds"; b.data=bounds;      b.size=sizeof(bounds); data.push_back(b);
+	for ( int i=0; i<numBuffers; i++ ) data.push_back( buffers[i] );
+
+	Header header;
+	memset( &header, 0, sizeof(header) );	// the magic is written last, so that incomplete files are never valid
+	header.version     = VERSION;
+	header.byteOrder   = 0x01020304;
+	header.sourceSize  = sourceInfo.size;
+	header.sourceTime  = sourceInfo.time;
+	header.sourceHash  = sourceInfo.hash;
+	header.flags       = loadMtl ? FLAG_MTL : 0;
+	header.numSections = (uint32_t) data.size();
+	header.bufferVersion = bufferVersion;
+
+	const uint64_t alignment = 64;
+	std::vector<Section> sections( data.size() );
+	uint64_t offset = sizeof(Header) + sizeof(Section)*data.size();
+	for ( size_t i=0; i<data.size(); i++ ) {
+		memset( sections[i].name, 0, sizeof(sections[i].name) );
+		strncpy( sections[i].name, data[i].name, sizeof(sections[i].name)-1 );
+		offset = ( offset + alignment - 1 ) & ~(alignment-1);
+		sections[i].offset = offset;
+		sections[i].size   = data[i].size;
+		offset += data[i].size;
+	}
+
+	FILE *fp = fopen( cacheFilename, "wb" );
+	if ( !fp ) return false;
+	bool ok = fwrite( &header, sizeof(Header), 1, fp ) == 1;
+	ok = ok && fwrite( sections.data(), sizeof(Section), sections.size(), fp ) == sections.size();
+	offset = sizeof(Header) + sizeof(Section)*data.size();
+	const char padding[alignment] = {};
+	for ( size_t i=0; ok && i<data.size(); i++ ) {
+		size_t pad = size_t( sections[i].offset - offset );
+		if ( pad > 0 ) ok = fwrite( padding, 1, pad, fp ) == pad;
+		if ( ok && data[i].size > 0 ) ok = fwrite( data[i].data, 1, data[i].size, fp ) == data[i].size;
+		offset = sections[i].offset + sections[i].size;
+	}
+	if ( ok ) {
+		memcpy( header.magic, "CYMESH\0\0", 8 );
+		ok = fseek( fp, 0, SEEK_SET ) == 0 && fwrite( header.magic, 8, 1, fp ) == 1;
+	}
+	if ( fclose(fp) != 0 ) ok = false;
+	if ( !ok ) remove( cacheFilename );
+	return ok;
+}
+
+inline bool MeshCache::GetSourceInfo( char const *filename, SourceInfo &info, bool computeHash )
+{
+#ifdef _WIN32
+	struct _stat64 st;
+	if ( _stat64( filename, &st ) != 0 ) return false;
+#else
+	struct stat st;
+	if ( stat( filename, &st ) != 0 ) return false;
+#endif
+	info.size = (uint64_t) st.st_size;
+	info.time = (int64_t) st.st_mtime;
+	info.hash = 0;
+	if ( computeHash ) {
+		MemoryMap source;
+		if ( !source.Open( filename ) ) return false;
+		info.hash = Hash( source.Data(), source.Size() );
+	}
+	return true;
+}
+
+inline uint64_t MeshCache::Hash( void const *data, size_t size )
+{
+	// FNV-1a applied to 8-byte words, followed by the remaining bytes
+	const uint64_t prime = 0x100000001B3ull;
+	uint64_t h = 0xCBF29CE484222325ull ^ size;
+	char const *p = (char const *) data;
+	char const *end = p + size;
+	for ( ; end-p >= 8; p+=8 ) {
+		uint64_t w;
+		memcpy( &w, p, 8 );
+		h = ( h ^ w ) * prime;
+		h ^= h >> 29;
+	}
+	for ( ; p<end; p++ ) h = ( h ^ (unsigned char)*p ) * prime;
+	return h;
+}
+
+inline std::string MeshCache::GetCacheFilename( char const *filename )
+{
+	std::string name = filename;
+	size_t dot = name.find_last_of( '.' );
+	size_t sep = name.find_last_of( "/\\" );
+	if ( dot != std::string::npos && ( sep == std::string::npos || dot > sep ) ) name.resize( dot );
+	return name + ".cymesh";
+}
+
+inline void MeshCache::WriteString( std::vector<char> &data, char const *str )
+{
+	uint32_t n = str ? (uint32_t) strlen(str) : 0xFFFFFFFF;
+	data.insert( data.end(), (char const *)&n, (char const *)&n + sizeof(n) );
+	if ( str ) data.insert( data.end(), str, str + n );
+}
+
+inline bool MeshCache::ReadString( char const *&p, char const *end, TriMesh::Str &str )
+{
+	uint32_t n;
+	if ( size_t(end-p) < sizeof(n) ) return false;
+	memcpy( &n, p, sizeof(n) );
+	p += sizeof(n);
+	if ( n == 0xFFFFFFFF ) { str = nullptr; return true; }
+	if ( size_t(end-p) < n ) return false;
+	std::string s( p, n );
+	str = s.c_str();
+	p += n;
+	return true;
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::MeshCache cyMeshCache;	//!< Binary mesh cache file
+
+//-------------------------------------------------------------------------------
+
+#endif
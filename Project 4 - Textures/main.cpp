@@ -2,23 +2,25 @@
 #include <GL/freeglut.h>
 #include <iostream>
 #include <stdlib.h>
+#include <map>
+#include <algorithm>
 #include "cyCodeBase/cyCore.h"
 #include "cyCodeBase/cyVector.h"
 #include "cyCodeBase/cyMatrix.h"
 #include "cyCodeBase/cyTriMesh.h"
+#include "cyCodeBase/cyMeshCache.h"
+#include "cyCodeBase/cyMeshWeld.h"
+#include "cyCodeBase/cyMeshOptimizer.h"
 #include "cyCodeBase/cyGL.h"
+#include "cyCodeBase/cyVertexLayout.h"
+#include "cyCodeBase/cyGLB.h"
 #include "lodepng.h"
 
-// number of vertices in given obj
-int num_v;
-// number of faces in given obj
-int num_f;
+// number of indices to draw
+GLsizei num_indices;
 // number of materials in given obj
 int num_m;
 
-// vector to store vertices
-std::vector<GLfloat> vertices;
-
 // texture image width and height
 unsigned img_width = 2048;
 unsigned img_height = 2048;
@@ -73,23 +75,58 @@ GLuint tex_a;
 GLuint tex_d;
 GLuint tex_s;
 
-// Attributes
-GLuint pos;
-GLuint norm;
-GLuint txc;
-
 // VAO and VBOs
-GLuint vao, vbo[3];
+GLuint vao, vbo[2];
+
+// quantization ranges of the vertex data
+cy::VertexQuantization quant;
+
+// material state, vertex array, and model matrix, and the index ranges drawn with them
+// (index_type is zero for vertices without indices, which are drawn with a single range)
+struct MaterialBatch
+{
+    cyVec3f k_a, k_d, k_s;
+    GLuint tex_a, tex_d, tex_s;
+    GLuint vao;
+    GLenum index_type;
+    cyMatrix4f model;
+    std::vector<GLsizei> counts;
+    std::vector<const void *> offsets;
+};
+
+// one batch per distinct material state, sorted by textures
+std::vector<MaterialBatch> batches;
+
+// textures by file name, and a white texture for materials without texture maps
+std::map<std::string, GLuint> textures;
+GLuint white_tex;
+
+// quantized vertex layout of the obj
+// positions and texture coordinates are relative to the bounding box of the mesh
+typedef cy::VertexLayout<
+    cy::VertexAttrib<cy::VERTEX_POSITION, cy::VertexUnorm16x3, 0>,
+    cy::VertexAttrib<cy::VERTEX_NORMAL, cy::VertexOct16, 1>,
+    cy::VertexAttrib<cy::VERTEX_TEXCOORD, cy::VertexUnorm16x2, 2>>
+    ObjLayout;
 
 // OBJ reader
 cyTriMesh reader;
 
+// glTF binary file, which is used instead of the OBJ reader for .glb files
+bool is_glb = false;
+cyGLBFile glb;
+std::vector<GLuint> glb_buffers;
+std::vector<GLuint> glb_vaos;
+
+// bounding box of the model
+cyVec3f bound_min, bound_max;
+
 // find center x & y points to translate to
 cyVec3f findCenter()
 {
 
-    cyVec3f max = reader.GetBoundMax();
-    cyVec3f min = reader.GetBoundMin();
+    cyVec3f max = bound_max;
+    cyVec3f min = bound_min;
 
     float center_x = min.x + ((max.x - min.x) / 2.0f);
     float center_y = min.y + ((max.y - min.y) / 2.0f);
@@ -125,192 +162,273 @@ cyTriMesh parseOBJ(int argc, const char *filename)
     // read OBJ file
     bool read_status;
     cyTriMesh reader;
-    if (!(read_status = reader.LoadFromFileObj(filename, true)))
+    cyMeshCache cache;
+    if (!(read_status = cache.LoadFromFileObj(reader, filename, true)))
     {
         fprintf(stderr, "Error: cannot read file");
         exit(1);
     }
+    bound_min = reader.GetBoundMin();
+    bound_max = reader.GetBoundMax();
     return reader;
 }
 
+// map and validate a glTF binary file
+void parseGLB(const char *filename)
+{
+    if (!glb.Load(filename))
+        exit(1);
+    glb.ComputeBoundingBox(bound_min, bound_max);
+}
+
 // generate vertex buffer object and bind data
 void getVBO()
 {
-    // read vertex data
-    num_v = reader.NV();
-    num_f = reader.NF();
+    // merge the face corners that share the same position, normal, and texture coordinate
+    cyMeshWelder welder;
+    welder.Weld(reader);
 
-    // fill vector with vertex data
-    int i;
-    for (i = 0; i < num_v; i++)
-    {
-        cyVec3f _verts = reader.V(i);
-        vertices.push_back(_verts[0]);
-        vertices.push_back(_verts[1]);
-        vertices.push_back(_verts[2]);
-    }
+    // reorder triangles and vertices for the vertex cache, keeping the faces of each material together
+    cyMeshOptimizer::OptimizeMaterials(welder, reader);
 
-    // fill vector with vertex data
-    cyVec3f *v = new cyVec3f[num_f * 3];
-    for (i = 0; i < num_f; i++)
-    {
-        cyTriMesh::TriFace _face = reader.F(i);
-        v[3 * i + 0] = reader.V(_face.v[0]);
-        v[3 * i + 1] = reader.V(_face.v[1]);
-        v[3 * i + 2] = reader.V(_face.v[2]);
-    }
+    num_indices = welder.NumIndices();
 
-    // fill vector with normal data
-    cyVec3f *n = new cyVec3f[num_f * 3];
-    for (i = 0; i < num_f; i++)
-    {
-        cyTriMesh::TriFace fn = reader.FN(i);
-        n[3 * i + 0] = reader.VN(fn.v[0]);
-        n[3 * i + 1] = reader.VN(fn.v[1]);
-        n[3 * i + 2] = reader.VN(fn.v[2]);
-    }
+    // quantize positions and texture coordinates to the bounding box of the mesh
+    quant.SetFromMesh(reader);
+    quant.SetUniforms(program_id);
 
-    // fill vector with texture data
-    cyVec3f *t = new cyVec3f[num_f * 3];
-    for (int i = 0; i < num_f; i++)
-    {
-        cyTriMesh::TriFace ft = reader.FT(i);
-        t[3 * i + 0] = reader.VT(ft.v[0]);
-        t[3 * i + 1] = reader.VT(ft.v[1]);
-        t[3 * i + 2] = reader.VT(ft.v[2]);
-    }
+    // pack vertex data into a single interleaved buffer
+    std::vector<unsigned char> vertex_data;
+    ObjLayout::Pack(vertex_data, reader, welder, quant);
+
+    // report the quantization error and the memory saved
+    cy::VertexError error = ObjLayout::MeasureError(vertex_data.data(), reader, welder, quant);
+    printf("Quantization error: position %g (max %g), normal %g deg (max %g), texcoord %g (max %g)\n",
+           error.positionRMS, error.positionMax, error.normalRMS, error.normalMax, error.texCoordRMS, error.texCoordMax);
+    printf("Vertex buffer: %u bytes (%u bytes with floats)\n", (unsigned)vertex_data.size(), welder.NumVertices() * 8u * (unsigned)sizeof(GLfloat));
 
     // generate and bind vertex buffer objects and vertex array object
     glGenVertexArrays(1, &vao);
     glBindVertexArray(vao);
 
-    glGenBuffers(3, vbo);
+    glGenBuffers(2, vbo);
 
     glBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
-    glBufferData(GL_ARRAY_BUFFER, num_f * 3 * sizeof(cyVec3f), v, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(pos);
-    glVertexAttribPointer(pos, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
-    glBufferData(GL_ARRAY_BUFFER, num_f * 3 * sizeof(cyVec3f), n, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(norm);
-    glVertexAttribPointer(norm, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vbo[2]);
-    glBufferData(GL_ARRAY_BUFFER, num_f * 3 * sizeof(cyVec3f), t, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(txc);
-    glVertexAttribPointer(txc, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
+    glBufferData(GL_ARRAY_BUFFER, vertex_data.size(), vertex_data.data(), GL_STATIC_DRAW);
+    ObjLayout::SetAttribs(vbo[0]);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, num_indices * sizeof(GLuint), welder.Indices().data(), GL_STATIC_DRAW);
 }
 
-// bind textures
-void setTextures()
-{
-    num_m = reader.NM();
+GLuint createTexture(const std::vector<unsigned char> &image, unsigned error);
 
-    int offset = 0;
+// load a PNG texture, or return the texture if it is already loaded
+GLuint loadTexture(const char *filename)
+{
+    // no texture
+    if (filename == nullptr)
+        return white_tex;
+
+    // textures shared by materials are loaded once
+    std::string name(filename);
+    std::map<std::string, GLuint>::iterator it = textures.find(name);
+    if (it != textures.end())
+        return it->second;
+
+    // decode PNG file
+    std::vector<unsigned char> image;
+    unsigned error = lodepng::decode(image, img_width, img_height, name);
+    GLuint tex = createTexture(image, error);
+    textures[name] = tex;
+    return tex;
+}
 
-    for (int i = 0; i < num_m; i++)
+// create a texture from a decoded PNG image, or return the white texture if the image could not be decoded
+GLuint createTexture(const std::vector<unsigned char> &image, unsigned error)
+{
+    if (error)
     {
-        // set K_a, K_d, K_s
-        glUniform3f(K_a, reader.M(i).Ka[0], reader.M(i).Ka[1], reader.M(i).Ka[2]);
-        glUniform3f(K_d, reader.M(i).Kd[0], reader.M(i).Kd[1], reader.M(i).Kd[2]);
-        glUniform3f(K_s, reader.M(i).Ks[0], reader.M(i).Ks[1], reader.M(i).Ks[2]);
+        std::cout << "decoder error " << error << ": " << lodepng_error_text(error) << std::endl;
+        return white_tex;
+    }
 
-        // decode diffuse PNG file
-        unsigned error;
+    // generate and bind texture
+    GLuint tex;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, img_width, img_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &image[0]);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    return tex;
+}
 
-        // check for no texture
-        if (reader.M(i).map_Ka.data != nullptr)
-        {
-            // decode ambient PNG file
-            std::string ambient_mtl(reader.M(i).map_Ka.data);
-            std::vector<unsigned char> ambient_image;
-            error = lodepng::decode(ambient_image, img_width, img_height, ambient_mtl);
-            if (error)
-                std::cout << "decoder error " << error << ": " << lodepng_error_text(error) << std::endl;
-
-            // generate and bind texture
-            glGenTextures(1, &tex_a);
-
-            glActiveTexture(GL_TEXTURE0 + offset);
-            glBindTexture(GL_TEXTURE_2D, tex_a);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, img_width, img_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &ambient_image[0]);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glGenerateMipmap(GL_TEXTURE_2D);
-
-            glUniform1i(tex_a, offset);
-
-            offset += 1;
-        }
-        else
-        {
-            // no texture
-            glUniform1i(tex_a, 255);
-        }
+// load the texture of a glTF material, decoding embedded images in place from the mapped file
+GLuint loadGLBTexture(int texture)
+{
+    if (texture < 0 || glb.GetTexture(texture).image < 0)
+        return white_tex;
+    const cyGLBFile::Image &img = glb.GetImage(glb.GetTexture(texture).image);
+    if (img.bufferView < 0)
+        return loadTexture(img.uri.c_str());
+
+    // embedded images are cached by their buffer view
+    std::string name = "glb:" + std::to_string(img.bufferView);
+    std::map<std::string, GLuint>::iterator it = textures.find(name);
+    if (it != textures.end())
+        return it->second;
+
+    std::vector<unsigned char> image;
+    unsigned error = lodepng::decode(image, img_width, img_height, (const unsigned char *)glb.BufferViewData(img.bufferView), glb.GetBufferView(img.bufferView).byteLength);
+    GLuint tex = createTexture(image, error);
+    textures[name] = tex;
+    return tex;
+}
 
-        // check for no texture
-        if (reader.M(i).map_Kd.data != nullptr)
-        {
-            // decode diffuse PNG file
-            std::string diffuse_mtl(reader.M(i).map_Kd.data);
-            std::vector<unsigned char> diffuse_image;
-            error = lodepng::decode(diffuse_image, img_width, img_height, diffuse_mtl);
-            if (error)
-                std::cout << "decoder error " << error << ": " << lodepng_error_text(error) << std::endl;
-
-            // generate and bind texture
-            glGenTextures(1, &tex_d);
-
-            glActiveTexture(GL_TEXTURE0 + offset);
-            glBindTexture(GL_TEXTURE_2D, tex_d);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, img_width, img_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &diffuse_image[0]);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glGenerateMipmap(GL_TEXTURE_2D);
-
-            glUniform1i(tex_d, offset);
-
-            offset += 1;
-        }
+// order batches by textures, so that consecutive batches share as many bindings as possible
+bool compareBatches(const MaterialBatch &a, const MaterialBatch &b)
+{
+    if (a.tex_d != b.tex_d)
+        return a.tex_d < b.tex_d;
+    if (a.tex_a != b.tex_a)
+        return a.tex_a < b.tex_a;
+    if (a.tex_s != b.tex_s)
+        return a.tex_s < b.tex_s;
+    return a.vao < b.vao;
+}
+
+// create the white texture for materials without texture maps
+void setWhiteTexture()
+{
+    const unsigned char white[4] = {255, 255, 255, 255};
+    glGenTextures(1, &white_tex);
+    glBindTexture(GL_TEXTURE_2D, white_tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+}
+
+// load textures and group the material face ranges by material state
+void setTextures()
+{
+    num_m = reader.NM();
+    setWhiteTexture();
+
+    // the faces are sorted by material when the OBJ file is loaded, and the faces without a material come last
+    batches.clear();
+    int first_face = 0;
+    for (int i = 0; i <= num_m; i++)
+    {
+        cyTriMesh::Mtl mtl = (i < num_m) ? reader.M(i) : cyTriMesh::Mtl();
+        int face_count = (i < num_m) ? reader.GetMaterialFaceCount(i) : reader.NF() - first_face;
+        if (i < num_m)
+            first_face = reader.GetMaterialFirstFace(i);
+        if (face_count <= 0)
+            continue;
+
+        MaterialBatch batch;
+        batch.k_a = cyVec3f(mtl.Ka[0], mtl.Ka[1], mtl.Ka[2]);
+        batch.k_d = cyVec3f(mtl.Kd[0], mtl.Kd[1], mtl.Kd[2]);
+        batch.k_s = cyVec3f(mtl.Ks[0], mtl.Ks[1], mtl.Ks[2]);
+        batch.tex_a = loadTexture(mtl.map_Ka.data);
+        batch.tex_d = loadTexture(mtl.map_Kd.data);
+        batch.tex_s = loadTexture(mtl.map_Ks.data);
+        batch.vao = vao;
+        batch.index_type = GL_UNSIGNED_INT;
+        batch.model.SetIdentity();
+        GLsizei count = face_count * 3;
+        const char *offset = (const char *)0 + sizeof(GLuint) * first_face * 3;
+        first_face += face_count;
+
+        // add the range to the batch with the same state, merging it with the previous range if they are adjacent
+        size_t j = 0;
+        while (j < batches.size() && !(batches[j].k_a == batch.k_a && batches[j].k_d == batch.k_d && batches[j].k_s == batch.k_s &&
+                                       batches[j].tex_a == batch.tex_a && batches[j].tex_d == batch.tex_d && batches[j].tex_s == batch.tex_s))
+            j++;
+        if (j == batches.size())
+            batches.push_back(batch);
+        MaterialBatch &b = batches[j];
+        if (!b.counts.empty() && (const char *)b.offsets.back() + sizeof(GLuint) * b.counts.back() == offset)
+            b.counts.back() += count;
         else
         {
-            // no texture
-            glUniform1i(tex_d, 255);
+            b.counts.push_back(count);
+            b.offsets.push_back(offset);
         }
+    }
+    std::sort(batches.begin(), batches.end(), compareBatches);
+    printf("Materials: %d, draw batches: %d\n", num_m, (int)batches.size());
+}
 
-        // check for no texture
-        if (reader.M(i).map_Ks.data != nullptr)
+// upload the buffer views of the glTF file directly from the mapped file, and create a batch for each triangle primitive of each mesh instance
+void setGLB()
+{
+    num_m = glb.NumMaterials();
+    setWhiteTexture();
+
+    // the vertex data is drawn as it is stored, and glTF texture coordinates start at the top left
+    quant.SetIdentity();
+    quant.texCoordOffset.y = 1;
+    quant.texCoordScale.y = -1;
+    quant.SetUniforms(program_id);
+
+    glb.CreateBuffers(glb_buffers);
+    const GLint locations[cyGLBFile::NUM_ATTRIBS] = {0, 1, 2};
+    // primitives without normals get a zero normal, for which the fragment shader uses the flat normal of the triangle
+    glVertexAttrib3f(locations[cyGLBFile::ATTRIB_NORMAL], 0, 0, 0);
+
+    // vertex array objects of the primitives, shared by their instances
+    std::vector<std::vector<GLuint>> prim_vaos(glb.NumMeshes());
+    for (int m = 0; m < glb.NumMeshes(); m++)
+    {
+        const cyGLBFile::Mesh &mesh = glb.GetMesh(m);
+        for (size_t p = 0; p < mesh.primitives.size(); p++)
         {
-            // decode specular PNG file
-            std::string specular_mtl(reader.M(i).map_Ks.data);
-            std::vector<unsigned char> specular_image;
-            error = lodepng::decode(specular_image, img_width, img_height, specular_mtl);
-            if (error)
-                std::cout << "decoder error " << error << ": " << lodepng_error_text(error) << std::endl;
-
-            // generate and bind texture
-            glGenTextures(1, &tex_s);
-
-            glActiveTexture(GL_TEXTURE0 + offset);
-            glBindTexture(GL_TEXTURE_2D, tex_s);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, img_width, img_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &specular_image[0]);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glGenerateMipmap(GL_TEXTURE_2D);
-
-            glUniform1i(tex_s, offset);
-
-            offset += 1;
+            GLuint prim_vao;
+            glGenVertexArrays(1, &prim_vao);
+            glBindVertexArray(prim_vao);
+            glb.SetAttribs(mesh.primitives[p], glb_buffers, locations);
+            prim_vaos[m].push_back(prim_vao);
+            glb_vaos.push_back(prim_vao);
         }
-        else
+    }
+    glBindVertexArray(0);
+
+    batches.clear();
+    const std::vector<cyGLBFile::MeshInstance> &instances = glb.GetMeshInstances();
+    for (size_t i = 0; i < instances.size(); i++)
+    {
+        const cyGLBFile::Mesh &mesh = glb.GetMesh(instances[i].mesh);
+        for (size_t p = 0; p < mesh.primitives.size(); p++)
         {
-            // no texture
-            glUniform1i(tex_s, 255);
+            const cyGLBFile::Primitive &prim = mesh.primitives[p];
+            if (prim.mode != GL_TRIANGLES)
+                continue;
+
+            // base color as the diffuse color, and a specular color from the roughness
+            MaterialBatch batch;
+            batch.k_a = cyVec3f(0, 0, 0);
+            batch.k_d = cyVec3f(1, 1, 1);
+            batch.k_s = cyVec3f(0, 0, 0);
+            batch.tex_a = batch.tex_d = batch.tex_s = white_tex;
+            if (prim.material >= 0)
+            {
+                const cyGLBFile::Material &mtl = glb.GetMaterial(prim.material);
+                batch.k_d = cyVec3f(mtl.baseColor[0], mtl.baseColor[1], mtl.baseColor[2]);
+                batch.k_s = cyVec3f(1, 1, 1) * (1 - mtl.roughness);
+                batch.tex_d = loadGLBTexture(mtl.baseColorTexture);
+            }
+            batch.vao = prim_vaos[instances[i].mesh][p];
+            batch.index_type = prim.indices >= 0 ? glb.IndexType(prim) : 0;
+            batch.model = instances[i].transform;
+            batch.counts.push_back(glb.NumElements(prim));
+            batch.offsets.push_back(prim.indices >= 0 ? glb.IndexOffset(prim) : nullptr);
+            batches.push_back(batch);
         }
     }
-
-    getVBO();
+    std::sort(batches.begin(), batches.end(), compareBatches);
+    printf("Meshes: %d, materials: %d, draw batches: %d\n", glb.NumMeshes(), num_m, (int)batches.size());
 }
 
 // read, compile and link shaders to program
@@ -321,7 +439,12 @@ void compileShaders()
 
     // read and compile shader files
     bool read_status;
-    if (!(read_status = vert.CompileFile("shader.vert", GL_VERTEX_SHADER)))
+    // the vertex shader uses the decode functions of the quantized vertex layout
+    std::string vert_prepend = std::string("#version 400 core\n") + cy::VertexQuantization::GLSLDecode();
+    // glTF files store normals as float vectors
+    if (is_glb)
+        vert_prepend += "#define CY_FLOAT_NORMALS\n";
+    if (!(read_status = vert.CompileFile("shader.vert", GL_VERTEX_SHADER, vert_prepend.c_str())))
     {
         fprintf(stderr, "Error: vertex shader compilation failed");
     }
@@ -349,10 +472,13 @@ void compileShaders()
     tex_d = glGetUniformLocation(program_id, "tex_d");
     tex_s = glGetUniformLocation(program_id, "tex_s");
 
-    // set attribute locations
-    pos = glGetAttribLocation(program_id, "pos");
-    norm = glGetAttribLocation(program_id, "norm");
-    txc = glGetAttribLocation(program_id, "txc");
+    // ambient, diffuse, and specular textures use fixed texture units
+    glUniform1i(tex_a, 0);
+    glUniform1i(tex_d, 1);
+    glUniform1i(tex_s, 2);
+
+    // quantization ranges of the vertex data
+    quant.SetUniforms(program_id);
 }
 
 // detach shaders from program and delete them
@@ -383,16 +509,45 @@ void draw()
     glUseProgram(program_id);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // calculate and set mvp matrix
-    float matrix[16];
-    float _mvn[16];
-    getMVP().Get(matrix);
-    getMVN().Get(_mvn);
-    glUniformMatrix4fv(mvp, 1, false, matrix);
-    glUniformMatrix4fv(mvn, 1, false, _mvn);
+    // view matrices, multiplied by the model matrix of each batch
+    cyMatrix4f view_mvp = getMVP();
+    cyMatrix4f view_mvn = getMVN();
 
-    // draw
-    glDrawArrays(GL_TRIANGLES, 0, num_f * 3 * sizeof(cyVec3f));
+    // draw each material batch with a single multi-draw, binding only the textures and vertex arrays that change
+    GLuint bound[3] = {0, 0, 0};
+    GLuint bound_vao = 0;
+    for (size_t i = 0; i < batches.size(); i++)
+    {
+        const MaterialBatch &b = batches[i];
+        float matrix[16];
+        float _mvn[16];
+        (view_mvp * b.model).Get(matrix);
+        (view_mvn * b.model).Get(_mvn);
+        glUniformMatrix4fv(mvp, 1, false, matrix);
+        glUniformMatrix4fv(mvn, 1, false, _mvn);
+        if (bound_vao != b.vao)
+        {
+            glBindVertexArray(b.vao);
+            bound_vao = b.vao;
+        }
+        glUniform3f(K_a, b.k_a.x, b.k_a.y, b.k_a.z);
+        glUniform3f(K_d, b.k_d.x, b.k_d.y, b.k_d.z);
+        glUniform3f(K_s, b.k_s.x, b.k_s.y, b.k_s.z);
+        GLuint tex[3] = {b.tex_a, b.tex_d, b.tex_s};
+        for (int k = 0; k < 3; k++)
+        {
+            if (bound[k] != tex[k])
+            {
+                glActiveTexture(GL_TEXTURE0 + k);
+                glBindTexture(GL_TEXTURE_2D, tex[k]);
+                bound[k] = tex[k];
+            }
+        }
+        if (b.index_type == 0)
+            glDrawArrays(GL_TRIANGLES, 0, b.counts[0]);
+        else
+            glMultiDrawElements(GL_TRIANGLES, b.counts.data(), b.index_type, b.offsets.data(), (GLsizei)b.counts.size());
+    }
 
     // Swap buffers
     glutSwapBuffers();
@@ -428,7 +583,6 @@ void spclKeyListener(int key, int x, int y)
     case GLUT_KEY_F6:
         removeShaders();
         compileShaders();
-        setTextures();
         break;
     }
 }
@@ -529,9 +683,20 @@ int main(int argc, char *argv[])
 
     // setup program, VBOs and shaders
     program_id = glCreateProgram();
+    std::string filename = argc > 1 ? argv[1] : "";
+    is_glb = filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".glb") == 0;
     compileShaders();
-    reader = parseOBJ(argc, argv[1]);
-    setTextures();
+    if (is_glb)
+    {
+        parseGLB(argv[1]);
+        setGLB();
+    }
+    else
+    {
+        reader = parseOBJ(argc, argv[1]);
+        getVBO();
+        setTextures();
+    }
 
     // start
     glutMainLoop();
@@ -539,7 +704,10 @@ int main(int argc, char *argv[])
     // clear VBO buffers
     glDeleteBuffers(1, &vbo[0]);
     glDeleteBuffers(1, &vbo[1]);
-    glDeleteBuffers(1, &vbo[2]);
+    if (!glb_buffers.empty())
+        glDeleteBuffers((GLsizei)glb_buffers.size(), glb_buffers.data());
+    if (!glb_vaos.empty())
+        glDeleteVertexArrays((GLsizei)glb_vaos.size(), glb_vaos.data());
 
     return 0;
 }
\ No newline at end of file
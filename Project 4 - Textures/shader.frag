@@ -22,8 +22,12 @@ void main()
 	vec3 v = vec3(normalize(frag_pos)) * vec3(-1, -1, -1);
 	vec3 h = normalize(light_dir + v);
 
-	float cos_theta = max(0.0, dot(normalize(frag_norm), light_dir));
-	float cos_phi = max(0.0, dot(normalize(frag_norm), h));
+	// triangles without vertex normals (a zero normal) use the flat normal of the triangle
+	vec3 flat_norm = cross(dFdx(frag_pos.xyz), dFdy(frag_pos.xyz));
+	vec3 n = normalize(dot(frag_norm, frag_norm) > 0.0 ? frag_norm : flat_norm);
+
+	float cos_theta = max(0.0, dot(n, light_dir));
+	float cos_phi = max(0.0, dot(n, h));
 
 	vec3 I = vec3(1, 1, 1);
 
@@ -1,8 +1,12 @@
-#version 400 core
+// "#version" and the cyDecode* functions are prepended by the application
 
 layout(location=0) in vec3 pos;
+#ifdef CY_FLOAT_NORMALS
 layout(location=1) in vec3 norm;
-layout(location=2) in vec3 txc;
+#else
+layout(location=1) in vec2 norm;
+#endif
+layout(location=2) in vec2 txc;
 
 uniform mat4 mvp;
 uniform mat4 mvn;
@@ -13,9 +17,17 @@ out vec2 frag_txc;
 
 void main()
 {
-	frag_pos = mvn * vec4(pos, 1);
-	frag_norm = (transpose(inverse(mvn)) * vec4(norm,0)).xyz;
-	frag_txc = vec2(txc.x, 1.0 - txc.y);
+	vec3 p = cyDecodePosition(pos);
+#ifdef CY_FLOAT_NORMALS
+	vec3 n = norm;
+#else
+	vec3 n = cyDecodeOctNormal(norm);
+#endif
+	vec2 t = cyDecodeTexCoord(txc);
 
-	gl_Position = mvp * vec4(pos, 1);
+	frag_pos = mvn * vec4(p, 1);
+	frag_norm = (transpose(inverse(mvn)) * vec4(n,0)).xyz;
+	frag_txc = vec2(t.x, 1.0 - t.y);
+
+	gl_Position = mvp * vec4(p, 1);
 }
\ No newline at end of file
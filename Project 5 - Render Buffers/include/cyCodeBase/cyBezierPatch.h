@@ -0,0 +1,320 @@
+//-------------------------------------------------------------------------------
+//! \file   cyBezierPatch.h
+//!
+//! \brief  Bicubic Bezier patches and the Utah teapot.
+//!
+//! BezierPatches stores a set of bicubic Bezier patches as 16 control point
+//! indices per patch and a shared array of control points. The patches can be
+//! loaded from the text format of the original Newell teapot data set, or they
+//! can be generated from the built-in teapot data of GLUT. The patches are meant
+//! to be uploaded as they are and evaluated with tessellation shaders, so a
+//! surface that would be thousands of triangles needs only a few kilobytes of
+//! vertex data.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_BEZIER_PATCH_H_INCLUDED_
+#define _CY_BEZIER_PATCH_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyVector.h"
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Bicubic Bezier patches with shared control points.
+//!
+//! The control points of a patch are stored row by row: control point j*4+k is
+//! in row j and column k. The surface is evaluated with parameter u along the
+//! rows (k) and v along the columns (j), and the normal is the cross product
+//! of the derivatives with respect to u and v.
+
+class BezierPatches
+{
+public:
+	//! The control point indices of a patch, row by row.
+	struct Patch { unsigned int cp[16]; };
+
+	//!@name Loading
+	//! Loads patches from a text file in the format of the Newell teapot data set: the number of patches, then
+	//! 16 one-based control point indices per patch, then the number of control points and three coordinates
+	//! per control point. Numbers can be separated with commas or white space.
+	bool LoadFromFile( char const *filename, std::ostream *outStream=&std::cout );
+	//! Saves the patches in the format that LoadFromFile reads.
+	bool SaveToFile( char const *filename, std::ostream *outStream=&std::cout ) const;
+	//! Generates the 32 patches of the Utah teapot from the 10 patches of GLUT and their reflections, with the
+	//! z axis up and the bottom of the teapot at z=0.
+	void SetTeapot();
+	//! Merges the control points with the same position and removes the unused ones.
+	void MergeControlPoints();
+
+	//!@name Access
+	unsigned int NumPatches() const { return (unsigned int) patches.size(); }		//!< Returns the number of patches.
+	unsigned int NumControlPoints() const { return (unsigned int) cp.size(); }		//!< Returns the number of control points.
+	Patch const & GetPatch( unsigned int i ) const { return patches[i]; }			//!< Returns the control point indices of a patch.
+	Vec3f const & ControlPoint( unsigned int i ) const { return cp[i]; }			//!< Returns a control point.
+	std::vector<Patch> const & Patches() const { return patches; }					//!< Returns all patches.
+	std::vector<Vec3f> const & ControlPoints() const { return cp; }					//!< Returns all control points.
+	size_t DataBytes() const { return cp.size()*sizeof(Vec3f) + patches.size()*sizeof(Patch); }	//!< Returns the size of the control points and indices in bytes.
+
+	//!@name Evaluation
+	//! Evaluates the position of a patch at the given parameters. If normal is not null, it is set to the unit
+	//! normal. At the collapsed edges of degenerate patches, like the top of the lid, the normal is computed
+	//! slightly inside the patch.
+	Vec3f Eval( unsigned int patch, float u, float v, Vec3f *normal=nullptr ) const;
+	//! Computes the bounding box of the control points, which contains the surface.
+	void ComputeBoundingBox( Vec3f &boundMin, Vec3f &boundMax ) const;
+
+private:
+	std::vector<Vec3f> cp;
+	std::vector<Patch> patches;
+
+	static void Bernstein( float t, float b[4], float d[4] );
+};
+
+//-------------------------------------------------------------------------------
+
+inline bool BezierPatches::LoadFromFile( char const *filename, std::ostream *outStream )
+{
+	FILE *fp = fopen( filename, "r" );
+	if ( !fp ) {
+		if ( outStream ) *outStream << "ERROR: Cannot open file " << filename << std::endl;
+		return false;
+	}
+	// Reads the next number, skipping commas and white space
+	auto ReadNumber = [fp]( double &value ) {
+		int c;
+		while ( ( c = fgetc(fp) ) != EOF && ( c == ',' || c == ' ' || c == '\t' || c == '\r' || c == '\n' ) );
+		if ( c == EOF ) return false;
+		ungetc( c, fp );
+		return fscanf( fp, "%lf", &value ) == 1;
+	};
+	auto Error = [&]( char const *msg ) {
+		if ( outStream ) *outStream << "ERROR: " << filename << ": " << msg << std::endl;
+		fclose( fp );
+		cp.clear();
+		patches.clear();
+		return false;
+	};
+
+	double value;
+	if ( !ReadNumber(value) || value < 1 || value > 1e7 ) return Error( "invalid number of patches" );
+	patches.resize( (size_t) value );
+	for ( Patch &p : patches ) {
+		for ( int i=0; i<16; i++ ) {
+			if ( !ReadNumber(value) || value < 1 ) return Error( "invalid control point index" );
+			p.cp[i] = (unsigned int) value - 1;
+		}
+	}
+	if ( !ReadNumber(value) || value < 1 || value > 1e8 ) return Error( "invalid number of control points" );
+	cp.resize( (size_t) value );
+	for ( Vec3f &v : cp ) {
+		for ( int i=0; i<3; i++ ) {
+			if ( !ReadNumber(value) ) return Error( "invalid control point" );
+			v[i] = (float) value;
+		}
+	}
+	for ( Patch const &p : patches ) {
+		for ( int i=0; i<16; i++ ) if ( p.cp[i] >= cp.size() ) return Error( "control point index out of range" );
+	}
+	fclose( fp );
+	return true;
+}
+
+inline bool BezierPatches::SaveToFile( char const *filename, std::ostream *outStream ) const
+{
+	FILE *fp = fopen( filename, "w" );
+	if ( !fp ) {
+		if ( outStream ) *outStream << "ERROR: Cannot create file " << filename << std::endl;
+		return false;
+	}
+	fprintf( fp, "%u\n", NumPatches() );
+	for ( Patch const &p : patches ) {
+		for ( int i=0; i<16; i++ ) fprintf( fp, i < 15 ? "%u," : "%u\n", p.cp[i] + 1 );
+	}
+	fprintf( fp, "%u\n", NumControlPoints() );
+	for ( Vec3f const &v : cp ) fprintf( fp, "%g,%g,%g\n", v.x, v.y, v.z );
+	fclose( fp );
+	return true;
+}
+
+//-------------------------------------------------------------------------------
+
+inline void BezierPatches::SetTeapot()
+{
+	// The rim, body, lid, and bottom patches cover a quarter of the teapot and the handle and spout patches cover half of it
+	static const int numPatches = 10;
+	static const int numQuarterPatches = 6;
+	static const unsigned char patchData[numPatches][16] = {
+		// rim
+		{ 102, 103, 104, 105,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15 },
+		// body
+		{  12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27 },
+		{  24,  25,  26,  27,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40 },
+		// lid
+		{  96,  96,  96,  96,  97,  98,  99, 100, 101, 101, 101, 101,   0,   1,   2,   3 },
+		{   0,   1,   2,   3, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117 },
+		// bottom
+		{ 118, 118, 118, 118, 124, 122, 119, 121, 123, 126, 125, 120,  40,  39,  38,  37 },
+		// handle
+		{  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  52,  53,  54,  55,  56 },
+		{  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  28,  65,  66,  67 },
+		// spout
+		{  68,  69,  70,  71,  72,  73,  74,  75,  76,  77,  78,  79,  80,  81,  82,  83 },
+		{  80,  81,  82,  83,  84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95 },
+	};
+	static const float cpData[127][3] = {
+		{  0.2f,    0.0f,    2.7f     }, {  0.2f,   -0.112f,  2.7f     }, {  0.112f, -0.2f,    2.7f     }, {  0.0f,   -0.2f,    2.7f     },
+		{  1.3375f, 0.0f,    2.53125f }, {  1.3375f,-0.749f,  2.53125f }, {  0.749f, -1.3375f, 2.53125f }, {  0.0f,   -1.3375f, 2.53125f },
+		{  1.4375f, 0.0f,    2.53125f }, {  1.4375f,-0.805f,  2.53125f }, {  0.805f, -1.4375f, 2.53125f }, {  0.0f,   -1.4375f, 2.53125f },
+		{  1.5f,    0.0f,    2.4f     }, {  1.5f,   -0.84f,   2.4f     }, {  0.84f,  -1.5f,    2.4f     }, {  0.0f,   -1.5f,    2.4f     },
+		{  1.75f,   0.0f,    1.875f   }, {  1.75f,  -0.98f,   1.875f   }, {  0.98f,  -1.75f,   1.875f   }, {  0.0f,   -1.75f,   1.875f   },
+		{  2.0f,    0.0f,    1.35f    }, {  2.0f,   -1.12f,   1.35f    }, {  1.12f,  -2.0f,    1.35f    }, {  0.0f,   -2.0f,    1.35f    },
+		{  2.0f,    0.0f,    0.9f     }, {  2.0f,   -1.12f,   0.9f     }, {  1.12f,  -2.0f,    0.9f     }, {  0.0f,   -2.0f,    0.9f     },
+		{ -2.0f,    0.0f,    0.9f     },
+		{  2.0f,    0.0f,    0.45f    }, {  2.0f,   -1.12f,   0.45f    }, {  1.12f,  -2.0f,    0.45f    }, {  0.0f,   -2.0f,    0.45f    },
+		{  1.5f,    0.0f,    0.225f   }, {  1.5f,   -0.84f,   0.225f   }, {  0.84f,  -1.5f,    0.225f   }, {  0.0f,   -1.5f,    0.225f   },
+		{  1.5f,    0.0f,    0.15f    }, {  1.5f,   -0.84f,   0.15f    }, {  0.84f,  -1.5f,    0.15f    }, {  0.0f,   -1.5f,    0.15f    },
+		{ -1.6f,    0.0f,    2.025f   }, { -1.6f,   -0.3f,    2.025f   }, { -1.5f,   -0.3f,    2.25f    }, { -1.5f,    0.0f,    2.25f    },
+		{ -2.3f,    0.0f,    2.025f   }, { -2.3f,   -0.3f,    2.025f   }, { -2.5f,   -0.3f,    2.25f    }, { -2.5f,    0.0f,    2.25f    },
+		{ -2.7f,    0.0f,    2.025f   }, { -2.7f,   -0.3f,    2.025f   }, { -3.0f,   -0.3f,    2.25f    }, { -3.0f,    0.0f,    2.25f    },
+		{ -2.7f,    0.0f,    1.8f     }, { -2.7f,   -0.3f,    1.8f     }, { -3.0f,   -0.3f,    1.8f     }, { -3.0f,    0.0f,    1.8f     },
+		{ -2.7f,    0.0f,    1.575f   }, { -2.7f,   -0.3f,    1.575f   }, { -3.0f,   -0.3f,    1.35f    }, { -3.0f,    0.0f,    1.35f    },
+		{ -2.5f,    0.0f,    1.125f   }, { -2.5f,   -0.3f,    1.125f   }, { -2.65f,  -0.3f,    0.9375f  }, { -2.65f,   0.0f,    0.9375f  },
+		{ -2.0f,   -0.3f,    0.9f     }, { -1.9f,   -0.3f,    0.6f     }, { -1.9f,    0.0f,    0.6f     },
+		{  1.7f,    0.0f,    1.425f   }, {  1.7f,   -0.66f,   1.425f   }, {  1.7f,   -0.66f,   0.6f     }, {  1.7f,    0.0f,    0.6f     },
+		{  2.6f,    0.0f,    1.425f   }, {  2.6f,   -0.66f,   1.425f   }, {  3.1f,   -0.66f,   0.825f   }, {  3.1f,    0.0f,    0.825f   },
+		{  2.3f,    0.0f,    2.1f     }, {  2.3f,   -0.25f,   2.1f     }, {  2.4f,   -0.25f,   2.025f   }, {  2.4f,    0.0f,    2.025f   },
+		{  2.7f,    0.0f,    2.4f     }, {  2.7f,   -0.25f,   2.4f     }, {  3.3f,   -0.25f,   2.4f     }, {  3.3f,    0.0f,    2.4f     },
+		{  2.8f,    0.0f,    2.475f   }, {  2.8f,   -0.25f,   2.475f   }, {  3.525f, -0.25f,   2.49375f }, {  3.525f,  0.0f,    2.49375f },
+		{  2.9f,    0.0f,    2.475f   }, {  2.9f,   -0.15f,   2.475f   }, {  3.45f,  -0.15f,   2.5125f  }, {  3.45f,   0.0f,    2.5125f  },
+		{  2.8f,    0.0f,    2.4f     }, {  2.8f,   -0.15f,   2.4f     }, {  3.2f,   -0.15f,   2.4f     }, {  3.2f,    0.0f,    2.4f     },
+		{  0.0f,    0.0f,    3.15f    },
+		{  0.8f,    0.0f,    3.15f    }, {  0.8f,   -0.45f,   3.15f    }, {  0.45f,  -0.8f,    3.15f    }, {  0.0f,   -0.8f,    3.15f    },
+		{  0.0f,    0.0f,    2.85f    },
+		{  1.4f,    0.0f,    2.4f     }, {  1.4f,   -0.784f,  2.4f     }, {  0.784f, -1.4f,    2.4f     }, {  0.0f,   -1.4f,    2.4f     },
+		{  0.4f,    0.0f,    2.55f    }, {  0.4f,   -0.224f,  2.55f    }, {  0.224f, -0.4f,    2.55f    }, {  0.0f,   -0.4f,    2.55f    },
+		{  1.3f,    0.0f,    2.55f    }, {  1.3f,   -0.728f,  2.55f    }, {  0.728f, -1.3f,    2.55f    }, {  0.0f,   -1.3f,    2.55f    },
+		{  1.3f,    0.0f,    2.4f     }, {  1.3f,   -0.728f,  2.4f     }, {  0.728f, -1.3f,    2.4f     }, {  0.0f,   -1.3f,    2.4f     },
+		{  0.0f,    0.0f,    0.0f     },
+		{  1.425f, -0.798f,  0.0f     }, {  1.5f,    0.0f,    0.075f   }, {  1.425f,  0.0f,    0.0f     }, {  0.798f, -1.425f,  0.0f     },
+		{  0.0f,   -1.5f,    0.075f   }, {  0.0f,   -1.425f,  0.0f     }, {  1.5f,   -0.84f,   0.075f   }, {  0.84f,  -1.5f,    0.075f   },
+	};
+
+	// Each reflection reverses the columns, so that all patches keep the same orientation
+	static const float reflections[4][2] = { { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+	cp.clear();
+	patches.clear();
+	for ( int i=0; i<numPatches; i++ ) {
+		int numReflections = i < numQuarterPatches ? 4 : 2;
+		for ( int r=0; r<numReflections; r++ ) {
+			float sx = reflections[r][0], sy = reflections[r][1];
+			bool reverse = sx * sy < 0;
+			Patch p;
+			for ( int j=0; j<4; j++ ) {
+				for ( int k=0; k<4; k++ ) {
+					float const *c = cpData[ patchData[i][ j*4 + ( reverse ? 3-k : k ) ] ];
+					p.cp[j*4+k] = (unsigned int) cp.size();
+					cp.push_back( Vec3f( c[0]*sx + 0.0f, c[1]*sy + 0.0f, c[2] ) );	// adding zero turns -0 into 0
+				}
+			}
+			patches.push_back( p );
+		}
+	}
+	MergeControlPoints();
+}
+
+inline void BezierPatches::MergeControlPoints()
+{
+	std::vector<unsigned int> order( cp.size() ), remap( cp.size() );
+	for ( unsigned int i=0; i<(unsigned int)cp.size(); i++ ) order[i] = i;
+	auto Less = []( Vec3f const &a, Vec3f const &b ) {
+		if ( a.x != b.x ) return a.x < b.x;
+		if ( a.y != b.y ) return a.y < b.y;
+		return a.z < b.z;
+	};
+	std::vector<bool> used( cp.size(), false );
+	for ( Patch const &p : patches ) for ( int i=0; i<16; i++ ) used[ p.cp[i] ] = true;
+	std::sort( order.begin(), order.end(), [&]( unsigned int a, unsigned int b ) { return Less( cp[a], cp[b] ); } );
+	std::vector<Vec3f> merged;
+	for ( size_t i=0; i<order.size(); i++ ) {
+		if ( !used[ order[i] ] ) continue;
+		if ( merged.empty() || Less( merged.back(), cp[order[i]] ) ) merged.push_back( cp[order[i]] );
+		remap[ order[i] ] = (unsigned int) merged.size() - 1;
+	}
+	for ( Patch &p : patches ) for ( int i=0; i<16; i++ ) p.cp[i] = remap[ p.cp[i] ];
+	cp.swap( merged );
+}
+
+//-------------------------------------------------------------------------------
+
+inline void BezierPatches::Bernstein( float t, float b[4], float d[4] )
+{
+	float s = 1 - t;
+	b[0] = s*s*s;
+	b[1] = 3*s*s*t;
+	b[2] = 3*s*t*t;
+	b[3] = t*t*t;
+	d[0] = -3*s*s;
+	d[1] = 3*s*s - 6*s*t;
+	d[2] = 6*s*t - 3*t*t;
+	d[3] = 3*t*t;
+}
+
+inline Vec3f BezierPatches::Eval( unsigned int patch, float u, float v, Vec3f *normal ) const
+{
+	Patch const &p = patches[patch];
+	float bu[4], du[4], bv[4], dv[4];
+	Bernstein( u, bu, du );
+	Bernstein( v, bv, dv );
+	Vec3f pos(0,0,0), tu(0,0,0), tv(0,0,0);
+	for ( int j=0; j<4; j++ ) {
+		for ( int k=0; k<4; k++ ) {
+			Vec3f const &c = cp[ p.cp[j*4+k] ];
+			pos += c * ( bv[j] * bu[k] );
+			tu  += c * ( bv[j] * du[k] );
+			tv  += c * ( dv[j] * bu[k] );
+		}
+	}
+	if ( normal ) {
+		Vec3f n = tu ^ tv;
+		if ( n.LengthSquared() < 1e-12f ) {
+			// a collapsed edge has a zero derivative, so the normal is taken from a nearby point
+			const float e = 1e-3f;
+			float ui = std::min( std::max( u, e ), 1-e ), vi = std::min( std::max( v, e ), 1-e );
+			if ( ui != u || vi != v ) Eval( patch, ui, vi, &n );
+		}
+		if ( n.LengthSquared() > 0 ) n.Normalize();
+		*normal = n;
+	}
+	return pos;
+}
+
+inline void BezierPatches::ComputeBoundingBox( Vec3f &boundMin, Vec3f &boundMax ) const
+{
+	if ( cp.empty() ) { boundMin.Set(0,0,0); boundMax.Set(0,0,0); return; }
+	boundMin = boundMax = cp[0];
+	for ( Vec3f const &c : cp ) {
+		for ( int i=0; i<3; i++ ) {
+			if ( boundMin[i] > c[i] ) boundMin[i] = c[i];
+			if ( boundMax[i] < c[i] ) boundMax[i] = c[i];
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::BezierPatches cyBezierPatches;	//!< Bicubic Bezier patches with shared control points
+
+//-------------------------------------------------------------------------------
+
+#endif
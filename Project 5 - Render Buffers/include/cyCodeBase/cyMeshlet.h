@@ -0,0 +1,302 @@
+//-------------------------------------------------------------------------------
+//! \file   cyMeshlet.h
+//!
+//! \brief  Meshlet clustering and culling.
+//!
+//! Meshlets splits an indexed triangle mesh into small clusters of triangles
+//! (meshlets) with a limited number of vertices and triangles. Each meshlet has
+//! a bounding sphere and a normal cone, so that the meshlets that are outside
+//! of the view frustum or that only contain back-facing triangles can be culled
+//! on the CPU before the mesh is drawn. The triangles of the visible meshlets
+//! are written into a compacted index buffer.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_MESHLET_H_INCLUDED_
+#define _CY_MESHLET_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyVector.h"
+#include "cyMatrix.h"
+#include <vector>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+# define _CY_MESHLET_SSE2
+#endif
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Meshlets of an indexed triangle mesh.
+//!
+//! The meshlets are built by scanning the triangles in the order of the index
+//! buffer, so an index buffer optimized for the vertex cache (which keeps nearby
+//! triangles together) produces compact meshlets. Each meshlet stores the
+//! indices of its vertices in the vertex buffer and its triangles as 8-bit
+//! indices into its own vertex list.
+//!
+//! The normal cone contains the normals of all triangles of the meshlet. A
+//! meshlet is back-facing if the view direction towards the cone apex is
+//! within the cone; in that case none of its triangles face the viewer.
+
+class Meshlets
+{
+public:
+	enum { MAX_VERTICES = 64, MAX_TRIANGLES = 124 };	//!< The default meshlet size limits
+
+	//! A meshlet in the vertex and triangle arrays.
+	struct Meshlet
+	{
+		unsigned int firstVertex;	//!< The first entry of the meshlet in the vertex array
+		unsigned int firstTriangle;	//!< The first triangle of the meshlet in the triangle array
+		unsigned int numVertices;	//!< The number of vertices of the meshlet
+		unsigned int numTriangles;	//!< The number of triangles of the meshlet
+	};
+
+	//! The bounding sphere and the normal cone of a meshlet.
+	struct Bounds
+	{
+		Vec3f center;		//!< Bounding sphere center
+		float radius;		//!< Bounding sphere radius
+		Vec3f coneApex;		//!< Apex of the normal cone
+		Vec3f coneAxis;		//!< Axis of the normal cone (zero if the triangles face in all directions)
+		float coneCutoff;	//!< Sine of the half angle of the normal cone (one if the meshlet cannot be back-facing)
+	};
+
+	//! Builds meshlets with at most the given number of vertices (at most 256) and triangles.
+	//! The positions are read with the given stride in bytes, so they can be part of an interleaved vertex buffer.
+	void Build( unsigned int const *indices, size_t numIndices, Vec3f const *positions, unsigned int numVertices, size_t positionStride=sizeof(Vec3f), unsigned int maxVertices=MAX_VERTICES, unsigned int maxTriangles=MAX_TRIANGLES );
+
+	//!@name Meshlet data
+	unsigned int NumMeshlets() const { return (unsigned int) meshlets.size(); }		//!< Returns the number of meshlets.
+	Meshlet const & GetMeshlet( unsigned int i ) const { return meshlets[i]; }			//!< Returns the given meshlet.
+	Bounds  const & GetBounds ( unsigned int i ) const { return bounds[i]; }			//!< Returns the bounds of the given meshlet.
+	std::vector<unsigned int>  const & Vertices () const { return vertices;  }		//!< Returns the vertex buffer indices of the meshlet vertices.
+	std::vector<unsigned char> const & Triangles() const { return triangles; }		//!< Returns three local vertex indices per triangle.
+	size_t NumIndices() const { return triangles.size(); }							//!< Returns the number of indices of all meshlets.
+
+	//!@name Culling
+	//! Finds the meshlets that intersect the view frustum and face the viewer, for the given model-view and
+	//! projection matrices. The indices of the visible meshlets are written to the given array.
+	//! Back-facing meshlets are culled only if cullBackFaces is true. Returns the number of visible meshlets.
+	unsigned int Cull( std::vector<unsigned int> &visible, Matrix4f const &modelView, Matrix4f const &projection, bool cullBackFaces=true ) const;
+	//! Writes the vertex buffer indices of the triangles of the given meshlets to the given index buffer.
+	void WriteIndices( std::vector<unsigned int> &indexBuffer, unsigned int const *meshletIDs, size_t numMeshlets ) const;
+	//! Culls the meshlets and writes the indices of the visible triangles to the given index buffer. Returns the number of visible meshlets.
+	unsigned int CullIndices( std::vector<unsigned int> &indexBuffer, Matrix4f const &modelView, Matrix4f const &projection, bool cullBackFaces=true ) const { unsigned int n = Cull( visibleTemp, modelView, projection, cullBackFaces ); WriteIndices( indexBuffer, visibleTemp.data(), n ); return n; }
+
+private:
+	std::vector<Meshlet>       meshlets;
+	std::vector<Bounds>        bounds;
+	std::vector<unsigned int>  vertices;
+	std::vector<unsigned char> triangles;
+	std::vector<float>         soa;			// bounds in groups of 4 meshlets for culling: center x,y,z, radius, apex x,y,z, axis x,y,z, cutoff
+	mutable std::vector<unsigned int> visibleTemp;
+
+	enum { SOA_FIELDS = 11 };
+
+	void ComputeBounds( Meshlet const &m, Vec3f const *positions, size_t positionStride, Bounds &b ) const;
+	static Vec3f const & Position( Vec3f const *positions, size_t stride, unsigned int i ) { return *(Vec3f const *)( (char const *) positions + stride * i ); }
+};
+
+//-------------------------------------------------------------------------------
+
+inline void Meshlets::Build( unsigned int const *indices, size_t numIndices, Vec3f const *positions, unsigned int numVertices, size_t positionStride, unsigned int maxVertices, unsigned int maxTriangles )
+{
+	meshlets.clear();
+	vertices.clear();
+	triangles.clear();
+	if ( maxVertices > 256 ) maxVertices = 256;
+	if ( maxVertices < 3 || maxTriangles < 1 ) return;
+
+	std::vector<unsigned char> localID( numVertices, 0xFF );
+	std::vector<unsigned char> localUsed( numVertices, 0 );
+	Meshlet m = { 0, 0, 0, 0 };
+	size_t numTriangles = numIndices / 3;
+	for ( size_t t=0; t<numTriangles; t++ ) {
+		unsigned int const *f = indices + t*3;
+		unsigned int newVerts = !localUsed[f[0]] + ( !localUsed[f[1]] && f[1]!=f[0] ) + ( !localUsed[f[2]] && f[2]!=f[0] && f[2]!=f[1] );
+		if ( m.numVertices + newVerts > maxVertices || m.numTriangles >= maxTriangles ) {
+			// Close the current meshlet
+			for ( unsigned int i=0; i<m.numVertices; i++ ) localUsed[ vertices[m.firstVertex+i] ] = 0;
+			meshlets.push_back( m );
+			m.firstVertex   = (unsigned int) vertices.size();
+			m.firstTriangle = (unsigned int)( triangles.size() / 3 );
+			m.numVertices   = 0;
+			m.numTriangles  = 0;
+		}
+		for ( int j=0; j<3; j++ ) {
+			unsigned int v = f[j];
+			if ( !localUsed[v] ) {
+				localUsed[v] = 1;
+				localID[v] = (unsigned char) m.numVertices++;
+				vertices.push_back( v );
+			}
+			triangles.push_back( localID[v] );
+		}
+		m.numTriangles++;
+	}
+	if ( m.numTriangles > 0 ) meshlets.push_back( m );
+
+	// Bounds, also stored in groups of four for culling
+	size_t numGroups = ( meshlets.size() + 3 ) / 4;
+	bounds.resize( meshlets.size() );
+	soa.assign( numGroups * SOA_FIELDS * 4, 0 );
+	for ( size_t i=0; i<meshlets.size(); i++ ) {
+		Bounds &b = bounds[i];
+		ComputeBounds( meshlets[i], positions, positionStride, b );
+		float fields[SOA_FIELDS] = { b.center.x, b.center.y, b.center.z, b.radius, b.coneApex.x, b.coneApex.y, b.coneApex.z, b.coneAxis.x, b.coneAxis.y, b.coneAxis.z, b.coneCutoff };
+		float *g = &soa[ ( i / 4 ) * SOA_FIELDS * 4 ];
+		for ( int k=0; k<SOA_FIELDS; k++ ) g[ k*4 + i%4 ] = fields[k];
+	}
+	// Padding meshlets are outside of every frustum
+	for ( size_t i=meshlets.size(); i<numGroups*4; i++ ) soa[ ( i / 4 ) * SOA_FIELDS * 4 + 3*4 + i%4 ] = -1;
+}
+
+inline void Meshlets::ComputeBounds( Meshlet const &m, Vec3f const *positions, size_t positionStride, Bounds &b ) const
+{
+	// Bounding sphere around the center of the bounding box
+	Vec3f pmin = Position( positions, positionStride, vertices[m.firstVertex] ), pmax = pmin;
+	for ( unsigned int i=1; i<m.numVertices; i++ ) {
+		Vec3f const &p = Position( positions, positionStride, vertices[m.firstVertex+i] );
+		for ( int k=0; k<3; k++ ) { pmin[k] = Min( pmin[k], p[k] ); pmax[k] = Max( pmax[k], p[k] ); }
+	}
+	b.center = ( pmin + pmax ) * 0.5f;
+	float r2 = 0;
+	for ( unsigned int i=0; i<m.numVertices; i++ ) r2 = Max( r2, ( Position( positions, positionStride, vertices[m.firstVertex+i] ) - b.center ).LengthSquared() );
+	b.radius = std::sqrt( r2 );
+
+	// Normal cone: the axis is the average normal, and the cutoff is the largest angle to the triangle normals
+	std::vector<Vec3f> normals( m.numTriangles );
+	Vec3f axis(0,0,0);
+	unsigned char const *tri = &triangles[ m.firstTriangle*3 ];
+	for ( unsigned int t=0; t<m.numTriangles; t++ ) {
+		Vec3f const &p0 = Position( positions, positionStride, vertices[ m.firstVertex + tri[t*3+0] ] );
+		Vec3f const &p1 = Position( positions, positionStride, vertices[ m.firstVertex + tri[t*3+1] ] );
+		Vec3f const &p2 = Position( positions, positionStride, vertices[ m.firstVertex + tri[t*3+2] ] );
+		Vec3f n = ( p1 - p0 ) ^ ( p2 - p0 );
+		float len = n.Length();
+		normals[t] = len > 0 ? n / len : Vec3f(0,0,0);
+		axis += normals[t];
+	}
+	float axisLen = axis.Length();
+	float minDot = 1;
+	if ( axisLen > 0 ) {
+		axis /= axisLen;
+		for ( unsigned int t=0; t<m.numTriangles; t++ ) minDot = Min( minDot, axis % normals[t] );
+	}
+	if ( axisLen <= 0 || minDot <= 0.1f ) {
+		// The normals span more than a hemisphere (with some margin), so the meshlet can always face the viewer
+		b.coneAxis.Zero();
+		b.coneApex = b.center;
+		b.coneCutoff = 1;
+		return;
+	}
+	// Move the apex back along the axis until the planes of all triangles are in front of it
+	float maxT = 0;
+	for ( unsigned int t=0; t<m.numTriangles; t++ ) {
+		Vec3f const &p0 = Position( positions, positionStride, vertices[ m.firstVertex + tri[t*3+0] ] );
+		float dn = axis % normals[t];
+		if ( dn > 0 ) maxT = Max( maxT, ( ( b.center - p0 ) % normals[t] ) / dn );
+	}
+	b.coneApex = b.center - axis * maxT;
+	b.coneAxis = axis;
+	b.coneCutoff = std::sqrt( 1 - minDot*minDot );
+}
+
+inline unsigned int Meshlets::Cull( std::vector<unsigned int> &visible, Matrix4f const &modelView, Matrix4f const &projection, bool cullBackFaces ) const
+{
+	visible.resize( meshlets.size() );
+	if ( meshlets.empty() ) return 0;
+
+	// Frustum planes in model space, from the rows of the model-view-projection matrix
+	Matrix4f mvp = projection * modelView;
+	float planes[6][4];
+	for ( int p=0; p<6; p++ ) {
+		int r = p / 2;
+		float s = ( p & 1 ) ? -1.0f : 1.0f;
+		for ( int k=0; k<4; k++ ) planes[p][k] = mvp.cell[k*4+3] + s * mvp.cell[k*4+r];
+		float len = std::sqrt( planes[p][0]*planes[p][0] + planes[p][1]*planes[p][1] + planes[p][2]*planes[p][2] );
+		if ( len > 0 ) for ( int k=0; k<4; k++ ) planes[p][k] /= len;
+	}
+
+	// The viewer in model space: a position for perspective projections, and a view direction for orthographic ones
+	Matrix4f inv = modelView.GetInverse();
+	bool perspective = projection.cell[11] != 0;
+	Vec3f eye = perspective ? Vec3f( inv.cell[12], inv.cell[13], inv.cell[14] ) : Vec3f( -inv.cell[8], -inv.cell[9], -inv.cell[10] );
+	float cullCones = cullBackFaces ? 1.0f : 0.0f;
+
+	unsigned int n = 0;
+	size_t numGroups = ( meshlets.size() + 3 ) / 4;
+	for ( size_t g=0; g<numGroups; g++ ) {
+		float const *s = &soa[ g * SOA_FIELDS * 4 ];
+		int mask;
+#ifdef _CY_MESHLET_SSE2
+		__m128 cx = _mm_loadu_ps( s+0 ), cy = _mm_loadu_ps( s+4 ), cz = _mm_loadu_ps( s+8 ), r = _mm_loadu_ps( s+12 );
+		__m128 inside = _mm_cmpge_ps( r, _mm_setzero_ps() );
+		for ( int p=0; p<6; p++ ) {
+			__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, _mm_set1_ps(planes[p][0]) ), _mm_mul_ps( cy, _mm_set1_ps(planes[p][1]) ) ),
+			                       _mm_add_ps( _mm_mul_ps( cz, _mm_set1_ps(planes[p][2]) ), _mm_set1_ps(planes[p][3]) ) );
+			inside = _mm_and_ps( inside, _mm_cmpge_ps( d, _mm_sub_ps( _mm_setzero_ps(), r ) ) );
+		}
+		// Back-facing if dot( apex - eye, axis ) >= cutoff * |apex - eye| (or dot( dir, axis ) >= cutoff for orthographic projections)
+		__m128 ax = _mm_loadu_ps( s+28 ), ay = _mm_loadu_ps( s+32 ), az = _mm_loadu_ps( s+36 ), cut = _mm_loadu_ps( s+40 );
+		__m128 vx, vy, vz;
+		if ( perspective ) {
+			vx = _mm_sub_ps( _mm_loadu_ps( s+16 ), _mm_set1_ps(eye.x) );
+			vy = _mm_sub_ps( _mm_loadu_ps( s+20 ), _mm_set1_ps(eye.y) );
+			vz = _mm_sub_ps( _mm_loadu_ps( s+24 ), _mm_set1_ps(eye.z) );
+		} else {
+			vx = _mm_set1_ps(eye.x);
+			vy = _mm_set1_ps(eye.y);
+			vz = _mm_set1_ps(eye.z);
+		}
+		__m128 len = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps(vx,vx), _mm_mul_ps(vy,vy) ), _mm_mul_ps(vz,vz) ) );
+		__m128 dp  = _mm_add_ps( _mm_add_ps( _mm_mul_ps(vx,ax), _mm_mul_ps(vy,ay) ), _mm_mul_ps(vz,az) );
+		__m128 back = _mm_and_ps( _mm_cmpge_ps( dp, _mm_mul_ps( cut, len ) ), _mm_cmpgt_ps( dp, _mm_setzero_ps() ) );
+		back = _mm_and_ps( back, _mm_cmpgt_ps( _mm_set1_ps(cullCones), _mm_setzero_ps() ) );
+		mask = _mm_movemask_ps( _mm_andnot_ps( back, inside ) );
+#else
+		mask = 0;
+		for ( int i=0; i<4; i++ ) {
+			float cx = s[i], cy = s[4+i], cz = s[8+i], r = s[12+i];
+			bool in = r >= 0;
+			for ( int p=0; p<6 && in; p++ ) in = cx*planes[p][0] + cy*planes[p][1] + cz*planes[p][2] + planes[p][3] >= -r;
+			Vec3f v = perspective ? Vec3f( s[16+i], s[20+i], s[24+i] ) - eye : eye;
+			float dp = v.x*s[28+i] + v.y*s[32+i] + v.z*s[36+i];
+			bool back = cullCones > 0 && dp > 0 && dp >= s[40+i] * v.Length();
+			if ( in && !back ) mask |= 1 << i;
+		}
+#endif
+		for ( int i=0; i<4; i++ ) if ( mask & (1<<i) ) visible[n++] = (unsigned int)( g*4 + i );
+	}
+	visible.resize( n );
+	return n;
+}
+
+inline void Meshlets::WriteIndices( std::vector<unsigned int> &indexBuffer, unsigned int const *meshletIDs, size_t numMeshlets ) const
+{
+	size_t n = 0;
+	for ( size_t i=0; i<numMeshlets; i++ ) n += meshlets[ meshletIDs[i] ].numTriangles * 3;
+	indexBuffer.resize( n );
+	unsigned int *out = indexBuffer.data();
+	for ( size_t i=0; i<numMeshlets; i++ ) {
+		Meshlet const &m = meshlets[ meshletIDs[i] ];
+		unsigned int const *v = &vertices[ m.firstVertex ];
+		unsigned char const *t = &triangles[ m.firstTriangle*3 ];
+		for ( unsigned int j=0; j<m.numTriangles*3; j++ ) *(out++) = v[ t[j] ];
+	}
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::Meshlets cyMeshlets;	//!< Meshlets of an indexed triangle mesh
+
+//-------------------------------------------------------------------------------
+
+#endif
@@ -6,16 +6,15 @@
 #include "cyCodeBase/cyVector.h"
 #include "cyCodeBase/cyMatrix.h"
 #include "cyCodeBase/cyTriMesh.h"
+#include "cyCodeBase/cyMeshCache.h"
+#include "cyCodeBase/cyMeshWeld.h"
+#include "cyCodeBase/cyMeshOptimizer.h"
 #include "cyCodeBase/cyGL.h"
+#include "cyCodeBase/cyVertexLayout.h"
 #include "lodepng.h"
 
-// number of vertices in given obj
-int num_v;
-// number of faces in given obj
-int num_f;
-
-// vector to store vertices
-std::vector<GLfloat> vertices;
+// number of indices to draw the given obj
+GLsizei num_indices;
 
 // texture image width and height
 unsigned img_width = 2048;
@@ -81,9 +80,16 @@ GLfloat display_width = 800;
 GLfloat display_height = 600;
 
 // VAOs and VBOs
-GLuint obj_vao, obj_vbo[3];
+GLuint obj_vao, obj_vbo[2];
 GLuint plane_vao, plane_vbo;
 
+// interleaved vertex layout of the obj
+typedef cy::VertexLayout<
+    cy::VertexAttrib<cy::VERTEX_POSITION, cy::VertexFloat3, 0>,
+    cy::VertexAttrib<cy::VERTEX_NORMAL, cy::VertexSnorm10, 1>,
+    cy::VertexAttrib<cy::VERTEX_TEXCOORD, cy::VertexHalf2, 2>>
+    ObjLayout;
+
 // OBJ reader
 cyTriMesh reader;
 
@@ -153,7 +159,8 @@ cyTriMesh parseOBJ(int argc, const char *filename)
     // read OBJ file
     bool read_status;
     cyTriMesh reader;
-    if (!(read_status = reader.LoadFromFileObj(filename, true)))
+    cyMeshCache cache;
+    if (!(read_status = cache.LoadFromFileObj(reader, filename, true)))
     {
         fprintf(stderr, "Error: cannot read file");
         exit(1);
@@ -164,73 +171,31 @@ cyTriMesh parseOBJ(int argc, const char *filename)
 // generate vertex buffer object and bind data
 void setVBO()
 {
-    // read vertex data
-    num_v = reader.NV();
-    num_f = reader.NF();
-
-    // fill vector with vertex data
-    int i;
-    for (i = 0; i < num_v; i++)
-    {
-        cyVec3f _verts = reader.V(i);
-        vertices.push_back(_verts[0]);
-        vertices.push_back(_verts[1]);
-        vertices.push_back(_verts[2]);
-    }
+    // merge the face corners that share the same position, normal, and texture coordinate
+    cyMeshWelder welder;
+    welder.Weld(reader);
 
-    // fill vector with vertex data
-    cyVec3f *v = new cyVec3f[num_f * 3];
-    for (i = 0; i < num_f; i++)
-    {
-        cyTriMesh::TriFace _face = reader.F(i);
-        v[3 * i + 0] = reader.V(_face.v[0]);
-        v[3 * i + 1] = reader.V(_face.v[1]);
-        v[3 * i + 2] = reader.V(_face.v[2]);
-    }
+    // reorder triangles and vertices for the vertex cache
+    cyMeshOptimizer::Optimize(welder);
 
-    // fill vector with normal data
-    cyVec3f *n = new cyVec3f[num_f * 3];
-    for (i = 0; i < num_f; i++)
-    {
-        cyTriMesh::TriFace fn = reader.FN(i);
-        n[3 * i + 0] = reader.VN(fn.v[0]);
-        n[3 * i + 1] = reader.VN(fn.v[1]);
-        n[3 * i + 2] = reader.VN(fn.v[2]);
-    }
+    num_indices = welder.NumIndices();
 
-    // fill vector with texture data
-    cyVec3f *t = new cyVec3f[num_f * 3];
-    for (int i = 0; i < num_f; i++)
-    {
-        cyTriMesh::TriFace ft = reader.FT(i);
-        t[3 * i + 0] = reader.VT(ft.v[0]);
-        t[3 * i + 1] = reader.VT(ft.v[1]);
-        t[3 * i + 2] = reader.VT(ft.v[2]);
-    }
+    // pack vertex data into a single interleaved buffer
+    std::vector<unsigned char> vertex_data;
+    ObjLayout::Pack(vertex_data, reader, welder);
 
     // generate and bind vertex buffer objects and vertex array object
     glGenVertexArrays(1, &obj_vao);
     glBindVertexArray(obj_vao);
 
-    glGenBuffers(3, obj_vbo);
+    glGenBuffers(2, obj_vbo);
 
     glBindBuffer(GL_ARRAY_BUFFER, obj_vbo[0]);
-    glBufferData(GL_ARRAY_BUFFER, num_f * 3 * sizeof(cyVec3f), v, GL_STATIC_DRAW);
-    GLuint obj_pos = glGetAttribLocation(obj_program_id, "pos");
-    glEnableVertexAttribArray(obj_pos);
-    glVertexAttribPointer(obj_pos, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
-
-    glBindBuffer(GL_ARRAY_BUFFER, obj_vbo[1]);
-    glBufferData(GL_ARRAY_BUFFER, num_f * 3 * sizeof(cyVec3f), n, GL_STATIC_DRAW);
-    GLuint obj_norm = glGetAttribLocation(obj_program_id, "norm");
-    glEnableVertexAttribArray(obj_norm);
-    glVertexAttribPointer(obj_norm, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
-
-    glBindBuffer(GL_ARRAY_BUFFER, obj_vbo[2]);
-    glBufferData(GL_ARRAY_BUFFER, num_f * 3 * sizeof(cyVec3f), t, GL_STATIC_DRAW);
-    GLuint obj_txc = glGetAttribLocation(obj_program_id, "txc");
-    glEnableVertexAttribArray(obj_txc);
-    glVertexAttribPointer(obj_txc, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
+    glBufferData(GL_ARRAY_BUFFER, vertex_data.size(), vertex_data.data(), GL_STATIC_DRAW);
+    ObjLayout::SetAttribs(obj_vbo[0]);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, obj_vbo[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, num_indices * sizeof(GLuint), welder.Indices().data(), GL_STATIC_DRAW);
 }
 
 // generate VBO for plane
@@ -426,7 +391,7 @@ void draw()
     glUniform3f(K_s, reader.M(0).Ks[0], reader.M(0).Ks[1], reader.M(0).Ks[2]);
 
     // draw obj
-    glDrawArrays(GL_TRIANGLES, 0, num_f * 3 * sizeof(cyVec3f));
+    glDrawElements(GL_TRIANGLES, num_indices, GL_UNSIGNED_INT, 0);
 
     renderBuffer.Unbind();
 
@@ -622,7 +587,6 @@ int main(int argc, char *argv[])
     // clear obj_vbo buffers
     glDeleteBuffers(1, &obj_vbo[0]);
     glDeleteBuffers(1, &obj_vbo[1]);
-    glDeleteBuffers(1, &obj_vbo[2]);
     glDeleteBuffers(1, &plane_vbo);
 
     return 0;
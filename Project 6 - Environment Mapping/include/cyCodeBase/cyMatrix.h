@@ -38,6 +38,12 @@
 
 #include "cyVector.h"
 
+#if !defined(CY_NO_INTRIN_H) && !defined(CY_NO_EMMINTRIN_H) && !defined(CY_NO_IMMINTRIN_H)
+# if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#  define _CY_MATRIX_SSE2
+# endif
+#endif
+
 //-------------------------------------------------------------------------------
 namespace cy {
 //-------------------------------------------------------------------------------
@@ -1693,16 +1699,14 @@ public:
 	explicit Matrix4( Matrix3 <T> const &m, Vec3<T> const &pos ) { Column(0).Set(m.Column(0),T(0)); Column(1).Set(m.Column(1),T(0)); Column(2).Set(m.Column(2),T(0)); Column(3).Set(pos,T(1)); }
 
 	//! Constructor using row-major order for initialization
-	Matrix4( T c00, T c01, T c02, T c03,
-		     T c10, T c11, T c12, T c13,
-		     T c20, T c21, T c22, T c23,
-		     T c30, T c31, T c32, T c33 )
-	{
-		cell[ 0] = c00;   cell[ 4] = c01;   cell[ 8] = c02;   cell[12] = c03;
-		cell[ 1] = c10;   cell[ 5] = c11;   cell[ 9] = c12;   cell[13] = c13;
-		cell[ 2] = c20;   cell[ 6] = c21;   cell[10] = c22;   cell[14] = c23;
-		cell[ 3] = c30;   cell[ 7] = c31;   cell[11] = c32;   cell[15] = c33;
-	}
+	constexpr Matrix4( T c00, T c01, T c02, T c03,
+		               T c10, T c11, T c12, T c13,
+		               T c20, T c21, T c22, T c23,
+		               T c30, T c31, T c32, T c33 )
+		: cell{ c00, c10, c20, c30,
+		        c01, c11, c21, c31,
+		        c02, c12, c22, c32,
+		        c03, c13, c23, c33 } {}
 
 
 	//////////////////////////////////////////////////////////////////////////
@@ -2265,6 +2269,31 @@ public:
 		return inverse / det;
 	}
 
+	void InvertAffine() { *this = GetAffineInverse(); }	//!< Invert this matrix, assuming that it is an affine transformation
+	//! Get the inverse of this matrix, assuming that it is an affine transformation (i.e. the last row is 0,0,0,1).
+	//! This is much cheaper than GetInverse, since only the 3x3 sub-matrix is inverted.
+	CY_NODISCARD Matrix4 GetAffineInverse() const
+	{
+		// The rows of the inverse 3x3 sub-matrix are the cross products of its columns divided by the determinant
+		Vec3<T> c0( cell[0], cell[1], cell[ 2] );
+		Vec3<T> c1( cell[4], cell[5], cell[ 6] );
+		Vec3<T> c2( cell[8], cell[9], cell[10] );
+		Vec3<T> t ( cell[12], cell[13], cell[14] );
+		Vec3<T> r0 = c1 ^ c2;
+		Vec3<T> r1 = c2 ^ c0;
+		Vec3<T> r2 = c0 ^ c1;
+		T invDet = T(1) / ( c0 % r0 );
+		r0 *= invDet;
+		r1 *= invDet;
+		r2 *= invDet;
+		Matrix4 m;
+		m.cell[ 0] = r0.x;   m.cell[ 1] = r1.x;   m.cell[ 2] = r2.x;   m.cell[ 3] = T(0);
+		m.cell[ 4] = r0.y;   m.cell[ 5] = r1.y;   m.cell[ 6] = r2.y;   m.cell[ 7] = T(0);
+		m.cell[ 8] = r0.z;   m.cell[ 9] = r1.z;   m.cell[10] = r2.z;   m.cell[11] = T(0);
+		m.cell[12] = -(r0%t);m.cell[13] = -(r1%t);m.cell[14] = -(r2%t);m.cell[15] = T(1);
+		return m;
+	}
+
 	//! Removes the scale component of the matrix by normalizing each column of the 3x3 sub-matrix.
 	//! The resulting matrix can contain shear, if it originally contained non-uniform scale and rotation.
 	void Normalize() { Column3(0).Normalize(); Column3(0).Normalize(); Column3(0).Normalize(); }
@@ -2333,15 +2362,29 @@ public:
 	//!@name Static Methods
 
 	//! Returns an identity matrix
-	CY_NODISCARD static Matrix4 Identity() { T c[] = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 }; return Matrix4(c); }
+	CY_NODISCARD static constexpr Matrix4 Identity() { return Matrix4( 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 ); }
 	//! Returns a view matrix using position, target and approximate up vector
-	CY_NODISCARD static Matrix4 View( Vec3<T> const &pos, Vec3<T> const &target, Vec3<T> const &up ) { Matrix4 m; m.SetView(pos,target,up); return m; }
+	CY_NODISCARD static CY_CONSTEXPR Matrix4 View( Vec3<T> const &pos, Vec3<T> const &target, Vec3<T> const &up )
+	{
+		// Same as SetView, but written with scalars, so that it can be evaluated at compile time
+		T fx = target.x - pos.x, fy = target.y - pos.y, fz = target.z - pos.z;
+		T fl = SqrtConst( fx*fx + fy*fy + fz*fz );
+		fx /= fl;  fy /= fl;  fz /= fl;
+		T sx = fy*up.z - fz*up.y, sy = fz*up.x - fx*up.z, sz = fx*up.y - fy*up.x;
+		T sl = SqrtConst( sx*sx + sy*sy + sz*sz );
+		sx /= sl;  sy /= sl;  sz /= sl;
+		T ux = sy*fz - sz*fy, uy = sz*fx - sx*fz, uz = sx*fy - sy*fx;
+		return Matrix4(  sx,  sy,  sz, -( sx*pos.x + sy*pos.y + sz*pos.z ),
+		                 ux,  uy,  uz, -( ux*pos.x + uy*pos.y + uz*pos.z ),
+		                -fx, -fy, -fz,    fx*pos.x + fy*pos.y + fz*pos.z,
+		                  0,   0,   0,    1 );
+	}
 	//! Returns a rotation matrix around x axis by angle in radians
-	CY_NODISCARD static Matrix4 RotationX( T angle ) { Matrix4 m; m.SetRotationX(angle); return m; }
+	CY_NODISCARD static CY_CONSTEXPR Matrix4 RotationX( T angle ) { T s = SinConst(angle), c = CosConst(angle); return Matrix4( 1,0,0,0, 0,c,-s,0, 0,s,c,0, 0,0,0,1 ); }
 	//! Returns a rotation matrix around y axis by angle in radians
-	CY_NODISCARD static Matrix4 RotationY( T angle ) { Matrix4 m; m.SetRotationY(angle); return m; }
+	CY_NODISCARD static CY_CONSTEXPR Matrix4 RotationY( T angle ) { T s = SinConst(angle), c = CosConst(angle); return Matrix4( c,0,s,0, 0,1,0,0, -s,0,c,0, 0,0,0,1 ); }
 	//! Returns a rotation matrix around z axis by angle in radians
-	CY_NODISCARD static Matrix4 RotationZ( T angle ) { Matrix4 m; m.SetRotationZ(angle); return m; }
+	CY_NODISCARD static CY_CONSTEXPR Matrix4 RotationZ( T angle ) { T s = SinConst(angle), c = CosConst(angle); return Matrix4( c,-s,0,0, s,c,0,0, 0,0,1,0, 0,0,0,1 ); }
 	//! Returns a rotation matrix about the given axis by angle in radians
 	CY_NODISCARD static Matrix4 Rotation( Vec3<T> const &axis, T angle ) { Matrix4 m; m.SetRotation(axis,angle); return m; }
 	//! Returns a rotation matrix about the given axis by cos and sin of the rotation angle
@@ -2349,25 +2392,58 @@ public:
 	//! Returns a rotation matrix that sets [from] unit vector to [to] unit vector
 	CY_NODISCARD static Matrix4 Rotation( Vec3<T> const &from, Vec3<T> const &to ) { Matrix4 m; m.SetRotation(from,to); return m; }
 	//! Returns a rotation matrix around x, y, and then z axes by angle in radians (Rz * Ry * Rx)
-	CY_NODISCARD static Matrix4 RotationXYZ( T angleX, T angleY, T angleZ ) { Matrix4 m; m.SetRotationXYZ(angleX,angleY,angleZ); return m; }
+	CY_NODISCARD static CY_CONSTEXPR Matrix4 RotationXYZ( T angleX, T angleY, T angleZ )
+	{
+		T sx = SinConst(angleX), cx = CosConst(angleX);
+		T sy = SinConst(angleY), cy = CosConst(angleY);
+		T sz = SinConst(angleZ), cz = CosConst(angleZ);
+		return Matrix4( cy*cz,  cz*sx*sy - cx*sz,  cx*cz*sy + sx*sz, 0,
+		                cy*sz,  cx*cz + sx*sy*sz, -cz*sx + cx*sy*sz, 0,
+		                  -sy,             cy*sx,             cx*cy, 0,
+		                    0,                 0,                 0, 1 );
+	}
 	//! Returns a rotation matrix around z, y, and then x axes by angle in radians (Rx * Ry * Rz)
 	CY_NODISCARD static Matrix4 RotationZYX( T angleX, T angleY, T angleZ ) { Matrix4 m; m.SetRotationZYX(angleX,angleY,angleZ); return m; }
 	//! Returns a uniform scale matrix
-	CY_NODISCARD static Matrix4 Scale( T uniformScale ) { Matrix4 m; m.SetScale(uniformScale); return m; }
+	CY_NODISCARD static constexpr Matrix4 Scale( T uniformScale ) { return Scale(uniformScale,uniformScale,uniformScale); }
 	//! Returns a scale matrix
-	CY_NODISCARD static Matrix4 Scale( T scaleX, T scaleY, T scaleZ, T scaleW=T(1) ) { Matrix4 m; m.SetScale(scaleX,scaleY,scaleZ,scaleW); return m; }
+	CY_NODISCARD static constexpr Matrix4 Scale( T scaleX, T scaleY, T scaleZ, T scaleW=T(1) ) { return Matrix4( scaleX,0,0,0, 0,scaleY,0,0, 0,0,scaleZ,0, 0,0,0,scaleW ); }
 	//! Returns a scale matrix
-	CY_NODISCARD static Matrix4 Scale( Vec3<T> const &scale ) { Matrix4 m; m.SetScale(scale); return m; }
+	CY_NODISCARD static constexpr Matrix4 Scale( Vec3<T> const &scale ) { return Scale(scale.x,scale.y,scale.z); }
 	//! Returns a translation matrix with no rotation or scale
-	CY_NODISCARD static Matrix4 Translation( Vec3<T> const &move ) { Matrix4 m; m.SetTranslation(move); return m; }
+	CY_NODISCARD static constexpr Matrix4 Translation( Vec3<T> const &move ) { return Matrix4( 1,0,0,move.x, 0,1,0,move.y, 0,0,1,move.z, 0,0,0,1 ); }
 	//! Returns a project matrix with field of view in radians
-	CY_NODISCARD static Matrix4 Perspective( T fov, T aspect, T znear, T zfar ) { Matrix4 m; m.SetPerspective(fov,aspect,znear,zfar); return m; }
+	CY_NODISCARD static CY_CONSTEXPR Matrix4 Perspective( T fov, T aspect, T znear, T zfar ) { return PerspectiveTan(TanConst(fov*T(0.5)),aspect,znear,zfar); }
 	//! Returns a project matrix with the tangent of the half field of view (tan_fov_2)
-	CY_NODISCARD static Matrix4 PerspectiveTan( T tan_fov_2, T aspect, T znear, T zfar ) { Matrix4 m; m.SetPerspectiveTan(tan_fov_2,aspect,znear,zfar); return m; }
+	CY_NODISCARD static constexpr Matrix4 PerspectiveTan( T tan_fov_2, T aspect, T znear, T zfar )
+	{
+		return Matrix4( (T(1)/tan_fov_2)/aspect, 0, 0, 0,
+		                0, T(1)/tan_fov_2, 0, 0,
+		                0, 0, (zfar+znear)/(znear-zfar), (2*zfar*znear)/(znear-zfar),
+		                0, 0, -1, 0 );
+	}
+	//! Returns the product of the given matrices. The result is the same as left * right, but it can be evaluated at compile time.
+	CY_NODISCARD static constexpr Matrix4 Product( Matrix4 const &left, Matrix4 const &right )
+	{
+		return Matrix4( ProductCell(left,right,0,0), ProductCell(left,right,0,1), ProductCell(left,right,0,2), ProductCell(left,right,0,3),
+		                ProductCell(left,right,1,0), ProductCell(left,right,1,1), ProductCell(left,right,1,2), ProductCell(left,right,1,3),
+		                ProductCell(left,right,2,0), ProductCell(left,right,2,1), ProductCell(left,right,2,2), ProductCell(left,right,2,3),
+		                ProductCell(left,right,3,0), ProductCell(left,right,3,1), ProductCell(left,right,3,2), ProductCell(left,right,3,3) );
+	}
+	//! Returns the product of the given matrices from left to right, which can be evaluated at compile time.
+	template <typename... M> CY_NODISCARD static constexpr Matrix4 Product( Matrix4 const &m0, Matrix4 const &m1, Matrix4 const &m2, M const &... more ) { return Product( Product(m0,m1), m2, more... ); }
 	//! Returns the tensor product (outer product) matrix of two vectors
 	CY_NODISCARD static Matrix4 TensorProduct( Vec4<T> const &v0, Vec4<T> const &v1 ) { Matrix4 m; m.SetTensorProduct(v0,v1); return m; }
 
 	//////////////////////////////////////////////////////////////////////////
+
+private:
+	// A cell of the product of two matrices, computed in the same order as operator*
+	static constexpr T ProductCell( Matrix4 const &left, Matrix4 const &right, int row, int col )
+	{
+		return ( left.cell[  row] * right.cell[4*col  ] + left.cell[ 4+row] * right.cell[4*col+1] ) +
+		       ( left.cell[8+row] * right.cell[4*col+2] + left.cell[12+row] * right.cell[4*col+3] );
+	}
 };
 
 //-------------------------------------------------------------------------------
@@ -2396,6 +2472,195 @@ template <typename T> inline Matrix4<T> Matrix34<T>::GetTranspose() const
 	return m;
 }
 
+//-------------------------------------------------------------------------------
+// SIMD specializations of Matrix4<float>
+//-------------------------------------------------------------------------------
+//
+// The methods below replace the generic Matrix4 methods for single precision
+// with explicit SSE2 code (and AVX code for the matrix product when available).
+// The products and transforms perform the same operations in the same order as
+// the generic versions, so they produce identical results. The inverse methods
+// use a different order of operations, so their results can differ within the
+// floating point round-off error.
+
+#ifdef _CY_MATRIX_SSE2
+
+//! \cond HIDDEN_SYMBOLS
+#define _CY_MM_SWIZZLE(v,x,y,z,w) _mm_castsi128_ps( _mm_shuffle_epi32( _mm_castps_si128(v), _MM_SHUFFLE(w,z,y,x) ) )
+#define _CY_MM_SHUFFLE(a,b,x,y,z,w) _mm_shuffle_ps( a, b, _MM_SHUFFLE(w,z,y,x) )
+#define _CY_MM_SPLAT(v,i) _CY_MM_SWIZZLE(v,i,i,i,i)
+
+// Linear combination of four columns with the components of v, in the order of the generic Matrix4 code.
+inline __m128 _CyMatrix4Combine( __m128 c0, __m128 c1, __m128 c2, __m128 c3, __m128 v )
+{
+	__m128 e = _mm_add_ps( _mm_mul_ps( c0, _CY_MM_SPLAT(v,0) ), _mm_mul_ps( c1, _CY_MM_SPLAT(v,1) ) );
+	__m128 f = _mm_add_ps( _mm_mul_ps( c2, _CY_MM_SPLAT(v,2) ), _mm_mul_ps( c3, _CY_MM_SPLAT(v,3) ) );
+	return _mm_add_ps( e, f );
+}
+
+// Products of 2x2 matrices that are stored in row-major order in an __m128, used by the block-wise inverse.
+inline __m128 _CyMat2Mul   ( __m128 a, __m128 b ) { return _mm_add_ps( _mm_mul_ps( a, _CY_MM_SWIZZLE(b,0,3,0,3) ), _mm_mul_ps( _CY_MM_SWIZZLE(a,1,0,3,2), _CY_MM_SWIZZLE(b,2,1,2,1) ) ); }	// a * b
+inline __m128 _CyMat2AdjMul( __m128 a, __m128 b ) { return _mm_sub_ps( _mm_mul_ps( _CY_MM_SWIZZLE(a,3,3,0,0), b ), _mm_mul_ps( _CY_MM_SWIZZLE(a,1,1,2,2), _CY_MM_SWIZZLE(b,2,3,0,1) ) ); }	// adj(a) * b
+inline __m128 _CyMat2MulAdj( __m128 a, __m128 b ) { return _mm_sub_ps( _mm_mul_ps( a, _CY_MM_SWIZZLE(b,3,0,3,0) ), _mm_mul_ps( _CY_MM_SWIZZLE(a,1,0,3,2), _CY_MM_SWIZZLE(b,2,1,2,1) ) ); }	// a * adj(b)
+
+// Cross product of the first three components, the last component is zero if the inputs are finite.
+inline __m128 _CyCross3( __m128 a, __m128 b )
+{
+	return _mm_sub_ps( _mm_mul_ps( _CY_MM_SWIZZLE(a,1,2,0,3), _CY_MM_SWIZZLE(b,2,0,1,3) ),
+	                   _mm_mul_ps( _CY_MM_SWIZZLE(a,2,0,1,3), _CY_MM_SWIZZLE(b,1,2,0,3) ) );
+}
+
+// Sum of the four components, broadcast to all components.
+inline __m128 _CyHorizontalSum( __m128 v )
+{
+	v = _mm_add_ps( v, _CY_MM_SWIZZLE(v,2,3,0,1) );
+	return _mm_add_ps( v, _CY_MM_SWIZZLE(v,1,0,3,2) );
+}
+//! \endcond
+
+template <> inline Matrix4<float> Matrix4<float>::operator * ( Matrix4<float> const &right ) const
+{
+	Matrix4<float> rm;
+#ifdef __AVX__
+	// two columns of the result at a time
+	__m256 c0 = _mm256_broadcast_ps( (__m128 const *) (cell   ) );
+	__m256 c1 = _mm256_broadcast_ps( (__m128 const *) (cell+ 4) );
+	__m256 c2 = _mm256_broadcast_ps( (__m128 const *) (cell+ 8) );
+	__m256 c3 = _mm256_broadcast_ps( (__m128 const *) (cell+12) );
+	for ( int i=0; i<16; i+=8 ) {
+		__m256 r = _mm256_loadu_ps( right.cell+i );
+		__m256 e = _mm256_add_ps( _mm256_mul_ps( c0, _mm256_shuffle_ps(r,r,0x00) ), _mm256_mul_ps( c1, _mm256_shuffle_ps(r,r,0x55) ) );
+		__m256 f = _mm256_add_ps( _mm256_mul_ps( c2, _mm256_shuffle_ps(r,r,0xAA) ), _mm256_mul_ps( c3, _mm256_shuffle_ps(r,r,0xFF) ) );
+		_mm256_storeu_ps( rm.cell+i, _mm256_add_ps( e, f ) );
+	}
+#else
+	__m128 c0 = _mm_loadu_ps( cell    );
+	__m128 c1 = _mm_loadu_ps( cell+ 4 );
+	__m128 c2 = _mm_loadu_ps( cell+ 8 );
+	__m128 c3 = _mm_loadu_ps( cell+12 );
+	for ( int i=0; i<16; i+=4 ) _mm_storeu_ps( rm.cell+i, _CyMatrix4Combine( c0, c1, c2, c3, _mm_loadu_ps( right.cell+i ) ) );
+#endif
+	return rm;
+}
+
+template <> inline Vec4<float> Matrix4<float>::operator * ( Vec3<float> const &p ) const
+{
+	__m128 d = _mm_add_ps( _mm_mul_ps( _mm_set1_ps(p.x), _mm_loadu_ps(cell) ), _mm_mul_ps( _mm_set1_ps(p.y), _mm_loadu_ps(cell+4) ) );
+	__m128 e = _mm_add_ps( _mm_mul_ps( _mm_set1_ps(p.z), _mm_loadu_ps(cell+8) ), _mm_loadu_ps(cell+12) );
+	Vec4<float> r;
+	_mm_storeu_ps( r.Elements(), _mm_add_ps( d, e ) );
+	return r;
+}
+
+template <> inline Vec4<float> Matrix4<float>::operator * ( Vec4<float> const &p ) const
+{
+	Vec4<float> r;
+	_mm_storeu_ps( r.Elements(), _CyMatrix4Combine( _mm_loadu_ps(cell), _mm_loadu_ps(cell+4), _mm_loadu_ps(cell+8), _mm_loadu_ps(cell+12), _mm_loadu_ps(p.Elements()) ) );
+	return r;
+}
+
+template <> inline void Matrix4<float>::Transpose()
+{
+	__m128 c0 = _mm_loadu_ps( cell    );
+	__m128 c1 = _mm_loadu_ps( cell+ 4 );
+	__m128 c2 = _mm_loadu_ps( cell+ 8 );
+	__m128 c3 = _mm_loadu_ps( cell+12 );
+	_MM_TRANSPOSE4_PS( c0, c1, c2, c3 );
+	_mm_storeu_ps( cell,    c0 );
+	_mm_storeu_ps( cell+ 4, c1 );
+	_mm_storeu_ps( cell+ 8, c2 );
+	_mm_storeu_ps( cell+12, c3 );
+}
+
+template <> inline Matrix4<float> Matrix4<float>::GetTranspose() const
+{
+	Matrix4<float> m( *this );
+	m.Transpose();
+	return m;
+}
+
+template <> inline Matrix4<float> Matrix4<float>::GetInverse() const
+{
+	// Block-wise inversion with 2x2 sub-matrices. The columns are treated as the rows of the transpose,
+	// which is fine, since the inverse of the transpose is the transpose of the inverse.
+	__m128 c0 = _mm_loadu_ps( cell    );
+	__m128 c1 = _mm_loadu_ps( cell+ 4 );
+	__m128 c2 = _mm_loadu_ps( cell+ 8 );
+	__m128 c3 = _mm_loadu_ps( cell+12 );
+
+	// 2x2 sub-matrices  | A B |
+	//                   | C D |
+	__m128 A = _mm_movelh_ps( c0, c1 );
+	__m128 B = _mm_movehl_ps( c1, c0 );
+	__m128 C = _mm_movelh_ps( c2, c3 );
+	__m128 D = _mm_movehl_ps( c3, c2 );
+
+	// determinants of the sub-matrices as ( |A|, |B|, |C|, |D| )
+	__m128 detSub = _mm_sub_ps( _mm_mul_ps( _CY_MM_SHUFFLE(c0,c2,0,2,0,2), _CY_MM_SHUFFLE(c1,c3,1,3,1,3) ),
+	                            _mm_mul_ps( _CY_MM_SHUFFLE(c0,c2,1,3,1,3), _CY_MM_SHUFFLE(c1,c3,0,2,0,2) ) );
+	__m128 detA = _CY_MM_SPLAT(detSub,0);
+	__m128 detB = _CY_MM_SPLAT(detSub,1);
+	__m128 detC = _CY_MM_SPLAT(detSub,2);
+	__m128 detD = _CY_MM_SPLAT(detSub,3);
+
+	// The inverse is | X Y | / |M|, and the adjugates of X, Y, Z, and W are computed below.
+	//                | Z W |
+	__m128 D_C = _CyMat2AdjMul( D, C );
+	__m128 A_B = _CyMat2AdjMul( A, B );
+	__m128 X_ = _mm_sub_ps( _mm_mul_ps( detD, A ), _CyMat2Mul   ( B, D_C ) );
+	__m128 W_ = _mm_sub_ps( _mm_mul_ps( detA, D ), _CyMat2Mul   ( C, A_B ) );
+	__m128 Y_ = _mm_sub_ps( _mm_mul_ps( detB, C ), _CyMat2MulAdj( D, A_B ) );
+	__m128 Z_ = _mm_sub_ps( _mm_mul_ps( detC, B ), _CyMat2MulAdj( A, D_C ) );
+
+	// |M| = |A| |D| + |B| |C| - tr( adj(A) B adj(D) C )
+	__m128 tr   = _CyHorizontalSum( _mm_mul_ps( A_B, _CY_MM_SWIZZLE(D_C,0,2,1,3) ) );
+	__m128 detM = _mm_sub_ps( _mm_add_ps( _mm_mul_ps( detA, detD ), _mm_mul_ps( detB, detC ) ), tr );
+	__m128 rDetM = _mm_div_ps( _mm_setr_ps( 1.0f, -1.0f, -1.0f, 1.0f ), detM );
+	X_ = _mm_mul_ps( X_, rDetM );
+	Y_ = _mm_mul_ps( Y_, rDetM );
+	Z_ = _mm_mul_ps( Z_, rDetM );
+	W_ = _mm_mul_ps( W_, rDetM );
+
+	// the adjugates are undone while storing
+	Matrix4<float> m;
+	_mm_storeu_ps( m.cell,    _CY_MM_SHUFFLE( X_, Y_, 3,1,3,1 ) );
+	_mm_storeu_ps( m.cell+ 4, _CY_MM_SHUFFLE( X_, Y_, 2,0,2,0 ) );
+	_mm_storeu_ps( m.cell+ 8, _CY_MM_SHUFFLE( Z_, W_, 3,1,3,1 ) );
+	_mm_storeu_ps( m.cell+12, _CY_MM_SHUFFLE( Z_, W_, 2,0,2,0 ) );
+	return m;
+}
+
+template <> inline Matrix4<float> Matrix4<float>::GetAffineInverse() const
+{
+	__m128 c0 = _mm_loadu_ps( cell    );
+	__m128 c1 = _mm_loadu_ps( cell+ 4 );
+	__m128 c2 = _mm_loadu_ps( cell+ 8 );
+	__m128 t  = _mm_loadu_ps( cell+12 );
+	__m128 r0 = _CyCross3( c1, c2 );
+	__m128 r1 = _CyCross3( c2, c0 );
+	__m128 r2 = _CyCross3( c0, c1 );
+	__m128 invDet = _mm_div_ps( _mm_set1_ps(1.0f), _CyHorizontalSum( _mm_mul_ps( c0, r0 ) ) );
+	r0 = _mm_mul_ps( r0, invDet );
+	r1 = _mm_mul_ps( r1, invDet );
+	r2 = _mm_mul_ps( r2, invDet );
+	__m128 r3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+	// the translation is the negated inverse 3x3 sub-matrix times the original translation
+	__m128 it = _mm_sub_ps( _mm_setzero_ps(), _mm_add_ps( _mm_add_ps( _mm_mul_ps( r0, _CY_MM_SPLAT(t,0) ), _mm_mul_ps( r1, _CY_MM_SPLAT(t,1) ) ), _mm_mul_ps( r2, _CY_MM_SPLAT(t,2) ) ) );
+	Matrix4<float> m;
+	_mm_storeu_ps( m.cell,    r0 );
+	_mm_storeu_ps( m.cell+ 4, r1 );
+	_mm_storeu_ps( m.cell+ 8, r2 );
+	_mm_storeu_ps( m.cell+12, _mm_add_ps( it, _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f ) ) );
+	return m;
+}
+
+#undef _CY_MM_SWIZZLE
+#undef _CY_MM_SHUFFLE
+#undef _CY_MM_SPLAT
+
+#endif // _CY_MATRIX_SSE2
+
 //-------------------------------------------------------------------------------
 
 typedef Matrix2 <float>  Matrix2f;	//!< Single precision (float) 2x2 Matrix class
@@ -0,0 +1,202 @@
+//-------------------------------------------------------------------------------
+//! \file   cyMeshWeld.h
+//!
+//! \brief  Converts TriMesh index streams into a single index buffer.
+//!
+//! TriMesh stores separate face indices for positions, normals, and texture
+//! coordinates, but GPUs use a single index per vertex. MeshWelder finds the
+//! unique combinations of these indices and produces vertex arrays with one
+//! entry per combination, along with an index buffer for the triangles.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_MESH_WELD_H_INCLUDED_
+#define _CY_MESH_WELD_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyTriMesh.h"
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Mesh welder.
+//!
+//! Weld merges the face corners that use the same (position, normal, texture
+//! coordinate) index triple. WeldQuantized merges the face corners whose values,
+//! rounded to the given epsilon, are the same, so that near-duplicate vertices
+//! with different indices are also merged. (Values that are close, but round to
+//! different grid points, are not merged.)
+//!
+//! Both methods use an open-addressing hash table and run in linear time. Welded
+//! vertices are numbered in the order they first appear in the faces, and each
+//! welded vertex takes the values of the first corner that created it.
+
+class MeshWelder
+{
+public:
+	//!@name Welding
+	void Weld( TriMesh const &mesh, bool useNormals=true, bool useTexCoords=true );	//!< Merges the face corners with the same index triple. Normals and texture coordinates are ignored if the mesh does not have them or if they are not used.
+	void WeldQuantized( TriMesh const &mesh, float positionEpsilon, float normalEpsilon=0, float texCoordEpsilon=0, bool useNormals=true, bool useTexCoords=true );	//!< Merges the face corners with the same quantized values. An epsilon of zero compares the exact values.
+
+	//!@name Results
+	unsigned int NumVertices() const { return (unsigned int) vertexV.size(); }	//!< Returns the number of welded vertices.
+	unsigned int NumIndices () const { return (unsigned int) indices.size(); }	//!< Returns the number of indices, which is three times the number of faces.
+	std::vector<unsigned int> const & Indices() const { return indices; }	//!< Returns the index buffer.
+	std::vector<unsigned int> &       Indices()       { return indices; }	//!< Returns the index buffer, so that the triangles can be reordered.
+	std::vector<unsigned int> const & VertexV () const { return vertexV;  }	//!< Returns the position index of each welded vertex.
+	std::vector<unsigned int> const & VertexVN() const { return vertexVN; }	//!< Returns the normal index of each welded vertex. Empty if normals are not used.
+	std::vector<unsigned int> const & VertexVT() const { return vertexVT; }	//!< Returns the texture coordinate index of each welded vertex. Empty if texture coordinates are not used.
+	bool HasNormals  () const { return useVN; }	//!< Returns true if normals are used.
+	bool HasTexCoords() const { return useVT; }	//!< Returns true if texture coordinates are used.
+
+	void GetPositions( TriMesh const &mesh, std::vector<Vec3f> &positions ) const { Gather( mesh.NV()  ? &mesh.V(0)  : nullptr, vertexV,  positions ); }	//!< Fills the positions of the welded vertices.
+	void GetNormals  ( TriMesh const &mesh, std::vector<Vec3f> &normals   ) const { Gather( mesh.NVN() ? &mesh.VN(0) : nullptr, vertexVN, normals   ); }	//!< Fills the normals of the welded vertices.
+	void GetTexCoords( TriMesh const &mesh, std::vector<Vec3f> &texCoords ) const { Gather( mesh.NVT() ? &mesh.VT(0) : nullptr, vertexVT, texCoords ); }	//!< Fills the texture coordinates of the welded vertices.
+
+	//!@name Reordering
+	void RemapVertices( unsigned int const *remap );	//!< Moves each welded vertex i to remap[i] and updates the index buffer. The remap array must be a permutation of the vertices.
+
+	MeshWelder() : useVN(false), useVT(false) {}
+
+private:
+	std::vector<unsigned int> indices;
+	std::vector<unsigned int> vertexV, vertexVN, vertexVT;
+	bool useVN, useVT;
+
+	enum : unsigned int { EMPTY = 0xFFFFFFFF };
+
+	template <typename KEY, typename GETKEY> void WeldKeys( TriMesh const &mesh, GETKEY getKey );
+	static void Gather( Vec3f const *src, std::vector<unsigned int> const &ids, std::vector<Vec3f> &dst ) { dst.resize( ids.size() ); for ( size_t i=0; i<ids.size(); i++ ) dst[i] = src[ids[i]]; }
+	static uint64_t Mix( uint64_t h ) { h ^= h >> 33; h *= 0xFF51AFD7ED558CCDull; h ^= h >> 33; h *= 0xC4CEB9FE1A85EC53ull; h ^= h >> 33; return h; }
+	static int Quantize( float x, float scale ) { return scale > 0 ? (int) std::floor( x * scale + 0.5f ) : 0; }
+	static int Bits( float x ) { int i; memcpy( &i, &x, sizeof(i) ); return x==0 ? 0 : i; }	// treats -0 as 0
+};
+
+//-------------------------------------------------------------------------------
+
+template <typename KEY, typename GETKEY>
+inline void MeshWelder::WeldKeys( TriMesh const &mesh, GETKEY getKey )
+{
+	unsigned int numCorners = mesh.NF() * 3;
+	indices.resize( numCorners );
+	vertexV .clear();
+	vertexVN.clear();
+	vertexVT.clear();
+	std::vector<KEY> keys;
+
+	// The table size is a power of two, kept at most half full
+	unsigned int tableSize = 64;
+	while ( tableSize < numCorners ) tableSize *= 2;	// the number of vertices is usually about half the number of corners
+	std::vector<unsigned int> table( tableSize, EMPTY );
+
+	for ( unsigned int c=0; c<numCorners; c++ ) {
+		unsigned int fi = c / 3, j = c % 3;
+		KEY key = getKey( fi, j );
+		unsigned int mask = tableSize - 1;
+		unsigned int slot = (unsigned int) key.Hash() & mask;
+		while ( table[slot] != EMPTY && !( keys[table[slot]] == key ) ) slot = ( slot + 1 ) & mask;
+		if ( table[slot] != EMPTY ) {
+			indices[c] = table[slot];
+			continue;
+		}
+		unsigned int id = (unsigned int) keys.size();
+		table[slot] = id;
+		keys.push_back( key );
+		vertexV.push_back( mesh.F(fi).v[j] );
+		if ( useVN ) vertexVN.push_back( mesh.FN(fi).v[j] );
+		if ( useVT ) vertexVT.push_back( mesh.FT(fi).v[j] );
+		indices[c] = id;
+		if ( keys.size() * 2 > tableSize ) {
+			// Grow the table
+			tableSize *= 2;
+			mask = tableSize - 1;
+			table.assign( tableSize, EMPTY );
+			for ( unsigned int k=0; k<keys.size(); k++ ) {
+				unsigned int s = (unsigned int) keys[k].Hash() & mask;
+				while ( table[s] != EMPTY ) s = ( s + 1 ) & mask;
+				table[s] = k;
+			}
+		}
+	}
+}
+
+inline void MeshWelder::RemapVertices( unsigned int const *remap )
+{
+	std::vector<unsigned int> *ids[3] = { &vertexV, &vertexVN, &vertexVT };
+	std::vector<unsigned int> tmp;
+	for ( int k=0; k<3; k++ ) {
+		std::vector<unsigned int> &v = *ids[k];
+		if ( v.empty() ) continue;
+		tmp.resize( v.size() );
+		for ( size_t i=0; i<v.size(); i++ ) tmp[ remap[i] ] = v[i];
+		v.swap( tmp );
+	}
+	for ( size_t i=0; i<indices.size(); i++ ) indices[i] = remap[ indices[i] ];
+}
+
+inline void MeshWelder::Weld( TriMesh const &mesh, bool useNormals, bool useTexCoords )
+{
+	useVN = useNormals   && mesh.HasNormals();
+	useVT = useTexCoords && mesh.HasTextureVertices();
+	struct Key
+	{
+		unsigned int v, vn, vt;
+		bool operator == ( Key const &k ) const { return v==k.v && vn==k.vn && vt==k.vt; }
+		uint64_t Hash() const { return Mix( ( uint64_t(v) * 0x9E3779B97F4A7C15ull ) ^ ( uint64_t(vn) * 0xC2B2AE3D27D4EB4Full ) ^ ( uint64_t(vt) * 0x165667B19E3779F9ull ) ); }
+	};
+	bool vn = useVN, vt = useVT;
+	WeldKeys<Key>( mesh, [&mesh,vn,vt]( unsigned int fi, unsigned int j ) {
+		Key k;
+		k.v  = mesh.F(fi).v[j];
+		k.vn = vn ? mesh.FN(fi).v[j] : 0;
+		k.vt = vt ? mesh.FT(fi).v[j] : 0;
+		return k;
+	});
+}
+
+inline void MeshWelder::WeldQuantized( TriMesh const &mesh, float positionEpsilon, float normalEpsilon, float texCoordEpsilon, bool useNormals, bool useTexCoords )
+{
+	useVN = useNormals   && mesh.HasNormals();
+	useVT = useTexCoords && mesh.HasTextureVertices();
+	struct Key
+	{
+		int q[9];
+		bool operator == ( Key const &k ) const { for ( int i=0; i<9; i++ ) if ( q[i] != k.q[i] ) return false; return true; }
+		uint64_t Hash() const { uint64_t h = 0; for ( int i=0; i<9; i++ ) h = Mix( h ^ (uint32_t) q[i] ) + i; return h; }
+	};
+	float ps = positionEpsilon > 0 ? 1/positionEpsilon : 0;
+	float ns = normalEpsilon   > 0 ? 1/normalEpsilon   : 0;
+	float ts = texCoordEpsilon > 0 ? 1/texCoordEpsilon : 0;
+	bool vn = useVN, vt = useVT;
+	WeldKeys<Key>( mesh, [&mesh,vn,vt,ps,ns,ts]( unsigned int fi, unsigned int j ) {
+		Key k;
+		for ( int i=0; i<9; i++ ) k.q[i] = 0;
+		Vec3f const &p = mesh.V( mesh.F(fi).v[j] );
+		for ( int i=0; i<3; i++ ) k.q[i] = ps > 0 ? Quantize( p[i], ps ) : Bits( p[i] );
+		if ( vn ) {
+			Vec3f const &n = mesh.VN( mesh.FN(fi).v[j] );
+			for ( int i=0; i<3; i++ ) k.q[3+i] = ns > 0 ? Quantize( n[i], ns ) : Bits( n[i] );
+		}
+		if ( vt ) {
+			Vec3f const &t = mesh.VT( mesh.FT(fi).v[j] );
+			for ( int i=0; i<3; i++ ) k.q[6+i] = ts > 0 ? Quantize( t[i], ts ) : Bits( t[i] );
+		}
+		return k;
+	});
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::MeshWelder cyMeshWelder;	//!< Mesh welder
+
+//-------------------------------------------------------------------------------
+
+#endif
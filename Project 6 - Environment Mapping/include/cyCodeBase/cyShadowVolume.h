@@ -0,0 +1,190 @@
+//-------------------------------------------------------------------------------
+//! \file   cyShadowVolume.h
+//!
+//! \brief  Shadow volume extraction for stencil shadows.
+//!
+//! ShadowVolume builds the shadow volume of a triangle mesh for a point light
+//! or a directional light on the CPU. The volume is the union of the prisms
+//! that the light-facing triangles sweep away from the light to infinity: the
+//! light-facing triangles are the front cap, the same triangles projected to
+//! infinity with the reverse orientation are the back cap, and the silhouette
+//! edges are extruded to infinity to form the sides. The volume is closed even
+//! if the mesh is not, so it can be used with depth-fail (z-fail) stencil
+//! counting. Vertices at infinity have w=0, so the volume should be drawn with
+//! depth clamping or with an infinite far plane.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_SHADOW_VOLUME_H_INCLUDED_
+#define _CY_SHADOW_VOLUME_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyMeshAdjacency.h"
+#include <vector>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+# define _CY_SHADOW_VOLUME_SSE2
+#endif
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Shadow volume of a triangle mesh.
+//!
+//! Build merges the vertices with the same position, so that the normal and
+//! texture seams of a welded vertex buffer do not break the adjacency, and stores
+//! the plane of each triangle in structure-of-arrays form. Extract finds the
+//! triangles that face the light with SIMD instructions (eight triangles at a
+//! time with AVX, four with SSE2) and writes the triangles of the volume.
+
+class ShadowVolume
+{
+public:
+	//! Builds the adjacency and the triangle planes of the given triangles. The positions are read with the given
+	//! stride in bytes, so they can be part of an interleaved vertex buffer.
+	void Build( unsigned int const *indices, size_t numIndices, Vec3f const *positions, unsigned int numVertices, size_t positionStride=sizeof(Vec3f) );
+	//! Builds the shadow volume of the faces of the given mesh.
+	void Build( TriMesh const &mesh ) { Build( mesh.NF() > 0 ? mesh.F(0).v : nullptr, (size_t) mesh.NF()*3, mesh.NV() > 0 ? &mesh.V(0) : nullptr, mesh.NV() ); }
+
+	//! Writes the triangles of the shadow volume for the given light in model space, three vertices per triangle.
+	//! The light is in homogeneous coordinates: w=1 for the position of a point light, and w=0 for the direction
+	//! towards a directional light. Returns the number of vertices.
+	unsigned int Extract( std::vector<Vec4f> &vertices, Vec4f const &light ) const;
+
+	unsigned int NumTriangles() const { return adjacency.NumTriangles(); }		//!< Returns the number of triangles of the mesh.
+	unsigned int NumVertices () const { return (unsigned int) pos.size(); }	//!< Returns the number of unique positions.
+	unsigned int NumLightFacing() const { return numLightFacing; }				//!< Returns the number of light-facing triangles of the last extraction.
+	unsigned int NumSilhouetteEdges() const { return numSilhouette; }			//!< Returns the number of extruded edges of the last extraction.
+	MeshAdjacency const & Adjacency() const { return adjacency; }				//!< Returns the adjacency of the merged positions.
+
+private:
+	MeshAdjacency      adjacency;
+	std::vector<Vec3f> pos;
+	std::vector<float> plane[4];			// triangle planes (normal and negative distance to the origin), padded to a multiple of 8
+	mutable std::vector<unsigned char> facing;
+	mutable unsigned int numLightFacing = 0;
+	mutable unsigned int numSilhouette  = 0;
+
+	void ComputeFacing( Vec4f const &light ) const;
+};
+
+//-------------------------------------------------------------------------------
+
+inline void ShadowVolume::Build( unsigned int const *indices, size_t numIndices, Vec3f const *positions, unsigned int numVertices, size_t positionStride )
+{
+	numIndices -= numIndices % 3;
+
+	// Merge the vertices with identical positions by sorting them
+	std::vector<unsigned int> order( numVertices ), remap( numVertices );
+	for ( unsigned int i=0; i<numVertices; i++ ) order[i] = i;
+	auto P = [&]( unsigned int i ) -> Vec3f const & { return *(Vec3f const *)( (char const *) positions + positionStride * i ); };
+	std::sort( order.begin(), order.end(), [&]( unsigned int a, unsigned int b ) {
+		Vec3f const &pa = P(a), &pb = P(b);
+		if ( pa.x != pb.x ) return pa.x < pb.x;
+		if ( pa.y != pb.y ) return pa.y < pb.y;
+		return pa.z < pb.z;
+	});
+	pos.clear();
+	for ( unsigned int i=0; i<numVertices; i++ ) {
+		if ( i == 0 || !( P(order[i]) == P(order[i-1]) ) ) pos.push_back( P(order[i]) );
+		remap[ order[i] ] = (unsigned int) pos.size() - 1;
+	}
+	std::vector<unsigned int> merged( numIndices );
+	for ( size_t i=0; i<numIndices; i++ ) merged[i] = remap[ indices[i] ];
+	adjacency.Build( merged.data(), numIndices, (unsigned int) pos.size() );
+
+	// Triangle planes
+	unsigned int nt = adjacency.NumTriangles();
+	size_t padded = ( (size_t) nt + 7 ) & ~size_t(7);
+	for ( int k=0; k<4; k++ ) plane[k].assign( padded, 0.0f );
+	for ( unsigned int f=0; f<nt; f++ ) {
+		Vec3f const &p0 = pos[ merged[3*f  ] ];
+		Vec3f const &p1 = pos[ merged[3*f+1] ];
+		Vec3f const &p2 = pos[ merged[3*f+2] ];
+		Vec3f n = (p1 - p0) ^ (p2 - p0);
+		plane[0][f] = n.x;
+		plane[1][f] = n.y;
+		plane[2][f] = n.z;
+		plane[3][f] = -(n % p0);
+	}
+	facing.resize( padded );
+}
+
+//-------------------------------------------------------------------------------
+
+inline void ShadowVolume::ComputeFacing( Vec4f const &light ) const
+{
+	size_t n = plane[0].size();
+	float const *a = plane[0].data(), *b = plane[1].data(), *c = plane[2].data(), *d = plane[3].data();
+	size_t i = 0;
+#if defined(__AVX__)
+	__m256 lx = _mm256_set1_ps( light.x ), ly = _mm256_set1_ps( light.y ), lz = _mm256_set1_ps( light.z ), lw = _mm256_set1_ps( light.w );
+	for ( ; i<n; i+=8 ) {
+		__m256 s = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps(a+i), lx ), _mm256_mul_ps( _mm256_loadu_ps(b+i), ly ) ),
+		                          _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps(c+i), lz ), _mm256_mul_ps( _mm256_loadu_ps(d+i), lw ) ) );
+		int mask = _mm256_movemask_ps( _mm256_cmp_ps( s, _mm256_setzero_ps(), _CMP_GT_OQ ) );
+		for ( int k=0; k<8; k++ ) facing[i+k] = (unsigned char)( (mask >> k) & 1 );
+	}
+#elif defined(_CY_SHADOW_VOLUME_SSE2)
+	__m128 lx = _mm_set1_ps( light.x ), ly = _mm_set1_ps( light.y ), lz = _mm_set1_ps( light.z ), lw = _mm_set1_ps( light.w );
+	for ( ; i<n; i+=4 ) {
+		__m128 s = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_loadu_ps(a+i), lx ), _mm_mul_ps( _mm_loadu_ps(b+i), ly ) ),
+		                       _mm_add_ps( _mm_mul_ps( _mm_loadu_ps(c+i), lz ), _mm_mul_ps( _mm_loadu_ps(d+i), lw ) ) );
+		int mask = _mm_movemask_ps( _mm_cmpgt_ps( s, _mm_setzero_ps() ) );
+		for ( int k=0; k<4; k++ ) facing[i+k] = (unsigned char)( (mask >> k) & 1 );
+	}
+#endif
+	for ( ; i<n; i++ ) facing[i] = ( a[i]*light.x + b[i]*light.y ) + ( c[i]*light.z + d[i]*light.w ) > 0;
+}
+
+inline unsigned int ShadowVolume::Extract( std::vector<Vec4f> &vertices, Vec4f const &light ) const
+{
+	ComputeFacing( light );
+
+	// A light-facing triangle writes its two caps and at most three sides of two triangles each
+	unsigned int nt = adjacency.NumTriangles();
+	unsigned int nf = 0;
+	for ( unsigned int f=0; f<nt; f++ ) nf += facing[f];
+	vertices.resize( (size_t) nf * 24 );
+	Vec4f *out = vertices.data();
+
+	auto Near = [&]( unsigned int v ) { Vec3f const &p = pos[v]; return Vec4f( p.x, p.y, p.z, 1.0f ); };
+	auto Far  = [&]( unsigned int v ) { Vec3f const &p = pos[v]; return Vec4f( p.x*light.w - light.x, p.y*light.w - light.y, p.z*light.w - light.z, 0.0f ); };
+
+	unsigned int ns = 0;
+	for ( unsigned int f=0; f<nt; f++ ) {
+		if ( !facing[f] ) continue;
+		unsigned int h = 3*f;
+		unsigned int v0 = adjacency.Origin(h), v1 = adjacency.Origin(h+1), v2 = adjacency.Origin(h+2);
+		// front cap, and back cap with the reverse orientation
+		*(out++) = Near(v0); *(out++) = Near(v1); *(out++) = Near(v2);
+		*(out++) = Far (v0); *(out++) = Far (v2); *(out++) = Far (v1);
+		// sides for the edges that are not shared with another light-facing triangle
+		for ( unsigned int j=0; j<3; j++ ) {
+			unsigned int t = adjacency.Twin( h+j );
+			if ( t != MeshAdjacency::NONE && facing[ MeshAdjacency::Triangle(t) ] ) continue;
+			unsigned int a = adjacency.Origin( h+j ), b = adjacency.Target( h+j );
+			Vec4f na = Near(a), nb = Near(b), fa = Far(a), fb = Far(b);
+			*(out++) = nb; *(out++) = na; *(out++) = fa;
+			*(out++) = nb; *(out++) = fa; *(out++) = fb;
+			ns++;
+		}
+	}
+	vertices.resize( out - vertices.data() );
+	numLightFacing = nf;
+	numSilhouette  = ns;
+	return (unsigned int) vertices.size();
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::ShadowVolume cyShadowVolume;	//!< Shadow volume of a triangle mesh
+
+//-------------------------------------------------------------------------------
+
+#endif
@@ -285,7 +285,7 @@ public:
 
 	//!@name Constructors
 	Vec3() CY_CLASS_FUNCTION_DEFAULT
-	Vec3( T _x, T _y, T _z )                  : x( _x), y( _y), z( _z) {}
+	constexpr Vec3( T _x, T _y, T _z )        : x( _x), y( _y), z( _z) {}
 	explicit Vec3( T v )                      : x(v  ), y(v  ), z(v  ) {}
 	explicit Vec3( Vec2<T> const &p, T _z=0 ) : x(p.x), y(p.y), z( _z) {}
 	explicit Vec3( Vec4<T> const &p );
@@ -445,7 +445,7 @@ public:
 
 	//!@name Constructors
 	Vec4() CY_CLASS_FUNCTION_DEFAULT
-	Vec4( T _x, T _y, T _z, T _w )                    : x( _x), y( _y), z( _z), w( _w) {}
+	constexpr Vec4( T _x, T _y, T _z, T _w )          : x( _x), y( _y), z( _z), w( _w) {}
 	explicit Vec4( T v )                              : x(v  ), y(v  ), z(v  ), w(v  ) {}
 	explicit Vec4( Vec2<T> const &p, T _z=0, T _w=1 ) : x(p.x), y(p.y), z( _z), w( _w) {}
 	explicit Vec4( Vec3<T> const &p,         T _w=1 ) : x(p.x), y(p.y), z(p.z), w( _w) {}
@@ -6,20 +6,15 @@
 #include "cyCodeBase/cyVector.h"
 #include "cyCodeBase/cyMatrix.h"
 #include "cyCodeBase/cyTriMesh.h"
+#include "cyCodeBase/cyMeshCache.h"
+#include "cyCodeBase/cyMeshWeld.h"
+#include "cyCodeBase/cyMeshOptimizer.h"
 #include "cyCodeBase/cyGL.h"
+#include "cyCodeBase/cyVertexLayout.h"
+#include "cyCodeBase/cyGeometryRegistry.h"
+#include "cyCodeBase/cyTransformNode.h"
 #include "lodepng.h"
 
-// number of vertices and faces in given obj
-int obj_num_v;
-int obj_num_f;
-
-// number of vertices and faces in cube
-int cube_num_v;
-int cube_num_f;
-
-// vector to store vertices
-std::vector<GLfloat> vertices;
-
 // texture image width and height
 unsigned img_width = 2048;
 unsigned img_height = 2048;
@@ -77,11 +72,34 @@ GLuint plane_mv;
 GLfloat display_width = 800;
 GLfloat display_height = 600;
 
+// fields of view, with the tangents of their halves computed at compile time when the compiler allows it
+constexpr float fov_wide = 3.145 * 40.0 / 180.0;
+constexpr float fov_narrow = 3.145 * 20.0 / 180.0;
+CY_CONSTEXPR_VAR float tan_half_fov_wide = cy::TanConst(fov_wide * 0.5f);
+CY_CONSTEXPR_VAR float tan_half_fov_narrow = cy::TanConst(fov_narrow * 0.5f);
+
+// fixed position of the plane
+constexpr cyVec3f plane_position(0, 0, -5);
+
 // VAOs and VBOs
-GLuint obj_vao, obj_vbo[2];
-GLuint ref_vao, ref_vbo[2];
 GLuint plane_vao, plane_vbo;
-GLuint cube_vao, cube_vbo;
+
+// GPU buffers shared by the programs that draw the same mesh
+cyGeometryRegistry geometry;
+const cyGeometryRegistry::Geometry *obj_geom;
+const cyGeometryRegistry::Geometry *ref_geom;
+const cyGeometryRegistry::Geometry *cube_geom;
+
+// interleaved vertex layout of the obj
+typedef cy::VertexLayout<
+    cy::VertexAttrib<cy::VERTEX_POSITION, cy::VertexFloat3, 0>,
+    cy::VertexAttrib<cy::VERTEX_NORMAL, cy::VertexSnorm10, 1>>
+    ObjLayout;
+
+// vertex layout of the cube
+typedef cy::VertexLayout<
+    cy::VertexAttrib<cy::VERTEX_POSITION, cy::VertexFloat3, 0>>
+    CubeLayout;
 
 // OBJ reader
 cyTriMesh reader;
@@ -89,90 +107,54 @@ cyTriMesh reader;
 // Render Buffer
 cyGLRenderTexture2D renderBuffer;
 
-// find center x & y points to translate to
-cyVec3f findCenter(float depth)
-{
-
-    cyVec3f max = reader.GetBoundMax();
-    cyVec3f min = reader.GetBoundMin();
-
-    float center_x = min.x + ((max.x - min.x) / 2.0f);
-    float center_y = min.y + ((max.y - min.y) / 2.0f);
+// object transformations, which cache their mvp/mv matrices for each camera between frames
+// (the reflection is a child of the obj, flipped around the x-axis, and the cube is only rotated)
+cyTransformNode obj_node;
+cyTransformNode ref_node;
+cyTransformNode plane_node;
+cyTransformNode cube_node;
 
-    return cyVec3f(center_x, center_y, depth);
-}
+// cameras (the view is fixed, so only their projections change)
+cyCamera main_camera;
+cyCamera ref_camera;
+cyCamera plane_camera;
 
-// calculate MV matrix
-cyMatrix4f getRefMV()
+// find center x & y points to translate to
+cyVec3f findCenter(float depth)
 {
-    // generate translation and rotation matrices then multiply them
-    return cyMatrix4f::Translation(findCenter(obj_t_z)) * cyMatrix4f::RotationXYZ(3.145 + obj_r_x, obj_r_y, 0);
+    cyVec3f center = obj_node.GetBoundCenter();
+    return cyVec3f(center.x, center.y, depth);
 }
 
-// calculate MVP matrix
-cyMatrix4f getRefMVP()
+// set up the transformation hierarchy
+void setTransforms()
 {
-    // perspective projection matrix values
-    float fov = 3.145 * 40.0 / 180.0;
-    float aspect = 1;
-    float near_p = 0.1f;
-    float far_p = obj_t_z * 2;
-
-    // generate perspective projection, translation, and rotation matrices and multiply them
-    return (cyMatrix4f::Perspective(fov, aspect, near_p, far_p) * cyMatrix4f::Translation(findCenter(obj_t_z)) * cyMatrix4f::RotationXYZ(3.145 + obj_r_x, obj_r_y, 0));
+    obj_node.SetBounds(reader.GetBoundMin(), reader.GetBoundMax());
+    ref_node.SetParent(&obj_node);
+    ref_node.SetRotation(cyMatrix3f::RotationX(3.145f));
+    plane_node.SetTranslation(plane_position);
 }
 
-// calculate MV matrix
-cyMatrix4f getMV()
+// update object transformations after rotation or zoom
+void updateTransforms()
 {
-    // generate translation and rotation matrices then multiply them
-    return cyMatrix4f::Translation(findCenter(obj_t_z)) * cyMatrix4f::RotationXYZ(obj_r_x, obj_r_y, 0);
+    obj_node.SetTranslation(findCenter(obj_t_z));
+    obj_node.SetRotationXYZ(obj_r_x, obj_r_y, 0);
+    plane_node.SetRotationXYZ(obj_r_x, obj_r_y, 0);
+    cube_node.SetRotationXYZ(obj_r_x, obj_r_y, 0);
 }
 
-// calculate MVP matrix
-cyMatrix4f getMVP()
+// update projection matrices after resize or zoom
+void updateCameras()
 {
     // perspective projection matrix values
-    float fov = 3.145 * 40.0 / 180.0;
     float aspect = display_width / display_height;
     float near_p = 0.1f;
     float far_p = obj_t_z * 2;
 
-    // generate perspective projection, translation, and rotation matrices and multiply them
-    return (cyMatrix4f::Perspective(fov, aspect, near_p, far_p) * cyMatrix4f::Translation(findCenter(obj_t_z)) * cyMatrix4f::RotationXYZ(obj_r_x, obj_r_y, 0));
-}
-
-// calculate MV matrix for plane
-cyMatrix4f getPlaneMV()
-{
-    // generate translation, and rotation matrices and multiply them
-    return (cyMatrix4f::Translation(cyVec3f(0, 0, -5)) * cyMatrix4f::RotationXYZ(obj_r_x, obj_r_y, 0));
-}
-
-// calculate MVP matrix for plane
-cyMatrix4f getPlaneMVP()
-{
-    // perspective projection matrix values
-    float fov = 3.145 * 20.0 / 180.0;
-    float aspect = display_width / display_height;
-    float n = 0.1f;
-    float f = obj_t_z * 2;
-
-    // generate perspective projection, translation, and rotation matrices and multiply them
-    return (cyMatrix4f::Perspective(fov, aspect, n, f) * cyMatrix4f::Translation(cyVec3f(0, 0, -5)) * cyMatrix4f::RotationXYZ(obj_r_x, obj_r_y, 0));
-}
-
-// calculate MVP matrix for cube
-cyMatrix4f getCubeMVP()
-{
-    // perspective projection matrix values
-    float fov = 3.145 * 40.0 / 180.0;
-    float aspect = display_width / display_height;
-    float n = 0.1f;
-    float f = obj_t_z + obj_t_z;
-
-    // generate perspective projection, translation, and rotation matrices and multiply them
-    return (cyMatrix4f::Perspective(fov, aspect, n, f) * cyMatrix4f::Translation(cyVec3f(0, 0, 0)) * cyMatrix4f::RotationXYZ(obj_r_x, obj_r_y, 0));
+    main_camera.SetProjection(cyMatrix4f::PerspectiveTan(tan_half_fov_wide, aspect, near_p, far_p));
+    ref_camera.SetProjection(cyMatrix4f::PerspectiveTan(tan_half_fov_wide, 1, near_p, far_p));
+    plane_camera.SetProjection(cyMatrix4f::PerspectiveTan(tan_half_fov_narrow, aspect, near_p, far_p));
 }
 
 // setup reader and parse OBJ file
@@ -188,7 +170,8 @@ cyTriMesh parseOBJ(int argc, const char *filename)
     // read OBJ file
     bool read_status;
     cyTriMesh reader;
-    if (!(read_status = reader.LoadFromFileObj(filename, true)))
+    cyMeshCache cache;
+    if (!(read_status = cache.LoadFromFileObj(reader, filename, true)))
     {
         fprintf(stderr, "Error: cannot read file");
         exit(1);
@@ -199,75 +182,17 @@ cyTriMesh parseOBJ(int argc, const char *filename)
 // generate vertex buffer object and bind data
 void setVBO()
 {
-    // read vertex data
-    obj_num_v = reader.NV();
-    obj_num_f = reader.NF();
+    // merge the face corners that share the same position and normal
+    cyMeshWelder welder;
+    welder.Weld(reader, true, false);
 
-    // fill vector with vertex data
-    int i;
-    for (i = 0; i < obj_num_v; i++)
-    {
-        cyVec3f _verts = reader.V(i);
-        vertices.push_back(_verts[0]);
-        vertices.push_back(_verts[1]);
-        vertices.push_back(_verts[2]);
-    }
+    // reorder triangles and vertices for the vertex cache
+    cyMeshOptimizer::Optimize(welder);
 
-    // fill vector with vertex data
-    cyVec3f *v = new cyVec3f[obj_num_f * 3];
-    for (i = 0; i < obj_num_f; i++)
-    {
-        cyTriMesh::TriFace _face = reader.F(i);
-        v[3 * i + 0] = reader.V(_face.v[0]);
-        v[3 * i + 1] = reader.V(_face.v[1]);
-        v[3 * i + 2] = reader.V(_face.v[2]);
-    }
-
-    // fill vector with normal data
-    cyVec3f *n = new cyVec3f[obj_num_f * 3];
-    for (i = 0; i < obj_num_f; i++)
-    {
-        cyTriMesh::TriFace fn = reader.FN(i);
-        n[3 * i + 0] = reader.VN(fn.v[0]);
-        n[3 * i + 1] = reader.VN(fn.v[1]);
-        n[3 * i + 2] = reader.VN(fn.v[2]);
-    }
-
-    // generate and bind vertex buffer objects and vertex array object
-    glGenVertexArrays(1, &obj_vao);
-    glBindVertexArray(obj_vao);
-
-    glGenBuffers(3, obj_vbo);
-
-    glBindBuffer(GL_ARRAY_BUFFER, obj_vbo[0]);
-    glBufferData(GL_ARRAY_BUFFER, obj_num_f * 3 * sizeof(cyVec3f), v, GL_STATIC_DRAW);
-    GLuint obj_pos = glGetAttribLocation(obj_program_id, "pos");
-    glEnableVertexAttribArray(obj_pos);
-    glVertexAttribPointer(obj_pos, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
-
-    glBindBuffer(GL_ARRAY_BUFFER, obj_vbo[1]);
-    glBufferData(GL_ARRAY_BUFFER, obj_num_f * 3 * sizeof(cyVec3f), n, GL_STATIC_DRAW);
-    GLuint obj_norm = glGetAttribLocation(obj_program_id, "norm");
-    glEnableVertexAttribArray(obj_norm);
-    glVertexAttribPointer(obj_norm, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
-
-    // generate and bind vertex buffer objects and vertex array object
-    glGenVertexArrays(1, &ref_vao);
-    glBindVertexArray(ref_vao);
-
-    glGenBuffers(3, ref_vbo);
-
-    glBindBuffer(GL_ARRAY_BUFFER, ref_vbo[0]);
-    glBufferData(GL_ARRAY_BUFFER, obj_num_f * 3 * sizeof(cyVec3f), v, GL_STATIC_DRAW);
-    GLuint ref_pos = glGetAttribLocation(ref_program_id, "pos");
-    glEnableVertexAttribArray(ref_pos);
-    glVertexAttribPointer(ref_pos, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
-
-    glBindBuffer(GL_ARRAY_BUFFER, ref_vbo[1]);
-    glBufferData(GL_ARRAY_BUFFER, obj_num_f * 3 * sizeof(cyVec3f), n, GL_STATIC_DRAW);
-    GLuint ref_norm = glGetAttribLocation(ref_program_id, "norm");
-    glEnableVertexAttribArray(ref_norm);
-    glVertexAttribPointer(ref_norm, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
+    // the obj and reflection programs use the same attribute locations, so they share the buffers and the VAO
+    obj_geom = geometry.Acquire<ObjLayout>(reader, welder);
+    ref_geom = geometry.Acquire<ObjLayout>(reader, welder);
+    printf("OBJ GPU memory: %zu bytes (%u references)\n", geometry.GPUBytes(&reader), geometry.NumReferences(obj_geom));
 }
 
 // generate VBO for plane
@@ -309,33 +234,16 @@ void setPlaneVBO()
 void setCubeVBO()
 {
     bool r;
-    if (!(r = cube_mesh.LoadFromFileObj("cube.obj")))
+    if (!(r = cube_mesh.LoadFromFileObjMapped("cube.obj")))
     {
         fprintf(stderr, "Error: cannot read cube file");
         exit(1);
     }
-    cube_num_v = cube_mesh.NV();
-    cube_num_f = cube_mesh.NF();
-
-    cyVec3f *v = new cyVec3f[cube_num_f * 3];
-    for (int i = 0; i < cube_num_f; i++)
-    {
-        cyTriMesh::TriFace f = cube_mesh.F(i);
-        v[3 * i + 0] = cube_mesh.V(f.v[0]);
-        v[3 * i + 1] = cube_mesh.V(f.v[1]);
-        v[3 * i + 2] = cube_mesh.V(f.v[2]);
-    }
-
-    // create and bind vertex buffer object with vertex data
-    glGenVertexArrays(1, &cube_vao);
-    glBindVertexArray(cube_vao);
-    glGenBuffers(1, &cube_vbo);
 
-    glBindBuffer(GL_ARRAY_BUFFER, cube_vbo);
-    glBufferData(GL_ARRAY_BUFFER, cube_num_f * 3 * sizeof(cyVec3f), v, GL_STATIC_DRAW);
-    GLuint pos = glGetAttribLocation(cube_program_id, "pos");
-    glEnableVertexAttribArray(pos);
-    glVertexAttribPointer(pos, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
+    // index the cube vertices by position
+    cyMeshWelder welder;
+    welder.Weld(cube_mesh, false, false);
+    cube_geom = geometry.Acquire<CubeLayout>(cube_mesh, welder);
 }
 
 void setCubeMap()
@@ -546,6 +454,7 @@ void resize(int w, int h)
     display_width = w;
     display_height = h;
     glViewport(0, 0, w, h);
+    updateCameras();
 }
 
 // listen for 'Esc' (to quit)
@@ -600,6 +509,7 @@ void mouseMotion(int x, int y)
         else if (prev_x > x)      // cursor moves left
             obj_r_y -= rot_speed; // rotate along y-axis
         prev_x = x;
+        updateTransforms();
     }
     // right click - start zooming
     else if (mouse_button == GLUT_RIGHT_BUTTON)
@@ -609,6 +519,8 @@ void mouseMotion(int x, int y)
         else
             obj_t_z -= obj_zoom_speed; // zoom out
         prev_y_zoom = y;
+        updateTransforms();
+        updateCameras();
     }
 
     glutPostRedisplay();
@@ -625,14 +537,10 @@ void draw()
 
     glDepthFunc(GL_ALWAYS);
 
-    float _cmvp[16];
-    getCubeMVP().Get(_cmvp);
-    glUniformMatrix4fv(cube_mvp, 1, false, _cmvp);
-
-    glBindVertexArray(cube_vao);
+    glUniformMatrix4fv(cube_mvp, 1, false, cube_node.GetMVP(main_camera).cell);
 
     // draw cubemap
-    glDrawArrays(GL_TRIANGLES, 0, cube_num_f * 3);
+    cube_geom->Draw();
     glDepthFunc(GL_LESS);
 
     // REFLECTION -----------------------------------
@@ -643,18 +551,12 @@ void draw()
     // obj render
     glUseProgram(ref_program_id);
 
-    // calculate and set mvp/mv matrix
-    float _rmvp[16];
-    float _rmv[16];
-    getRefMVP().Get(_rmvp);
-    getRefMV().Get(_rmv);
-    glUniformMatrix4fv(ref_mvp, 1, false, _rmvp);
-    glUniformMatrix4fv(ref_mv, 1, false, _rmv);
-
-    glBindVertexArray(ref_vao);
+    // set mvp/mv matrix
+    glUniformMatrix4fv(ref_mvp, 1, false, ref_node.GetMVP(ref_camera).cell);
+    glUniformMatrix4fv(ref_mv, 1, false, ref_node.GetModelView(ref_camera).cell);
 
     // draw obj
-    glDrawArrays(GL_TRIANGLES, 0, obj_num_f * 3 * sizeof(cyVec3f));
+    ref_geom->Draw();
 
     renderBuffer.Unbind();
 
@@ -665,12 +567,8 @@ void draw()
 
     glUseProgram(plane_program_id);
 
-    float _pmvp[16];
-    float _pmv[16];
-    getPlaneMVP().Get(_pmvp);
-    getPlaneMV().Get(_pmv);
-    glUniformMatrix4fv(plane_mvp, 1, false, _pmvp);
-    glUniformMatrix4fv(plane_mv, 1, false, _pmv);
+    glUniformMatrix4fv(plane_mvp, 1, false, plane_node.GetMVP(plane_camera).cell);
+    glUniformMatrix4fv(plane_mv, 1, false, plane_node.GetModelView(plane_camera).cell);
 
     GLuint planeTexID = glGetUniformLocation(plane_program_id, "renderTex");
     glUniform1i(planeTexID, 0);
@@ -688,18 +586,12 @@ void draw()
     // obj render
     glUseProgram(obj_program_id);
 
-    // calculate and set mvp/mv matrix
-    float _mvp[16];
-    float _mv[16];
-    getMVP().Get(_mvp);
-    getMV().Get(_mv);
-    glUniformMatrix4fv(obj_mvp, 1, false, _mvp);
-    glUniformMatrix4fv(obj_mv, 1, false, _mv);
-
-    glBindVertexArray(obj_vao);
+    // set mvp/mv matrix
+    glUniformMatrix4fv(obj_mvp, 1, false, obj_node.GetMVP(main_camera).cell);
+    glUniformMatrix4fv(obj_mv, 1, false, obj_node.GetModelView(main_camera).cell);
 
     // draw obj
-    glDrawArrays(GL_TRIANGLES, 0, obj_num_f * 3 * sizeof(cyVec3f));
+    obj_geom->Draw();
 
     // ----------------------------------------------
 
@@ -736,6 +628,9 @@ int main(int argc, char *argv[])
 
     // read and parse OBJ
     reader = parseOBJ(argc, argv[1]);
+    setTransforms();
+    updateTransforms();
+    updateCameras();
 
     compileShaders();
     setRenderBuffer();
@@ -747,14 +642,11 @@ int main(int argc, char *argv[])
     // start
     glutMainLoop();
 
-    // clear obj_vbo buffers
-    glDeleteBuffers(1, &obj_vbo[0]);
-    glDeleteBuffers(1, &obj_vbo[1]);
-    glDeleteBuffers(1, &cube_vbo);
+    // release shared geometry and clear plane buffers
+    geometry.Release(obj_geom);
+    geometry.Release(ref_geom);
+    geometry.Release(cube_geom);
     glDeleteBuffers(1, &plane_vbo);
-
-    glDeleteVertexArrays(1, &obj_vao);
-    glDeleteVertexArrays(1, &cube_vao);
     glDeleteVertexArrays(1, &plane_vao);
 
     return 0;
@@ -1,3 +1,3 @@
-g++ main.cpp -o main -lfreeglut -lglu32 -lopengl32 -lglew32
+g++ -Wa,-muse-unaligned-vector-move -DCY_MINGW_UNALIGNED_VECTOR_MOVE main.cpp -o main -lfreeglut -lglu32 -lopengl32 -lglew32
 main.exe teapot.obj
 pause
\ No newline at end of file
@@ -0,0 +1,908 @@
+//-------------------------------------------------------------------------------
+//! \file   cyMeshCodec.h
+//!
+//! \brief  Compressed storage of welded triangle meshes.
+//!
+//! MeshCodec compresses an indexed triangle mesh with positions, and optionally
+//! normals and texture coordinates, into a compact binary form (.cymc files).
+//! Positions and texture coordinates are quantized to a given number of bits
+//! in their bounding box and normals are quantized with octahedral encoding.
+//! Each vertex is predicted from the vertices that were decoded before it,
+//! using the parallelogram rule when the triangle shares an edge with an
+//! earlier triangle, and only the difference is stored. Triangles that share an
+//! edge with one of the last few triangles refer to that edge and store only
+//! their third vertex, and vertices are stored relative to the next new vertex,
+//! which makes the indices small for meshes whose triangles are in vertex cache
+//! order. The values are entropy coded with rANS.
+//!
+//! The mesh is split into blocks of triangles that are coded independently, so
+//! that both encoding and decoding run in parallel.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_MESH_CODEC_H_INCLUDED_
+#define _CY_MESH_CODEC_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyMeshOptimizer.h"
+#include "cyMemoryMap.h"
+#include <vector>
+#include <thread>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+#ifdef _MSC_VER
+# include <intrin.h>
+#endif
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Mesh compression codec.
+//!
+//! Decoding returns the vertices in the order they are first used by the
+//! triangles, which is the order that OptimizeVertexFetch produces, and it drops
+//! the vertices that are not used by any triangle. The order of the triangles is
+//! preserved, but their first vertex can change (their orientation does not).
+//! Materials are not stored.
+//!
+//! Each block begins with a table of the symbol frequencies of each stream,
+//! followed by the rANS coded symbols (four interleaved states, so that the
+//! decoder can overlap their dependency chains) and the raw low bits of the
+//! values. Values are decoded stream by stream into flat arrays before the
+//! prediction loop, and the final conversion to floating point is a simple
+//! loop over these arrays that the compiler can vectorize.
+
+class MeshCodec
+{
+public:
+	static const uint32_t VERSION = 1;	//!< The version of the file format.
+
+	//! Encoding settings
+	struct Settings
+	{
+		int          positionBits;		//!< Bits per position component (1 to 24)
+		int          normalBits;		//!< Bits per octahedral normal component (2 to 16)
+		int          texCoordBits;		//!< Bits per texture coordinate component (1 to 24)
+		unsigned int blockTriangles;	//!< The number of triangles per independently coded block
+		unsigned int numThreads;		//!< The number of encoding threads (zero uses all hardware threads)
+		Settings() : positionBits(14), normalBits(10), texCoordBits(12), blockTriangles(1<<16), numThreads(0) {}
+	};
+
+	//! Information about encoded data
+	struct Info
+	{
+		unsigned int numVertices;	//!< The number of vertices
+		unsigned int numIndices;	//!< The number of indices, which is three times the number of triangles
+		unsigned int numBlocks;		//!< The number of blocks
+		bool         hasNormals;	//!< True if the data has normals
+		bool         hasTexCoords;	//!< True if the data has texture coordinates
+	};
+
+	//!@name Encoding
+
+	//! Encodes the given indexed triangles. The normals and the texture coordinates are optional. Only the x and y
+	//! components of the texture coordinates are stored.
+	static void Encode( std::vector<unsigned char> &data, unsigned int const *indices, size_t numIndices, unsigned int numVertices,
+	                    Vec3f const *positions, Vec3f const *normals, Vec3f const *texCoords, Settings const &settings=Settings() );
+	//! Welds the given mesh, puts its triangles in vertex cache order, and encodes it.
+	static void Encode( std::vector<unsigned char> &data, TriMesh const &mesh, Settings const &settings=Settings() );
+	//! Encodes the given mesh and writes it to a file.
+	static bool SaveToFile( char const *filename, TriMesh const &mesh, Settings const &settings=Settings(), std::ostream *outStream=&std::cout );
+
+	//!@name Decoding
+
+	//! Reads the header of encoded data. Returns false if the data is not valid.
+	static bool GetInfo( void const *data, size_t size, Info &info );
+	//! Decodes the given data. The normals and the texture coordinates are decoded only if the given pointers are not
+	//! null and the data has them; otherwise the arrays are cleared. Returns false if the data is not valid.
+	static bool Decode( void const *data, size_t size, std::vector<unsigned int> &indices, std::vector<Vec3f> &positions,
+	                    std::vector<Vec3f> *normals=nullptr, std::vector<Vec3f> *texCoords=nullptr, unsigned int numThreads=0 );
+	//! Decodes the given data into a mesh, in which the normals and the texture coordinates use the same face indices as the positions.
+	static bool Decode( void const *data, size_t size, TriMesh &mesh, unsigned int numThreads=0 );
+	//! Maps the given file and decodes it into a mesh. The bounding box of the mesh is computed.
+	static bool LoadFromFile( TriMesh &mesh, char const *filename, unsigned int numThreads=0, std::ostream *outStream=&std::cout );
+
+private:
+	struct Header
+	{
+		char     magic[8];		// "CYMESHC" followed by a null character
+		uint32_t version;
+		uint32_t byteOrder;		// 0x01020304 in the native byte order of the writer
+		uint32_t flags;
+		uint32_t numVertices;
+		uint32_t numIndices;
+		uint32_t numBlocks;
+		uint32_t bits[3];		// position, normal, and texture coordinate bits
+		float    positionOffset[3];
+		float    positionScale [3];
+		float    texCoordOffset[2];
+		float    texCoordScale [2];
+	};
+	struct Block
+	{
+		uint32_t firstTriangle;
+		uint32_t numTriangles;
+		uint32_t firstVertex;	// the first vertex that is used for the first time in the block
+		uint32_t numVertices;	// the number of vertices that are used for the first time in the block
+		uint64_t offset;
+		uint64_t size;
+	};
+	enum { FLAG_NORMALS=1, FLAG_TEXCOORDS=2 };
+	enum : unsigned int { NONE = 0xFFFFFFFF };
+
+	//! Quantized attributes of the vertices that are first used in a block, in their first-use order
+	struct BlockData
+	{
+		std::vector<uint32_t> pos, norm, txc;
+	};
+
+	// Prediction
+	class EdgeTable;
+	class EdgeFifo;
+	static void RotateTriangles( unsigned int *indices, unsigned int numTriangles );
+	template <typename FUNC> static void Traverse( unsigned int const *indices, unsigned int numTriangles, unsigned int firstVertex, unsigned int numVertices, FUNC newVertex );
+	static uint32_t Predict( uint32_t const *q, int comps, int c, unsigned int a, unsigned int b, unsigned int d, unsigned int prev, uint32_t maxValue );
+
+	// Value coding
+	static const int NUM_SYMBOLS = 64;
+	static const int PROB_BITS   = 12;
+	static const int BIT_PADDING = 24;
+	static const uint32_t RANS_L = 1u << 16;
+	static void EncodeValues( std::vector<unsigned char> &out, uint32_t const *values, size_t n );
+	static bool DecodeValues( unsigned char const *&p, unsigned char const *end, uint32_t *values, size_t n );
+	static int  BitLength( uint32_t u );
+	static void SymbolBits( int symbol, uint32_t &base, int &numBits );
+	static uint32_t ZigZag  ( int32_t  i ) { return ( uint32_t(i) << 1 ) ^ uint32_t( i >> 31 ); }
+	static int32_t  UnZigZag( uint32_t u ) { return int32_t( u >> 1 ) ^ -int32_t( u & 1 ); }
+
+	// Blocks
+	static void EncodeBlock( std::vector<unsigned char> &out, Block const &block, unsigned int const *indices, BlockData const &data, int numPos, int numNorm, int numTxc, uint32_t const maxValue[3] );
+	static bool DecodeBlock( Block const &block, unsigned char const *data, Header const &header, unsigned int *indices, Vec3f *positions, Vec3f *normals, Vec3f *texCoords );
+
+	static void OctEncode( float &u, float &v, Vec3f n );
+	static Vec3f OctDecode( float u, float v );
+
+	static unsigned int NumThreads( unsigned int numThreads, size_t numBlocks );
+	template <typename FUNC> static void ParallelFor( unsigned int n, FUNC func );
+};
+
+//-------------------------------------------------------------------------------
+// Edge table
+//
+// Maps the directed edges of the decoded triangles of a block to the vertex
+// opposite to them. Each vertex of the block keeps its last few outgoing edges
+// in a small fixed array, so that the lookups for recently used vertices stay
+// in the cache. Vertices with more edges replace their oldest ones.
+//-------------------------------------------------------------------------------
+
+class MeshCodec::EdgeTable
+{
+public:
+	EdgeTable( unsigned int firstVertex, unsigned int numVertices ) : first(firstVertex), edges( (size_t) numVertices * SLOTS ), count( numVertices, 0 ) {}
+	void Insert( unsigned int a, unsigned int b, unsigned int opposite )
+	{
+		unsigned int i = a - first;
+		Edge &e = edges[ (size_t) i * SLOTS + ( count[i]++ & (SLOTS-1) ) ];
+		e.target   = b;
+		e.opposite = opposite;
+	}
+	unsigned int Find( unsigned int a, unsigned int b ) const
+	{
+		unsigned int i = a - first;
+		Edge const *e = edges.data() + (size_t) i * SLOTS;
+		unsigned int n = count[i] < SLOTS ? count[i] : (unsigned int) SLOTS;
+		for ( unsigned int k=0; k<n; k++ ) if ( e[k].target == b ) return e[k].opposite;
+		return NONE;
+	}
+private:
+	enum { SLOTS = 8 };
+	struct Edge { unsigned int target, opposite; };
+	unsigned int          first;
+	std::vector<Edge>     edges;
+	std::vector<uint8_t>  count;
+};
+
+//-------------------------------------------------------------------------------
+// Edge FIFO
+//
+// The edges of the last few triangles of a block, in the orientation of the
+// neighboring triangles that share them. Position k is the k^th most recent
+// edge, starting from one.
+//-------------------------------------------------------------------------------
+
+class MeshCodec::EdgeFifo
+{
+public:
+	enum { SIZE = 32 };
+	EdgeFifo() : head(0), size(0) {}
+	void Push( unsigned int const *tri )
+	{
+		Push( tri[1], tri[0] );
+		Push( tri[2], tri[1] );
+		Push( tri[0], tri[2] );
+	}
+	unsigned int Find( unsigned int a, unsigned int b ) const
+	{
+		for ( unsigned int k=1; k<=size; k++ ) {
+			unsigned int i = ( head - k ) & (SIZE-1);
+			if ( edges[i][0] == a && edges[i][1] == b ) return k;
+		}
+		return 0;
+	}
+	bool Get( unsigned int k, unsigned int &a, unsigned int &b ) const
+	{
+		if ( k > size ) return false;
+		unsigned int i = ( head - k ) & (SIZE-1);
+		a = edges[i][0];
+		b = edges[i][1];
+		return true;
+	}
+private:
+	unsigned int edges[SIZE][2];
+	unsigned int head, size;
+	void Push( unsigned int a, unsigned int b ) { edges[head][0] = a; edges[head][1] = b; head = (head+1) & (SIZE-1); if ( size < SIZE ) size++; }
+};
+
+// Rotates each triangle, keeping its orientation, so that its first edge is the most recent edge in the FIFO.
+inline void MeshCodec::RotateTriangles( unsigned int *indices, unsigned int numTriangles )
+{
+	EdgeFifo fifo;
+	for ( unsigned int t=0; t<numTriangles; t++ ) {
+		unsigned int *tri = indices + 3*t;
+		unsigned int best = 0, rotation = 0;
+		for ( unsigned int r=0; r<3; r++ ) {
+			unsigned int k = fifo.Find( tri[r], tri[ r<2 ? r+1 : 0 ] );
+			if ( k > 0 && ( best == 0 || k < best ) ) { best = k; rotation = r; }
+		}
+		if ( rotation > 0 ) {
+			unsigned int rotated[3] = { tri[rotation], tri[ (rotation+1)%3 ], tri[ (rotation+2)%3 ] };
+			tri[0] = rotated[0]; tri[1] = rotated[1]; tri[2] = rotated[2];
+		}
+		fifo.Push( tri );
+	}
+}
+
+//-------------------------------------------------------------------------------
+// Prediction
+//-------------------------------------------------------------------------------
+
+// Calls newVertex(v,a,b,d,prev) for each vertex of the block when it is first used, where a and b are the other two
+// vertices of the triangle if they are already known, d is the vertex opposite to the edge (a,b) in an earlier
+// triangle of the block, and prev is the previous new vertex. Unknown vertices are NONE. The encoder and the decoder
+// run the same traversal, so the predictions match.
+template <typename FUNC>
+inline void MeshCodec::Traverse( unsigned int const *indices, unsigned int numTriangles, unsigned int firstVertex, unsigned int numVertices, FUNC newVertex )
+{
+	EdgeTable edges( firstVertex, numVertices );
+	unsigned int next = firstVertex;
+	unsigned int prev = NONE;
+	for ( unsigned int t=0; t<numTriangles; t++ ) {
+		unsigned int const *tri = indices + 3*t;
+		for ( int j=0; j<3; j++ ) {
+			unsigned int v = tri[j];
+			if ( v != next ) continue;
+			next++;
+			unsigned int a = tri[ j<2 ? j+1 : 0 ];
+			unsigned int b = tri[ j>0 ? j-1 : 2 ];
+			if ( a < firstVertex || a >= next || a == v ) a = NONE;
+			if ( b < firstVertex || b >= next || b == v ) b = NONE;
+			unsigned int d = ( a != NONE && b != NONE ) ? edges.Find( b, a ) : NONE;
+			newVertex( v, a, b, d, prev );
+			prev = v;
+		}
+		for ( int j=0; j<3; j++ ) {
+			unsigned int opposite = tri[ j>0 ? j-1 : 2 ];
+			if ( tri[j] >= firstVertex && opposite >= firstVertex ) edges.Insert( tri[j], tri[ j<2 ? j+1 : 0 ], opposite );
+		}
+	}
+}
+
+// Predicts component c of a vertex with comps components per vertex, using the parallelogram rule if d is known,
+// otherwise one of the other vertices of the triangle, or the previous new vertex. The quantized values q are
+// indexed relative to the first vertex of the block.
+inline uint32_t MeshCodec::Predict( uint32_t const *q, int comps, int c, unsigned int a, unsigned int b, unsigned int d, unsigned int prev, uint32_t maxValue )
+{
+	if ( d != NONE ) {
+		int64_t p = int64_t( q[a*comps+c] ) + int64_t( q[b*comps+c] ) - int64_t( q[d*comps+c] );
+		return p < 0 ? 0 : ( p > maxValue ? maxValue : uint32_t(p) );
+	}
+	if ( a    != NONE ) return q[a*comps+c];
+	if ( b    != NONE ) return q[b*comps+c];
+	if ( prev != NONE ) return q[prev*comps+c];
+	return ( maxValue + 1 ) / 2;
+}
+
+//-------------------------------------------------------------------------------
+// Value coding
+//
+// Each value is split into a symbol that is entropy coded and extra bits that
+// are stored as they are. Values below 4 are symbols themselves. Larger values
+// with n significant bits use the symbol 2n-2 or 2n-1, depending on the bit
+// below the highest one, followed by the remaining n-2 bits.
+//
+// The symbols are coded with rANS using 32-bit states and 16-bit renormalization,
+// so that each decoded symbol reads at most one 16-bit word and the decoder does
+// not need any data-dependent branches.
+//-------------------------------------------------------------------------------
+
+inline int MeshCodec::BitLength( uint32_t u )
+{
+#ifdef _MSC_VER
+	unsigned long i;
+	return _BitScanReverse( &i, u ) ? int(i) + 1 : 0;
+#else
+	return u ? 32 - __builtin_clz(u) : 0;
+#endif
+}
+
+inline void MeshCodec::SymbolBits( int s, uint32_t &base, int &numBits )
+{
+	if ( s < 4 ) { base = (uint32_t) s; numBits = 0; return; }
+	numBits = ( ( s + 2 ) >> 1 ) - 2;
+	base = ( 2u | uint32_t( s & 1 ) ) << numBits;
+}
+
+inline void MeshCodec::EncodeValues( std::vector<unsigned char> &out, uint32_t const *values, size_t n )
+{
+	// Symbols and extra bits
+	std::vector<unsigned char> symbols( n );
+	std::vector<unsigned char> bits( ( n*30 + 7 ) / 8 + BIT_PADDING, 0 );
+	uint64_t bitPos = 0;
+	uint32_t count[NUM_SYMBOLS] = {};
+	for ( size_t i=0; i<n; i++ ) {
+		uint32_t u = values[i];
+		if ( u < 4 ) { symbols[i] = (unsigned char) u; count[u]++; continue; }
+		int len = BitLength(u);
+		int nb  = len - 2;
+		unsigned char s = (unsigned char)( 2*len - 2 + ( ( u >> nb ) & 1 ) );
+		symbols[i] = s;
+		count[s]++;
+		uint64_t extra = u & ( ( 1u << nb ) - 1 );
+		uint64_t w;
+		memcpy( &w, bits.data() + (bitPos>>3), 8 );
+		w |= extra << (bitPos & 7);
+		memcpy( bits.data() + (bitPos>>3), &w, 8 );
+		bitPos += nb;
+	}
+	bits.resize( (size_t)( (bitPos+7)/8 ) + BIT_PADDING );	// padded, so that the decoder can read past the last value
+
+	// Normalized frequencies that sum to 1<<PROB_BITS, with at least one for each used symbol
+	uint32_t freq[NUM_SYMBOLS] = {}, start[NUM_SYMBOLS];
+	if ( n > 0 ) {
+		uint32_t sum = 0;
+		for ( int s=0; s<NUM_SYMBOLS; s++ ) {
+			if ( count[s] == 0 ) continue;
+			freq[s] = (uint32_t)( uint64_t(count[s]) * (1u<<PROB_BITS) / n );
+			if ( freq[s] == 0 ) freq[s] = 1;
+			sum += freq[s];
+		}
+		while ( sum != (1u<<PROB_BITS) ) {
+			int m = 0;
+			for ( int s=1; s<NUM_SYMBOLS; s++ ) if ( freq[s] > freq[m] ) m = s;
+			if ( sum > (1u<<PROB_BITS) ) { freq[m]--; sum--; }
+			else { freq[m] += (1u<<PROB_BITS) - sum; sum = 1u<<PROB_BITS; }
+		}
+	}
+	uint32_t cum = 0;
+	for ( int s=0; s<NUM_SYMBOLS; s++ ) { start[s] = cum; cum += freq[s]; }
+
+	// rANS with four interleaved states, encoded backwards
+	std::vector<uint16_t> rans( n + 8 );
+	uint16_t *ptr = rans.data() + rans.size();
+	uint32_t state[4] = { RANS_L, RANS_L, RANS_L, RANS_L };
+	for ( size_t i=n; i-->0; ) {
+		uint32_t &x = state[i&3];
+		uint32_t f = freq[ symbols[i] ];
+		uint64_t xMax = uint64_t( ( RANS_L >> PROB_BITS ) << 16 ) * f;
+		if ( x >= xMax ) { *--ptr = (uint16_t)( x & 0xFFFF ); x >>= 16; }
+		x = ( ( x / f ) << PROB_BITS ) + ( x % f ) + start[ symbols[i] ];
+	}
+	for ( int k=3; k>=0; k-- ) {
+		*--ptr = (uint16_t)( state[k] >> 16 );
+		*--ptr = (uint16_t)( state[k] & 0xFFFF );
+	}
+	uint32_t ransBytes = (uint32_t)( rans.data() + rans.size() - ptr ) * 2;
+	uint32_t bitBytes  = (uint32_t) bits.size();
+
+	uint16_t table[NUM_SYMBOLS];
+	for ( int s=0; s<NUM_SYMBOLS; s++ ) table[s] = (uint16_t) freq[s];
+	auto Append = [&out]( void const *p, size_t size ) { out.insert( out.end(), (unsigned char const *)p, (unsigned char const *)p + size ); };
+	Append( table, sizeof(table) );
+	Append( &ransBytes, sizeof(ransBytes) );
+	Append( ptr, ransBytes );
+	Append( &bitBytes, sizeof(bitBytes) );
+	Append( bits.data(), bitBytes );
+}
+
+inline bool MeshCodec::DecodeValues( unsigned char const *&p, unsigned char const *end, uint32_t *values, size_t n )
+{
+	uint16_t table[NUM_SYMBOLS];
+	uint32_t ransBytes, bitBytes;
+	if ( size_t(end-p) < sizeof(table) + sizeof(ransBytes) ) return false;
+	memcpy( table, p, sizeof(table) ); p += sizeof(table);
+	memcpy( &ransBytes, p, sizeof(ransBytes) ); p += sizeof(ransBytes);
+	if ( size_t(end-p) < (size_t) ransBytes + sizeof(bitBytes) || ransBytes % 2 != 0 ) return false;
+	unsigned char const *rans = p, *ransEnd = p + ransBytes;
+	p += ransBytes;
+	memcpy( &bitBytes, p, sizeof(bitBytes) ); p += sizeof(bitBytes);
+	if ( size_t(end-p) < bitBytes || bitBytes < BIT_PADDING ) return false;
+	unsigned char const *bits = p;
+	uint64_t bitLimit = uint64_t( bitBytes - BIT_PADDING ) * 8;
+	p += bitBytes;
+	if ( n == 0 ) return true;
+
+	// Decoding tables: the symbol, its frequency, and the offset of the slot within the symbol for each slot
+	uint32_t freq[NUM_SYMBOLS], start[NUM_SYMBOLS], cum = 0;
+	for ( int s=0; s<NUM_SYMBOLS; s++ ) { freq[s] = table[s]; start[s] = cum; cum += freq[s]; }
+	if ( cum != (1u<<PROB_BITS) ) return false;
+	struct Slot { uint16_t freq, bias; uint8_t symbol, numBits; };
+	Slot slots[1<<PROB_BITS];
+	uint32_t base[NUM_SYMBOLS];
+	for ( int s=0; s<NUM_SYMBOLS; s++ ) {
+		int nb;
+		SymbolBits( s, base[s], nb );
+		for ( uint32_t k=0; k<freq[s]; k++ ) {
+			Slot &slot = slots[ start[s] + k ];
+			slot.freq    = (uint16_t) freq[s];
+			slot.bias    = (uint16_t) k;
+			slot.symbol  = (uint8_t) s;
+			slot.numBits = (uint8_t) nb;
+		}
+	}
+
+	if ( ransBytes < 16 ) return false;
+	auto Read16 = []( unsigned char const *r ) { return uint32_t(r[0]) | uint32_t(r[1]) << 8; };
+	uint32_t x[4];
+	for ( int k=0; k<4; k++ ) x[k] = Read16( rans + 4*k ) | Read16( rans + 4*k + 2 ) << 16;
+	uint32_t x0 = x[0], x1 = x[1], x2 = x[2], x3 = x[3];
+	rans += 16;
+
+	// The states are local variables, so that they stay in registers. A group of four symbols reads at most four
+	// words and at most 120 extra bits, so the streams are checked once per group, except near their ends.
+	const uint32_t mask = (1u<<PROB_BITS) - 1;
+	uint64_t bitPos = 0;
+	auto Step = [&]( uint32_t &s, size_t i ) {
+		Slot const &slot = slots[ s & mask ];
+		s = slot.freq * ( s >> PROB_BITS ) + slot.bias;
+		uint32_t renorm = s < RANS_L;
+		uint32_t word = Read16( rans );
+		s = renorm ? ( s << 16 ) | word : s;
+		rans += renorm * 2;
+		uint64_t w;
+		memcpy( &w, bits + (bitPos>>3), 8 );
+		values[i] = base[ slot.symbol ] | ( uint32_t( w >> (bitPos & 7) ) & ( ( 1u << slot.numBits ) - 1 ) );
+		bitPos += slot.numBits;
+	};
+	size_t i = 0;
+	for ( ; i+4<=n && ransEnd-rans >= 8; i+=4 ) {
+		Step( x0, i ); Step( x1, i+1 ); Step( x2, i+2 ); Step( x3, i+3 );
+		if ( bitPos > bitLimit ) return false;
+	}
+	for ( ; i<n; i++ ) {
+		uint32_t &s = (i&3)==0 ? x0 : (i&3)==1 ? x1 : (i&3)==2 ? x2 : x3;
+		Slot const &slot = slots[ s & mask ];
+		if ( ( slot.freq * ( s >> PROB_BITS ) + slot.bias ) < RANS_L && ransEnd-rans < 2 ) return false;
+		Step( s, i );
+		if ( bitPos > bitLimit ) return false;
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------
+// Octahedral normals
+//-------------------------------------------------------------------------------
+
+inline void MeshCodec::OctEncode( float &u, float &v, Vec3f n )
+{
+	float s = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+	if ( s == 0 ) { u = v = 0; return; }
+	n /= s;
+	if ( n.z < 0 ) {
+		float x = n.x;
+		n.x = ( 1 - std::abs(n.y) ) * ( x   >= 0 ? 1.0f : -1.0f );
+		n.y = ( 1 - std::abs(x)   ) * ( n.y >= 0 ? 1.0f : -1.0f );
+	}
+	u = n.x;
+	v = n.y;
+}
+
+inline Vec3f MeshCodec::OctDecode( float u, float v )
+{
+	Vec3f n( u, v, 1 - std::abs(u) - std::abs(v) );
+	if ( n.z < 0 ) {
+		n.x = ( 1 - std::abs(v) ) * ( u >= 0 ? 1.0f : -1.0f );
+		n.y = ( 1 - std::abs(u) ) * ( v >= 0 ? 1.0f : -1.0f );
+	}
+	return n.GetNormalized();
+}
+
+//-------------------------------------------------------------------------------
+// Encoding
+//-------------------------------------------------------------------------------
+
+inline void MeshCodec::Encode( std::vector<unsigned char> &data, unsigned int const *indices, size_t numIndices, unsigned int numVertices,
+                               Vec3f const *positions, Vec3f const *normals, Vec3f const *texCoords, Settings const &settings )
+{
+	numIndices -= numIndices % 3;
+	unsigned int numTriangles = (unsigned int)( numIndices / 3 );
+
+	unsigned int blockTriangles = settings.blockTriangles > 0 ? settings.blockTriangles : 1;
+	size_t numBlocks = ( numTriangles + blockTriangles - 1 ) / blockTriangles;
+	unsigned int nt = NumThreads( settings.numThreads, numBlocks );
+
+	// Rotate the triangles of each block for the edge FIFO, and number the vertices in the order they are first used
+	std::vector<unsigned int> idx( indices, indices + numIndices );
+	ParallelFor( nt, [&]( unsigned int t ) {
+		for ( size_t b=t; b<numBlocks; b+=nt ) RotateTriangles( idx.data() + 3*b*blockTriangles, std::min( blockTriangles, numTriangles - (unsigned int)( b*blockTriangles ) ) );
+	});
+	std::vector<unsigned int> remap( numVertices, NONE ), order;
+	for ( size_t i=0; i<numIndices; i++ ) {
+		unsigned int v = idx[i];
+		if ( remap[v] == NONE ) { remap[v] = (unsigned int) order.size(); order.push_back(v); }
+		idx[i] = remap[v];
+	}
+	unsigned int nv = (unsigned int) order.size();
+
+	// Quantization ranges
+	Header header;
+	memset( &header, 0, sizeof(header) );
+	memcpy( header.magic, "CYMESHC\0", 8 );
+	header.version     = VERSION;
+	header.byteOrder   = 0x01020304;
+	header.flags       = ( normals ? FLAG_NORMALS : 0 ) | ( texCoords ? FLAG_TEXCOORDS : 0 );
+	header.numVertices = nv;
+	header.numIndices  = (uint32_t) numIndices;
+	header.bits[0] = (uint32_t)( settings.positionBits < 1 ? 1 : ( settings.positionBits > 24 ? 24 : settings.positionBits ) );
+	header.bits[1] = (uint32_t)( settings.normalBits   < 2 ? 2 : ( settings.normalBits   > 16 ? 16 : settings.normalBits   ) );
+	header.bits[2] = (uint32_t)( settings.texCoordBits < 1 ? 1 : ( settings.texCoordBits > 24 ? 24 : settings.texCoordBits ) );
+	uint32_t maxValue[3];
+	for ( int k=0; k<3; k++ ) maxValue[k] = ( 1u << header.bits[k] ) - 1;
+	auto SetRange = [nv,&order]( Vec3f const *v, int comps, uint32_t maxValue, float *offset, float *scale ) {
+		for ( int c=0; c<comps; c++ ) {
+			float lo = 0, hi = 0;
+			if ( nv > 0 ) lo = hi = v[order[0]][c];
+			for ( unsigned int i=1; i<nv; i++ ) { float x = v[order[i]][c]; if ( x < lo ) lo = x; if ( x > hi ) hi = x; }
+			offset[c] = lo;
+			scale [c] = hi > lo ? ( hi - lo ) / maxValue : 0;
+		}
+	};
+	SetRange( positions, 3, maxValue[0], header.positionOffset, header.positionScale );
+	if ( texCoords ) SetRange( texCoords, 2, maxValue[2], header.texCoordOffset, header.texCoordScale );
+
+	// Blocks and the first vertex of each block
+	std::vector<Block> blocks( numBlocks );
+	unsigned int next = 0;
+	for ( size_t b=0; b<blocks.size(); b++ ) {
+		Block &block = blocks[b];
+		block.firstTriangle = (uint32_t)( b * blockTriangles );
+		block.numTriangles  = std::min( blockTriangles, numTriangles - block.firstTriangle );
+		block.firstVertex   = next;
+		for ( size_t i=3*size_t(block.firstTriangle); i<3*size_t(block.firstTriangle+block.numTriangles); i++ ) if ( idx[i] == next ) next++;
+		block.numVertices   = next - block.firstVertex;
+	}
+	header.numBlocks = (uint32_t) blocks.size();
+
+	// Quantize and encode the blocks in parallel
+	std::vector< std::vector<unsigned char> > blockData( blocks.size() );
+	ParallelFor( nt, [&]( unsigned int t ) {
+		BlockData q;
+		for ( size_t b=t; b<blocks.size(); b+=nt ) {
+			Block const &block = blocks[b];
+			q.pos.resize( (size_t) block.numVertices * 3 );
+			q.norm.resize( normals ? (size_t) block.numVertices * 2 : 0 );
+			q.txc.resize( texCoords ? (size_t) block.numVertices * 2 : 0 );
+			for ( unsigned int i=0; i<block.numVertices; i++ ) {
+				unsigned int v = order[ block.firstVertex + i ];
+				for ( int c=0; c<3; c++ ) {
+					float s = header.positionScale[c];
+					q.pos[3*i+c] = s > 0 ? (uint32_t) std::min( (float) maxValue[0], std::floor( ( positions[v][c] - header.positionOffset[c] ) / s + 0.5f ) ) : 0;
+				}
+				if ( normals ) {
+					float uv[2];
+					OctEncode( uv[0], uv[1], normals[v] );
+					for ( int c=0; c<2; c++ ) q.norm[2*i+c] = (uint32_t) std::floor( ( uv[c] * 0.5f + 0.5f ) * maxValue[1] + 0.5f );
+				}
+				if ( texCoords ) {
+					for ( int c=0; c<2; c++ ) {
+						float s = header.texCoordScale[c];
+						q.txc[2*i+c] = s > 0 ? (uint32_t) std::min( (float) maxValue[2], std::floor( ( texCoords[v][c] - header.texCoordOffset[c] ) / s + 0.5f ) ) : 0;
+					}
+				}
+			}
+			EncodeBlock( blockData[b], block, idx.data() + 3*size_t(block.firstTriangle), q, 3, normals ? 2 : 0, texCoords ? 2 : 0, maxValue );
+		}
+	});
+
+	// Header, block table, and block data
+	uint64_t offset = sizeof(Header) + sizeof(Block)*blocks.size();
+	for ( size_t b=0; b<blocks.size(); b++ ) {
+		blocks[b].offset = offset;
+		blocks[b].size   = blockData[b].size();
+		offset += blocks[b].size;
+	}
+	data.resize( (size_t) offset );
+	memcpy( data.data(), &header, sizeof(Header) );
+	if ( !blocks.empty() ) memcpy( data.data() + sizeof(Header), blocks.data(), sizeof(Block)*blocks.size() );
+	for ( size_t b=0; b<blocks.size(); b++ ) {
+		if ( !blockData[b].empty() ) memcpy( data.data() + blocks[b].offset, blockData[b].data(), blockData[b].size() );
+	}
+}
+
+inline void MeshCodec::EncodeBlock( std::vector<unsigned char> &out, Block const &block, unsigned int const *indices, BlockData const &data, int numPos, int numNorm, int numTxc, uint32_t const maxValue[3] )
+{
+	// Edge FIFO positions of the triangles, and the vertices that are not on a FIFO edge relative to the next new vertex
+	std::vector<uint32_t> triCodes( block.numTriangles ), vertexCodes;
+	vertexCodes.reserve( (size_t) block.numTriangles * 3 );
+	EdgeFifo fifo;
+	unsigned int next = block.firstVertex;
+	auto Vertex = [&]( unsigned int v ) { vertexCodes.push_back( next - v ); if ( v == next ) next++; };
+	for ( unsigned int t=0; t<block.numTriangles; t++ ) {
+		unsigned int const *tri = indices + 3*t;
+		triCodes[t] = fifo.Find( tri[0], tri[1] );
+		if ( triCodes[t] == 0 ) { Vertex( tri[0] ); Vertex( tri[1] ); }
+		Vertex( tri[2] );
+		fifo.Push( tri );
+	}
+	uint32_t numVertexCodes = (uint32_t) vertexCodes.size();
+
+	// Prediction residuals of the new vertices
+	std::vector<uint32_t> pos ( (size_t) block.numVertices * numPos  );
+	std::vector<uint32_t> norm( (size_t) block.numVertices * numNorm );
+	std::vector<uint32_t> txc ( (size_t) block.numVertices * numTxc  );
+	unsigned int f = block.firstVertex;
+	auto Local = [f]( unsigned int v ) { return v == NONE ? NONE : v - f; };
+	Traverse( indices, block.numTriangles, block.firstVertex, block.numVertices, [&]( unsigned int v, unsigned int a, unsigned int b, unsigned int d, unsigned int prev ) {
+		v = v - f; a = Local(a); b = Local(b); d = Local(d); prev = Local(prev);
+		for ( int c=0; c<numPos;  c++ ) pos [v*numPos +c] = ZigZag( int32_t( data.pos [v*numPos +c] - Predict( data.pos.data(),  numPos,  c, a, b, d,    prev, maxValue[0] ) ) );
+		for ( int c=0; c<numNorm; c++ ) norm[v*numNorm+c] = ZigZag( int32_t( data.norm[v*numNorm+c] - Predict( data.norm.data(), numNorm, c, a, b, d,    prev, maxValue[1] ) ) );
+		for ( int c=0; c<numTxc;  c++ ) txc [v*numTxc +c] = ZigZag( int32_t( data.txc [v*numTxc +c] - Predict( data.txc.data(),  numTxc,  c, a, b, d,    prev, maxValue[2] ) ) );
+	});
+
+	out.clear();
+	EncodeValues( out, triCodes.data(), triCodes.size() );
+	out.insert( out.end(), (unsigned char const *) &numVertexCodes, (unsigned char const *) &numVertexCodes + sizeof(numVertexCodes) );
+	EncodeValues( out, vertexCodes.data(), vertexCodes.size() );
+	EncodeValues( out, pos.data(),   pos.size()   );
+	if ( numNorm ) EncodeValues( out, norm.data(), norm.size() );
+	if ( numTxc  ) EncodeValues( out, txc.data(),  txc.size()  );
+}
+
+inline void MeshCodec::Encode( std::vector<unsigned char> &data, TriMesh const &mesh, Settings const &settings )
+{
+	MeshWelder welder;
+	welder.Weld( mesh );
+	MeshOptimizer::OptimizeVertexCache( welder.Indices().data(), welder.NumIndices(), welder.NumVertices() );
+	std::vector<Vec3f> positions, normals, texCoords;
+	welder.GetPositions( mesh, positions );
+	if ( welder.HasNormals  () ) welder.GetNormals  ( mesh, normals   );
+	if ( welder.HasTexCoords() ) welder.GetTexCoords( mesh, texCoords );
+	Encode( data, welder.Indices().data(), welder.NumIndices(), welder.NumVertices(), positions.data(),
+	        welder.HasNormals() ? normals.data() : nullptr, welder.HasTexCoords() ? texCoords.data() : nullptr, settings );
+}
+
+inline bool MeshCodec::SaveToFile( char const *filename, TriMesh const &mesh, Settings const &settings, std::ostream *outStream )
+{
+	std::vector<unsigned char> data;
+	Encode( data, mesh, settings );
+	FILE *fp = fopen( filename, "wb" );
+	bool ok = fp && fwrite( data.data(), 1, data.size(), fp ) == data.size();
+	if ( fp && fclose(fp) != 0 ) ok = false;
+	if ( !ok ) {
+		if ( fp ) remove( filename );
+		if ( outStream ) *outStream << "ERROR: Cannot write file " << filename << std::endl;
+	}
+	return ok;
+}
+
+//-------------------------------------------------------------------------------
+// Decoding
+//-------------------------------------------------------------------------------
+
+inline bool MeshCodec::GetInfo( void const *data, size_t size, Info &info )
+{
+	if ( size < sizeof(Header) ) return false;
+	Header header;
+	memcpy( &header, data, sizeof(Header) );
+	if ( memcmp( header.magic, "CYMESHC\0", 8 ) != 0 || header.version != VERSION || header.byteOrder != 0x01020304 ) return false;
+	if ( header.numIndices % 3 != 0 || header.bits[0] < 1 || header.bits[0] > 24 || header.bits[1] < 2 || header.bits[1] > 16 || header.bits[2] < 1 || header.bits[2] > 24 ) return false;
+	if ( ( size - sizeof(Header) ) / sizeof(Block) < header.numBlocks ) return false;
+	info.numVertices  = header.numVertices;
+	info.numIndices   = header.numIndices;
+	info.numBlocks    = header.numBlocks;
+	info.hasNormals   = ( header.flags & FLAG_NORMALS   ) != 0;
+	info.hasTexCoords = ( header.flags & FLAG_TEXCOORDS ) != 0;
+	return true;
+}
+
+inline bool MeshCodec::Decode( void const *data, size_t size, std::vector<unsigned int> &indices, std::vector<Vec3f> &positions,
+                               std::vector<Vec3f> *normals, std::vector<Vec3f> *texCoords, unsigned int numThreads )
+{
+	Info info;
+	if ( !GetInfo( data, size, info ) ) return false;
+	Header header;
+	memcpy( &header, data, sizeof(Header) );
+	std::vector<Block> blocks( header.numBlocks );
+	if ( !blocks.empty() ) memcpy( blocks.data(), (char const *) data + sizeof(Header), sizeof(Block)*blocks.size() );
+
+	// The blocks must cover the triangles and the vertices in order
+	uint64_t triangle = 0, vertex = 0;
+	for ( size_t b=0; b<blocks.size(); b++ ) {
+		Block const &block = blocks[b];
+		if ( block.firstTriangle != triangle || block.firstVertex != vertex ) return false;
+		if ( block.offset > size || block.size > size - block.offset ) return false;
+		triangle += block.numTriangles;
+		vertex   += block.numVertices;
+	}
+	if ( triangle*3 != header.numIndices || vertex != header.numVertices ) return false;
+
+	indices.resize( header.numIndices );
+	positions.resize( header.numVertices );
+	if ( normals   ) { if ( info.hasNormals   ) normals  ->resize( header.numVertices ); else normals  ->clear(); }
+	if ( texCoords ) { if ( info.hasTexCoords ) texCoords->resize( header.numVertices ); else texCoords->clear(); }
+	Vec3f *n = normals   && info.hasNormals   ? normals  ->data() : nullptr;
+	Vec3f *t = texCoords && info.hasTexCoords ? texCoords->data() : nullptr;
+
+	unsigned int nt = NumThreads( numThreads, blocks.size() );
+	std::vector<char> ok( nt, 1 );
+	ParallelFor( nt, [&]( unsigned int i ) {
+		for ( size_t b=i; b<blocks.size() && ok[i]; b+=nt ) {
+			ok[i] = DecodeBlock( blocks[b], (unsigned char const *) data + blocks[b].offset, header, indices.data(), positions.data(), n, t );
+		}
+	});
+	for ( unsigned int i=0; i<nt; i++ ) if ( !ok[i] ) return false;
+	return true;
+}
+
+inline bool MeshCodec::DecodeBlock( Block const &block, unsigned char const *data, Header const &header, unsigned int *indices, Vec3f *positions, Vec3f *normals, Vec3f *texCoords )
+{
+	unsigned char const *p = data, *end = data + block.size;
+	int numPos  = 3;
+	int numNorm = ( header.flags & FLAG_NORMALS   ) ? 2 : 0;
+	int numTxc  = ( header.flags & FLAG_TEXCOORDS ) ? 2 : 0;
+	size_t ni = (size_t) block.numTriangles * 3;
+	size_t nv = block.numVertices;
+
+	// Entropy decoding of all streams
+	std::vector<uint32_t> triCodes( block.numTriangles ), vertexCodes;
+	std::vector<uint32_t> pos( nv*numPos ), norm( nv*numNorm ), txc( nv*numTxc );
+	uint32_t numVertexCodes;
+	if ( !DecodeValues( p, end, triCodes.data(), triCodes.size() ) ) return false;
+	if ( size_t(end-p) < sizeof(numVertexCodes) ) return false;
+	memcpy( &numVertexCodes, p, sizeof(numVertexCodes) );
+	p += sizeof(numVertexCodes);
+	if ( numVertexCodes > ni ) return false;
+	vertexCodes.resize( numVertexCodes );
+	if ( !DecodeValues( p, end, vertexCodes.data(), vertexCodes.size() ) ) return false;
+	if ( !DecodeValues( p, end, pos.data(), pos.size() ) ) return false;
+	if ( numNorm && !DecodeValues( p, end, norm.data(), norm.size() ) ) return false;
+	if ( numTxc  && !DecodeValues( p, end, txc .data(), txc .size() ) ) return false;
+
+	// Indices
+	unsigned int *idx = indices + 3*size_t(block.firstTriangle);
+	unsigned int next = block.firstVertex;
+	size_t vc = 0;
+	auto Vertex = [&]( unsigned int &v ) {
+		if ( vc >= vertexCodes.size() ) return false;
+		uint32_t code = vertexCodes[vc++];
+		if ( code > next ) return false;
+		v = next - code;
+		next += ( code == 0 );
+		return true;
+	};
+	EdgeFifo fifo;
+	for ( unsigned int t=0; t<block.numTriangles; t++ ) {
+		unsigned int *tri = idx + 3*t;
+		if ( triCodes[t] ) { if ( !fifo.Get( triCodes[t], tri[0], tri[1] ) ) return false; }
+		else if ( !Vertex( tri[0] ) || !Vertex( tri[1] ) ) return false;
+		if ( !Vertex( tri[2] ) ) return false;
+		fifo.Push( tri );
+	}
+	if ( vc != vertexCodes.size() || next != block.firstVertex + block.numVertices ) return false;
+
+	// Prediction, replacing the residuals with the quantized values
+	uint32_t maxValue[3];
+	for ( int k=0; k<3; k++ ) maxValue[k] = ( 1u << header.bits[k] ) - 1;
+	unsigned int f = block.firstVertex;
+	auto Local = [f]( unsigned int v ) { return v == NONE ? NONE : v - f; };
+	Traverse( idx, block.numTriangles, block.firstVertex, block.numVertices, [&]( unsigned int v, unsigned int a, unsigned int b, unsigned int d, unsigned int prev ) {
+		v = v - f; a = Local(a); b = Local(b); d = Local(d); prev = Local(prev);
+		for ( int c=0; c<numPos;  c++ ) pos [v*numPos +c] = ( Predict( pos.data(),  numPos,  c, a, b, d,    prev, maxValue[0] ) + UnZigZag( pos [v*numPos +c] ) ) & maxValue[0];
+		for ( int c=0; c<numNorm; c++ ) norm[v*numNorm+c] = ( Predict( norm.data(), numNorm, c, a, b, d,    prev, maxValue[1] ) + UnZigZag( norm[v*numNorm+c] ) ) & maxValue[1];
+		for ( int c=0; c<numTxc;  c++ ) txc [v*numTxc +c] = ( Predict( txc.data(),  numTxc,  c, a, b, d,    prev, maxValue[2] ) + UnZigZag( txc [v*numTxc +c] ) ) & maxValue[2];
+	});
+
+	// Dequantization
+	Vec3f *P = positions + f;
+	float const *po = header.positionOffset, *ps = header.positionScale;
+	for ( size_t i=0; i<nv; i++ ) {
+		P[i].x = po[0] + ps[0] * (float) pos[3*i  ];
+		P[i].y = po[1] + ps[1] * (float) pos[3*i+1];
+		P[i].z = po[2] + ps[2] * (float) pos[3*i+2];
+	}
+	if ( numNorm && normals ) {
+		float s = 2.0f / maxValue[1];
+		for ( size_t i=0; i<nv; i++ ) normals[f+i] = OctDecode( norm[2*i] * s - 1, norm[2*i+1] * s - 1 );
+	}
+	if ( numTxc && texCoords ) {
+		float const *to = header.texCoordOffset, *ts = header.texCoordScale;
+		Vec3f *T = texCoords + f;
+		for ( size_t i=0; i<nv; i++ ) {
+			T[i].x = to[0] + ts[0] * (float) txc[2*i  ];
+			T[i].y = to[1] + ts[1] * (float) txc[2*i+1];
+			T[i].z = 0;
+		}
+	}
+	return true;
+}
+
+inline bool MeshCodec::Decode( void const *data, size_t size, TriMesh &mesh, unsigned int numThreads )
+{
+	std::vector<unsigned int> indices;
+	std::vector<Vec3f> positions, normals, texCoords;
+	if ( !Decode( data, size, indices, positions, &normals, &texCoords, numThreads ) ) return false;
+	unsigned int nf = (unsigned int)( indices.size() / 3 );
+	mesh.Clear();
+	mesh.SetNumVertex  ( (unsigned int) positions.size() );
+	mesh.SetNumFaces   ( nf );
+	mesh.SetNumNormals ( (unsigned int) normals.size() );
+	mesh.SetNumTexVerts( (unsigned int) texCoords.size() );
+	for ( size_t i=0; i<positions.size(); i++ ) mesh.V(i)  = positions[i];
+	for ( size_t i=0; i<normals.size();   i++ ) mesh.VN(i) = normals[i];
+	for ( size_t i=0; i<texCoords.size(); i++ ) mesh.VT(i) = texCoords[i];
+	for ( unsigned int i=0; i<nf; i++ ) {
+		for ( int j=0; j<3; j++ ) {
+			mesh.F(i).v[j] = indices[3*i+j];
+			if ( mesh.HasNormals() ) mesh.FN(i).v[j] = indices[3*i+j];
+			if ( mesh.HasTextureVertices() ) mesh.FT(i).v[j] = indices[3*i+j];
+		}
+	}
+	return true;
+}
+
+inline bool MeshCodec::LoadFromFile( TriMesh &mesh, char const *filename, unsigned int numThreads, std::ostream *outStream )
+{
+	MemoryMap file;
+	if ( !file.Open( filename ) ) {
+		if ( outStream ) *outStream << "ERROR: Cannot open file " << filename << std::endl;
+		return false;
+	}
+	if ( !Decode( file.Data(), file.Size(), mesh, numThreads ) ) {
+		if ( outStream ) *outStream << "ERROR: Invalid compressed mesh file " << filename << std::endl;
+		return false;
+	}
+	mesh.ComputeBoundingBox();
+	return true;
+}
+
+//-------------------------------------------------------------------------------
+
+inline unsigned int MeshCodec::NumThreads( unsigned int numThreads, size_t numBlocks )
+{
+	if ( numThreads == 0 ) numThreads = std::thread::hardware_concurrency();
+	if ( numThreads > numBlocks ) numThreads = (unsigned int) numBlocks;
+	return numThreads < 1 ? 1 : numThreads;
+}
+
+template <typename FUNC>
+inline void MeshCodec::ParallelFor( unsigned int n, FUNC func )
+{
+	std::vector<std::thread> threads;
+	for ( unsigned int i=1; i<n; i++ ) threads.push_back( std::thread( func, i ) );
+	if ( n > 0 ) func(0);
+	for ( size_t i=0; i<threads.size(); i++ ) threads[i].join();
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::MeshCodec cyMeshCodec;	//!< Mesh compression codec
+
+//-------------------------------------------------------------------------------
+
+#endif
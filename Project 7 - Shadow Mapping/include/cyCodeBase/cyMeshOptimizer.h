@@ -0,0 +1,511 @@
+//-------------------------------------------------------------------------------
+//! \file   cyMeshOptimizer.h
+//!
+//! \brief  Index and vertex buffer reordering for faster rendering.
+//!
+//! MeshOptimizer reorders the triangles of an indexed mesh so that the GPU
+//! reuses more of the vertices it has already transformed (using the Tipsify
+//! algorithm by Sander, Nehab, and Barczak, "Fast Triangle Reordering for Vertex
+//! Locality and Reduced Overdraw", SIGGRAPH 2007), and reorders the vertices in
+//! the order they are first used, so that vertex fetches read memory linearly.
+//! It can also reorder clusters of triangles, so that the triangles that are
+//! likely to occlude others are drawn first, reducing overdraw. Analyzers that
+//! measure the effect of these passes are included.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_MESH_OPTIMIZER_H_INCLUDED_
+#define _CY_MESH_OPTIMIZER_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyMeshWeld.h"
+#include <vector>
+#include <algorithm>
+#include <cfloat>
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Index and vertex buffer reordering for triangle meshes.
+//!
+//! The index arrays hold three indices per triangle. The triangles keep their
+//! winding order.
+
+class MeshOptimizer
+{
+public:
+	//! Statistics of an index buffer, as computed by AnalyzeVertexCache.
+	struct VertexCacheStats
+	{
+		size_t verticesTransformed;	//!< Number of vertex shader invocations (vertex cache misses)
+		size_t bytesFetched;		//!< Number of bytes read from the vertex buffer, in whole cache lines
+		float  acmr;				//!< Average cache miss ratio: transformed vertices per triangle (0.5 is the best possible for a large regular mesh, 3 is the worst)
+		float  atvr;				//!< Average transform to vertex ratio: transformed vertices per used vertex (1 is the best possible)
+		float  overfetch;			//!< Bytes fetched per byte of used vertex data (1 is the best possible)
+	};
+
+	//! Statistics of an index buffer, as computed by AnalyzeOverdraw.
+	struct OverdrawStats
+	{
+		size_t pixelsCovered;	//!< Number of pixels covered by the mesh, summed over all views
+		size_t pixelsShaded;	//!< Number of fragments that passed the depth test, summed over all views
+		float  overdraw;		//!< Shaded fragments per covered pixel (1 is the best possible)
+	};
+
+	//!@name Reordering
+	//! Reorders the triangles for a post-transform vertex cache with the given size. Runs in linear time.
+	static void OptimizeVertexCache( unsigned int *indices, size_t numIndices, unsigned int numVertices, unsigned int cacheSize=16 );
+	//! Computes a vertex order in which the vertices appear in the same order as they are first used by the triangles.
+	//! The remap array gets the new index of each vertex. Vertices that are not used are moved to the end.
+	//! Returns the number of vertices that are used.
+	static unsigned int OptimizeVertexFetch( unsigned int *remap, unsigned int const *indices, size_t numIndices, unsigned int numVertices );
+	//! Reorders clusters of triangles of an index buffer that is already optimized for the vertex cache, so that the
+	//! clusters facing outwards, which are likely to occlude others, are drawn first. The order is computed from the
+	//! given number of view directions, distributed uniformly on the sphere, so it does not depend on the view.
+	//! The threshold limits the ACMR of the result to threshold times the ACMR of the input. If no cluster order
+	//! meets this limit, the index buffer is not changed.
+	static void OptimizeOverdraw( unsigned int *indices, size_t numIndices, Vec3f const *positions, unsigned int numVertices, float threshold=1.05f, unsigned int cacheSize=16, unsigned int numViews=32 );
+	//! Runs OptimizeVertexCache and OptimizeVertexFetch on the welded mesh, reordering its triangles and vertices.
+	static void Optimize( MeshWelder &welder, unsigned int cacheSize=16 );
+	//! Runs OptimizeVertexCache, OptimizeOverdraw with the given threshold, and OptimizeVertexFetch on the welded mesh.
+	static void Optimize( MeshWelder &welder, TriMesh const &mesh, float overdrawThreshold, unsigned int cacheSize=16 );
+	//! Runs OptimizeVertexCache on the faces of each material of the mesh separately and OptimizeVertexFetch on the welded mesh.
+	//! The faces of each material stay in the index range given by GetMaterialFirstFace and GetMaterialFaceCount, so that the
+	//! materials can be drawn separately. The welder must be created from the given mesh.
+	static void OptimizeMaterials( MeshWelder &welder, TriMesh const &mesh, unsigned int cacheSize=16 );
+
+	//!@name Analysis
+	//! Simulates a FIFO post-transform vertex cache with the given size and a fully associative LRU cache with
+	//! the given number of lines for vertex fetches from a vertex buffer with the given vertex size.
+	static VertexCacheStats AnalyzeVertexCache( unsigned int const *indices, size_t numIndices, unsigned int numVertices, unsigned int vertexSize, unsigned int cacheSize=16, unsigned int cacheLineSize=64, unsigned int numCacheLines=32 );
+	//! Rasterizes the triangles with orthographic projections from the given number of view directions, distributed
+	//! uniformly on the sphere, with back-face culling and a depth test, and counts the fragments that are shaded.
+	static OverdrawStats AnalyzeOverdraw( unsigned int const *indices, size_t numIndices, Vec3f const *positions, unsigned int numVertices, unsigned int numViews=8, unsigned int resolution=256 );
+
+	//!@name Utilities
+	static Vec3f ViewDirection( unsigned int i, unsigned int numViews );	//!< Returns the i^th of the given number of directions on a spherical Fibonacci lattice.
+
+private:
+	static unsigned int SkipDeadEnd( std::vector<unsigned int> &deadEnd, unsigned int const *liveCount, unsigned int &cursor, unsigned int numVertices );
+	static size_t CountCacheMisses( unsigned int const *indices, size_t numIndices, std::vector<size_t> &vertexTime, size_t &time, unsigned int cacheSize );
+	static void BuildClusters( std::vector<size_t> &clusters, unsigned int const *indices, size_t numTriangles, unsigned int numVertices, float threshold, unsigned int cacheSize, size_t minClusterSize );
+	static void SortClusters( unsigned int *output, unsigned int const *indices, std::vector<size_t> const &clusters, Vec3f const *positions, unsigned int numViews );
+};
+
+//-------------------------------------------------------------------------------
+
+inline void MeshOptimizer::OptimizeVertexCache( unsigned int *indices, size_t numIndices, unsigned int numVertices, unsigned int cacheSize )
+{
+	size_t numTriangles = numIndices / 3;
+	if ( numTriangles == 0 || numVertices == 0 ) return;
+
+	// Vertex to triangle adjacency
+	std::vector<unsigned int> liveCount( numVertices, 0 );
+	for ( size_t i=0; i<numTriangles*3; i++ ) liveCount[ indices[i] ]++;
+	std::vector<size_t> adjFirst( numVertices + 1 );
+	adjFirst[0] = 0;
+	for ( unsigned int v=0; v<numVertices; v++ ) adjFirst[v+1] = adjFirst[v] + liveCount[v];
+	std::vector<unsigned int> adjacency( adjFirst[numVertices] );
+	{
+		std::vector<size_t> pos( adjFirst.begin(), adjFirst.end()-1 );
+		for ( size_t i=0; i<numTriangles*3; i++ ) adjacency[ pos[ indices[i] ]++ ] = (unsigned int)( i / 3 );
+	}
+
+	std::vector<unsigned int> timeStamp( numVertices, 0 );
+	std::vector<unsigned char> emitted( numTriangles, 0 );
+	std::vector<unsigned int> deadEnd;
+	std::vector<unsigned int> candidates;
+	std::vector<unsigned int> output( numTriangles*3 );
+	size_t outCount = 0;
+	unsigned int time = cacheSize + 1;
+	unsigned int cursor = 0;
+
+	unsigned int fan = 0;	// the vertex whose triangles are emitted next
+	while ( fan != 0xFFFFFFFF ) {
+		candidates.clear();
+		// Emit all remaining triangles around the fanning vertex
+		for ( size_t a=adjFirst[fan]; a<adjFirst[fan+1]; a++ ) {
+			unsigned int t = adjacency[a];
+			if ( emitted[t] ) continue;
+			for ( int j=0; j<3; j++ ) {
+				unsigned int v = indices[t*3+j];
+				output[outCount++] = v;
+				deadEnd.push_back( v );
+				candidates.push_back( v );
+				liveCount[v]--;
+				if ( time - timeStamp[v] > cacheSize ) timeStamp[v] = time++;
+			}
+			emitted[t] = 1;
+		}
+		// Pick the candidate that will still be in the cache and has the fewest remaining triangles
+		unsigned int next = 0xFFFFFFFF;
+		int best = -1;
+		for ( unsigned int v : candidates ) {
+			if ( liveCount[v] == 0 ) continue;
+			int priority = 0;
+			if ( time - timeStamp[v] + 2*liveCount[v] <= cacheSize ) priority = time - timeStamp[v];
+			if ( priority > best ) { best = priority; next = v; }
+		}
+		if ( next == 0xFFFFFFFF ) next = SkipDeadEnd( deadEnd, liveCount.data(), cursor, numVertices );
+		fan = next;
+	}
+	memcpy( indices, output.data(), outCount * sizeof(unsigned int) );
+}
+
+inline unsigned int MeshOptimizer::SkipDeadEnd( std::vector<unsigned int> &deadEnd, unsigned int const *liveCount, unsigned int &cursor, unsigned int numVertices )
+{
+	// Try the recently used vertices first, then any vertex with remaining triangles
+	while ( !deadEnd.empty() ) {
+		unsigned int v = deadEnd.back();
+		deadEnd.pop_back();
+		if ( liveCount[v] > 0 ) return v;
+	}
+	for ( ; cursor<numVertices; cursor++ ) {
+		if ( liveCount[cursor] > 0 ) return cursor;
+	}
+	return 0xFFFFFFFF;
+}
+
+inline unsigned int MeshOptimizer::OptimizeVertexFetch( unsigned int *remap, unsigned int const *indices, size_t numIndices, unsigned int numVertices )
+{
+	for ( unsigned int v=0; v<numVertices; v++ ) remap[v] = 0xFFFFFFFF;
+	unsigned int next = 0;
+	for ( size_t i=0; i<numIndices; i++ ) {
+		unsigned int v = indices[i];
+		if ( remap[v] == 0xFFFFFFFF ) remap[v] = next++;
+	}
+	unsigned int numUsed = next;
+	for ( unsigned int v=0; v<numVertices; v++ ) {
+		if ( remap[v] == 0xFFFFFFFF ) remap[v] = next++;
+	}
+	return numUsed;
+}
+
+inline size_t MeshOptimizer::CountCacheMisses( unsigned int const *indices, size_t numIndices, std::vector<size_t> &vertexTime, size_t &time, unsigned int cacheSize )
+{
+	// The FIFO cache is simulated with time stamps: a vertex is in the cache if
+	// fewer than cacheSize vertices were added after it. Skipping the time
+	// forward by cacheSize clears the cache.
+	size_t misses = 0;
+	for ( size_t i=0; i<numIndices; i++ ) {
+		unsigned int v = indices[i];
+		if ( time - vertexTime[v] <= cacheSize ) continue;
+		vertexTime[v] = time++;
+		misses++;
+	}
+	return misses;
+}
+
+inline void MeshOptimizer::OptimizeOverdraw( unsigned int *indices, size_t numIndices, Vec3f const *positions, unsigned int numVertices, float threshold, unsigned int cacheSize, unsigned int numViews )
+{
+	size_t numTriangles = numIndices / 3;
+	if ( numTriangles < 2 || numVertices == 0 ) return;
+
+	std::vector<size_t> vertexTime( numVertices, 0 );
+	size_t time = (size_t) cacheSize + 1;
+	size_t budget = (size_t) ( CountCacheMisses( indices, numTriangles*3, vertexTime, time, cacheSize ) * threshold );
+
+	// Cluster boundaries are not always at points where the cache is empty, so reordering the clusters can add
+	// cache misses. If the result exceeds the ACMR budget, larger clusters are tried.
+	std::vector<size_t> clusters;
+	std::vector<unsigned int> output( numTriangles*3 );
+	for ( size_t minClusterSize=1; minClusterSize<numTriangles; minClusterSize*=4 ) {
+		BuildClusters( clusters, indices, numTriangles, numVertices, threshold, cacheSize, minClusterSize );
+		if ( clusters.size() < 3 ) return;	// a single cluster
+		SortClusters( output.data(), indices, clusters, positions, numViews );
+		time += cacheSize + 1;
+		if ( CountCacheMisses( output.data(), numTriangles*3, vertexTime, time, cacheSize ) <= budget ) {
+			memcpy( indices, output.data(), numTriangles*3 * sizeof(unsigned int) );
+			return;
+		}
+	}
+}
+
+inline void MeshOptimizer::BuildClusters( std::vector<size_t> &clusters, unsigned int const *indices, size_t numTriangles, unsigned int numVertices, float threshold, unsigned int cacheSize, size_t minClusterSize )
+{
+	std::vector<size_t> vertexTime( numVertices, 0 );
+	size_t time = (size_t) cacheSize + 1;
+
+	// Hard boundaries are where the vertex cache order starts a new fan with all three vertices missing the cache
+	std::vector<size_t> hard;
+	hard.push_back( 0 );
+	CountCacheMisses( indices, 3, vertexTime, time, cacheSize );
+	for ( size_t t=1; t<numTriangles; t++ ) {
+		if ( CountCacheMisses( indices + t*3, 3, vertexTime, time, cacheSize ) == 3 && t - hard.back() >= minClusterSize ) hard.push_back( t );
+	}
+	hard.push_back( numTriangles );
+
+	// Soft boundaries split the hard clusters further, where the ACMR of the part so far, starting with an empty
+	// cache, is within the threshold of the ACMR of the whole cluster
+	clusters.clear();
+	for ( size_t c=0; c+1<hard.size(); c++ ) {
+		size_t begin = hard[c], end = hard[c+1];
+		time += cacheSize + 1;
+		size_t misses = CountCacheMisses( indices + begin*3, (end-begin)*3, vertexTime, time, cacheSize );
+		float target = float(misses) / float(end-begin) * threshold;
+		time += cacheSize + 1;
+		size_t partMisses = 0;
+		clusters.push_back( begin );
+		for ( size_t t=begin; t<end; t++ ) {
+			partMisses += CountCacheMisses( indices + t*3, 3, vertexTime, time, cacheSize );
+			size_t partSize = t+1 - clusters.back();
+			if ( t+1 < end && partSize >= minClusterSize && float(partMisses) <= target * float(partSize) ) {
+				clusters.push_back( t+1 );
+				partMisses = 0;
+				time += cacheSize + 1;
+			}
+		}
+	}
+	clusters.push_back( numTriangles );
+}
+
+inline void MeshOptimizer::SortClusters( unsigned int *output, unsigned int const *indices, std::vector<size_t> const &clusters, Vec3f const *positions, unsigned int numViews )
+{
+	size_t numClusters = clusters.size() - 1;
+
+	// The area-weighted center and normal of each cluster and of the whole mesh
+	std::vector<Vec3f> clusterCenter( numClusters ), clusterNormal( numClusters );
+	Vec3f meshCenter(0,0,0);
+	float meshArea = 0;
+	for ( size_t c=0; c<numClusters; c++ ) {
+		Vec3f center(0,0,0), normal(0,0,0);
+		float area = 0;
+		for ( size_t t=clusters[c]; t<clusters[c+1]; t++ ) {
+			Vec3f const &p0 = positions[ indices[t*3+0] ];
+			Vec3f const &p1 = positions[ indices[t*3+1] ];
+			Vec3f const &p2 = positions[ indices[t*3+2] ];
+			Vec3f n = (p1 - p0) ^ (p2 - p0);
+			float a = n.Length();
+			center += (p0 + p1 + p2) * (a / 3);
+			normal += n;
+			area += a;
+		}
+		meshCenter += center;
+		meshArea += area;
+		clusterCenter[c] = area > 0 ? center / area : positions[ indices[ clusters[c]*3 ] ];
+		float len = normal.Length();
+		clusterNormal[c] = len > 0 ? normal / len : Vec3f(0,0,0);
+	}
+	if ( meshArea > 0 ) meshCenter /= meshArea;
+	float meshRadius = 0;
+	for ( size_t c=0; c<numClusters; c++ ) meshRadius = Max( meshRadius, (clusterCenter[c] - meshCenter).Length() );
+	if ( meshRadius == 0 ) meshRadius = 1;
+
+	// For each view direction, a cluster that faces the viewer and is close to it is likely to occlude others,
+	// so it is scored by how much it faces the viewer times how far in front of the mesh center it is
+	std::vector<float> score( numClusters, 0 );
+	for ( unsigned int k=0; k<numViews; k++ ) {
+		Vec3f d = ViewDirection( k, numViews );	// the view direction, from the viewer towards the mesh
+		for ( size_t c=0; c<numClusters; c++ ) {
+			float facing = -( clusterNormal[c] % d );
+			if ( facing <= 0 ) continue;
+			score[c] += facing * ( -( ( clusterCenter[c] - meshCenter ) % d ) / meshRadius );
+		}
+	}
+
+	std::vector<unsigned int> order( numClusters );
+	for ( size_t c=0; c<numClusters; c++ ) order[c] = (unsigned int) c;
+	std::stable_sort( order.begin(), order.end(), [&score]( unsigned int a, unsigned int b ) { return score[a] > score[b]; } );
+
+	size_t outCount = 0;
+	for ( size_t i=0; i<numClusters; i++ ) {
+		size_t c = order[i];
+		size_t n = ( clusters[c+1] - clusters[c] ) * 3;
+		memcpy( output + outCount, indices + clusters[c]*3, n * sizeof(unsigned int) );
+		outCount += n;
+	}
+}
+
+inline void MeshOptimizer::Optimize( MeshWelder &welder, unsigned int cacheSize )
+{
+	std::vector<unsigned int> &indices = welder.Indices();
+	if ( indices.empty() ) return;
+	OptimizeVertexCache( indices.data(), indices.size(), welder.NumVertices(), cacheSize );
+	std::vector<unsigned int> remap( welder.NumVertices() );
+	OptimizeVertexFetch( remap.data(), indices.data(), indices.size(), welder.NumVertices() );
+	welder.RemapVertices( remap.data() );
+}
+
+inline void MeshOptimizer::Optimize( MeshWelder &welder, TriMesh const &mesh, float overdrawThreshold, unsigned int cacheSize )
+{
+	std::vector<unsigned int> &indices = welder.Indices();
+	if ( indices.empty() ) return;
+	OptimizeVertexCache( indices.data(), indices.size(), welder.NumVertices(), cacheSize );
+	std::vector<Vec3f> positions;
+	welder.GetPositions( mesh, positions );
+	OptimizeOverdraw( indices.data(), indices.size(), positions.data(), welder.NumVertices(), overdrawThreshold, cacheSize );
+	std::vector<unsigned int> remap( welder.NumVertices() );
+	OptimizeVertexFetch( remap.data(), indices.data(), indices.size(), welder.NumVertices() );
+	welder.RemapVertices( remap.data() );
+}
+
+inline void MeshOptimizer::OptimizeMaterials( MeshWelder &welder, TriMesh const &mesh, unsigned int cacheSize )
+{
+	std::vector<unsigned int> &indices = welder.Indices();
+	if ( indices.empty() ) return;
+	// The faces without a material are placed after the last material. The vertices of each material are
+	// renumbered in their original order, so that the cost of each material depends only on its own size.
+	std::vector<unsigned int> localIndex( welder.NumVertices(), 0xFFFFFFFF );
+	std::vector<unsigned int> vertices, local;
+	size_t first = 0;
+	for ( int m=0; m<=(int)mesh.NM(); m++ ) {
+		size_t end = ( m < (int)mesh.NM() ) ? size_t( mesh.GetMaterialFirstFace(m) + mesh.GetMaterialFaceCount(m) ) * 3 : indices.size();
+		if ( end > first ) {
+			vertices.clear();
+			for ( size_t i=first; i<end; i++ ) {
+				unsigned int v = indices[i];
+				if ( localIndex[v] == 0xFFFFFFFF ) { localIndex[v] = 0; vertices.push_back(v); }
+			}
+			std::sort( vertices.begin(), vertices.end() );
+			for ( unsigned int i=0; i<(unsigned int)vertices.size(); i++ ) localIndex[ vertices[i] ] = i;
+			local.resize( end - first );
+			for ( size_t i=first; i<end; i++ ) local[i-first] = localIndex[ indices[i] ];
+			OptimizeVertexCache( local.data(), local.size(), (unsigned int) vertices.size(), cacheSize );
+			for ( size_t i=first; i<end; i++ ) indices[i] = vertices[ local[i-first] ];
+			for ( unsigned int v : vertices ) localIndex[v] = 0xFFFFFFFF;
+		}
+		first = end;
+	}
+	std::vector<unsigned int> remap( welder.NumVertices() );
+	OptimizeVertexFetch( remap.data(), indices.data(), indices.size(), welder.NumVertices() );
+	welder.RemapVertices( remap.data() );
+}
+
+//-------------------------------------------------------------------------------
+
+inline MeshOptimizer::VertexCacheStats MeshOptimizer::AnalyzeVertexCache( unsigned int const *indices, size_t numIndices, unsigned int numVertices, unsigned int vertexSize, unsigned int cacheSize, unsigned int cacheLineSize, unsigned int numCacheLines )
+{
+	VertexCacheStats stats;
+	stats.verticesTransformed = 0;
+	stats.bytesFetched = 0;
+
+	// The FIFO cache is simulated with time stamps: a vertex is in the cache if
+	// fewer than cacheSize vertices were added after it.
+	std::vector<size_t> vertexTime( numVertices, 0 );
+	std::vector<unsigned char> used( numVertices, 0 );
+	size_t time = (size_t) cacheSize + 1;
+
+	// The fetch cache keeps the last use time of each line, and it is searched linearly
+	std::vector<size_t> lineAddr( numCacheLines, ~size_t(0) );
+	std::vector<size_t> lineTime( numCacheLines, 0 );
+	size_t lineClock = 0;
+
+	for ( size_t i=0; i<numIndices; i++ ) {
+		unsigned int v = indices[i];
+		used[v] = 1;
+		if ( time - vertexTime[v] <= cacheSize ) continue;
+		vertexTime[v] = time++;
+		stats.verticesTransformed++;
+
+		size_t first = (size_t) v * vertexSize / cacheLineSize;
+		size_t last  = ( (size_t) v * vertexSize + vertexSize - 1 ) / cacheLineSize;
+		for ( size_t line=first; line<=last; line++ ) {
+			unsigned int lru = 0;
+			bool hit = false;
+			for ( unsigned int k=0; k<numCacheLines; k++ ) {
+				if ( lineAddr[k] == line ) { lineTime[k] = ++lineClock; hit = true; break; }
+				if ( lineTime[k] < lineTime[lru] ) lru = k;
+			}
+			if ( hit ) continue;
+			lineAddr[lru] = line;
+			lineTime[lru] = ++lineClock;
+			stats.bytesFetched += cacheLineSize;
+		}
+	}
+
+	size_t numUsed = 0;
+	for ( unsigned int v=0; v<numVertices; v++ ) numUsed += used[v];
+	size_t numTriangles = numIndices / 3;
+	stats.acmr      = numTriangles ? float(stats.verticesTransformed) / float(numTriangles) : 0;
+	stats.atvr      = numUsed ? float(stats.verticesTransformed) / float(numUsed) : 0;
+	stats.overfetch = numUsed ? float(stats.bytesFetched) / float( numUsed * vertexSize ) : 0;
+	return stats;
+}
+
+inline MeshOptimizer::OverdrawStats MeshOptimizer::AnalyzeOverdraw( unsigned int const *indices, size_t numIndices, Vec3f const *positions, unsigned int numVertices, unsigned int numViews, unsigned int resolution )
+{
+	OverdrawStats stats;
+	stats.pixelsCovered = 0;
+	stats.pixelsShaded = 0;
+	size_t numTriangles = numIndices / 3;
+	if ( numTriangles == 0 || numVertices == 0 || resolution == 0 ) { stats.overdraw = 0; return stats; }
+
+	Vec3f center(0,0,0);
+	for ( unsigned int v=0; v<numVertices; v++ ) center += positions[v];
+	center /= float(numVertices);
+	float radius = 0;
+	for ( unsigned int v=0; v<numVertices; v++ ) radius = Max( radius, (positions[v] - center).Length() );
+	if ( radius == 0 ) radius = 1;
+	float scale = 0.5f * resolution / radius;
+
+	std::vector<float> depth( (size_t) resolution * resolution );
+	std::vector<Vec3f> screen( numVertices );
+	for ( unsigned int k=0; k<numViews; k++ ) {
+		// An orthographic view looking along d, where x, y, and d form a right-handed frame
+		Vec3f d = ViewDirection( k, numViews );
+		Vec3f up = std::abs(d.y) < 0.9f ? Vec3f(0,1,0) : Vec3f(1,0,0);
+		Vec3f x = (up ^ d).GetNormalized();
+		Vec3f y = d ^ x;
+		for ( unsigned int v=0; v<numVertices; v++ ) {
+			Vec3f p = positions[v] - center;
+			screen[v].Set( (p % x) * scale + 0.5f*resolution, (p % y) * scale + 0.5f*resolution, p % d );
+		}
+		std::fill( depth.begin(), depth.end(), FLT_MAX );
+
+		for ( size_t t=0; t<numTriangles; t++ ) {
+			Vec3f a = screen[ indices[t*3+0] ];
+			Vec3f b = screen[ indices[t*3+1] ];
+			Vec3f c = screen[ indices[t*3+2] ];
+			// Looking along d flips the handedness of the screen, so front faces are clockwise here
+			float area = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+			if ( area >= 0 ) continue;
+			std::swap( b, c );
+			area = -area;
+			int x0 = Max( 0, (int) std::floor( Min( a.x, b.x, c.x ) ) );
+			int y0 = Max( 0, (int) std::floor( Min( a.y, b.y, c.y ) ) );
+			int x1 = Min( (int) resolution - 1, (int) std::ceil( Max( a.x, b.x, c.x ) ) );
+			int y1 = Min( (int) resolution - 1, (int) std::ceil( Max( a.y, b.y, c.y ) ) );
+			for ( int py=y0; py<=y1; py++ ) {
+				float sy = py + 0.5f;
+				for ( int px=x0; px<=x1; px++ ) {
+					float sx = px + 0.5f;
+					// Edge functions with a top-left rule, so that shared edges are rasterized once
+					float w0 = (c.x - b.x) * (sy - b.y) - (c.y - b.y) * (sx - b.x);
+					float w1 = (a.x - c.x) * (sy - c.y) - (a.y - c.y) * (sx - c.x);
+					float w2 = (b.x - a.x) * (sy - a.y) - (b.y - a.y) * (sx - a.x);
+					if ( w0 < 0 || w1 < 0 || w2 < 0 ) continue;
+					if ( ( w0 == 0 && !( c.y > b.y || ( c.y == b.y && c.x < b.x ) ) ) ||
+					     ( w1 == 0 && !( a.y > c.y || ( a.y == c.y && a.x < c.x ) ) ) ||
+					     ( w2 == 0 && !( b.y > a.y || ( b.y == a.y && b.x < a.x ) ) ) ) continue;
+					float z = ( w0 * a.z + w1 * b.z + w2 * c.z ) / area;
+					float &dz = depth[ (size_t) py * resolution + px ];
+					if ( dz == FLT_MAX ) stats.pixelsCovered++;
+					if ( z < dz ) { dz = z; stats.pixelsShaded++; }
+				}
+			}
+		}
+	}
+	stats.overdraw = stats.pixelsCovered ? float(stats.pixelsShaded) / float(stats.pixelsCovered) : 0;
+	return stats;
+}
+
+inline Vec3f MeshOptimizer::ViewDirection( unsigned int i, unsigned int numViews )
+{
+	float const goldenAngle = 2.39996323f;
+	float z = 1 - ( 2*i + 1 ) / float(numViews);
+	float r = std::sqrt( Max( 0.0f, 1 - z*z ) );
+	float phi = goldenAngle * i;
+	return Vec3f( r * std::cos(phi), r * std::sin(phi), z );
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+typedef cy::MeshOptimizer cyMeshOptimizer;	//!< Index and vertex buffer reordering
+
+//-------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,584 @@
+//-------------------------------------------------------------------------------
+//! \file   cyVertexLayout.h
+//!
+//! \brief  Compile-time interleaved vertex layouts.
+//!
+//! A vertex layout is declared as a list of attributes, each with a semantic,
+//! a storage format, and a shader attribute location. The layout computes the
+//! offsets and the stride at compile time, packs the vertices of a welded
+//! TriMesh into a single interleaved buffer, and sets up the matching vertex
+//! attribute pointers of a vertex array object. For example:
+//!
+//!   typedef cy::VertexLayout<
+//!       cy::VertexAttrib< cy::VERTEX_POSITION, cy::VertexFloat3,  0 >,
+//!       cy::VertexAttrib< cy::VERTEX_NORMAL,   cy::VertexSnorm10, 1 >,
+//!       cy::VertexAttrib< cy::VERTEX_TEXCOORD, cy::VertexHalf2,   2 > > Layout;
+//!
+//! Quantized formats store positions and texture coordinates relative to a
+//! range given by VertexQuantization, and normals with octahedral encoding.
+//! The shader decodes them with the GLSL functions of VertexQuantization.
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_VERTEX_LAYOUT_H_INCLUDED_
+#define _CY_VERTEX_LAYOUT_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#if !defined(__gl_h_) && !defined(__GL_H__) && !defined(_GL_H) && !defined(__X_GL_H)
+#error gl.h not included before cyVertexLayout.h
+#endif
+#ifndef GL_VERSION_3_3
+#error OpenGL 3.3 definitions are required for cyVertexLayout.h. You must include an OpenGL extensions header before including cyVertexLayout.h.
+#endif
+
+//-------------------------------------------------------------------------------
+
+#include "cyMeshWeld.h"
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+# define _CY_VERTEX_LAYOUT_SSE2
+#endif
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! The mesh data that a vertex attribute is filled with.
+enum VertexSemantic
+{
+	VERTEX_POSITION,	//!< Vertex position
+	VERTEX_NORMAL,		//!< Vertex normal
+	VERTEX_TEXCOORD,	//!< Texture coordinate
+};
+
+//-------------------------------------------------------------------------------
+
+//! Conversions between 32-bit floats and 16-bit half floats.
+struct HalfFloat
+{
+	static uint16_t FromFloat ( float f );	//!< Rounds to the nearest half value, with ties to even.
+	static float    ToFloat   ( uint16_t h );	//!< Converts a half value to float exactly.
+	static void     FromFloat4( uint16_t *h, float x, float y, float z, float w );	//!< Converts four values at once, using F16C or SSE2 instructions when available.
+};
+
+//! Octahedral encoding of unit vectors, which maps the sphere to the [-1,1] square.
+struct OctahedralNormal
+{
+	static void  Encode( float &u, float &v, Vec3f const &n );	//!< Encodes a vector that is not necessarily normalized. A zero vector is encoded as (0,0).
+	static Vec3f Decode( float u, float v );						//!< Decodes a normalized vector.
+	//! Encodes the vector into signed normalized integers in [-maxValue,maxValue], picking the rounding with the smallest angular error.
+	template <typename T> static void Quantize( T *q, Vec3f const &n, int maxValue );
+};
+
+//-------------------------------------------------------------------------------
+// Attribute formats
+//
+// Each format has its size in bytes, the number of components and the type
+// passed to glVertexAttribPointer, a Pack function that writes a Vec3f, and an
+// Unpack function that reads it back.
+//-------------------------------------------------------------------------------
+
+//! Three 32-bit floats.
+struct VertexFloat3
+{
+	enum { size=12, components=3, type=GL_FLOAT, normalized=GL_FALSE };
+	static void  Pack  ( void *dst, Vec3f const &v ) { memcpy( dst, &v, 12 ); }
+	static Vec3f Unpack( void const *src ) { Vec3f v; memcpy( &v, src, 12 ); return v; }
+};
+
+//! Two 32-bit floats (x and y).
+struct VertexFloat2
+{
+	enum { size=8, components=2, type=GL_FLOAT, normalized=GL_FALSE };
+	static void  Pack  ( void *dst, Vec3f const &v ) { memcpy( dst, &v, 8 ); }
+	static Vec3f Unpack( void const *src ) { Vec3f v(0,0,0); memcpy( &v, src, 8 ); return v; }
+};
+
+//! Two 16-bit floats (x and y), rounded to the nearest half value.
+struct VertexHalf2
+{
+	enum { size=4, components=2, type=GL_HALF_FLOAT, normalized=GL_FALSE };
+	static void  Pack  ( void *dst, Vec3f const &v ) { uint16_t h[4]; HalfFloat::FromFloat4( h, v.x, v.y, 0, 0 ); memcpy( dst, h, 4 ); }
+	static Vec3f Unpack( void const *src ) { uint16_t h[2]; memcpy( h, src, 4 ); return Vec3f( HalfFloat::ToFloat(h[0]), HalfFloat::ToFloat(h[1]), 0 ); }
+};
+
+//! Three 16-bit floats, padded to 8 bytes. Suitable for positions with a centered VertexQuantization range.
+struct VertexHalf3
+{
+	enum { size=8, components=3, type=GL_HALF_FLOAT, normalized=GL_FALSE };
+	static void  Pack  ( void *dst, Vec3f const &v ) { uint16_t h[4]; HalfFloat::FromFloat4( h, v.x, v.y, v.z, 0 ); memcpy( dst, h, 8 ); }
+	static Vec3f Unpack( void const *src ) { uint16_t h[3]; memcpy( h, src, 6 ); return Vec3f( HalfFloat::ToFloat(h[0]), HalfFloat::ToFloat(h[1]), HalfFloat::ToFloat(h[2]) ); }
+};
+
+//! Signed normalized 10-bit x, y, and z, packed into 32 bits. The values are clamped to [-1,1].
+//! The shader reads the attribute as a vec3 or a vec4 with w equal to zero.
+struct VertexSnorm10
+{
+	enum { size=4, components=4, type=GL_INT_2_10_10_10_REV, normalized=GL_TRUE };
+	static void  Pack  ( void *dst, Vec3f const &v );
+	static Vec3f Unpack( void const *src );
+};
+
+//! Two unsigned normalized 16-bit values (x and y). The values are clamped to [0,1].
+//! Suitable for texture coordinates with a VertexQuantization range.
+struct VertexUnorm16x2
+{
+	enum { size=4, components=2, type=GL_UNSIGNED_SHORT, normalized=GL_TRUE };
+	static void  Pack  ( void *dst, Vec3f const &v ) { uint16_t q[2] = { Unorm16(v.x), Unorm16(v.y) }; memcpy( dst, q, 4 ); }
+	static Vec3f Unpack( void const *src ) { uint16_t q[2]; memcpy( q, src, 4 ); return Vec3f( q[0]/65535.0f, q[1]/65535.0f, 0 ); }
+	static uint16_t Unorm16( float f ) { return (uint16_t) ( f <= 0 ? 0 : ( f >= 1 ? 65535 : int( f * 65535.0f + 0.5f ) ) ); }	//!< Converts a single value.
+};
+
+//! Three unsigned normalized 16-bit values, padded to 8 bytes. The values are clamped to [0,1].
+//! Suitable for positions with a VertexQuantization range.
+struct VertexUnorm16x3
+{
+	enum { size=8, components=3, type=GL_UNSIGNED_SHORT, normalized=GL_TRUE };
+	static void  Pack  ( void *dst, Vec3f const &v ) { uint16_t q[4] = { VertexUnorm16x2::Unorm16(v.x), VertexUnorm16x2::Unorm16(v.y), VertexUnorm16x2::Unorm16(v.z), 0 }; memcpy( dst, q, 8 ); }
+	static Vec3f Unpack( void const *src ) { uint16_t q[3]; memcpy( q, src, 6 ); return Vec3f( q[0]/65535.0f, q[1]/65535.0f, q[2]/65535.0f ); }
+};
+
+//! Octahedral normal in two signed normalized 16-bit values. The shader reads the attribute as a vec2.
+struct VertexOct16
+{
+	enum { size=4, components=2, type=GL_SHORT, normalized=GL_TRUE };
+	static void  Pack  ( void *dst, Vec3f const &v ) { int16_t q[2]; OctahedralNormal::Quantize( q, v, 32767 ); memcpy( dst, q, 4 ); }
+	static Vec3f Unpack( void const *src ) { int16_t q[2]; memcpy( q, src, 4 ); return OctahedralNormal::Decode( Max( q[0]/32767.0f, -1.0f ), Max( q[1]/32767.0f, -1.0f ) ); }
+};
+
+//! Octahedral normal in two signed normalized 8-bit values. The shader reads the attribute as a vec2.
+//! Since it uses 2 bytes, it must be paired with another 2-byte attribute to keep the stride a multiple of 4.
+struct VertexOct8
+{
+	enum { size=2, components=2, type=GL_BYTE, normalized=GL_TRUE };
+	static void  Pack  ( void *dst, Vec3f const &v ) { int8_t q[2]; OctahedralNormal::Quantize( q, v, 127 ); memcpy( dst, q, 2 ); }
+	static Vec3f Unpack( void const *src ) { int8_t q[2]; memcpy( q, src, 2 ); return OctahedralNormal::Decode( Max( q[0]/127.0f, -1.0f ), Max( q[1]/127.0f, -1.0f ) ); }
+};
+
+//-------------------------------------------------------------------------------
+
+//! Ranges of quantized positions and texture coordinates.
+//! A stored value s is decoded as offset + scale * s.
+struct VertexQuantization
+{
+	Vec3f positionOffset, positionScale;
+	Vec3f texCoordOffset, texCoordScale;
+
+	VertexQuantization() { SetIdentity(); }
+
+	void SetIdentity() { positionOffset.Zero(); positionScale.Set(1,1,1); texCoordOffset.Zero(); texCoordScale.Set(1,1,1); }	//!< Stores the values as they are.
+	//! Sets the position range to the given box. Positions are stored in [0,1], which suits unorm formats,
+	//! or in [-1,1] if centered is true, which suits half formats.
+	void SetPositionRange( Vec3f const &boundMin, Vec3f const &boundMax, bool centered=false ) { SetRange( positionOffset, positionScale, boundMin, boundMax, centered ); }
+	//! Sets the texture coordinate range to the given box. Texture coordinates are stored in [0,1].
+	void SetTexCoordRange( Vec3f const &texMin, Vec3f const &texMax ) { SetRange( texCoordOffset, texCoordScale, texMin, texMax, false ); }
+	//! Sets the ranges to the bounding boxes of the vertices and texture vertices of the mesh.
+	void SetFromMesh( TriMesh const &mesh, bool centeredPositions=false );
+
+	Vec3f EncodePosition( Vec3f const &p ) const { return ( p - positionOffset ) / positionScale; }	//!< Returns the value stored for the given position.
+	Vec3f DecodePosition( Vec3f const &s ) const { return positionOffset + positionScale * s; }		//!< Returns the position of the given stored value.
+	Vec3f EncodeTexCoord( Vec3f const &t ) const { return ( t - texCoordOffset ) / texCoordScale; }	//!< Returns the value stored for the given texture coordinate.
+	Vec3f DecodeTexCoord( Vec3f const &s ) const { return texCoordOffset + texCoordScale * s; }		//!< Returns the texture coordinate of the given stored value.
+
+	//! Returns GLSL code with the uniforms and the functions that decode quantized attributes: cyDecodePosition,
+	//! cyDecodeTexCoord, and cyDecodeOctNormal. It does not include a "#version" statement.
+	static char const * GLSLDecode();
+	//! Sets the uniforms used by the GLSLDecode functions. The program must be in use.
+	void SetUniforms( GLuint programID ) const;
+
+private:
+	static void SetRange( Vec3f &offset, Vec3f &scale, Vec3f const &boundMin, Vec3f const &boundMax, bool centered );
+};
+
+//! Differences between the values stored in a packed vertex buffer and the mesh data.
+struct VertexError
+{
+	float positionMax, positionRMS;	//!< Position error, in mesh units
+	float normalMax,   normalRMS;	//!< Angle between the stored and the original normals, in degrees
+	float texCoordMax, texCoordRMS;	//!< Texture coordinate error, in texture coordinate units
+};
+
+//-------------------------------------------------------------------------------
+
+//! A vertex attribute of a layout.
+template <VertexSemantic SEMANTIC, typename FORMAT, GLuint LOCATION>
+struct VertexAttrib
+{
+	typedef FORMAT Format;
+	enum { semantic=SEMANTIC, location=LOCATION };
+};
+
+//-------------------------------------------------------------------------------
+
+//! Interleaved vertex layout made of the given VertexAttrib types, in the order they are given.
+
+template <typename... ATTRIBS>
+class VertexLayout
+{
+	template <typename... A> struct List;
+	typedef List<ATTRIBS...> Attribs;
+public:
+	//!@name Layout
+	static constexpr unsigned int NumAttribs() { return sizeof...(ATTRIBS); }				//!< Returns the number of attributes.
+	static constexpr unsigned int Stride() { return Attribs::Size(); }						//!< Returns the size of a vertex in bytes.
+	static constexpr unsigned int Offset( unsigned int i ) { return Attribs::Offset(i); }	//!< Returns the offset of the i^th attribute in bytes.
+	//! Returns a hash of the semantics, locations, and formats of the attributes, which identifies the layout of stored vertex buffers.
+	static constexpr uint32_t Signature() { return Attribs::Signature( 2166136261u ); }
+
+	//!@name Packing
+	//! Packs the welded vertices of the mesh into the given buffer, which must hold welder.NumVertices()*Stride() bytes.
+	//! Positions and texture coordinates are encoded with the given quantization ranges.
+	//! Attributes that the welder does not use are filled with zeros.
+	static void Pack( void *buffer, TriMesh const &mesh, MeshWelder const &welder, VertexQuantization const &quant=VertexQuantization() );
+	//! Resizes the given buffer and packs the welded vertices of the mesh into it.
+	static void Pack( std::vector<unsigned char> &buffer, TriMesh const &mesh, MeshWelder const &welder, VertexQuantization const &quant=VertexQuantization() ) { buffer.resize( (size_t)welder.NumVertices() * Stride() ); if ( !buffer.empty() ) Pack( buffer.data(), mesh, welder, quant ); }
+	//! Decodes the packed vertices and compares them to the mesh data they were packed from.
+	static VertexError MeasureError( void const *buffer, TriMesh const &mesh, MeshWelder const &welder, VertexQuantization const &quant=VertexQuantization() );
+
+	//!@name OpenGL
+	//! Binds the given vertex buffer and sets the attribute pointers of the currently bound vertex array object.
+	//! The offset is the byte offset of the first vertex in the buffer.
+	static void SetAttribs( GLuint vertexBuffer, size_t offset=0 ) { glBindBuffer( GL_ARRAY_BUFFER, vertexBuffer ); Attribs::SetAttribs( offset ); }
+
+private:
+	struct Source
+	{
+		Vec3f const *data[3];
+		unsigned int const *index[3];
+		VertexQuantization const *quant;
+		void Init( TriMesh const &mesh, MeshWelder const &welder, VertexQuantization const &q );
+		bool  Has( int semantic ) const { return index[semantic] != nullptr; }
+		Vec3f Get( int semantic, unsigned int i ) const { return index[semantic] ? data[semantic][ index[semantic][i] ] : Vec3f(0,0,0); }
+		Vec3f Encode( int semantic, unsigned int i ) const
+		{
+			Vec3f v = Get( semantic, i );
+			if ( semantic == VERTEX_POSITION ) return quant->EncodePosition( v );
+			if ( semantic == VERTEX_TEXCOORD ) return quant->EncodeTexCoord( v );
+			return v;
+		}
+	};
+
+	struct ErrorSum
+	{
+		double sum[3], max[3];
+		size_t count[3];
+	};
+
+	template <typename... A> struct List
+	{
+		static constexpr unsigned int Size() { return 0; }
+		static constexpr unsigned int Offset( unsigned int ) { return 0; }
+		static constexpr uint32_t Signature( uint32_t h ) { return h; }
+		static void Pack( unsigned char *, Source const &, unsigned int ) {}
+		static void Measure( unsigned char const *, Source const &, unsigned int, ErrorSum & ) {}
+		static void SetAttribs( size_t ) {}
+	};
+	template <typename A, typename... REST> struct List<A,REST...>
+	{
+		typedef List<REST...> Rest;
+		static constexpr unsigned int Size() { return A::Format::size + Rest::Size(); }
+		static constexpr unsigned int Offset( unsigned int i ) { return i == 0 ? 0 : A::Format::size + Rest::Offset(i-1); }
+		static constexpr uint32_t Signature( uint32_t h ) { return Rest::Signature( Mix( Mix( Mix( Mix( Mix( Mix( h, A::semantic ), A::location ), A::Format::size ), A::Format::components ), A::Format::type ), A::Format::normalized ) ); }
+		static void Pack( unsigned char *dst, Source const &src, unsigned int i )
+		{
+			A::Format::Pack( dst, src.Encode( A::semantic, i ) );
+			Rest::Pack( dst + A::Format::size, src, i );
+		}
+		static void Measure( unsigned char const *p, Source const &src, unsigned int i, ErrorSum &err )
+		{
+			if ( src.Has( A::semantic ) ) {
+				Vec3f v = A::Format::Unpack( p );
+				Vec3f s = src.Get( A::semantic, i );
+				double e = 0;
+				switch ( (int) A::semantic ) {
+					case VERTEX_POSITION: e = ( src.quant->DecodePosition(v) - s ).Length(); break;
+					case VERTEX_TEXCOORD: v = src.quant->DecodeTexCoord(v); e = Vec2f( v.x - s.x, v.y - s.y ).Length(); break;
+					case VERTEX_NORMAL: {
+						float lv = v.Length(), ls = s.Length();
+						if ( lv == 0 || ls == 0 ) e = ( lv == ls ) ? 0 : 180;
+						else e = std::acos( (double) Min( 1.0f, Max( -1.0f, (v % s) / (lv * ls) ) ) ) * ( 180.0 / 3.14159265358979323846 );
+						break;
+					}
+				}
+				err.sum[A::semantic] += e * e;
+				err.max[A::semantic] = Max( err.max[A::semantic], e );
+				err.count[A::semantic]++;
+			}
+			Rest::Measure( p + A::Format::size, src, i, err );
+		}
+		static void SetAttribs( size_t offset )
+		{
+			glEnableVertexAttribArray( A::location );
+			glVertexAttribPointer( A::location, A::Format::components, A::Format::type, A::Format::normalized, Stride(), (GLvoid const *) offset );
+			Rest::SetAttribs( offset + A::Format::size );
+		}
+	};
+
+	static constexpr uint32_t Mix( uint32_t h, uint32_t v ) { return ( h ^ v ) * 16777619u; }	// FNV-1a step
+
+	static_assert( sizeof...(ATTRIBS) > 0, "A vertex layout must have at least one attribute." );
+	static_assert( Attribs::Size() % 4 == 0, "The vertex stride must be a multiple of 4 bytes." );
+};
+
+//-------------------------------------------------------------------------------
+
+template <typename... ATTRIBS>
+inline void VertexLayout<ATTRIBS...>::Source::Init( TriMesh const &mesh, MeshWelder const &welder, VertexQuantization const &q )
+{
+	data [VERTEX_POSITION] = mesh.NV()  ? &mesh.V(0)  : nullptr;
+	data [VERTEX_NORMAL  ] = mesh.NVN() ? &mesh.VN(0) : nullptr;
+	data [VERTEX_TEXCOORD] = mesh.NVT() ? &mesh.VT(0) : nullptr;
+	index[VERTEX_POSITION] = welder.VertexV ().empty() ? nullptr : welder.VertexV ().data();
+	index[VERTEX_NORMAL  ] = welder.VertexVN().empty() ? nullptr : welder.VertexVN().data();
+	index[VERTEX_TEXCOORD] = welder.VertexVT().empty() ? nullptr : welder.VertexVT().data();
+	quant = &q;
+}
+
+template <typename... ATTRIBS>
+inline void VertexLayout<ATTRIBS...>::Pack( void *buffer, TriMesh const &mesh, MeshWelder const &welder, VertexQuantization const &quant )
+{
+	Source src;
+	src.Init( mesh, welder, quant );
+	unsigned char *dst = (unsigned char *) buffer;
+	unsigned int n = welder.NumVertices();
+	for ( unsigned int i=0; i<n; i++, dst+=Stride() ) Attribs::Pack( dst, src, i );
+}
+
+template <typename... ATTRIBS>
+inline VertexError VertexLayout<ATTRIBS...>::MeasureError( void const *buffer, TriMesh const &mesh, MeshWelder const &welder, VertexQuantization const &quant )
+{
+	Source src;
+	src.Init( mesh, welder, quant );
+	ErrorSum err;
+	for ( int k=0; k<3; k++ ) { err.sum[k] = 0; err.max[k] = 0; err.count[k] = 0; }
+	unsigned char const *p = (unsigned char const *) buffer;
+	unsigned int n = welder.NumVertices();
+	for ( unsigned int i=0; i<n; i++, p+=Stride() ) Attribs::Measure( p, src, i, err );
+	float rms[3];
+	for ( int k=0; k<3; k++ ) rms[k] = err.count[k] ? (float) std::sqrt( err.sum[k] / err.count[k] ) : 0;
+	VertexError e;
+	e.positionMax = (float) err.max[VERTEX_POSITION];	e.positionRMS = rms[VERTEX_POSITION];
+	e.normalMax   = (float) err.max[VERTEX_NORMAL  ];	e.normalRMS   = rms[VERTEX_NORMAL  ];
+	e.texCoordMax = (float) err.max[VERTEX_TEXCOORD];	e.texCoordRMS = rms[VERTEX_TEXCOORD];
+	return e;
+}
+
+//-------------------------------------------------------------------------------
+
+inline uint16_t HalfFloat::FromFloat( float f )
+{
+	uint32_t x;
+	memcpy( &x, &f, sizeof(x) );
+	uint32_t sign = x & 0x80000000u;
+	x ^= sign;
+	uint32_t h;
+	if ( x >= 0x47800000u ) h = x > 0x7F800000u ? 0x7E00 : 0x7C00;	// NaN or too large
+	else if ( x < 0x38800000u ) {
+		// denormals are rounded by adding a magic number with the right exponent
+		float t;
+		uint32_t const magic = 0x3F000000u;
+		memcpy( &t, &x, sizeof(t) );
+		float m;
+		memcpy( &m, &magic, sizeof(m) );
+		t += m;
+		memcpy( &h, &t, sizeof(h) );
+		h -= magic;
+	} else {
+		// rebias the exponent and round to nearest even
+		uint32_t odd = ( x >> 13 ) & 1;
+		h = ( x + 0xC8000FFFu + odd ) >> 13;
+	}
+	return (uint16_t) ( h | ( sign >> 16 ) );
+}
+
+inline float HalfFloat::ToFloat( uint16_t h )
+{
+	uint32_t sign = uint32_t( h & 0x8000 ) << 16;
+	uint32_t e = ( h >> 10 ) & 0x1F;
+	uint32_t m = h & 0x3FF;
+	if ( e == 0 ) {
+		float f = m * ( 1.0f / 16777216.0f );	// denormal: m * 2^-24
+		return sign ? -f : f;
+	}
+	uint32_t x = sign | ( e == 31 ? 0x7F800000u : ( e + 112 ) << 23 ) | ( m << 13 );
+	float f;
+	memcpy( &f, &x, sizeof(f) );
+	return f;
+}
+
+inline void HalfFloat::FromFloat4( uint16_t *h, float x, float y, float z, float w )
+{
+#if defined(__F16C__)
+	_mm_storel_epi64( (__m128i*) h, _mm_cvtps_ph( _mm_set_ps( w, z, y, x ), _MM_FROUND_TO_NEAREST_INT ) );
+#elif defined(_CY_VERTEX_LAYOUT_SSE2)
+	// The same conversion as FromFloat, for four values at once
+	__m128i v    = _mm_castps_si128( _mm_set_ps( w, z, y, x ) );
+	__m128i sign = _mm_and_si128( v, _mm_set1_epi32( (int) 0x80000000u ) );
+	v = _mm_xor_si128( v, sign );
+	__m128i infNan  = _mm_cmpgt_epi32( v, _mm_set1_epi32( 0x477FFFFF ) );
+	__m128i nanBits = _mm_or_si128( _mm_set1_epi32( 0x7C00 ), _mm_and_si128( _mm_cmpgt_epi32( v, _mm_set1_epi32( 0x7F800000 ) ), _mm_set1_epi32( 0x0200 ) ) );
+	__m128i denorm  = _mm_cmplt_epi32( v, _mm_set1_epi32( 0x38800000 ) );
+	__m128i magic   = _mm_set1_epi32( 0x3F000000 );
+	__m128i denBits = _mm_sub_epi32( _mm_castps_si128( _mm_add_ps( _mm_castsi128_ps(v), _mm_castsi128_ps(magic) ) ), magic );
+	__m128i odd     = _mm_and_si128( _mm_srli_epi32( v, 13 ), _mm_set1_epi32(1) );
+	__m128i norBits = _mm_srli_epi32( _mm_add_epi32( _mm_add_epi32( v, _mm_set1_epi32( (int) 0xC8000FFFu ) ), odd ), 13 );
+	__m128i r = _mm_or_si128( _mm_and_si128( denorm, denBits ), _mm_andnot_si128( denorm, norBits ) );
+	r = _mm_or_si128( _mm_and_si128( infNan, nanBits ), _mm_andnot_si128( infNan, r ) );
+	r = _mm_or_si128( r, _mm_srli_epi32( sign, 16 ) );
+	// gather the low 16 bits of the four lanes into the low 64 bits
+	r = _mm_shufflelo_epi16( r, _MM_SHUFFLE(3,3,2,0) );
+	r = _mm_shufflehi_epi16( r, _MM_SHUFFLE(3,3,2,0) );
+	r = _mm_shuffle_epi32( r, _MM_SHUFFLE(3,3,2,0) );
+	_mm_storel_epi64( (__m128i*) h, r );
+#else
+	h[0] = FromFloat(x);
+	h[1] = FromFloat(y);
+	h[2] = FromFloat(z);
+	h[3] = FromFloat(w);
+#endif
+}
+
+//-------------------------------------------------------------------------------
+
+inline void OctahedralNormal::Encode( float &u, float &v, Vec3f const &n )
+{
+	float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+	if ( l1 == 0 ) { u = v = 0; return; }
+	u = n.x / l1;
+	v = n.y / l1;
+	if ( n.z < 0 ) {
+		// fold the lower hemisphere over the diagonals
+		float fu = ( 1 - std::abs(v) ) * ( u >= 0 ? 1 : -1 );
+		float fv = ( 1 - std::abs(u) ) * ( v >= 0 ? 1 : -1 );
+		u = fu;
+		v = fv;
+	}
+}
+
+inline Vec3f OctahedralNormal::Decode( float u, float v )
+{
+	Vec3f n( u, v, 1 - std::abs(u) - std::abs(v) );
+	float t = Max( -n.z, 0.0f );
+	n.x += n.x >= 0 ? -t : t;
+	n.y += n.y >= 0 ? -t : t;
+	return n.GetNormalized();
+}
+
+template <typename T>
+inline void OctahedralNormal::Quantize( T *q, Vec3f const &n, int maxValue )
+{
+	float u, v;
+	Encode( u, v, n );
+	float len = n.Length();
+	if ( len == 0 ) { q[0] = q[1] = 0; return; }
+	Vec3f nn = n / len;
+	int u0 = (int) std::floor( u * maxValue );
+	int v0 = (int) std::floor( v * maxValue );
+	float best = -2;
+	for ( int i=0; i<4; i++ ) {
+		int qu = Min( maxValue, Max( -maxValue, u0 + (i & 1) ) );
+		int qv = Min( maxValue, Max( -maxValue, v0 + (i >> 1) ) );
+		float d = Decode( float(qu) / maxValue, float(qv) / maxValue ) % nn;
+		if ( d > best ) { best = d; q[0] = (T) qu; q[1] = (T) qv; }
+	}
+}
+
+//-------------------------------------------------------------------------------
+
+inline void VertexQuantization::SetRange( Vec3f &offset, Vec3f &scale, Vec3f const &boundMin, Vec3f const &boundMax, bool centered )
+{
+	Vec3f size = boundMax - boundMin;
+	for ( int i=0; i<3; i++ ) if ( !( size[i] > 0 ) ) size[i] = 1;	// avoid dividing by zero for flat ranges
+	if ( centered ) {
+		offset = ( boundMin + boundMax ) * 0.5f;
+		scale  = size * 0.5f;
+	} else {
+		offset = boundMin;
+		scale  = size;
+	}
+}
+
+inline void VertexQuantization::SetFromMesh( TriMesh const &mesh, bool centeredPositions )
+{
+	SetIdentity();
+	if ( mesh.NV() > 0 ) {
+		Vec3f pmin = mesh.V(0), pmax = mesh.V(0);
+		for ( unsigned int i=1; i<mesh.NV(); i++ ) for ( int j=0; j<3; j++ ) { pmin[j] = Min( pmin[j], mesh.V(i)[j] ); pmax[j] = Max( pmax[j], mesh.V(i)[j] ); }
+		SetPositionRange( pmin, pmax, centeredPositions );
+	}
+	if ( mesh.NVT() > 0 ) {
+		Vec3f tmin = mesh.VT(0), tmax = mesh.VT(0);
+		for ( unsigned int i=1; i<mesh.NVT(); i++ ) for ( int j=0; j<3; j++ ) { tmin[j] = Min( tmin[j], mesh.VT(i)[j] ); tmax[j] = Max( tmax[j], mesh.VT(i)[j] ); }
+		SetTexCoordRange( tmin, tmax );
+	}
+}
+
+inline char const * VertexQuantization::GLSLDecode()
+{
+	return
+		"uniform vec3 cyPositionOffset;\n"
+		"uniform vec3 cyPositionScale;\n"
+		"uniform vec2 cyTexCoordOffset;\n"
+		"uniform vec2 cyTexCoordScale;\n"
+		"vec3 cyDecodePosition( vec3 p ) { return cyPositionOffset + cyPositionScale * p; }\n"
+		"vec2 cyDecodeTexCoord( vec2 t ) { return cyTexCoordOffset + cyTexCoordScale * t; }\n"
+		"vec3 cyDecodeOctNormal( vec2 e )\n"
+		"{\n"
+		"	vec3 n = vec3( e, 1.0 - abs(e.x) - abs(e.y) );\n"
+		"	float t = max( -n.z, 0.0 );\n"
+		"	n.x += n.x >= 0.0 ? -t : t;\n"
+		"	n.y += n.y >= 0.0 ? -t : t;\n"
+		"	return normalize(n);\n"
+		"}\n";
+}
+
+inline void VertexQuantization::SetUniforms( GLuint programID ) const
+{
+	glUniform3f( glGetUniformLocation( programID, "cyPositionOffset" ), positionOffset.x, positionOffset.y, positionOffset.z );
+	glUniform3f( glGetUniformLocation( programID, "cyPositionScale"  ), positionScale .x, positionScale .y, positionScale .z );
+	glUniform2f( glGetUniformLocation( programID, "cyTexCoordOffset" ), texCoordOffset.x, texCoordOffset.y );
+	glUniform2f( glGetUniformLocation( programID, "cyTexCoordScale"  ), texCoordScale .x, texCoordScale .y );
+}
+
+//-------------------------------------------------------------------------------
+
+inline void VertexSnorm10::Pack( void *dst, Vec3f const &v )
+{
+#ifdef _CY_VERTEX_LAYOUT_SSE2
+	__m128 f = _mm_set_ps( 0, v.z, v.y, v.x );
+	f = _mm_min_ps( _mm_max_ps( f, _mm_set1_ps(-1.0f) ), _mm_set1_ps(1.0f) );
+	__m128i i = _mm_and_si128( _mm_cvtps_epi32( _mm_mul_ps( f, _mm_set1_ps(511.0f) ) ), _mm_set1_epi32( 0x3FF ) );
+	__m128i y = _mm_slli_epi32( _mm_shuffle_epi32( i, _MM_SHUFFLE(1,1,1,1) ), 10 );
+	__m128i z = _mm_slli_epi32( _mm_shuffle_epi32( i, _MM_SHUFFLE(2,2,2,2) ), 20 );
+	uint32_t p = (uint32_t) _mm_cvtsi128_si32( _mm_or_si128( i, _mm_or_si128( y, z ) ) );
+#else
+	uint32_t p = 0;
+	for ( int j=0; j<3; j++ ) {
+		float c = v[j] < -1 ? -1 : ( v[j] > 1 ? 1 : v[j] );
+		int q = (int) std::floor( c * 511.0f + 0.5f );
+		p |= ( (uint32_t) q & 0x3FF ) << ( 10*j );
+	}
+#endif
+	memcpy( dst, &p, 4 );
+}
+
+inline Vec3f VertexSnorm10::Unpack( void const *src )
+{
+	uint32_t p;
+	memcpy( &p, src, 4 );
+	Vec3f v;
+	for ( int j=0; j<3; j++ ) {
+		int q = int( ( p >> ( 10*j ) ) & 0x3FF );
+		if ( q >= 512 ) q -= 1024;
+		v[j] = Max( q / 511.0f, -1.0f );
+	}
+	return v;
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+#endif
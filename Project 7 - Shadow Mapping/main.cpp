@@ -2,11 +2,21 @@
 #include <GL/freeglut.h>
 #include <iostream>
 #include <stdlib.h>
+#include <chrono>
 #include "cyCodeBase/cyCore.h"
 #include "cyCodeBase/cyVector.h"
 #include "cyCodeBase/cyMatrix.h"
 #include "cyCodeBase/cyTriMesh.h"
+#include "cyCodeBase/cyTriMeshSoA.h"
+#include "cyCodeBase/cyMeshCache.h"
+#include "cyCodeBase/cyMeshWeld.h"
+#include "cyCodeBase/cyMeshOptimizer.h"
+#include "cyCodeBase/cyMeshSimplify.h"
+#include "cyCodeBase/cyMeshlet.h"
+#include "cyCodeBase/cyShadowVolume.h"
+#include "cyCodeBase/cyMeshCodec.h"
 #include "cyCodeBase/cyGL.h"
+#include "cyCodeBase/cyVertexLayout.h"
 
 // window dimensions
 GLfloat displayWidth = 800;
@@ -32,7 +42,7 @@ float camFOV = 0.25 * M_PI;
 cyVec3f lightPos = cyVec3f(0, distance, 0);
 cyVec3f lightTarget = cyVec3f(0, 0, 0);
 cyVec3f lightUp = cyVec3f(0, 1, 0);
-float lightFOV = 0.3 * M_PI;
+constexpr float lightFOV = 0.3 * M_PI;
 
 // MVP matrices
 cy::Matrix4f projMatrix = cy::Matrix4f::Perspective(camFOV, displayWidth / displayHeight, 0.1f, 1000.0f);
@@ -40,9 +50,13 @@ cy::Matrix4f viewMatrix = cy::Matrix4f::View(camPos, camTarget, camUp);
 cy::Matrix4f modelMatrix = cy::Matrix4f::Identity();
 
 // light space matrices
-cy::Matrix4f lightProjMatrix = cy::Matrix4f::Perspective(lightFOV, 1.0f, 0.1f, 1000.0f);
+CY_CONSTEXPR_VAR cy::Matrix4f lightProjMatrix = cy::Matrix4f::Perspective(lightFOV, 1.0f, 0.1f, 1000.0f);
 cy::Matrix4f lightMatrix = cy::Matrix4f::View(lightPos, lightTarget, lightUp);
 
+// maps light clip space to shadow map coordinates, with a small depth bias
+constexpr float shadowBias = 0.00003f;
+CY_CONSTEXPR_VAR cy::Matrix4f shadowBiasMatrix = cy::Matrix4f::Product(cy::Matrix4f::Translation(cyVec3f(0.5f, 0.5f, 0.5f - shadowBias)), cy::Matrix4f::Scale(0.5f));
+
 // callback variables (mouse)
 int mouseButton = -1;
 int lastX;
@@ -53,23 +67,55 @@ bool ctrlPressed = false;
 // OBJ reader
 cy::TriMesh reader;
 
+// binary cache of the OBJ file and its vertex data
+cyMeshCache meshCache;
+std::string meshFilename;
+
 // programs
 cy::GLSLProgram program;
 cy::GLSLProgram program_shadow;
 cy::GLSLProgram program_hint;
+cy::GLSLProgram program_volume;
 
 // to store vertex data
-std::vector<cyVec3f> positionBufferData;
-std::vector<cyVec3f> normalBufferData;
+std::vector<unsigned char> vertexBufferData;
 std::vector<GLuint> indexBufferData;
 
+// interleaved vertex layout of the object
+typedef cy::VertexLayout<
+    cy::VertexAttrib<cy::VERTEX_POSITION, cy::VertexFloat3, 0>,
+    cy::VertexAttrib<cy::VERTEX_NORMAL, cy::VertexSnorm10, 1>>
+    ObjectLayout;
+
+// levels of detail of the object, stored one after another in the index buffer
+cyMeshLOD meshLOD;
+
+// settings of the vertex data stored in the mesh cache. Increment the revision when the way the
+// vertex data is generated changes in any other way, so that the cached vertex data is rebuilt.
+const uint32_t vertexDataRevision = 1;
+const float vertexCacheThreshold = 1.05f;
+const float lodRatios[] = {0.5f, 0.25f, 0.125f, 0.0625f};
+
+// meshlets of the full detail level, culled on the CPU into a compacted index buffer
+cyMeshlets meshlets;
+std::vector<GLuint> culledIndices;
+
 // VAOs and VBOs
-GLuint vao, vbo[2], ibo;
+GLuint vao, vbo, ibo;
+GLuint vao_culled, ibo_culled;
 GLuint vao_square, vbo_square[2];
 GLuint vao_hint, vbo_hint;
+GLuint vao_volume, vbo_volume;
 
 // shadow map
 cyGLRenderDepth2D shadowMap;
+int shadowMapWidth = 1024;
+int shadowMapHeight = 1024;
+
+// shadow volumes of the levels of detail, extracted on the CPU every frame and drawn into the stencil buffer
+bool useShadowVolumes = false;
+std::vector<cyShadowVolume> shadowVolumes;
+std::vector<cyVec4f> volumeVertices;
 
 // calculate position with given theta and phi
 cyVec3f calculatePos(double &iTheta, double &iPhi)
@@ -104,6 +150,7 @@ void setCamera()
     program.SetUniform("camPos", camPos.x, camPos.y, camPos.z);
 
     program_hint.SetUniformMatrix4("vp", vp.cell);
+    program_volume.SetUniformMatrix4("mvp", mvp.cell);
 }
 
 // update light space matrices and send to shaders
@@ -119,8 +166,7 @@ void setLight()
     cyMatrix4f mvp = lightProjMatrix * lightMatrix * modelMatrix;
     program_shadow.SetUniformMatrix4("mvp", mvp.cell);
 
-    float shadowBias = 0.00003f;
-    cyMatrix4f mShadow = cyMatrix4f::Translation(cyVec3f(0.5f, 0.5f, 0.5f - shadowBias)) * cyMatrix4f::Scale(0.5f) * mvp;
+    cyMatrix4f mShadow = shadowBiasMatrix * mvp;
 
     program.SetUniformMatrix4("matrixShadow", mShadow.cell);
 
@@ -132,9 +178,10 @@ void setLight()
 void setUniforms()
 {
     program.SetUniformMatrix4("m", modelMatrix.cell);
-    cy::Matrix3f mN = modelMatrix.GetInverse().GetTranspose().GetSubMatrix3();
+    cy::Matrix3f mN = modelMatrix.GetAffineInverse().GetTranspose().GetSubMatrix3();
     program.SetUniformMatrix3("mN", mN.cell);
     program.SetUniform("lightFovRad", lightFOV);
+    program.SetUniform("lightingPass", 0);
 }
 
 // compile object, shadow, and light hint shaders
@@ -152,6 +199,10 @@ void compileShaders()
     if (!program_hint.BuildFiles("hint_shader.vert", "hint_shader.frag"))
         exit(1);
 
+    // shadow volume shaders
+    if (!program_volume.BuildFiles("shadow_volume.vert", "shadow_volume.frag"))
+        exit(1);
+
     setUniforms();
 
     setCamera();
@@ -245,7 +296,13 @@ void mouseMotion(int x, int y)
     glutPostRedisplay();
 }
 
-// listen for 'Esc' (to quit)
+// compare shadow maps and shadow volumes (defined below)
+void benchmarkShadows();
+
+// write the mesh as a compressed mesh file (defined below)
+void saveCompressedMesh();
+
+// listen for 'Esc' (to quit), 'V' (to switch between the shadow map and shadow volumes), 'B' (to run the shadow benchmark), and 'C' (to save a compressed mesh)
 void keyListener(unsigned char key, int x, int y)
 {
     switch (key)
@@ -254,6 +311,21 @@ void keyListener(unsigned char key, int x, int y)
     case 27:
         glutLeaveMainLoop();
         break;
+    case 'v':
+    case 'V':
+        useShadowVolumes = !useShadowVolumes;
+        printf("Shadows: %s\n", useShadowVolumes ? "stencil shadow volumes" : "shadow map");
+        glutPostRedisplay();
+        break;
+    case 'b':
+    case 'B':
+        benchmarkShadows();
+        glutPostRedisplay();
+        break;
+    case 'c':
+    case 'C':
+        saveCompressedMesh();
+        break;
     }
 }
 
@@ -295,100 +367,177 @@ cyTriMesh parseOBJ(int argc, const char *filename)
         exit(1);
     }
 
-    // read OBJ file
+    // read compressed mesh file or OBJ file
     bool read_status;
     cyTriMesh reader;
-    if (!(read_status = reader.LoadFromFileObj(filename)))
+    meshFilename = filename;
+    bool compressed = meshFilename.size() > 5 && meshFilename.compare(meshFilename.size() - 5, 5, ".cymc") == 0;
+    if (compressed)
+    {
+        auto start = std::chrono::steady_clock::now();
+        read_status = cyMeshCodec::LoadFromFile(reader, filename);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (read_status)
+            printf("Decoded %s in %.2f ms\n", filename, elapsed.count());
+    }
+    else
+        read_status = meshCache.LoadFromFileObj(reader, filename);
+    if (!read_status)
     {
         fprintf(stderr, "Error: cannot read file");
         exit(1);
     }
     // calculate mesh information
     reader.ComputeBoundingBox();
+
+    // compute vertex normals if the OBJ file does not have them
+    if (!reader.HasNormals())
+    {
+        cyTriMeshSoA soa;
+        soa.Set(reader);
+        soa.ComputeNormals(reader);
+    }
     return reader;
 }
 
+// version of the vertex data in the mesh cache, which changes with the vertex layout and the settings
+uint64_t getVertexDataVersion()
+{
+    uint32_t settings[5 + sizeof(lodRatios) / sizeof(float)] = {vertexDataRevision, ObjectLayout::Signature(), ObjectLayout::Stride(), sizeof(cyMeshLOD::Level)};
+    memcpy(settings + 4, &vertexCacheThreshold, sizeof(float));
+    memcpy(settings + 5, lodRatios, sizeof(lodRatios));
+    return cyMeshCache::Hash(settings, sizeof(settings));
+}
+
 // read vertex data from reader
 void getVertexData()
 {
-    unsigned int max = cy::Max(reader.NV(), reader.NVN());
-    for (int vi = 0; vi < max; vi++)
+    // vertex data is already in the mesh cache, generated with the same layout and settings
+    size_t lodSize;
+    const void *lodData = meshCache.GetBuffer("lod", lodSize);
+    if (meshCache.GetBufferVersion() == getVertexDataVersion() && meshCache.GetBuffer("vertex") && meshCache.GetBuffer("index") && lodData)
     {
-        positionBufferData.push_back(vi < reader.NV() ? reader.V(vi) : reader.V(0));
-        normalBufferData.push_back(vi < reader.NVN() ? reader.VN(vi) : reader.VN(0));
+        meshLOD.SetLevels((const cyMeshLOD::Level *)lodData, lodSize / sizeof(cyMeshLOD::Level), reader);
+        return;
     }
 
-    for (int i = 0; i < reader.NF(); i++)
-    {
-        for (int j = 0; j < 3; j++)
-        {
-            // set up triangle vertex buffer data
-            unsigned int index = reader.F(i).v[j];
-            unsigned int indexN = reader.FN(i).v[j];
-
-            if (indexN == index)
-            {
-                indexBufferData.push_back(index);
-            }
-            else
-            {
-                bool added = false;
-                for (unsigned int mi = max; mi < positionBufferData.size(); mi++)
-                {
-                    if (positionBufferData.at(mi) == reader.V(index) &&
-                        normalBufferData.at(mi) == reader.VN(indexN))
-                    {
-                        added = true;
-                        indexBufferData.push_back(mi);
-                        break;
-                    }
-                }
-                if (!added)
-                {
-                    unsigned int newIndex = positionBufferData.size();
-                    positionBufferData.push_back(reader.V(index));
-                    normalBufferData.push_back(reader.VN(indexN));
-                    indexBufferData.push_back(newIndex);
-                }
-            }
-        }
-    }
+    // merge the face corners that share the same position and normal
+    cyMeshWelder welder;
+    welder.Weld(reader, true, false);
+
+    // reorder triangles and vertices for the vertex cache and overdraw, and report the improvement
+    std::vector<cyVec3f> positions;
+    welder.GetPositions(reader, positions);
+    cyMeshOptimizer::VertexCacheStats before = cyMeshOptimizer::AnalyzeVertexCache(welder.Indices().data(), welder.NumIndices(), welder.NumVertices(), ObjectLayout::Stride());
+    cyMeshOptimizer::OverdrawStats overdrawBefore = cyMeshOptimizer::AnalyzeOverdraw(welder.Indices().data(), welder.NumIndices(), positions.data(), welder.NumVertices());
+    cyMeshOptimizer::Optimize(welder, reader, vertexCacheThreshold);
+    welder.GetPositions(reader, positions);
+    cyMeshOptimizer::VertexCacheStats after = cyMeshOptimizer::AnalyzeVertexCache(welder.Indices().data(), welder.NumIndices(), welder.NumVertices(), ObjectLayout::Stride());
+    cyMeshOptimizer::OverdrawStats overdrawAfter = cyMeshOptimizer::AnalyzeOverdraw(welder.Indices().data(), welder.NumIndices(), positions.data(), welder.NumVertices());
+    printf("Vertex cache: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, overfetch %.3f -> %.3f\n",
+           before.acmr, after.acmr, before.atvr, after.atvr, before.overfetch, after.overfetch);
+    printf("Overdraw: %.3f -> %.3f\n", overdrawBefore.overdraw, overdrawAfter.overdraw);
+
+    ObjectLayout::Pack(vertexBufferData, reader, welder);
+
+    // simplified levels of detail, which share the vertex buffer
+    meshLOD.Build(reader, welder, lodRatios, sizeof(lodRatios) / sizeof(float));
+    for (int i = 0; i < meshLOD.NumLevels(); i++)
+        printf("LOD %d: %u triangles, error %g\n", i, meshLOD.GetLevel(i).numIndices / 3, meshLOD.GetLevel(i).error);
+    indexBufferData = meshLOD.Indices();
+
+    // store vertex data in the mesh cache for the next run
+    cyMeshCache::Buffer buffers[3] = {
+        {"vertex", vertexBufferData.data(), vertexBufferData.size()},
+        {"index", indexBufferData.data(), sizeof(GLuint) * indexBufferData.size()},
+        {"lod", meshLOD.GetLevels(), sizeof(cyMeshLOD::Level) * meshLOD.NumLevels()}};
+    meshCache.SaveBuffers(reader, buffers, 3, getVertexDataVersion());
+}
+
+// write the mesh next to the input file as a compressed mesh file, and report its size and decoding time
+void saveCompressedMesh()
+{
+    std::string filename = cyMeshCache::GetCacheFilename(meshFilename.c_str());
+    filename.replace(filename.size() - 7, 7, ".cymc");
+    if (filename == meshFilename || !cyMeshCodec::SaveToFile(filename.c_str(), reader))
+        return;
+
+    cyTriMesh decoded;
+    auto start = std::chrono::steady_clock::now();
+    cyMeshCodec::LoadFromFile(decoded, filename.c_str());
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    cyMeshCache::SourceInfo source, output;
+    cyMeshCache::GetSourceInfo(meshFilename.c_str(), source, false);
+    cyMeshCache::GetSourceInfo(filename.c_str(), output, false);
+    printf("Saved %s: %llu -> %llu bytes (%.1fx), decoded in %.2f ms\n", filename.c_str(), (unsigned long long)source.size,
+           (unsigned long long)output.size, (double)source.size / output.size, elapsed.count());
 }
 
 // generate and set VBOs for the object
 void setVBOs()
 {
-    // vao
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
+    // vertex data from the mesh cache, or from getVertexData if the cache could not be written
+    size_t vertexSize, indexSize;
+    const void *vertexData = meshCache.GetBuffer("vertex", vertexSize);
+    const void *indexData = meshCache.GetBuffer("index", indexSize);
+    if (!vertexData || !indexData)
+    {
+        vertexSize = vertexBufferData.size();
+        indexSize = sizeof(GLuint) * indexBufferData.size();
+        vertexData = vertexBufferData.data();
+        indexData = indexBufferData.data();
+    }
 
-    // vbo
-    glGenBuffers(2, &vbo[0]);
+    // meshlets of the full detail level, using the positions at the start of each vertex
+    const cyMeshLOD::Level &level = meshLOD.GetLevel(0);
+    meshlets.Build((const GLuint *)indexData + level.firstIndex, level.numIndices, (const cyVec3f *)vertexData, vertexSize / ObjectLayout::Stride(), ObjectLayout::Stride());
+    printf("Meshlets: %u\n", meshlets.NumMeshlets());
 
-    // shader variables
-    GLuint pos = program.AttribLocation("iPos");
-    GLuint posN = program.AttribLocation("iNormal");
+    // shadow volumes of each level of detail, which merge the vertices that are split at normal seams
+    shadowVolumes.resize(meshLOD.NumLevels());
+    for (int i = 0; i < meshLOD.NumLevels(); i++)
+    {
+        const cyMeshLOD::Level &l = meshLOD.GetLevel(i);
+        shadowVolumes[i].Build((const GLuint *)indexData + l.firstIndex, l.numIndices, (const cyVec3f *)vertexData, vertexSize / ObjectLayout::Stride(), ObjectLayout::Stride());
+    }
 
-    // position
-    glBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(cyVec3f) * positionBufferData.size(), positionBufferData.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(pos, 3, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(pos);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // vao
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
 
-    // normal
-    glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(cyVec3f) * normalBufferData.size(), normalBufferData.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(posN, 3, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(posN);
+    // vbo with interleaved positions and normals
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertexSize, vertexData, GL_STATIC_DRAW);
+    ObjectLayout::SetAttribs(vbo);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     // ibo
     glGenBuffers(1, &ibo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indexBufferData.size(), indexBufferData.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize, indexData, GL_STATIC_DRAW);
+
+    // vao with the same vertices and an ibo for the visible meshlets, updated every draw
+    glGenVertexArrays(1, &vao_culled);
+    glBindVertexArray(vao_culled);
+    ObjectLayout::SetAttribs(vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glGenBuffers(1, &ibo_culled);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_culled);
+
+    // vao and vbo for the shadow volume, updated every draw
+    glGenVertexArrays(1, &vao_volume);
+    glBindVertexArray(vao_volume);
+    glGenBuffers(1, &vbo_volume);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_volume);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     glBindVertexArray(0);
+
+    // the mapped cache file is no longer needed
+    meshCache.Close();
 }
 
 // generate and set VBOs for the plane
@@ -502,10 +651,6 @@ void getHintVBOs()
 // initialize shadow map
 void setShadowMap()
 {
-    // shadow map dimensions
-    int shadowMapWidth = 1024;
-    int shadowMapHeight = 1024;
-
     // initialize shadow map
     shadowMap.Initialize(true, shadowMapWidth, shadowMapHeight);
     shadowMap.SetTextureFilteringMode(GL_LINEAR, GL_LINEAR);
@@ -514,26 +659,126 @@ void setShadowMap()
     program.SetUniform("shadow", 0);
 }
 
-// draw function
-void draw()
+// draw the given level of detail of the object
+void drawLevel(int lod)
+{
+    const cyMeshLOD::Level &level = meshLOD.GetLevel(lod);
+    glBindVertexArray(vao);
+    glDrawElements(GL_TRIANGLES, level.numIndices, GL_UNSIGNED_INT, (const void *)(sizeof(GLuint) * level.firstIndex));
+}
+
+// draw the level of detail of the object for the given view, and return the level
+int drawObject(const cy::Matrix4f &view, const cy::Matrix4f &proj, float viewportHeight)
+{
+    cy::Matrix4f modelView = view * modelMatrix;
+    int lod = meshLOD.SelectLevel(modelView, proj, viewportHeight);
+
+    // at full detail, draw only the meshlets that are in the view. The back faces are kept, since face culling
+    // is not enabled and the inside of the open teapot is visible (to the camera and the light) through its openings.
+    if (lod == 0 && meshlets.NumMeshlets() > 0)
+    {
+        meshlets.CullIndices(culledIndices, modelView, proj, false);
+        glBindVertexArray(vao_culled);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * culledIndices.size(), culledIndices.data(), GL_STREAM_DRAW);
+        glDrawElements(GL_TRIANGLES, culledIndices.size(), GL_UNSIGNED_INT, nullptr);
+        return lod;
+    }
+
+    drawLevel(lod);
+    return lod;
+}
+
+// draw the object and the plane with the given lighting pass of the object shader
+int drawScene(int lightingPass)
+{
+    program.Bind();
+    program.SetUniform("lightingPass", lightingPass);
+    int lod = drawObject(viewMatrix, projMatrix, displayHeight);
+    glBindVertexArray(vao_square);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    return lod;
+}
+
+// extract the shadow volume of the given level of detail for the light, and return the extraction time in milliseconds
+double extractShadowVolume(int lod)
+{
+    cyVec4f light = modelMatrix.GetAffineInverse() * cyVec4f(lightPos, 1.0f);
+    auto start = std::chrono::high_resolution_clock::now();
+    shadowVolumes[lod].Extract(volumeVertices, light);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// count the shadow volume faces in front of the scene depth in the stencil buffer (depth-fail)
+void drawShadowVolume()
+{
+    glBindVertexArray(vao_volume);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_volume);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(cyVec4f) * volumeVertices.size(), volumeVertices.data(), GL_STREAM_DRAW);
+
+    // the back cap is at infinity, so clamp it to the far plane instead of clipping it
+    program_volume.Bind();
+    glEnable(GL_DEPTH_CLAMP);
+    glEnable(GL_STENCIL_TEST);
+    glDepthMask(GL_FALSE);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glStencilFunc(GL_ALWAYS, 0, ~0u);
+    glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+    glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+    glDrawArrays(GL_TRIANGLES, 0, volumeVertices.size());
+
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_DEPTH_CLAMP);
+}
+
+// draw the scene with stencil shadow volumes
+void drawWithShadowVolumes()
+{
+    // ambient light, which also fills the depth buffer
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    int lod = drawScene(1);
+
+    // shadow volume of the same level of detail, so that its front cap matches the depth of the object
+    extractShadowVolume(lod);
+    drawShadowVolume();
+
+    // add the spot light where the stencil count is zero
+    glStencilFunc(GL_EQUAL, 0, ~0u);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    glDepthFunc(GL_LEQUAL);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    drawScene(2);
+    glDisable(GL_BLEND);
+    glDepthFunc(GL_LESS);
+    glDisable(GL_STENCIL_TEST);
+}
+
+// draw the scene with the shadow map
+void drawWithShadowMap()
 {
     // render shadow map
     shadowMap.Bind();
     glClear(GL_DEPTH_BUFFER_BIT);
     program_shadow.Bind();
-    glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, indexBufferData.size(), GL_UNSIGNED_INT, nullptr);
+    drawObject(lightMatrix, lightProjMatrix, shadowMapHeight);
     shadowMap.Unbind();
 
     // render scene
-    program.Bind();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glBindVertexArray(vao);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, shadowMap.GetTextureID());
-    glDrawElements(GL_TRIANGLES, indexBufferData.size(), GL_UNSIGNED_INT, nullptr);
-    glBindVertexArray(vao_square);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    drawScene(0);
+}
+
+// draw function
+void draw()
+{
+    if (useShadowVolumes)
+        drawWithShadowVolumes();
+    else
+        drawWithShadowMap();
 
     // render light hint
     program_hint.Bind();
@@ -544,6 +789,54 @@ void draw()
     glutSwapBuffers();
 }
 
+// compare the GPU time of the shadow map pass and of the shadow volume stencil pass, and the CPU time of the
+// shadow volume extraction, for each level of detail
+void benchmarkShadows()
+{
+    const int frames = 50;
+    GLuint query;
+    glGenQueries(1, &query);
+
+    printf("LOD  triangles  map GPU ms  volume GPU ms  volume CPU ms  volume triangles\n");
+    for (int lod = 0; lod < meshLOD.NumLevels(); lod++)
+    {
+        double mapTime = 0, volumeTime = 0, extractTime = 0;
+        for (int i = 0; i < frames; i++)
+        {
+            GLuint64 ns;
+
+            // shadow map pass
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            shadowMap.Bind();
+            glClear(GL_DEPTH_BUFFER_BIT);
+            program_shadow.Bind();
+            drawLevel(lod);
+            shadowMap.Unbind();
+            glEndQuery(GL_TIME_ELAPSED);
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+            mapTime += ns * 1e-6;
+
+            // shadow volume pass over the depth of the scene, including the upload of the volume
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+            program.Bind();
+            program.SetUniform("lightingPass", 1);
+            drawLevel(lod);
+            glBindVertexArray(vao_square);
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            extractTime += extractShadowVolume(lod);
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            drawShadowVolume();
+            glEndQuery(GL_TIME_ELAPSED);
+            glDisable(GL_STENCIL_TEST);
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+            volumeTime += ns * 1e-6;
+        }
+        printf("%3d  %9u  %10.3f  %13.3f  %13.3f  %16u\n", lod, meshLOD.GetLevel(lod).numIndices / 3,
+               mapTime / frames, volumeTime / frames, extractTime / frames, (unsigned)volumeVertices.size() / 3);
+    }
+    glDeleteQueries(1, &query);
+}
+
 // main
 int main(int argc, char *argv[])
 {
@@ -551,7 +844,7 @@ int main(int argc, char *argv[])
     glutInit(&argc, argv);
 
     // initialize window
-    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH | GLUT_STENCIL);
     glutInitContextFlags(GLUT_DEBUG);
     glutInitWindowSize(displayWidth, displayHeight);
     glutInitWindowPosition(100, 100);
@@ -596,15 +889,18 @@ int main(int argc, char *argv[])
     glutMainLoop();
 
     // clear VBOs and VAOs
-    glDeleteBuffers(1, &vbo[0]);
-    glDeleteBuffers(1, &vbo[1]);
+    glDeleteBuffers(1, &vbo);
     glDeleteBuffers(1, &ibo);
+    glDeleteBuffers(1, &ibo_culled);
     glDeleteBuffers(1, &vbo_square[0]);
     glDeleteBuffers(1, &vbo_square[1]);
     glDeleteBuffers(1, &vbo_hint);
+    glDeleteBuffers(1, &vbo_volume);
     glDeleteVertexArrays(1, &vao);
+    glDeleteVertexArrays(1, &vao_culled);
     glDeleteVertexArrays(1, &vao_hint);
     glDeleteVertexArrays(1, &vao_square);
+    glDeleteVertexArrays(1, &vao_volume);
 
     return 0;
 }
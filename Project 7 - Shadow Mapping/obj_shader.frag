@@ -12,6 +12,11 @@ uniform vec3 lightPos;
 uniform float lightFovRad;
 uniform sampler2DShadow shadow;
 
+// 0: ambient and spot light shadowed by the shadow map
+// 1: ambient only
+// 2: spot light only, shadowed by the stencil buffer
+uniform int lightingPass;
+
 void main() {
 
     color = vec4(0, 0, 0, 1);
@@ -23,7 +28,7 @@ void main() {
     vec3 lightDir = normalize(lightPos - worldPos);
     float angle = max(acos(dot(spotDir, - lightDir)),0);
 
-    if(angle <= lightFovRad) {
+    if(lightingPass != 1 && angle <= lightFovRad) {
 
         vec3 normal = normalize(worldNormal);
         vec3 viewDir = normalize(camPos - worldPos);
@@ -40,6 +45,8 @@ void main() {
         color += vec4(C_Blinn,0);
     }
 
-    color *= textureProj(shadow, lightViewPos);
-    color += vec4(C_Ambient, 0);
+    if(lightingPass == 0)
+        color *= textureProj(shadow, lightViewPos);
+    if(lightingPass != 2)
+        color += vec4(C_Ambient, 0);
 }
\ No newline at end of file
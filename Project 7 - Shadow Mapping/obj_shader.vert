@@ -12,6 +12,9 @@ uniform mat3 mN;
 uniform mat4 mvp;
 uniform mat4 matrixShadow;
 
+// the shadow volume caps must have the same depth as the object
+invariant gl_Position;
+
 void main() {
 	
     worldPos = vec3(m * vec4(iPos, 1));
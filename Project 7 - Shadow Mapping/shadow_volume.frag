@@ -0,0 +1,7 @@
+#version 410 core
+
+out vec4 color;
+
+void main() {
+
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#version 410 core
+
+layout (location = 0) in vec4 iPos;
+
+uniform mat4 mvp;
+
+// the caps must have the same depth as the object
+invariant gl_Position;
+
+void main() {
+
+    gl_Position = mvp * iPos;
+}
\ No newline at end of file
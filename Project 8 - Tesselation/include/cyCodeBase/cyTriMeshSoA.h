@@ -0,0 +1,352 @@
+//-------------------------------------------------------------------------------
+//! \file   cyTriMeshSoA.h
+//!
+//! \brief  Structure-of-arrays view of triangle mesh positions.
+//!
+//! TriMeshSoA stores the vertex positions of a triangle mesh in separate x, y,
+//! and z arrays, so that they can be processed with SIMD instructions, and
+//! computes the bounding box and the vertex normals of the mesh in parallel.
+//! The results are the same as TriMesh::ComputeBoundingBox and
+//! TriMesh::ComputeNormals. The instruction set is selected at run time (see
+//! cyCPU.h).
+//!
+//-------------------------------------------------------------------------------
+
+#ifndef _CY_TRIMESH_SOA_H_INCLUDED_
+#define _CY_TRIMESH_SOA_H_INCLUDED_
+
+//-------------------------------------------------------------------------------
+
+#include "cyTriMesh.h"
+#include "cyBatchTransform.h"
+#include "cyCPU.h"
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#if !defined(CY_NO_INTRIN_H) && !defined(CY_NO_EMMINTRIN_H) && !defined(CY_NO_IMMINTRIN_H)
+# if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#  if defined(__AVX2__) || defined(_CY_CPU_DISPATCH_AVX)
+#   define _CY_TRIMESH_SOA_AVX2
+#  endif
+#  if defined(__AVX512F__) || defined(_CY_CPU_DISPATCH_AVX)
+#   define _CY_TRIMESH_SOA_AVX512
+#  endif
+# endif
+#endif
+
+// The AVX-512 gather intrinsics of gcc 12 cause false warnings.
+#if defined(_CY_COMPILER_GCC) && __GNUC__ == 12
+# pragma GCC diagnostic push
+# pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+//-------------------------------------------------------------------------------
+namespace cy {
+//-------------------------------------------------------------------------------
+
+//! Structure-of-arrays view of the vertex positions and faces of a triangle mesh.
+//!
+//! Set copies the positions of a TriMesh into 32-byte aligned arrays, and
+//! SetView uses existing arrays without copying them. In both cases the faces
+//! are not copied, so they must stay valid while the view is used.
+//!
+//! ComputeBoundingBox uses BatchTransform::ComputeBounds for the vertices of
+//! each thread, so NaN coordinates are ignored.
+//!
+//! ComputeNormals does not use atomic operations. First, the face normals are
+//! computed by partitioning the faces among the threads (sixteen faces at a
+//! time with AVX-512 and eight with AVX2, selected for the instruction set
+//! level of CPU::GetISA() at each call). Then, each thread sums the face normals of a separate range of
+//! vertices, in the order of the faces. With a single thread, the face normals
+//! are computed in small blocks instead, so that they stay in the cache. Since
+//! the sums are computed in the same order as TriMesh::ComputeNormals, the
+//! results are the same (unless the compiler contracts the scalar code into
+//! fused multiply-add instructions).
+
+class TriMeshSoA
+{
+public:
+	//! Copies the vertex positions of the mesh and refers to its faces.
+	void Set( TriMesh const &mesh );
+	//! Uses the given position arrays and faces without copying them. The arrays need not be aligned.
+	void SetView( float const *x, float const *y, float const *z, unsigned int numVertices, TriMesh::TriFace const *faces, unsigned int numFaces );
+
+	unsigned int NV() const { return nv; }		//!< Returns the number of vertices.
+	unsigned int NF() const { return nf; }		//!< Returns the number of faces.
+	float const * X() const { return px; }		//!< Returns the x coordinates of the vertices.
+	float const * Y() const { return py; }		//!< Returns the y coordinates of the vertices.
+	float const * Z() const { return pz; }		//!< Returns the z coordinates of the vertices.
+	TriMesh::TriFace const * F() const { return f; }	//!< Returns the faces.
+
+	//! Computes the bounding box of the vertices using the given number of threads (0 uses all hardware threads).
+	//! If there are no vertices, the minimum is (1,1,1) and the maximum is (0,0,0), as in TriMesh.
+	void ComputeBoundingBox( Vec3f &boundMin, Vec3f &boundMax, unsigned int numThreads=0 ) const;
+	//! Computes the normalized vertex normals, one per vertex, using the given number of threads (0 uses all hardware threads).
+	void ComputeNormals( Vec3f *normals, bool clockwise=false, unsigned int numThreads=0 ) const;
+	//! Computes the vertex normals of the mesh, which must be the mesh of this view, and sets its normal faces, like TriMesh::ComputeNormals.
+	void ComputeNormals( TriMesh &mesh, bool clockwise=false, unsigned int numThreads=0 ) const;
+
+	TriMeshSoA() : px(nullptr), py(nullptr), pz(nullptr), f(nullptr), nv(0), nf(0) {}
+
+private:
+	std::vector<float> storage;
+	float const *px, *py, *pz;
+	TriMesh::TriFace const *f;
+	unsigned int nv, nf;
+
+	static unsigned int NumThreads( unsigned int numThreads, size_t n );
+	template <typename FUNC> static void ParallelFor( unsigned int n, FUNC func );
+
+	// The face normal kernels of each instruction set level write the normal of face i to index i-begin, using the widest vectors first.
+	// Each one calls the kernel of the level below for the remaining faces.
+	typedef void (TriMeshSoA::*FaceNormalsKernel)( float *nx, float *ny, float *nz, unsigned int begin, unsigned int end, bool clockwise ) const;
+	static FaceNormalsKernel GetFaceNormalsKernel();
+	void FaceNormalsScalar( float *nx, float *ny, float *nz, unsigned int begin, unsigned int end, bool clockwise ) const;
+#ifdef _CY_TRIMESH_SOA_AVX2
+	CY_TARGET_AVX2 CY_FLATTEN void FaceNormalsAVX2( float *nx, float *ny, float *nz, unsigned int begin, unsigned int end, bool clockwise ) const;
+#endif
+#ifdef _CY_TRIMESH_SOA_AVX512
+	CY_TARGET_AVX512 CY_FLATTEN void FaceNormalsAVX512( float *nx, float *ny, float *nz, unsigned int begin, unsigned int end, bool clockwise ) const;
+#endif
+};
+
+//-------------------------------------------------------------------------------
+
+inline void TriMeshSoA::Set( TriMesh const &mesh )
+{
+	nv = mesh.NV();
+	nf = mesh.NF();
+	f  = nf ? &mesh.F(0) : nullptr;
+	// Each array starts at a 32-byte boundary
+	size_t stride = ( (size_t)nv + 7 ) & ~size_t(7);
+	storage.resize( stride*3 + 8 );
+	float *p = storage.data();
+	while ( ( (uintptr_t) p ) & 31 ) p++;
+	float *x = p, *y = p + stride, *z = p + stride*2;
+	for ( unsigned int i=0; i<nv; i++ ) {
+		Vec3f const &v = mesh.V(i);
+		x[i] = v.x;
+		y[i] = v.y;
+		z[i] = v.z;
+	}
+	px = x;
+	py = y;
+	pz = z;
+}
+
+inline void TriMeshSoA::SetView( float const *x, float const *y, float const *z, unsigned int numVertices, TriMesh::TriFace const *faces, unsigned int numFaces )
+{
+	storage.clear();
+	px = x;
+	py = y;
+	pz = z;
+	nv = numVertices;
+	f  = faces;
+	nf = numFaces;
+}
+
+inline unsigned int TriMeshSoA::NumThreads( unsigned int numThreads, size_t n )
+{
+	const size_t minItemsPerThread = 1 << 16;
+	if ( numThreads == 0 ) numThreads = std::thread::hardware_concurrency();
+	size_t maxThreads = n / minItemsPerThread;
+	if ( numThreads > maxThreads ) numThreads = (unsigned int) maxThreads;
+	return numThreads < 1 ? 1 : numThreads;
+}
+
+template <typename FUNC>
+inline void TriMeshSoA::ParallelFor( unsigned int n, FUNC func )
+{
+	std::vector<std::thread> threads;
+	for ( unsigned int i=1; i<n; i++ ) threads.push_back( std::thread( func, i ) );
+	if ( n > 0 ) func(0);
+	for ( size_t i=0; i<threads.size(); i++ ) threads[i].join();
+}
+
+inline void TriMeshSoA::ComputeBoundingBox( Vec3f &boundMin, Vec3f &boundMax, unsigned int numThreads ) const
+{
+	if ( nv == 0 ) {
+		boundMin.Set(1,1,1);
+		boundMax.Set(0,0,0);
+		return;
+	}
+	unsigned int n = NumThreads( numThreads, nv );
+	std::vector<Vec3f> tmin( n ), tmax( n );
+	ParallelFor( n, [&]( unsigned int t ) {
+		size_t begin = (size_t) nv * t / n, end = (size_t) nv * (t+1) / n;
+		BatchTransform::ComputeBounds( px+begin, py+begin, pz+begin, end-begin, tmin[t], tmax[t] );
+	});
+	boundMin = tmin[0];
+	boundMax = tmax[0];
+	for ( unsigned int t=1; t<n; t++ ) {
+		for ( int k=0; k<3; k++ ) {
+			boundMin[k] = Min( boundMin[k], tmin[t][k] );
+			boundMax[k] = Max( boundMax[k], tmax[t][k] );
+		}
+	}
+}
+
+inline void TriMeshSoA::FaceNormalsScalar( float *nx, float *ny, float *nz, unsigned int begin, unsigned int end, bool clockwise ) const
+{
+	for ( unsigned int i=begin; i<end; i++ ) {
+		unsigned int const *v = f[i].v;
+		Vec3f p0( px[v[0]], py[v[0]], pz[v[0]] );
+		Vec3f N = ( Vec3f( px[v[1]], py[v[1]], pz[v[1]] ) - p0 ) ^ ( Vec3f( px[v[2]], py[v[2]], pz[v[2]] ) - p0 );
+		if ( clockwise ) N = -N;
+		nx[i-begin] = N.x;
+		ny[i-begin] = N.y;
+		nz[i-begin] = N.z;
+	}
+}
+
+#ifdef _CY_TRIMESH_SOA_AVX2
+inline void TriMeshSoA::FaceNormalsAVX2( float *nx, float *ny, float *nz, unsigned int begin, unsigned int end, bool clockwise ) const
+{
+	unsigned int i = begin;
+	// The faces are read as eight consecutive triples of indices
+	__m256i offset = _mm256_setr_epi32( 0, 3, 6, 9, 12, 15, 18, 21 );
+	int const *fi = (int const *) f;
+	for ( ; i+8<=end; i+=8 ) {
+		__m256i i0 = _mm256_i32gather_epi32( fi + i*3 + 0, offset, 4 );
+		__m256i i1 = _mm256_i32gather_epi32( fi + i*3 + 1, offset, 4 );
+		__m256i i2 = _mm256_i32gather_epi32( fi + i*3 + 2, offset, 4 );
+		__m256 x0 = _mm256_i32gather_ps( px, i0, 4 ), y0 = _mm256_i32gather_ps( py, i0, 4 ), z0 = _mm256_i32gather_ps( pz, i0, 4 );
+		__m256 x1 = _mm256_i32gather_ps( px, i1, 4 ), y1 = _mm256_i32gather_ps( py, i1, 4 ), z1 = _mm256_i32gather_ps( pz, i1, 4 );
+		__m256 x2 = _mm256_i32gather_ps( px, i2, 4 ), y2 = _mm256_i32gather_ps( py, i2, 4 ), z2 = _mm256_i32gather_ps( pz, i2, 4 );
+		__m256 ax = _mm256_sub_ps( x1, x0 ), ay = _mm256_sub_ps( y1, y0 ), az = _mm256_sub_ps( z1, z0 );
+		__m256 bx = _mm256_sub_ps( x2, x0 ), by = _mm256_sub_ps( y2, y0 ), bz = _mm256_sub_ps( z2, z0 );
+		__m256 cx = _mm256_sub_ps( _mm256_mul_ps( ay, bz ), _mm256_mul_ps( az, by ) );
+		__m256 cy = _mm256_sub_ps( _mm256_mul_ps( az, bx ), _mm256_mul_ps( ax, bz ) );
+		__m256 cz = _mm256_sub_ps( _mm256_mul_ps( ax, by ), _mm256_mul_ps( ay, bx ) );
+		if ( clockwise ) {
+			__m256 sign = _mm256_set1_ps( -0.0f );
+			cx = _mm256_xor_ps( cx, sign );
+			cy = _mm256_xor_ps( cy, sign );
+			cz = _mm256_xor_ps( cz, sign );
+		}
+		_mm256_storeu_ps( nx+i-begin, cx );
+		_mm256_storeu_ps( ny+i-begin, cy );
+		_mm256_storeu_ps( nz+i-begin, cz );
+	}
+	FaceNormalsScalar( nx+i-begin, ny+i-begin, nz+i-begin, i, end, clockwise );
+}
+#endif
+
+#ifdef _CY_TRIMESH_SOA_AVX512
+inline void TriMeshSoA::FaceNormalsAVX512( float *nx, float *ny, float *nz, unsigned int begin, unsigned int end, bool clockwise ) const
+{
+	unsigned int i = begin;
+	// The faces are read as sixteen consecutive triples of indices
+	__m512i offset = _mm512_setr_epi32( 0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45 );
+	int const *fi = (int const *) f;
+	for ( ; i+16<=end; i+=16 ) {
+		__m512i i0 = _mm512_i32gather_epi32( offset, fi + i*3 + 0, 4 );
+		__m512i i1 = _mm512_i32gather_epi32( offset, fi + i*3 + 1, 4 );
+		__m512i i2 = _mm512_i32gather_epi32( offset, fi + i*3 + 2, 4 );
+		__m512 x0 = _mm512_i32gather_ps( i0, px, 4 ), y0 = _mm512_i32gather_ps( i0, py, 4 ), z0 = _mm512_i32gather_ps( i0, pz, 4 );
+		__m512 x1 = _mm512_i32gather_ps( i1, px, 4 ), y1 = _mm512_i32gather_ps( i1, py, 4 ), z1 = _mm512_i32gather_ps( i1, pz, 4 );
+		__m512 x2 = _mm512_i32gather_ps( i2, px, 4 ), y2 = _mm512_i32gather_ps( i2, py, 4 ), z2 = _mm512_i32gather_ps( i2, pz, 4 );
+		__m512 ax = _mm512_sub_ps( x1, x0 ), ay = _mm512_sub_ps( y1, y0 ), az = _mm512_sub_ps( z1, z0 );
+		__m512 bx = _mm512_sub_ps( x2, x0 ), by = _mm512_sub_ps( y2, y0 ), bz = _mm512_sub_ps( z2, z0 );
+		__m512 cx = _mm512_sub_ps( _mm512_mul_ps( ay, bz ), _mm512_mul_ps( az, by ) );
+		__m512 cy = _mm512_sub_ps( _mm512_mul_ps( az, bx ), _mm512_mul_ps( ax, bz ) );
+		__m512 cz = _mm512_sub_ps( _mm512_mul_ps( ax, by ), _mm512_mul_ps( ay, bx ) );
+		if ( clockwise ) {
+			__m512i sign = _mm512_set1_epi32( (int) 0x80000000 );
+			cx = _mm512_castsi512_ps( _mm512_xor_si512( _mm512_castps_si512(cx), sign ) );
+			cy = _mm512_castsi512_ps( _mm512_xor_si512( _mm512_castps_si512(cy), sign ) );
+			cz = _mm512_castsi512_ps( _mm512_xor_si512( _mm512_castps_si512(cz), sign ) );
+		}
+		_mm512_storeu_ps( nx+i-begin, cx );
+		_mm512_storeu_ps( ny+i-begin, cy );
+		_mm512_storeu_ps( nz+i-begin, cz );
+	}
+	FaceNormalsAVX2( nx+i-begin, ny+i-begin, nz+i-begin, i, end, clockwise );
+}
+#endif
+
+inline TriMeshSoA::FaceNormalsKernel TriMeshSoA::GetFaceNormalsKernel()
+{
+	static CPUDispatch<FaceNormalsKernel> const kernels = []() {
+		CPUDispatch<FaceNormalsKernel> k( &TriMeshSoA::FaceNormalsScalar );
+#ifdef _CY_TRIMESH_SOA_AVX2
+		k.Set( CPU::ISA_AVX2, &TriMeshSoA::FaceNormalsAVX2 );
+#endif
+#ifdef _CY_TRIMESH_SOA_AVX512
+		k.Set( CPU::ISA_AVX512, &TriMeshSoA::FaceNormalsAVX512 );
+#endif
+		return k;
+	}();
+	return kernels.Get();
+}
+
+inline void TriMeshSoA::ComputeNormals( Vec3f *normals, bool clockwise, unsigned int numThreads ) const
+{
+	if ( nv == 0 ) return;
+	FaceNormalsKernel kernel = GetFaceNormalsKernel();
+	unsigned int n = NumThreads( numThreads, nf );
+	if ( n == 1 ) {
+		const unsigned int blockSize = 1024;
+		alignas(32) float nx[blockSize], ny[blockSize], nz[blockSize];
+		for ( unsigned int i=0; i<nv; i++ ) normals[i].Set(0,0,0);
+		for ( unsigned int b=0; b<nf; b+=blockSize ) {
+			unsigned int e = Min( nf, b + blockSize );
+			(this->*kernel)( nx, ny, nz, b, e, clockwise );
+			for ( unsigned int i=b; i<e; i++ ) {
+				Vec3f N( nx[i-b], ny[i-b], nz[i-b] );
+				normals[ f[i].v[0] ] += N;
+				normals[ f[i].v[1] ] += N;
+				normals[ f[i].v[2] ] += N;
+			}
+		}
+		for ( unsigned int i=0; i<nv; i++ ) normals[i].Normalize();
+		return;
+	}
+
+	std::vector<float> faceNormals( (size_t) nf * 3 );
+	float *nx = faceNormals.data(), *ny = nx + nf, *nz = ny + nf;
+
+	// Face normals, partitioned by faces
+	ParallelFor( n, [&]( unsigned int t ) {
+		unsigned int begin = (unsigned int)( (size_t) nf * t / n ), end = (unsigned int)( (size_t) nf * (t+1) / n );
+		(this->*kernel)( nx+begin, ny+begin, nz+begin, begin, end, clockwise );
+	});
+
+	// Vertex normals, partitioned by vertices. Each thread only writes the normals of its own vertices.
+	ParallelFor( n, [&]( unsigned int t ) {
+		unsigned int begin = (unsigned int)( (size_t) nv * t / n ), end = (unsigned int)( (size_t) nv * (t+1) / n );
+		for ( unsigned int i=begin; i<end; i++ ) normals[i].Set(0,0,0);
+		for ( unsigned int i=0; i<nf; i++ ) {
+			for ( int j=0; j<3; j++ ) {
+				unsigned int v = f[i].v[j];
+				if ( v >= begin && v < end ) normals[v] += Vec3f( nx[i], ny[i], nz[i] );
+			}
+		}
+		for ( unsigned int i=begin; i<end; i++ ) normals[i].Normalize();
+	});
+}
+
+inline void TriMeshSoA::ComputeNormals( TriMesh &mesh, bool clockwise, unsigned int numThreads ) const
+{
+	mesh.SetNumNormals( nv );
+	if ( nv == 0 ) return;
+	ComputeNormals( &mesh.VN(0), clockwise, numThreads );
+	for ( unsigned int i=0; i<nf; i++ ) mesh.FN(i) = f[i];
+}
+
+//-------------------------------------------------------------------------------
+} // namespace cy
+//-------------------------------------------------------------------------------
+
+#if defined(_CY_COMPILER_GCC) && __GNUC__ == 12
+# pragma GCC diagnostic pop
+#endif
+
+//-------------------------------------------------------------------------------
+
+typedef cy::TriMeshSoA cyTriMeshSoA;	//!< Structure-of-arrays view of triangle mesh positions
+
+//-------------------------------------------------------------------------------
+
+#endif
@@ -6,6 +6,7 @@
 #include "cyCodeBase/cyVector.h"
 #include "cyCodeBase/cyMatrix.h"
 #include "cyCodeBase/cyTriMesh.h"
+#include "cyCodeBase/cyBezierPatch.h"
 #include "cyCodeBase/cyGL.h"
 #include "lodepng.h"
 
@@ -37,7 +38,7 @@ float camFOV = 0.25 * M_PI;
 cyVec3f lightPos = cyVec3f(0, distance, 0);
 cyVec3f lightTarget = cyVec3f(0, 0, 0);
 cyVec3f lightUp = cyVec3f(0, 1, 0);
-float lightFOV = 0.3 * M_PI;
+constexpr float lightFOV = 0.3 * M_PI;
 
 // MVP matrices
 cy::Matrix4f projMatrix = cy::Matrix4f::Perspective(camFOV, displayWidth / displayHeight, 0.1f, 1000.0f);
@@ -45,9 +46,13 @@ cy::Matrix4f viewMatrix = cy::Matrix4f::View(camPos, camTarget, camUp);
 cy::Matrix4f modelMatrix = cy::Matrix4f::Identity();
 
 // light space matrices
-cy::Matrix4f lightProjMatrix = cy::Matrix4f::Perspective(lightFOV, 1.0f, 0.1f, 1000.0f);
+CY_CONSTEXPR_VAR cy::Matrix4f lightProjMatrix = cy::Matrix4f::Perspective(lightFOV, 1.0f, 0.1f, 1000.0f);
 cy::Matrix4f lightMatrix = cy::Matrix4f::View(lightPos, lightTarget, lightUp);
 
+// maps light clip space to shadow map coordinates, with a small depth bias
+constexpr float shadowBias = 0.00003f;
+CY_CONSTEXPR_VAR cy::Matrix4f shadowBiasMatrix = cy::Matrix4f::Product(cy::Matrix4f::Translation(cyVec3f(0.5f, 0.5f, 0.5f - shadowBias)), cy::Matrix4f::Scale(0.5f));
+
 // callback variables
 int mouseButton = -1;
 int lastX;
@@ -66,6 +71,9 @@ cy::GLSLProgram program;
 cy::GLSLProgram program_outline;
 cy::GLSLProgram program_shadow;
 cy::GLSLProgram program_hint;
+cy::GLSLProgram program_patches;
+cy::GLSLProgram program_patches_outline;
+cy::GLSLProgram program_patches_shadow;
 
 // image data
 std::vector<unsigned char> image_normal, image_disp;
@@ -73,6 +81,14 @@ std::vector<unsigned char> image_normal, image_disp;
 // VAOs and VBOs
 GLuint vao_square, vbo_square[2];
 GLuint vao_hint, vbo_hint;
+GLuint vao_patches, vbo_patches[2];
+
+// Bezier patches (the teapot), drawn on the plane
+cyBezierPatches patches;
+bool hasPatches = false;
+CY_CONSTEXPR_VAR cy::Matrix4f patchModel = cy::Matrix4f::Product(cy::Matrix4f::Translation(cyVec3f(0, 0, 4)), cy::Matrix4f::Scale(12.0f));
+float edgePixels = 8.0f;
+int maxPatchTessLevel = 64;
 
 // shadow map
 cyGLRenderDepth2D shadowMap;
@@ -111,6 +127,14 @@ void setCamera()
     program_outline.SetUniformMatrix4("vp", vp.cell);
 
     program_hint.SetUniformMatrix4("vp", vp.cell);
+
+    if (hasPatches)
+    {
+        cy::Matrix4f patchMVP = projMatrix * viewMatrix * modelMatrix * patchModel;
+        program_patches.SetUniformMatrix4("mvp", patchMVP.cell);
+        program_patches.SetUniform("camPos", camPos.x, camPos.y, camPos.z);
+        program_patches_outline.SetUniformMatrix4("mvp", patchMVP.cell);
+    }
 }
 
 // update light space matrices and send to shaders
@@ -126,13 +150,22 @@ void setLight()
     cyMatrix4f mvp = lightProjMatrix * lightMatrix * modelMatrix;
     program_shadow.SetUniformMatrix4("mvp", mvp.cell);
 
-    float shadowBias = 0.00003f;
-    cyMatrix4f mShadow = cyMatrix4f::Translation(cyVec3f(0.5f, 0.5f, 0.5f - shadowBias)) * cyMatrix4f::Scale(0.5f) * mvp;
+    cyMatrix4f mShadow = shadowBiasMatrix * mvp;
 
     program.SetUniformMatrix4("matrixShadow", mShadow.cell);
 
     cyMatrix4f hintModel = cyMatrix4f::Translation(lightPos) * cyMatrix4f::Rotation(cyVec3f(0, 1, 0), spotDir);
     program_hint.SetUniformMatrix4("m", hintModel.cell);
+
+    if (hasPatches)
+    {
+        cyMatrix4f patchMVP = lightProjMatrix * lightMatrix * modelMatrix * patchModel;
+        cyMatrix4f patchShadow = shadowBiasMatrix * patchMVP;
+        program_patches_shadow.SetUniformMatrix4("mvp", patchMVP.cell);
+        program_patches.SetUniformMatrix4("matrixShadow", patchShadow.cell);
+        program_patches.SetUniform("spotDir", spotDir.x, spotDir.y, spotDir.z);
+        program_patches.SetUniform("lightPos", lightPos.x, lightPos.y, lightPos.z);
+    }
 }
 
 // change tesselation level
@@ -155,6 +188,28 @@ void changeTessLevel(int delta = 0)
     }
 }
 
+// change the screen-space length of the patch edges, which sets their tesselation level
+void changeEdgePixels(float scale = 1)
+{
+    edgePixels *= scale;
+
+    if (edgePixels < 1)
+        edgePixels = 1;
+    if (edgePixels > 256)
+        edgePixels = 256;
+
+    program_patches.SetUniform("edgePixels", edgePixels);
+    program_patches_outline.SetUniform("edgePixels", edgePixels);
+    program_patches_shadow.SetUniform("edgePixels", edgePixels);
+}
+
+// update viewport dimensions used for the tesselation level of the patches
+void setPatchViewport()
+{
+    program_patches.SetUniform("viewport", displayWidth, displayHeight);
+    program_patches_outline.SetUniform("viewport", displayWidth, displayHeight);
+}
+
 // update shader uniforms
 void setUniforms()
 {
@@ -167,6 +222,23 @@ void setUniforms()
     program.SetUniform("tessLevel", 1);
     program_outline.SetUniform("tessLevel", 1);
     program_shadow.SetUniform("tessLevel", 1);
+    program.SetUniform("hasShadow", hasDisp || hasPatches);
+
+    if (hasPatches)
+    {
+        cy::Matrix4f m = modelMatrix * patchModel;
+        program_patches.SetUniformMatrix4("m", m.cell);
+        program_patches.SetUniform("lightFovRad", lightFOV);
+        program_patches.SetUniform("tessLevel", maxPatchTessLevel);
+        program_patches_outline.SetUniform("tessLevel", maxPatchTessLevel);
+        program_patches_shadow.SetUniform("tessLevel", maxPatchTessLevel);
+        program_patches.SetUniform("shadowMap", 3);
+
+        // the shadow map is rendered with its own resolution
+        program_patches_shadow.SetUniform("viewport", 1024.0f, 1024.0f);
+        setPatchViewport();
+        changeEdgePixels();
+    }
 }
 
 // compile outline, shadow, and light hint shaders
@@ -176,8 +248,8 @@ void compileShaders()
     if (!program.BuildFiles("shader.vert", "shader.frag", nullptr, "shader.tesc", "shader.tese"))
         exit(1);
 
-    // outline shaders
-    if (!program_outline.BuildFiles("shader.vert", "outline.frag", "outline.geom", "shader.tesc", "outline.tese"))
+    // outline shaders (the edges are rasterized with the line polygon mode instead of a geometry shader)
+    if (!program_outline.BuildFiles("shader.vert", "outline.frag", nullptr, "shader.tesc", "outline.tese"))
         exit(1);
 
     // shadow shaders
@@ -188,6 +260,17 @@ void compileShaders()
     if (!program_hint.BuildFiles("hint.vert", "hint.frag"))
         exit(1);
 
+    // Bezier patch shaders (the patches are evaluated in the tesselation evaluation shader)
+    if (hasPatches)
+    {
+        if (!program_patches.BuildFiles("teapot.vert", "teapot.frag", nullptr, "teapot.tesc", "teapot.tese"))
+            exit(1);
+        if (!program_patches_outline.BuildFiles("teapot.vert", "outline.frag", nullptr, "teapot.tesc", "teapot.tese"))
+            exit(1);
+        if (!program_patches_shadow.BuildFiles("teapot.vert", "shadow.frag", nullptr, "teapot.tesc", "teapot.tese"))
+            exit(1);
+    }
+
     setUniforms();
 
     setCamera();
@@ -299,7 +382,8 @@ void keyListener(unsigned char key, int x, int y)
     }
 }
 
-// listen for 'F6' to re-compile shaders, left and right arrow keys to increase tesselation levels
+// listen for 'F6' to re-compile shaders, left and right arrow keys to increase tesselation levels,
+// and up and down arrow keys to refine or coarsen the tesselation of the patches
 void spclKeyListener(int key, int x, int y)
 {
     switch (key)
@@ -316,6 +400,14 @@ void spclKeyListener(int key, int x, int y)
     case GLUT_KEY_RIGHT:
         changeTessLevel(1);
         break;
+
+    case GLUT_KEY_UP:
+        changeEdgePixels(0.8f);
+        break;
+
+    case GLUT_KEY_DOWN:
+        changeEdgePixels(1.25f);
+        break;
     }
     glutPostRedisplay();
 }
@@ -330,6 +422,8 @@ void resize(int w, int h)
     // update projection matrix aspect ratio
     projMatrix = cy::Matrix4f::Perspective(camFOV, displayWidth / displayHeight, 0.1f, 1000.0f);
     setCamera();
+    if (hasPatches)
+        setPatchViewport();
 
     // change viewport and re-display
     glViewport(0, 0, w, h);
@@ -370,31 +464,60 @@ void bindTextures()
         program_shadow.SetUniform("dispMap", 2);
     }
 
-    program.SetUniform("hasDisp", hasDisp);
+}
+
+// load Bezier patches from a file, or the built-in teapot if the argument is "teapot"
+void loadPatches(const char *arg)
+{
+    std::string name = arg;
+    if (name == "teapot")
+        patches.SetTeapot();
+    else if (!patches.LoadFromFile(arg))
+        exit(1);
+    hasPatches = true;
+
+    // the same surface as triangles, with a position and a normal per vertex
+    size_t level = maxPatchTessLevel;
+    size_t meshBytes = patches.NumPatches() * (level + 1) * (level + 1) * 2 * sizeof(cyVec3f) + patches.NumPatches() * level * level * 6 * sizeof(unsigned int);
+    std::cout << "Patches: " << patches.NumPatches() << " patches, " << patches.NumControlPoints() << " control points, " << patches.DataBytes() << " bytes";
+    std::cout << " (a mesh tesselated at level " << level << " would need " << meshBytes / 1024 << " KB)" << std::endl;
 }
 
 // parse arguments
 void parseArgs(int argc, char *argv[])
 {
+    // a Bezier patch file (.bpt) or "teapot" can be given before the maps
+    int first = 1;
+    if (argc >= 2)
+    {
+        std::string arg = argv[1];
+        if (arg == "teapot" || (arg.size() > 4 && arg.substr(arg.size() - 4) == ".bpt"))
+        {
+            loadPatches(argv[1]);
+            first = 2;
+        }
+    }
+    int numMaps = argc - first;
+
     // edge cases
-    if (argc < 2 || argc > 3)
+    if (numMaps < 1 || numMaps > 2)
     {
         std::cout << "Error: invalid number of arguments";
         std::cout << argc;
         exit(1);
     }
-    else if (argc == 3)
+    else if (numMaps == 2)
     {
         // has a displacement map
         hasDisp = true;
-        loadImage(argv[1], imageWidth, imageHeight, image_normal);
-        loadImage(argv[2], imageWidth, imageHeight, image_disp);
+        loadImage(argv[first], imageWidth, imageHeight, image_normal);
+        loadImage(argv[first + 1], imageWidth, imageHeight, image_disp);
     }
     else
     {
-        // argc == 2, doesn't have a displacement map
+        // one map, doesn't have a displacement map
         hasDisp = false;
-        loadImage(argv[1], imageWidth, imageHeight, image_normal);
+        loadImage(argv[first], imageWidth, imageHeight, image_normal);
     }
 }
 
@@ -502,6 +625,40 @@ void getHintVBOs()
     glBindVertexArray(0);
 }
 
+// generate and set VBOs for the Bezier patches: only the control points and 16 indices per patch are uploaded
+void getPatchVBOs()
+{
+    // vao
+    glGenVertexArrays(1, &vao_patches);
+    glBindVertexArray(vao_patches);
+
+    // shader variable
+    GLuint pos_patches = program_patches.AttribLocation("iPos");
+
+    // vbo and index buffer
+    glGenBuffers(2, vbo_patches);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_patches[0]);
+    glBufferData(GL_ARRAY_BUFFER, patches.NumControlPoints() * sizeof(cyVec3f), patches.ControlPoints().data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(pos_patches, 3, GL_FLOAT, GL_FALSE, 0, 0);
+    glEnableVertexAttribArray(pos_patches);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo_patches[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, patches.NumPatches() * sizeof(cyBezierPatches::Patch), patches.Patches().data(), GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+}
+
+// draw the Bezier patches with the bound program
+void drawPatches()
+{
+    glPatchParameteri(GL_PATCH_VERTICES, 16);
+    glBindVertexArray(vao_patches);
+    glDrawElements(GL_PATCHES, patches.NumPatches() * 16, GL_UNSIGNED_INT, 0);
+    glPatchParameteri(GL_PATCH_VERTICES, 4);
+}
+
 // initialize shadow map
 void setShadowMap()
 {
@@ -515,13 +672,14 @@ void setShadowMap()
     shadowMap.SetTextureWrappingMode(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
 
     program.SetUniform("shadowMap", 3);
+    program_patches.SetUniform("shadowMap", 3);
 }
 
 // draw function
 void draw()
 {
-    // render the plane in shadow camera  (if displacement map is rendered)
-    if (hasDisp)
+    // render the plane in shadow camera  (if displacement map is rendered), and the patches that cast shadows on it
+    if (hasDisp || hasPatches)
     {
         shadowMap.Bind();
         glClear(GL_DEPTH_BUFFER_BIT);
@@ -530,6 +688,11 @@ void draw()
         glBindTexture(GL_TEXTURE_2D, displacementMap.GetID());
         glBindVertexArray(vao_square);
         glDrawArrays(GL_PATCHES, 0, 4);
+        if (hasPatches)
+        {
+            program_patches_shadow.Bind();
+            drawPatches();
+        }
         shadowMap.Unbind();
     }
 
@@ -542,12 +705,22 @@ void draw()
     {
         glActiveTexture(GL_TEXTURE2);
         glBindTexture(GL_TEXTURE_2D, displacementMap.GetID());
+    }
+    if (hasDisp || hasPatches)
+    {
         glActiveTexture(GL_TEXTURE3);
         glBindTexture(GL_TEXTURE_2D, shadowMap.GetTextureID());
     }
     glBindVertexArray(vao_square);
     glDrawArrays(GL_PATCHES, 0, 4);
 
+    // render the patches in world camera
+    if (hasPatches)
+    {
+        program_patches.Bind();
+        drawPatches();
+    }
+
     // render the outline of the plane
     if (renderOutline)
     {
@@ -558,7 +731,19 @@ void draw()
             glBindTexture(GL_TEXTURE_2D, displacementMap.GetID());
         }
         glBindVertexArray(vao_square);
+        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
         glDrawArrays(GL_PATCHES, 0, 4);
+
+        // the patch outline is pulled towards the camera, like the plane outline
+        if (hasPatches)
+        {
+            program_patches_outline.Bind();
+            glEnable(GL_POLYGON_OFFSET_LINE);
+            glPolygonOffset(-1.0f, -1.0f);
+            drawPatches();
+            glDisable(GL_POLYGON_OFFSET_LINE);
+        }
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     }
 
     // render the hint object
@@ -611,6 +796,8 @@ int main(int argc, char *argv[])
     // set VBOs and VAOs
     getPlaneVBOs();
     getHintVBOs();
+    if (hasPatches)
+        getPatchVBOs();
 
     // setup shadow map
     setShadowMap();
@@ -626,6 +813,11 @@ int main(int argc, char *argv[])
     glDeleteBuffers(1, &vbo_hint);
     glDeleteVertexArrays(1, &vao_hint);
     glDeleteVertexArrays(1, &vao_square);
+    if (hasPatches)
+    {
+        glDeleteBuffers(2, vbo_patches);
+        glDeleteVertexArrays(1, &vao_patches);
+    }
 
     return 0;
 }
\ No newline at end of file
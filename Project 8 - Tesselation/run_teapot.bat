@@ -0,0 +1,2 @@
+main.exe teapot.bpt teapot_normal.png teapot_disp.png
+pause
\ No newline at end of file